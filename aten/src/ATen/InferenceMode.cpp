@@ -0,0 +1,55 @@
+#include <ATen/InferenceMode.h>
+
+#include <torch/library.h>
+
+namespace at {
+
+/// thread_local is a feature that is not enabled by Caffe2 mobile
+/// build (e.g. iOS). Therefore, we only provide `at::InferenceMode`
+/// when we are not in mobile build or when FEATURE_TORCH_MOBILE
+/// is on.
+#if !defined(C10_MOBILE) || defined(FEATURE_TORCH_MOBILE)
+
+InferenceMode::InferenceMode(bool enabled)
+    : grad_mode_(enabled ? false : GradMode::is_enabled()),
+      prev_keyset_(c10::impl::tls_local_dispatch_key_set()) {
+  c10::impl::LocalDispatchKeySet keyset = prev_keyset_;
+  if (enabled) {
+    keyset.included_ = keyset.included_.add(DispatchKey::InferenceMode);
+    keyset.excluded_ = keyset.excluded_ | c10::autograd_dispatch_keyset;
+  } else {
+    keyset.included_ = keyset.included_.remove(DispatchKey::InferenceMode);
+    keyset.excluded_ = keyset.excluded_ - c10::autograd_dispatch_keyset;
+  }
+  c10::impl::_force_tls_local_dispatch_key_set(keyset);
+}
+
+InferenceMode::~InferenceMode() {
+  c10::impl::_force_tls_local_dispatch_key_set(prev_keyset_);
+}
+
+bool InferenceMode::is_enabled() {
+  return c10::impl::tls_is_dispatch_key_included(DispatchKey::InferenceMode);
+}
+
+#else
+
+InferenceMode::InferenceMode(bool enabled)
+    : grad_mode_(false),
+      prev_keyset_(c10::impl::tls_local_dispatch_key_set()) {
+  TORCH_CHECK(false, "InferenceMode is not supported on mobile");
+}
+
+InferenceMode::~InferenceMode() {}
+
+bool InferenceMode::is_enabled() {
+  return false;
+}
+
+#endif
+
+TORCH_LIBRARY_IMPL(_, InferenceMode, m) {
+  m.fallback(torch::CppFunction::makeFallthrough());
+}
+
+} // namespace at
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <ATen/core/grad_mode.h>
+#include <c10/core/impl/LocalDispatchKeySet.h>
+
+namespace at {
+
+// Note [Inference tensors]
+// ~~~~~~~~~~~~~~~~~~~~~~~~
+// Even with grad mode disabled, every op on normal tensors goes through the
+// autograd kernels, which check the autograd metadata of the inputs, bump the
+// version counters of the mutated tensors and set up the views; and every
+// tensor allocates a version counter.  InferenceMode is meant for code that
+// never uses autograd, e.g. serving, and skips all of it:
+//
+//  - It adds DispatchKey::InferenceMode to the thread local included set and
+//    excludes the autograd keys, so that ops go straight to the backend
+//    kernels.  It also disables grad mode.
+//
+//  - The tensors created in it are inference tensors: they have the
+//    InferenceMode key instead of an autograd key, and no version counter.
+//    Views of inference tensors are inference tensors too.  Outside of
+//    InferenceMode, ops on inference tensors only still skip the autograd
+//    kernels.
+//
+//  - Ops that neither mutate nor alias their inputs fall through the
+//    InferenceMode key.  The others have a kernel generated in
+//    torch/csrc/autograd/generated/InferenceModeType.cpp, which keeps the
+//    version counters of normal tensors correct in InferenceMode: it bumps the
+//    mutated ones, and the views of normal tensors share the version counter
+//    of their base.  When the tensors involved are inference tensors, it just
+//    redispatches.
+//
+// Inference tensors can be mixed with normal tensors, with the following
+// checks (their only error cases):
+//
+//  - They can't require grad, nor be saved for backward by an op recording
+//    autograd history outside of InferenceMode.
+//
+//  - They can't be updated inplace outside of InferenceMode, since their
+//    version is not tracked.
+//
+// Clone an inference tensor outside of InferenceMode to get a normal tensor.
+// Custom ops that mutate or alias their inputs and don't register a kernel
+// for the InferenceMode key don't bump version counters in InferenceMode.
+
+// A RAII, thread local (!) guard that enables or disables InferenceMode upon
+// construction, and sets it back to the original state upon destruction.
+struct TORCH_API InferenceMode {
+  InferenceMode(bool enabled = true);
+  ~InferenceMode();
+
+  InferenceMode(const InferenceMode&) = delete;
+  InferenceMode& operator=(const InferenceMode&) = delete;
+
+  static bool is_enabled();
+
+ private:
+  AutoGradMode grad_mode_;
+  c10::impl::LocalDispatchKeySet prev_keyset_;
+};
+
+} // namespace at
@@ -0,0 +1,75 @@
+#include <ATen/ATen.h>
+#include <ATen/JaggedTensorImpl.h>
+#include <ATen/InitialTensorOptions.h>
+
+namespace at {
+
+// An empty jagged tensor is a batch of no sequences, of sizes (0, 0).
+JaggedTensorImpl::JaggedTensorImpl(at::DispatchKeySet key_set, const caffe2::TypeMeta data_type)
+    : TensorImpl(key_set, data_type, kCPU)
+    , values_(at::empty({0}, at::initialTensorOptions().dtype(data_type)))
+    , offsets_(at::zeros({1}, at::initialTensorOptions().dtype(ScalarType::Long))) {
+  TORCH_INTERNAL_ASSERT(key_set.has(DispatchKey::JaggedCPU),
+      "Cannot construct a jagged tensor with dispatch keys ", key_set);
+  sizes_and_strides_.set_sizes({0, 0});
+  refresh_numel();
+  is_non_overlapping_and_dense_ = false;
+}
+
+IntArrayRef JaggedTensorImpl::strides() const {
+  AT_ERROR("jagged tensors do not have strides");
+}
+bool JaggedTensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
+  AT_ERROR("jagged tensors do not have is_contiguous");
+}
+int64_t JaggedTensorImpl::stride(int64_t d) const {
+  AT_ERROR("jagged tensors do not have strides");
+}
+void JaggedTensorImpl::set_size(int64_t dim, int64_t new_size) {
+  AT_ERROR("jagged tensors do not have set_size");
+}
+void JaggedTensorImpl::set_stride(int64_t dim, int64_t new_stride) {
+  AT_ERROR("jagged tensors do not have set_stride");
+}
+void JaggedTensorImpl::set_storage_offset(int64_t storage_offset) {
+  AT_ERROR("jagged tensors do not have set_storage_offset");
+}
+#ifdef DEBUG
+bool JaggedTensorImpl::has_storage() const {
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(!storage_, "JaggedTensorImpl assumes that storage_ is never set");
+  return false;
+}
+#endif
+const Storage& JaggedTensorImpl::storage() const {
+  AT_ERROR("jagged tensors do not have storage");
+}
+
+void JaggedTensorImpl::set_member_tensors(const Tensor& values, const Tensor& offsets, int64_t max_length) {
+  TORCH_CHECK(allow_tensor_metadata_change(), "set_member_tensors ", err_msg_tensor_metadata_change_not_allowed);
+
+  TORCH_CHECK(values.layout() == kStrided && offsets.layout() == kStrided,
+      "expected values and offsets to be strided tensors");
+  TORCH_CHECK(values.device() == device() && offsets.device() == device(),
+      "device of values (", values.device(), ") and offsets (", offsets.device(),
+      ") must match device of jagged tensor (", device(), ")");
+  TORCH_CHECK(values.scalar_type() == typeMetaToScalarType(dtype()), "dtype of values (", values.scalar_type(), ") must match dtype of jagged tensor (", typeMetaToScalarType(dtype()), ")");
+  TORCH_CHECK(offsets.scalar_type() == kInt || offsets.scalar_type() == kLong,
+      "offsets must be an int32 or int64 tensor, but got ", offsets.scalar_type());
+  TORCH_CHECK(values.dim() >= 1, "values must be at least 1-D, but got a ", values.dim(), "-D tensor");
+  TORCH_CHECK(offsets.dim() == 1 && offsets.size(0) >= 1,
+      "offsets must be a 1-D tensor with at least one element, but got size ", offsets.sizes());
+  TORCH_CHECK(max_length >= 0, "max_length must be non-negative, but got ", max_length);
+
+  std::vector<int64_t> size;
+  size.reserve(values.dim() + 1);
+  size.push_back(offsets.size(0) - 1);
+  size.push_back(max_length);
+  size.insert(size.end(), values.sizes().begin() + 1, values.sizes().end());
+
+  values_ = values;
+  offsets_ = offsets.contiguous();
+  sizes_and_strides_.set_sizes(size);
+  refresh_numel();
+}
+
+} // namespace at
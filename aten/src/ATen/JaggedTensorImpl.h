@@ -0,0 +1,131 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/util/Exception.h>
+
+namespace at {
+
+// A batch of variable-length sequences.  The elements of all the sequences
+// are stored one sequence after the other along the first dimension of
+// values, and sequence i is stored at [offsets[i], offsets[i + 1]) in it.
+// Unlike a padded dense tensor, the batch only takes the memory and compute
+// of its elements, however long its longest sequence is.
+//
+// The sizes of a jagged tensor are the sizes of the dense tensor with the
+// sequences padded to max_length, so that the elements of sequence i are at
+// [i, 0:length_i] like in that dense tensor.  Like for sparse tensors, numel()
+// is the number of elements of that dense tensor.
+//
+// INVARIANTS:
+//  sizes: (batch_size, max_length, *inner_sizes), jagged tensors are at least 2-D
+//  offsets_.shape: (batch_size + 1), non-decreasing from 0 to total_length
+//  values_.shape: (total_length, *inner_sizes)
+//  max_length >= offsets_[i + 1] - offsets_[i] for every i
+//  offsets_ is contiguous, and int32 or int64
+struct TORCH_API JaggedTensorImpl : public TensorImpl {
+  Tensor values_;
+  Tensor offsets_;
+
+ public:
+  explicit JaggedTensorImpl(at::DispatchKeySet, const caffe2::TypeMeta);
+
+  int64_t batch_size() const { return offsets_.size(0) - 1; }
+  int64_t max_length() const { return sizes_and_strides_.size_at_unchecked(1); }
+  int64_t total_length() const { return values_.size(0); }
+  const Tensor& values() const { return values_; }
+  const Tensor& offsets() const { return offsets_; }
+
+  IntArrayRef strides() const override;
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const override;
+  int64_t stride(int64_t d) const override;
+  void set_size(int64_t dim, int64_t new_size) override;
+  void set_stride(int64_t dim, int64_t new_stride) override;
+  void set_storage_offset(int64_t storage_offset) override;
+
+#ifdef DEBUG
+  bool has_storage() const override;
+#endif
+  const Storage& storage() const override;
+
+  // Takes the values and offsets and directly puts them into the jagged
+  // tensor, no copy.  Only the shapes and dtypes are checked: the offsets are
+  // assumed to be valid, see _validate_jagged_tensor_args.
+  void set_member_tensors(const Tensor& values, const Tensor& offsets, int64_t max_length);
+
+  /**
+   * Return a TensorImpl that is a shallow-copy of this TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) const override {
+    auto impl = c10::make_intrusive<JaggedTensorImpl>(key_set(), dtype());
+    copy_tensor_metadata(
+      /*src_impl=*/this,
+      /*dest_impl=*/impl.get(),
+      /*version_counter=*/version_counter,
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+    impl->refresh_numel();
+    return impl;
+  }
+
+  /**
+   * Return a TensorImpl that is a shallow-copy of this TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      c10::VariableVersion&& version_counter,
+      bool allow_tensor_metadata_change) const override {
+    auto impl = c10::make_intrusive<JaggedTensorImpl>(key_set(), dtype());
+    copy_tensor_metadata(
+      /*src_impl=*/this,
+      /*dest_impl=*/impl.get(),
+      /*version_counter=*/std::move(version_counter),
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+    impl->refresh_numel();
+    return impl;
+  }
+
+  /**
+   * Shallow-copies data from another TensorImpl into this TensorImpl.
+   *
+   * For why this function doesn't check this TensorImpl's `allow_tensor_metadata_change_`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  void shallow_copy_from(const c10::intrusive_ptr<TensorImpl>& impl) override {
+    AT_ASSERT(has_compatible_shallow_copy_type(impl->key_set()));
+    auto jagged_impl = static_cast<const JaggedTensorImpl*>(impl.get());
+    copy_tensor_metadata(
+      /*src_impl=*/jagged_impl,
+      /*dest_impl=*/this,
+      /*version_counter=*/version_counter(),
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change());
+    refresh_numel();
+  }
+
+ private:
+  /**
+   * Copy the tensor metadata fields (e.g. sizes / strides / storage pointer / storage_offset)
+   * from one TensorImpl to another TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`, see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  static void copy_tensor_metadata(
+      const JaggedTensorImpl* src_jagged_impl,
+      JaggedTensorImpl* dest_jagged_impl,
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) {
+    TensorImpl::copy_tensor_metadata(src_jagged_impl, dest_jagged_impl, version_counter, allow_tensor_metadata_change);
+
+    // Jagged tensor specific fields
+    dest_jagged_impl->values_ = src_jagged_impl->values();
+    dest_jagged_impl->offsets_ = src_jagged_impl->offsets();
+  }
+};
+
+} // namespace at
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/JaggedTensorImpl.h>
+
+namespace at { namespace jagged {
+
+// Just for documentary purposes
+using JaggedTensor = Tensor;
+
+// This is an internal utility function for getting at the JaggedTensorImpl,
+// see get_sparse_impl in SparseTensorUtils.h.
+inline JaggedTensorImpl* get_jagged_impl(const JaggedTensor& self) {
+  TORCH_INTERNAL_ASSERT(self.is_jagged(), "_internal_get_JaggedTensorImpl: not a jagged tensor");
+  return static_cast<JaggedTensorImpl*>(self.unsafeGetTensorImpl());
+}
+
+}} // namespace at::jagged
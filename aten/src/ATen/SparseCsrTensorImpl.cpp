@@ -0,0 +1,83 @@
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/InitialTensorOptions.h>
+
+namespace at {
+
+// An empty CSR tensor is a 0 x 0 matrix: it has a single row offset and no
+// specified elements.
+SparseCsrTensorImpl::SparseCsrTensorImpl(at::DispatchKeySet key_set, const caffe2::TypeMeta data_type)
+    : TensorImpl(key_set, data_type, kCPU)
+    , crow_indices_(at::zeros({1}, at::initialTensorOptions().dtype(ScalarType::Long)))
+    , col_indices_(at::empty({0}, at::initialTensorOptions().dtype(ScalarType::Long)))
+    , values_(at::empty({0}, at::initialTensorOptions().dtype(data_type))) {
+  TORCH_INTERNAL_ASSERT(key_set.has(DispatchKey::SparseCsrCPU),
+      "Cannot construct a sparse CSR tensor with dispatch keys ", key_set);
+  sizes_and_strides_.set_sizes({0, 0});
+  refresh_numel();
+  is_non_overlapping_and_dense_ = false;
+}
+
+IntArrayRef SparseCsrTensorImpl::strides() const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+bool SparseCsrTensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
+  AT_ERROR("sparse CSR tensors do not have is_contiguous");
+}
+int64_t SparseCsrTensorImpl::stride(int64_t d) const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+void SparseCsrTensorImpl::set_size(int64_t dim, int64_t new_size) {
+  AT_ERROR("sparse CSR tensors do not have set_size");
+}
+void SparseCsrTensorImpl::set_stride(int64_t dim, int64_t new_stride) {
+  AT_ERROR("sparse CSR tensors do not have set_stride");
+}
+void SparseCsrTensorImpl::set_storage_offset(int64_t storage_offset) {
+  AT_ERROR("sparse CSR tensors do not have set_storage_offset");
+}
+#ifdef DEBUG
+bool SparseCsrTensorImpl::has_storage() const {
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(!storage_, "SparseCsrTensorImpl assumes that storage_ is never set");
+  return false;
+}
+#endif
+const Storage& SparseCsrTensorImpl::storage() const {
+  AT_ERROR("sparse CSR tensors do not have storage");
+}
+
+void SparseCsrTensorImpl::set_member_tensors(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  TORCH_CHECK(allow_tensor_metadata_change(), "set_member_tensors ", err_msg_tensor_metadata_change_not_allowed);
+
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be 2-D, but got size ", size);
+  TORCH_CHECK(crow_indices.layout() == kStrided && col_indices.layout() == kStrided && values.layout() == kStrided,
+      "expected crow_indices, col_indices and values to be strided tensors");
+  TORCH_CHECK(values.device() == device(), "device of values (", values.device(), ") must match device of sparse CSR tensor (", device(), ")");
+  TORCH_CHECK(crow_indices.device() == device() && col_indices.device() == device(),
+      "device of crow_indices (", crow_indices.device(), ") and col_indices (", col_indices.device(),
+      ") must match device of sparse CSR tensor (", device(), ")");
+  TORCH_CHECK(values.scalar_type() == typeMetaToScalarType(dtype()), "dtype of values (", values.scalar_type(), ") must match dtype of sparse CSR tensor (", typeMetaToScalarType(dtype()), ")");
+  TORCH_CHECK(crow_indices.scalar_type() == col_indices.scalar_type(),
+      "crow_indices and col_indices must have the same dtype, but got ", crow_indices.scalar_type(), " and ", col_indices.scalar_type());
+  TORCH_CHECK(crow_indices.scalar_type() == kInt || crow_indices.scalar_type() == kLong,
+      "crow_indices and col_indices must be int32 or int64 tensors, but got ", crow_indices.scalar_type());
+  TORCH_CHECK(crow_indices.dim() == 1 && col_indices.dim() == 1 && values.dim() == 1,
+      "crow_indices, col_indices and values must be 1-D, but got ", crow_indices.dim(), "-D, ",
+      col_indices.dim(), "-D and ", values.dim(), "-D tensors");
+  TORCH_CHECK(crow_indices.size(0) == size[0] + 1,
+      "crow_indices must have nrows + 1 = ", size[0] + 1, " elements, but got ", crow_indices.size(0));
+  TORCH_CHECK(col_indices.size(0) == values.size(0),
+      "col_indices and values must have the same number of elements, but got ", col_indices.size(0), " and ", values.size(0));
+
+  crow_indices_ = crow_indices.contiguous();
+  col_indices_ = col_indices.contiguous();
+  values_ = values;
+  sizes_and_strides_.set_sizes(size);
+  refresh_numel();
+}
+
+} // namespace at
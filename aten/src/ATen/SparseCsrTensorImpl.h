@@ -0,0 +1,134 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/util/Exception.h>
+
+namespace at {
+
+// A sparse matrix in compressed sparse row (CSR) format.  The column indices
+// and the values of the specified elements are stored row after row, and row i
+// is stored at [crow_indices[i], crow_indices[i + 1]) in them.  Unlike COO,
+// rows can be accessed and processed independently without sorting the
+// indices first, which is what sparse-dense products need.
+//
+// INVARIANTS:
+//  sizes: (nrows, ncols), CSR tensors are always 2-D
+//  crow_indices_.shape: (nrows + 1), non-decreasing from 0 to nnz
+//  col_indices_.shape: (nnz), in range [0, ncols)
+//  values_.shape: (nnz)
+//  crow_indices_ and col_indices_ are contiguous, and both int32 or both int64
+//
+// The column indices of a row are not required to be sorted nor unique:
+// like in an uncoalesced COO tensor, duplicate elements are summed.
+struct TORCH_API SparseCsrTensorImpl : public TensorImpl {
+  Tensor crow_indices_;
+  Tensor col_indices_;
+  Tensor values_;
+
+ public:
+  explicit SparseCsrTensorImpl(at::DispatchKeySet, const caffe2::TypeMeta);
+
+  int64_t nnz() const { return values_.size(0); }
+  const Tensor& crow_indices() const { return crow_indices_; }
+  const Tensor& col_indices() const { return col_indices_; }
+  const Tensor& values() const { return values_; }
+
+  IntArrayRef strides() const override;
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const override;
+  int64_t stride(int64_t d) const override;
+  void set_size(int64_t dim, int64_t new_size) override;
+  void set_stride(int64_t dim, int64_t new_stride) override;
+  void set_storage_offset(int64_t storage_offset) override;
+
+#ifdef DEBUG
+  bool has_storage() const override;
+#endif
+  const Storage& storage() const override;
+
+  // Takes the indices and values and directly puts them into the CSR tensor,
+  // no copy.  Only the shapes and dtypes are checked: the indices are assumed
+  // to be valid, see _validate_sparse_csr_tensor_args.
+  void set_member_tensors(
+      const Tensor& crow_indices,
+      const Tensor& col_indices,
+      const Tensor& values,
+      IntArrayRef size);
+
+  /**
+   * Return a TensorImpl that is a shallow-copy of this TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) const override {
+    auto impl = c10::make_intrusive<SparseCsrTensorImpl>(key_set(), dtype());
+    copy_tensor_metadata(
+      /*src_impl=*/this,
+      /*dest_impl=*/impl.get(),
+      /*version_counter=*/version_counter,
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+    impl->refresh_numel();
+    return impl;
+  }
+
+  /**
+   * Return a TensorImpl that is a shallow-copy of this TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      c10::VariableVersion&& version_counter,
+      bool allow_tensor_metadata_change) const override {
+    auto impl = c10::make_intrusive<SparseCsrTensorImpl>(key_set(), dtype());
+    copy_tensor_metadata(
+      /*src_impl=*/this,
+      /*dest_impl=*/impl.get(),
+      /*version_counter=*/std::move(version_counter),
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+    impl->refresh_numel();
+    return impl;
+  }
+
+  /**
+   * Shallow-copies data from another TensorImpl into this TensorImpl.
+   *
+   * For why this function doesn't check this TensorImpl's `allow_tensor_metadata_change_`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  void shallow_copy_from(const c10::intrusive_ptr<TensorImpl>& impl) override {
+    AT_ASSERT(has_compatible_shallow_copy_type(impl->key_set()));
+    auto sparse_csr_impl = static_cast<const SparseCsrTensorImpl*>(impl.get());
+    copy_tensor_metadata(
+      /*src_impl=*/sparse_csr_impl,
+      /*dest_impl=*/this,
+      /*version_counter=*/version_counter(),
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change());
+    refresh_numel();
+  }
+
+ private:
+  /**
+   * Copy the tensor metadata fields (e.g. sizes / strides / storage pointer / storage_offset)
+   * from one TensorImpl to another TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`, see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  static void copy_tensor_metadata(
+      const SparseCsrTensorImpl* src_sparse_csr_impl,
+      SparseCsrTensorImpl* dest_sparse_csr_impl,
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) {
+    TensorImpl::copy_tensor_metadata(src_sparse_csr_impl, dest_sparse_csr_impl, version_counter, allow_tensor_metadata_change);
+
+    // Sparse CSR specific fields
+    dest_sparse_csr_impl->crow_indices_ = src_sparse_csr_impl->crow_indices();
+    dest_sparse_csr_impl->col_indices_ = src_sparse_csr_impl->col_indices();
+    dest_sparse_csr_impl->values_ = src_sparse_csr_impl->values();
+  }
+};
+
+} // namespace at
@@ -7,6 +7,8 @@
 #include <ATen/MemoryOverlap.h>
 #include <ATen/native/Resize.h>
 #include <ATen/TensorOperators.h>
+#include <c10/core/DefaultDtype.h>
+#include <c10/util/hash.h>
 
 namespace at {
 
@@ -113,6 +115,34 @@ TensorIteratorConfig& TensorIteratorConfig::declare_static_shape(IntArrayRef sha
   return *this;
 }
 
+TensorIteratorConfig& TensorIteratorConfig::set_plan_cache(TensorIteratorPlanCache* plan_cache) {
+  plan_cache_ = plan_cache;
+  return *this;
+}
+
+const TensorIteratorPlan* TensorIteratorPlanCache::find(const TensorIteratorPlan::Key& key, size_t hash) const {
+  for (const auto& plan : plans_) {
+    if (plan.hash == hash && plan.key == key) {
+      return &plan;
+    }
+  }
+  return nullptr;
+}
+
+void TensorIteratorPlanCache::insert(TensorIteratorPlan plan) {
+  if (plans_.size() < capacity_) {
+    plans_.push_back(std::move(plan));
+    return;
+  }
+  plans_[next_] = std::move(plan);
+  next_ = (next_ + 1) % capacity_;
+}
+
+void TensorIteratorPlanCache::clear() {
+  plans_.clear();
+  next_ = 0;
+}
+
 // NOTE: [Computing output strides]
 // We use the following algorithm to compute output strides
 // If correctly sized output is provided, we respect its stides and don't change them
@@ -477,19 +507,19 @@ void TensorIteratorBase::allocate_or_resize_outputs() {
         // can just return contiguous output
         // it is faster because it avoids allocating 0 size tensor and
         // resizing and restriding it
-        set_output(i, tensor_shape, {}, op.options(), names_);
+        set_output_and_record(i, tensor_shape, {}, op.options());
       } else {
         auto tensor_stride = invert_perm(op.stride_bytes);
         for (int dim = 0; dim < ndim(); dim++) {
           tensor_stride[dim] /= element_size;
         }
-        set_output(i, tensor_shape, tensor_stride, op.options(), names_);
+        set_output_and_record(i, tensor_shape, tensor_stride, op.options());
       }
       op.current_dtype = op.target_dtype;
     } else if (op.tensor.defined()) {
       // Even if we don't resize, we still need to tell set_output about
       // the output, so that we properly set guard and propagate names
-      set_output(i, op.tensor.sizes(), {}, op.tensor.options(), names_);
+      set_output_and_record(i, op.tensor.sizes(), {}, op.tensor.options());
     }
   }
 }
@@ -808,8 +838,27 @@ void TensorIteratorBase::select_all_keeping_dim(int start_dim, IntArrayRef indic
   }
 }
 
+namespace {
+
+// The plan cache shared by the factory functions below.  The configuration is
+// part of the key of the plans, so they can't be mixed up.
+TensorIteratorPlanCache* factory_plan_cache() {
+// thread_local is a feature that is not enabled by Caffe2 mobile
+// build (e.g. iOS).
+#if !defined(PYTORCH_DISABLE_TENSOR_ITERATOR_PLAN_CACHE) && \
+    (!defined(C10_MOBILE) || defined(FEATURE_TORCH_MOBILE))
+  static thread_local TensorIteratorPlanCache plan_cache;
+  return &plan_cache;
+#else
+  return nullptr;
+#endif
+}
+
+} // namespace
+
 void TensorIteratorBase::build_binary_op(const Tensor& out, const Tensor& a, const Tensor& b) {
   build(TensorIteratorConfig()
+    .set_plan_cache(factory_plan_cache())
     .set_check_mem_overlap(true)
     .add_output(out)
     .add_input(a)
@@ -830,6 +879,7 @@ TensorIterator TensorIterator::binary_op(Tensor& out, const Tensor& a, const Ten
 TensorIterator TensorIterator::binary_float_op(Tensor& out, const Tensor& a,
     const Tensor& b) {
   return TensorIteratorConfig()
+     .set_plan_cache(factory_plan_cache())
      .set_check_mem_overlap(true)
      .add_output(out)
      .add_input(a)
@@ -853,6 +903,7 @@ TensorIterator TensorIterator::comparison_op(Tensor& out, const Tensor& a,
   // the output tensor has bool dtype, and provide a lambda of type (scalar_t, scalar_t -> bool).
   if (out.scalar_type() == kBool) {
     return TensorIteratorConfig()
+    .set_plan_cache(factory_plan_cache())
     .set_check_mem_overlap(true)
     .add_output(out)
     .add_input(a)
@@ -862,6 +913,7 @@ TensorIterator TensorIterator::comparison_op(Tensor& out, const Tensor& a,
     .build();
   } else {
     return TensorIteratorConfig()
+    .set_plan_cache(factory_plan_cache())
     .set_check_mem_overlap(true)
     .add_output(out)
     .add_input(a)
@@ -875,6 +927,7 @@ TensorIterator TensorIterator::comparison_op(Tensor& out, const Tensor& a,
 
 TensorIterator TensorIterator::unary_op(Tensor& out, const Tensor& a) {
   return TensorIteratorConfig()
+    .set_plan_cache(factory_plan_cache())
     .set_check_mem_overlap(true)
     .add_output(out)
     .add_input(a)
@@ -886,6 +939,7 @@ TensorIterator TensorIterator::unary_op(Tensor& out, const Tensor& a) {
 
 TensorIterator TensorIterator::unary_float_op(Tensor& out, const Tensor& a) {
   return TensorIteratorConfig()
+      .set_plan_cache(factory_plan_cache())
       .set_check_mem_overlap(true)
       .add_output(out)
       .add_input(a)
@@ -1145,7 +1199,7 @@ bool TensorIteratorBase::fast_set_up(const TensorIteratorConfig& config) {
           if (!op.tensor.defined()) {
             TORCH_INTERNAL_ASSERT(op.is_type_defined(), "no type for operand", i);
           }
-          set_output(i, shape_, {}, op.options().memory_format(MemoryFormat::Contiguous), names_);
+          set_output_and_record(i, shape_, {}, op.options().memory_format(MemoryFormat::Contiguous));
         }
         break;
       }
@@ -1156,7 +1210,7 @@ bool TensorIteratorBase::fast_set_up(const TensorIteratorConfig& config) {
           if (!op.tensor.defined()) {
             TORCH_INTERNAL_ASSERT(op.is_type_defined(), "no type for operand", i);
           }
-          set_output(i, shape_, {}, op.options().memory_format(MemoryFormat::ChannelsLast), names_);
+          set_output_and_record(i, shape_, {}, op.options().memory_format(MemoryFormat::ChannelsLast));
         }
         break;
       }
@@ -1173,7 +1227,7 @@ bool TensorIteratorBase::fast_set_up(const TensorIteratorConfig& config) {
           if (!op.tensor.defined()) {
             TORCH_INTERNAL_ASSERT(op.is_type_defined(), "no type for operand", i);
           }
-          set_output(i, shape_, operands_[i_defined].tensor.strides(), op.options(), names_);
+          set_output_and_record(i, shape_, operands_[i_defined].tensor.strides(), op.options());
         }
         break;
       }
@@ -1263,24 +1317,46 @@ void TensorIteratorBase::build(TensorIteratorConfig& config) {
   // Check that the outputs have no internal overlap
   // and do not share memory with inputs.
   compute_mem_overlaps(config);
-  // Check that input dimensions are aligned correctly & compute outnames.
-  compute_names(config);
-  // compute the broadcasted shape
-  compute_shape(config);
-  // mark outputs for resizing if necessary
-  mark_resize_outputs(config);
-  // compute the result dtype and device
-  compute_types(config);
-  // try fast setup output tensor, if failed, fallback to normal setup
-  if (!fast_set_up(config)) {
-    // compute each tensor's stride after broadcasting
-    compute_strides(config);
-    // re-order dimensions to improve coalescing
-    reorder_dimensions();
-    // allocate the output tensor if it's not provided
-    allocate_or_resize_outputs();
-    // coalesce adjacent dimensions when possible
-    if (!is_meta_) coalesce_dimensions();
+
+  // Skip the analysis below if its plan is cached,
+  // see Note [TensorIterator plans]
+  TensorIteratorPlan plan;
+  const TensorIteratorPlan* cached_plan = nullptr;
+  bool should_record_plan = false;
+  if (config.plan_cache_ && compute_plan_key(config, plan)) {
+    cached_plan = config.plan_cache_->find(plan.key, plan.hash);
+    should_record_plan = cached_plan == nullptr;
+  }
+
+  if (cached_plan) {
+    apply_plan(*cached_plan);
+  } else {
+    if (should_record_plan) {
+      recording_plan_ = &plan;
+    }
+    // Check that input dimensions are aligned correctly & compute outnames.
+    compute_names(config);
+    // compute the broadcasted shape
+    compute_shape(config);
+    // mark outputs for resizing if necessary
+    mark_resize_outputs(config);
+    // compute the result dtype and device
+    compute_types(config);
+    // try fast setup output tensor, if failed, fallback to normal setup
+    if (!fast_set_up(config)) {
+      // compute each tensor's stride after broadcasting
+      compute_strides(config);
+      // re-order dimensions to improve coalescing
+      reorder_dimensions();
+      // allocate the output tensor if it's not provided
+      allocate_or_resize_outputs();
+      // coalesce adjacent dimensions when possible
+      if (!is_meta_) coalesce_dimensions();
+    }
+    recording_plan_ = nullptr;
+    if (should_record_plan && record_plan(plan)) {
+      config.plan_cache_->insert(std::move(plan));
+    }
   }
 
   if (is_meta_) return;
@@ -1298,6 +1374,111 @@ void TensorIteratorBase::build(TensorIteratorConfig& config) {
   view_offsets_ = DimVector(ndim_offsets, 0);
 }
 
+bool TensorIteratorBase::compute_plan_key(const TensorIteratorConfig& config, TensorIteratorPlan& plan) const {
+  if (is_meta_ || config.static_shape_.has_value() || config.static_dtype_and_device_.has_value()) {
+    return false;
+  }
+  auto& key = plan.key;
+  int64_t flags =
+      config.check_mem_overlap_ |
+      config.allow_cpu_scalars_ << 1 |
+      config.is_reduction_ << 2 |
+      config.resize_outputs_ << 3 |
+      config.check_all_same_dtype_ << 4 |
+      config.check_all_same_device_ << 5 |
+      config.enforce_safe_casting_to_output_ << 6 |
+      config.promote_inputs_to_common_dtype_ << 7 |
+      config.promote_integer_inputs_to_float_ << 8 |
+      config.cast_common_dtype_to_outputs_ << 9;
+  key.push_back(flags);
+  if (config.promote_integer_inputs_to_float_) {
+    key.push_back(static_cast<int64_t>(c10::typeMetaToScalarType(c10::get_default_dtype())));
+  }
+  key.push_back(num_outputs_);
+  key.push_back(ntensors());
+  for (const auto& op : operands_) {
+    const auto& t = op.tensor;
+    if (!t.defined()) {
+      key.push_back(-1);
+      continue;
+    }
+    if (t.has_names()) {
+      return false;
+    }
+    // Wrapped numbers take part in type promotion differently
+    key.push_back(
+        static_cast<int64_t>(op.current_dtype) |
+        static_cast<int64_t>(op.device.type()) << 8 |
+        static_cast<int64_t>(static_cast<uint8_t>(op.device.index())) << 16 |
+        static_cast<int64_t>(t.unsafeGetTensorImpl()->is_wrapped_number()) << 24 |
+        static_cast<int64_t>(op.is_read_write) << 25);
+    auto sizes = t.sizes();
+    auto strides = t.strides();
+    key.push_back(sizes.size());
+    key.append(sizes.begin(), sizes.end());
+    key.append(strides.begin(), strides.end());
+  }
+  size_t hash = 0;
+  for (int64_t value : key) {
+    hash = c10::hash_combine(hash, std::hash<int64_t>()(value));
+  }
+  plan.hash = hash;
+  return true;
+}
+
+bool TensorIteratorBase::record_plan(TensorIteratorPlan& plan) const {
+  // Temporaries created to cast the operands can't be reused
+  for (const auto& op : operands_) {
+    if (op.original_tensor.defined()) {
+      return false;
+    }
+  }
+  plan.shape = shape_;
+  plan.perm = perm_;
+  plan.has_coalesced_dimensions = has_coalesced_dimensions_;
+  plan.all_ops_same_shape = all_ops_same_shape_;
+  plan.common_dtype = common_dtype_;
+  for (const auto& op : operands_) {
+    TensorIteratorPlan::Operand planned;
+    planned.stride_bytes = op.stride_bytes;
+    planned.device = op.device;
+    planned.target_dtype = op.target_dtype;
+    planned.will_resize = op.will_resize;
+    plan.operands.push_back(std::move(planned));
+  }
+  return true;
+}
+
+void TensorIteratorBase::apply_plan(const TensorIteratorPlan& plan) {
+  TORCH_INTERNAL_ASSERT(static_cast<int>(plan.operands.size()) == ntensors());
+  all_ops_same_shape_ = plan.all_ops_same_shape;
+  common_dtype_ = plan.common_dtype;
+  for (int i = 0; i < ntensors(); i++) {
+    auto& op = operands_[i];
+    op.device = plan.operands[i].device;
+    op.target_dtype = plan.operands[i].target_dtype;
+    op.will_resize = plan.operands[i].will_resize;
+  }
+  for (const auto& output : plan.outputs) {
+    set_output(output.output_idx, output.sizes, output.strides, output.options, names_);
+  }
+  for (int i = 0; i < ntensors(); i++) {
+    auto& op = operands_[i];
+    op.current_dtype = op.target_dtype;
+    op.stride_bytes = plan.operands[i].stride_bytes;
+  }
+  shape_ = plan.shape;
+  perm_ = plan.perm;
+  has_coalesced_dimensions_ = plan.has_coalesced_dimensions;
+}
+
+void TensorIteratorBase::set_output_and_record(int64_t output_idx, IntArrayRef sizes, IntArrayRef strides, TensorOptions options) {
+  if (recording_plan_) {
+    recording_plan_->outputs.push_back({output_idx, DimVector(sizes), DimVector(strides), options});
+  }
+  set_output(output_idx, sizes, strides, options, names_);
+}
+
 // This is the structured kernels implementation of set_output.  It is
 // NEVER actually called directly; instead, a subclass of TensorIteratorBase
 // will override set_output to actually do the operation, and then call
@@ -141,6 +141,83 @@ enum class FastSetupType : uint8_t {
 class TensorIteratorConfig;
 struct TensorIterator;
 
+// Note [TensorIterator plans]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Besides the memory overlap checks, everything build() does only depends on
+// the sizes, strides, dtypes and devices of the operands (and on the
+// configuration): broadcasting, type promotion, the choice of the output
+// layout, the reordering and coalescing of the dimensions.  For small tensors
+// this analysis costs more than the kernel itself.
+//
+// A TensorIteratorPlan records its result: the computation shape, the stride
+// of each operand, their dtypes and devices, and the set_output calls that
+// allocated or resized the outputs.  When TensorIteratorConfig is given a
+// TensorIteratorPlanCache, build() looks up the plan of its operands in it,
+// and if one is found replays the set_output calls instead of running the
+// analysis.  Otherwise it runs the analysis and inserts its plan.
+//
+// The key of a plan is made of everything the analysis reads, so a plan is
+// only ever applied to operands it is valid for.  Iterators with named or meta
+// tensors, static shapes, dtypes or devices, and the ones that create
+// temporaries to cast their operands (see compute_types) are not cached.
+//
+// The factory functions of TensorIterator (binary_op, unary_op, ...) share a
+// thread local cache.  Building with -DPYTORCH_DISABLE_TENSOR_ITERATOR_PLAN_CACHE
+// disables it.
+struct TORCH_API TensorIteratorPlan {
+  using Key = SmallVector<int64_t, 32>;
+
+  struct Operand {
+    OperandInfo::StrideVector stride_bytes;
+    Device device = kCPU;
+    ScalarType target_dtype = ScalarType::Undefined;
+    bool will_resize = false;
+  };
+
+  // Arguments of a set_output call done by build()
+  struct Output {
+    int64_t output_idx;
+    DimVector sizes;
+    DimVector strides;
+    TensorOptions options;
+  };
+
+  Key key;
+  size_t hash = 0;
+
+  DimVector shape;
+  DimVector perm;
+  bool has_coalesced_dimensions = false;
+  bool all_ops_same_shape = false;
+  ScalarType common_dtype = ScalarType::Undefined;
+  SmallVector<Operand, 4> operands;
+  SmallVector<Output, 1> outputs;
+};
+
+// A small cache of TensorIteratorPlans, which evicts its oldest plan when it is
+// full.  It is not thread safe.
+class TORCH_API TensorIteratorPlanCache final {
+ public:
+  explicit TensorIteratorPlanCache(size_t capacity = 16) : capacity_(capacity) {
+    TORCH_INTERNAL_ASSERT(capacity_ > 0);
+  }
+
+  C10_DISABLE_COPY_AND_ASSIGN(TensorIteratorPlanCache);
+
+  const TensorIteratorPlan* find(const TensorIteratorPlan::Key& key, size_t hash) const;
+  void insert(TensorIteratorPlan plan);
+
+  size_t size() const { return plans_.size(); }
+  size_t capacity() const { return capacity_; }
+  void clear();
+
+ private:
+  std::vector<TensorIteratorPlan> plans_;
+  size_t capacity_;
+  // Next plan to evict once the cache is full
+  size_t next_ = 0;
+};
+
 struct TORCH_API TensorIteratorBase : public impl::MetaBase {
   using DimMask = std::bitset<64>;
   using PtrVector = SmallVector<char*, 4>;
@@ -319,6 +396,10 @@ protected:
   void compute_names(const TensorIteratorConfig&);
   void propagate_names_to_outputs();
   void coalesce_dimensions();
+  bool compute_plan_key(const TensorIteratorConfig&, TensorIteratorPlan&) const;
+  bool record_plan(TensorIteratorPlan&) const;
+  void apply_plan(const TensorIteratorPlan&);
+  void set_output_and_record(int64_t output_idx, IntArrayRef sizes, IntArrayRef strides, TensorOptions options);
 
 protected:
 
@@ -406,6 +487,10 @@ protected:
 
   /// Set by populate_operands(), says if we're handling meta tensors
   bool is_meta_ = false;
+
+  /// The plan build() records the set_output calls in, if any.  See
+  /// Note [TensorIterator plans].
+  TensorIteratorPlan* recording_plan_ = nullptr;
 };
 
 struct TORCH_API TensorIterator final : public TensorIteratorBase {
@@ -500,6 +585,10 @@ public:
   TensorIteratorConfig& declare_static_shape(IntArrayRef shape);
   TensorIteratorConfig& declare_static_shape(IntArrayRef shape, IntArrayRef squash_dims);
 
+  // Sets the plan cache build() looks up and records its analysis in, which
+  // must outlive the call to build().  See Note [TensorIterator plans].
+  TensorIteratorConfig& set_plan_cache(TensorIteratorPlanCache* plan_cache);
+
   // It would be better if this was && qualified, but this would be at the cost
   // of a lot of boilerplate above
   TensorIterator build() {
@@ -525,6 +614,7 @@ private:
   bool promote_inputs_to_common_dtype_ = false;
   bool promote_integer_inputs_to_float_ = false;
   bool cast_common_dtype_to_outputs_ = false;
+  TensorIteratorPlanCache* plan_cache_ = nullptr;
 };
 
 
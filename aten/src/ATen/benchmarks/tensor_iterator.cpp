@@ -0,0 +1,84 @@
+#include <ATen/ATen.h>
+#include <ATen/native/TensorIterator.h>
+
+#include <benchmark/benchmark.h>
+
+// Per op overhead of TensorIterator on small tensors, with and without
+// plans (see Note [TensorIterator plans]).
+
+static at::TensorIterator build_binary_op(
+    at::TensorIteratorPlanCache* plan_cache,
+    const at::Tensor& a,
+    const at::Tensor& b) {
+  return at::TensorIteratorConfig()
+      .set_plan_cache(plan_cache)
+      .add_output(at::Tensor())
+      .add_input(a)
+      .add_input(b)
+      .build();
+}
+
+static void tensor_iterator_build(benchmark::State& state) {
+  const int64_t numel = state.range(0);
+  const bool use_plan_cache = state.range(1);
+
+  at::TensorIteratorPlanCache plan_cache;
+  at::Tensor a = at::rand({numel});
+  at::Tensor b = at::rand({numel});
+  for (auto _ : state) {
+    auto iter = build_binary_op(use_plan_cache ? &plan_cache : nullptr, a, b);
+    benchmark::DoNotOptimize(iter.data_ptr(0));
+  }
+}
+
+static void tensor_iterator_build_broadcast(benchmark::State& state) {
+  const int64_t numel = state.range(0);
+  const bool use_plan_cache = state.range(1);
+
+  at::TensorIteratorPlanCache plan_cache;
+  at::Tensor a = at::rand({numel, 1});
+  at::Tensor b = at::rand({1, numel}).t();
+  for (auto _ : state) {
+    auto iter = build_binary_op(use_plan_cache ? &plan_cache : nullptr, a, b);
+    benchmark::DoNotOptimize(iter.data_ptr(0));
+  }
+}
+
+// at::add builds its iterator with TensorIterator::binary_op, which uses the
+// plan cache of the factory functions.
+static void tensor_add_small(benchmark::State& state) {
+  const int64_t numel = state.range(0);
+
+  at::Tensor a = at::rand({numel});
+  at::Tensor b = at::rand({numel});
+  at::Tensor c;
+  for (auto _ : state) {
+    c = a + b;
+  }
+}
+
+static void tensor_add_small_out(benchmark::State& state) {
+  const int64_t numel = state.range(0);
+
+  at::Tensor a = at::rand({numel});
+  at::Tensor b = at::rand({numel});
+  at::Tensor c = at::empty({numel});
+  for (auto _ : state) {
+    at::add_out(c, a, b);
+  }
+}
+
+static void GenerateSizes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"N", "cached"});
+
+  for (int64_t n : {1, 10, 100, 1000}) {
+    b->Args({n, 0});
+    b->Args({n, 1});
+  }
+}
+
+BENCHMARK(tensor_iterator_build)->Apply(GenerateSizes);
+BENCHMARK(tensor_iterator_build_broadcast)->Apply(GenerateSizes);
+BENCHMARK(tensor_add_small)->ArgName("N")->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK(tensor_add_small_out)->ArgName("N")->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_MAIN();
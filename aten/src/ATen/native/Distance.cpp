@@ -3,6 +3,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/native/Distance.h>
 
 namespace at { namespace native {
@@ -11,6 +12,7 @@ DEFINE_DISPATCH(pdist_forward_stub);
 DEFINE_DISPATCH(pdist_backward_stub);
 DEFINE_DISPATCH(cdist_stub);
 DEFINE_DISPATCH(cdist_backward_stub);
+DEFINE_DISPATCH(cdist_topk_stub);
 
 Tensor pairwise_distance(const Tensor& x1, const Tensor& x2, double p, double eps, bool keepdim) {
   return at::norm(x1 - x2 + eps, p, 1, keepdim);
@@ -185,6 +187,62 @@ Tensor _pdist_backward(const Tensor& grad, const Tensor& self, const double p, c
   return result;
 }
 
+static DistanceMetric get_distance_metric(const std::string& metric) {
+  if (metric == "euclidean") {
+    return DistanceMetric::EUCLIDEAN;
+  } else if (metric == "inner_product") {
+    return DistanceMetric::INNER_PRODUCT;
+  } else if (metric == "cosine") {
+    return DistanceMetric::COSINE;
+  } else {
+    TORCH_CHECK(false, "cdist_topk: unsupported metric ", metric, ", expected euclidean, inner_product or cosine");
+  }
+}
+
+// Unlike cdist followed by topk, this never materializes the N x M distance
+// matrix: the kernel computes it by blocks and keeps only the k nearest rows
+// of x2 for each row of x1.
+std::tuple<Tensor, Tensor> cdist_topk(const Tensor& x1, const Tensor& x2, int64_t k, std::string metric, double eps) {
+  Tensor values, indices;
+  std::tie(values, indices) = at::_cdist_topk(x1, x2, k, metric, eps);
+  if (GradMode::is_enabled() && (x1.requires_grad() || x2.requires_grad())) {
+    // The kernel is not differentiable, so recompute the values from the
+    // selected rows of x2, which only costs O(N * k * D).
+    Tensor neighbors = x2.index_select(0, indices.view(-1)).view({x1.size(0), k, x2.size(1)});
+    Tensor queries = x1.unsqueeze(1);
+    switch (get_distance_metric(metric)) {
+      case DistanceMetric::EUCLIDEAN:
+        values = (queries - neighbors).norm(2, -1);
+        break;
+      case DistanceMetric::INNER_PRODUCT:
+        values = (queries * neighbors).sum(-1);
+        break;
+      case DistanceMetric::COSINE:
+        values = at::cosine_similarity(queries, neighbors, -1, eps);
+        break;
+    }
+  }
+  return std::make_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> _cdist_topk_cpu(const Tensor& x1, const Tensor& x2, int64_t k, std::string metric, double eps) {
+  TORCH_CHECK(x1.dim() == 2, "cdist_topk only supports 2D tensors, X1 got: ", x1.dim(), "D");
+  TORCH_CHECK(x2.dim() == 2, "cdist_topk only supports 2D tensors, X2 got: ", x2.dim(), "D");
+  TORCH_CHECK(x1.size(1) == x2.size(1), "X1 and X2 must have the same number of columns. X1: ", x1.size(1), " X2: ", x2.size(1));
+  TORCH_CHECK(x1.scalar_type() == kFloat || x1.scalar_type() == kDouble,
+      "cdist_topk only supports float and double dtypes, X1 got: ", x1.scalar_type());
+  TORCH_CHECK(x1.scalar_type() == x2.scalar_type(),
+      "X1 and X2 must have the same dtype. X1: ", x1.scalar_type(), " X2: ", x2.scalar_type());
+  TORCH_CHECK(k >= 0 && k <= x2.size(0), "cdist_topk: k (", k, ") must be between 0 and the number of rows of X2 (", x2.size(0), ")");
+  const DistanceMetric metric_ = get_distance_metric(metric);
+  Tensor values = at::empty({x1.size(0), k}, x1.options());
+  Tensor indices = at::empty({x1.size(0), k}, x1.options().dtype(kLong));
+  if (values.numel() > 0) {
+    cdist_topk_stub(kCPU, values, indices, x1.contiguous(), x2.contiguous(), k, metric_, eps);
+  }
+  return std::make_tuple(values, indices);
+}
+
 Tensor cosine_similarity(const Tensor& x1, const Tensor& x2, int64_t dim, double eps) {
   // Follow scipy impl to improve numerical precision
   // Use x / sqrt(x * x) instead of x / (sqrt(x) * sqrt(x))
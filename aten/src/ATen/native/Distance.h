@@ -15,4 +15,15 @@ DECLARE_DISPATCH(pdist_backward_fn, pdist_backward_stub);
 DECLARE_DISPATCH(cdist_fn, cdist_stub);
 DECLARE_DISPATCH(cdist_backward_fn, cdist_backward_stub);
 
+enum class DistanceMetric { EUCLIDEAN, INNER_PRODUCT, COSINE };
+
+// values and indices are contiguous (N, k) tensors, x1 and x2 contiguous (N, D)
+// and (M, D) tensors, with k <= M.  Row i of indices holds the k rows of x2
+// nearest to x1[i], the nearest first, and row i of values their euclidean
+// distances, or their inner products or cosine similarities with x1[i] in
+// decreasing order.  eps bounds the product of the norms in the cosine
+// similarity, as in cosine_similarity.
+using cdist_topk_fn = void(*)(const Tensor& values, const Tensor& indices, const Tensor& x1, const Tensor& x2, int64_t k, DistanceMetric metric, double eps);
+DECLARE_DISPATCH(cdist_topk_fn, cdist_topk_stub);
+
 }} // namespace at::native
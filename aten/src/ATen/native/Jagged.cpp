@@ -0,0 +1,573 @@
+// Basic functions on jagged tensors
+
+#include <ATen/native/Jagged.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/CPUBlas.h>
+#include <ATen/native/ReduceOpsUtils.h>
+#include <c10/util/accumulate.h>
+
+namespace at { namespace native {
+
+using namespace at::jagged;
+
+// NOTE [ Jagged tensors ]
+//
+// A jagged tensor is a batch of variable-length sequences, stored without
+// padding as the values of all the sequences and the offsets of each sequence
+// in them, see JaggedTensorImpl.h for its invariants.  This is the values +
+// offsets pair that ops like embedding_bag already take, as a tensor of its
+// own, so that variable-length inputs can go through several ops without
+// being padded to the longest sequence in between.  Only CPU tensors are
+// supported.  The ops it supports are:
+//
+//   - construction with jagged_tensor, and conversions from and to padded
+//     dense tensors with to_jagged, to_padded_dense and to_dense;
+//   - the accessors values and offsets;
+//   - elementwise ops between jagged tensors with the same offsets, or between
+//     a jagged tensor and a strided tensor that broadcasts with its inner
+//     dimensions, such as a scalar or a bias;
+//   - sum, mean and amax along the jagged dimension 1;
+//   - bmm of a jagged tensor with a batch of strided matrices.
+//
+// Autograd flows through all of them to the values of jagged tensors and to
+// the strided operands.  offsets() is non-differentiable.  The reductions
+// share their kernel with segment_reduce, and their backward with
+// _segment_reduce_backward.  Since sum and mean share their autograd kernel
+// with strided tensors, they save the offsets of jagged tensors instead of the
+// tensor itself (see jagged_offsets in derivatives.yaml).
+
+/******************************************************************************
+ * access methods
+ ******************************************************************************/
+
+Tensor values_jagged(const JaggedTensor& self) {
+  return get_jagged_impl(self)->values().alias();
+}
+
+Tensor offsets_jagged(const JaggedTensor& self) {
+  return get_jagged_impl(self)->offsets().alias();
+}
+
+/******************************************************************************
+ * creation methods
+ ******************************************************************************/
+
+namespace {
+
+// Checks that offsets are non-decreasing from 0 to total_length, and returns
+// the length of the longest sequence.
+int64_t check_offsets(const Tensor& offsets_, int64_t total_length) {
+  TORCH_CHECK(offsets_.layout() == kStrided && offsets_.device().type() == DeviceType::CPU,
+      "offsets must be a strided CPU tensor");
+  TORCH_CHECK(offsets_.scalar_type() == kInt || offsets_.scalar_type() == kLong,
+      "offsets must be an int32 or int64 tensor, but got ", offsets_.scalar_type());
+  TORCH_CHECK(offsets_.dim() == 1 && offsets_.size(0) >= 1,
+      "offsets must be a 1-D tensor with at least one element, but got size ", offsets_.sizes());
+  Tensor offsets = offsets_.contiguous();
+  const int64_t batch_size = offsets.size(0) - 1;
+  int64_t longest = 0;
+  AT_DISPATCH_INDEX_TYPES(offsets.scalar_type(), "check_offsets", [&] {
+    const index_t* offsets_data = offsets.data_ptr<index_t>();
+    TORCH_CHECK(offsets_data[0] == 0, "offsets must start with 0, but got ", offsets_data[0]);
+    TORCH_CHECK(offsets_data[batch_size] == total_length,
+        "offsets must end with the total length of the sequences ", total_length, ", but got ", offsets_data[batch_size]);
+    for (int64_t i = 0; i < batch_size; i++) {
+      TORCH_CHECK(offsets_data[i] <= offsets_data[i + 1],
+          "offsets must be non-decreasing, but offsets[", i, "] = ", offsets_data[i],
+          " > offsets[", i + 1, "] = ", offsets_data[i + 1]);
+      longest = std::max<int64_t>(longest, offsets_data[i + 1] - offsets_data[i]);
+    }
+  });
+  return longest;
+}
+
+int64_t total_length_of(const Tensor& offsets) {
+  return offsets.select(0, offsets.size(0) - 1).item<int64_t>();
+}
+
+int64_t inner_size_of(const Tensor& values) {
+  return c10::multiply_integers(values.sizes().begin() + 1, values.sizes().end());
+}
+
+} // namespace
+
+void _validate_jagged_tensor_args(const Tensor& values, const Tensor& offsets) {
+  TORCH_CHECK(values.layout() == kStrided, "expected values to be a strided tensor, but got layout ", values.layout());
+  TORCH_CHECK(values.dim() >= 1, "values must be at least 1-D, but got a ", values.dim(), "-D tensor");
+  check_offsets(offsets, values.size(0));
+}
+
+// NOTE: _jagged_tensor_unsafe() differs from jagged_tensor() in that we don't
+// check the offsets nor compute the longest sequence, see
+// _sparse_coo_tensor_unsafe.
+Tensor _jagged_tensor_unsafe(const Tensor& values, const Tensor& offsets, int64_t max_length) {
+  TORCH_CHECK(values.device().type() == DeviceType::CPU, "jagged tensors are only supported on CPU, but values are on ", values.device());
+  JaggedTensor self = at::detail::make_tensor<JaggedTensorImpl>(
+      DispatchKeySet(DispatchKey::JaggedCPU), values.dtype());
+  // NOTE: like in _sparse_csr_tensor_unsafe, we shallow-copy the member
+  // tensors so that they don't contain AutogradMeta.
+  auto shallow_copy = [](const Tensor& t) {
+    return Tensor(t.unsafeGetTensorImpl()->shallow_copy_and_detach(
+        /*version_counter=*/t.unsafeGetTensorImpl()->version_counter(),
+        /*allow_tensor_metadata_change=*/true));
+  };
+  get_jagged_impl(self)->set_member_tensors(shallow_copy(values), shallow_copy(offsets), max_length);
+  return self;
+}
+
+Tensor jagged_tensor(const Tensor& values, const Tensor& offsets, c10::optional<int64_t> max_length) {
+  at::native::_validate_jagged_tensor_args(values, offsets);
+  const int64_t longest = check_offsets(offsets, values.size(0));
+  TORCH_CHECK(!max_length.has_value() || *max_length >= longest,
+      "max_length (", max_length.value_or(0), ") must be at least the length of the longest sequence (", longest, ")");
+  return at::_jagged_tensor_unsafe(values, offsets, max_length.value_or(longest));
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+Tensor jagged_to_padded_dense(const JaggedTensor& self, Scalar padding_value, c10::optional<int64_t> max_length_opt) {
+  auto impl = get_jagged_impl(self);
+  const int64_t max_length = max_length_opt.value_or(impl->max_length());
+  const Tensor& offsets = impl->offsets();
+  if (max_length < impl->max_length()) {
+    const int64_t longest = check_offsets(offsets, impl->total_length());
+    TORCH_CHECK(max_length >= longest,
+        "to_padded_dense: max_length (", max_length, ") must be at least the length of the longest sequence (", longest, ")");
+  }
+  Tensor values = impl->values().contiguous();
+  const int64_t batch_size = impl->batch_size();
+  const int64_t inner_size = inner_size_of(values);
+  const int64_t sequence_size = max_length * inner_size;
+
+  std::vector<int64_t> size = self.sizes().vec();
+  size[1] = max_length;
+  Tensor result = at::empty(size, values.options());
+  AT_DISPATCH_INDEX_TYPES(offsets.scalar_type(), "to_padded_dense", [&] {
+    const index_t* offsets_data = offsets.data_ptr<index_t>();
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kHalf, kBFloat16, kBool, values.scalar_type(), "to_padded_dense", [&] {
+      const scalar_t padding = padding_value.to<scalar_t>();
+      const scalar_t* values_data = values.data_ptr<scalar_t>();
+      scalar_t* result_data = result.data_ptr<scalar_t>();
+      // Every sequence writes sequence_size elements, so they all have the
+      // same cost.
+      at::parallel_for(0, batch_size, at::internal::GRAIN_SIZE / std::max<int64_t>(sequence_size, 1), [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const scalar_t* src = values_data + static_cast<int64_t>(offsets_data[i]) * inner_size;
+          const int64_t length_size = static_cast<int64_t>(offsets_data[i + 1] - offsets_data[i]) * inner_size;
+          scalar_t* dst = result_data + i * sequence_size;
+          std::copy(src, src + length_size, dst);
+          std::fill(dst + length_size, dst + sequence_size, padding);
+        }
+      });
+    });
+  });
+  return result;
+}
+
+Tensor jagged_to_dense(const JaggedTensor& self, c10::optional<ScalarType> dtype) {
+  TORCH_CHECK(!dtype.has_value(), "dtype argument is not supported by jagged_to_dense");
+  return at::native::jagged_to_padded_dense(self, 0, c10::nullopt);
+}
+
+JaggedTensor dense_to_jagged(const Tensor& self_, const Tensor& offsets, c10::optional<int64_t> max_length) {
+  TORCH_CHECK(self_.dim() >= 2, "to_jagged: expected a tensor of at least 2 dimensions, but got a ", self_.dim(), "-D tensor");
+  TORCH_CHECK(offsets.dim() == 1 && offsets.size(0) == self_.size(0) + 1,
+      "to_jagged: expected offsets of size ", self_.size(0) + 1, " for a batch of ", self_.size(0),
+      " sequences, but got size ", offsets.sizes());
+  const int64_t total_length = offsets.numel() > 0 ? total_length_of(offsets) : 0;
+  const int64_t longest = check_offsets(offsets, total_length);
+  const int64_t padded_length = self_.size(1);
+  TORCH_CHECK(longest <= padded_length,
+      "to_jagged: the longest sequence (", longest, ") is longer than the padded sequences (", padded_length, ")");
+  TORCH_CHECK(!max_length.has_value() || *max_length >= longest,
+      "to_jagged: max_length (", max_length.value_or(0), ") must be at least the length of the longest sequence (", longest, ")");
+
+  Tensor self = self_.contiguous();
+  Tensor offsets_contig = offsets.contiguous();
+  const int64_t batch_size = self.size(0);
+  std::vector<int64_t> values_size = {total_length};
+  values_size.insert(values_size.end(), self.sizes().begin() + 2, self.sizes().end());
+  Tensor values = at::empty(values_size, self.options());
+  const int64_t inner_size = inner_size_of(values);
+  const int64_t sequence_size = padded_length * inner_size;
+  AT_DISPATCH_INDEX_TYPES(offsets_contig.scalar_type(), "to_jagged", [&] {
+    const index_t* offsets_data = offsets_contig.data_ptr<index_t>();
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kHalf, kBFloat16, kBool, self.scalar_type(), "to_jagged", [&] {
+      const scalar_t* self_data = self.data_ptr<scalar_t>();
+      scalar_t* values_data = values.data_ptr<scalar_t>();
+      // Only the elements of the sequences are copied, so the work of a
+      // sequence is its length.
+      parallel_for_sequences(offsets_data, batch_size, inner_size, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const scalar_t* src = self_data + i * sequence_size;
+          const int64_t length_size = static_cast<int64_t>(offsets_data[i + 1] - offsets_data[i]) * inner_size;
+          std::copy(src, src + length_size, values_data + static_cast<int64_t>(offsets_data[i]) * inner_size);
+        }
+      });
+    });
+  });
+  return at::native::_jagged_tensor_unsafe(values, offsets_contig, max_length.value_or(padded_length));
+}
+
+/******************************************************************************
+ * elementwise ops
+ ******************************************************************************/
+
+namespace {
+
+bool same_offsets(const Tensor& a, const Tensor& b) {
+  if (a.is_same(b)) {
+    return true;
+  }
+  return a.sizes() == b.sizes() && at::equal(a.to(kLong), b.to(kLong));
+}
+
+// An elementwise op between jagged tensors with the same offsets is the same
+// op between their values.  A strided operand is used as is, so it must
+// broadcast with the inner dimensions of the jagged operand.
+Tensor operand_values(const Tensor& operand, const JaggedTensor& jagged, const char* name) {
+  if (operand.is_jagged()) {
+    TORCH_CHECK(same_offsets(get_jagged_impl(operand)->offsets(), get_jagged_impl(jagged)->offsets()),
+        name, ": expected jagged operands with the same offsets");
+    return get_jagged_impl(operand)->values();
+  }
+  TORCH_CHECK(operand.layout() == kStrided,
+      name, ": expected the other operand of a jagged tensor to be jagged or strided, but got layout ", operand.layout());
+  TORCH_CHECK(operand.dim() <= jagged.dim() - 2,
+      name, ": a strided operand must broadcast with the inner dimensions of the jagged operand of size ",
+      jagged.sizes(), ", but got size ", operand.sizes());
+  return operand;
+}
+
+int64_t max_length_of(const Tensor& t) {
+  return t.is_jagged() ? get_jagged_impl(t)->max_length() : 0;
+}
+
+template <typename Op>
+JaggedTensor jagged_binary_op(const Tensor& self, const Tensor& other, const char* name, const Op& op) {
+  const Tensor& jagged = self.is_jagged() ? self : other;
+  Tensor values = op(operand_values(self, jagged, name), operand_values(other, jagged, name));
+  return at::native::_jagged_tensor_unsafe(
+      values, get_jagged_impl(jagged)->offsets(), std::max(max_length_of(self), max_length_of(other)));
+}
+
+template <typename Op>
+JaggedTensor& jagged_binary_op_(JaggedTensor& self, const Tensor& other, const char* name, const Op& op) {
+  TORCH_CHECK(self.is_jagged(), name, ": cannot update a strided tensor in-place with a jagged tensor");
+  Tensor self_values = get_jagged_impl(self)->values();
+  op(self_values, operand_values(other, self, name));
+  return self;
+}
+
+template <typename Op>
+JaggedTensor jagged_unary_op(const JaggedTensor& self, const Op& op) {
+  auto impl = get_jagged_impl(self);
+  return at::native::_jagged_tensor_unsafe(op(impl->values()), impl->offsets(), impl->max_length());
+}
+
+} // namespace
+
+Tensor add_jagged(const Tensor& self, const Tensor& other, Scalar alpha) {
+  return jagged_binary_op(self, other, "add", [&](const Tensor& a, const Tensor& b) { return at::add(a, b, alpha); });
+}
+
+Tensor& add_jagged_(Tensor& self, const Tensor& other, Scalar alpha) {
+  return jagged_binary_op_(self, other, "add_", [&](Tensor& a, const Tensor& b) { return a.add_(b, alpha); });
+}
+
+Tensor sub_jagged(const Tensor& self, const Tensor& other, Scalar alpha) {
+  return jagged_binary_op(self, other, "sub", [&](const Tensor& a, const Tensor& b) { return at::sub(a, b, alpha); });
+}
+
+Tensor& sub_jagged_(Tensor& self, const Tensor& other, Scalar alpha) {
+  return jagged_binary_op_(self, other, "sub_", [&](Tensor& a, const Tensor& b) { return a.sub_(b, alpha); });
+}
+
+Tensor mul_jagged(const Tensor& self, const Tensor& other) {
+  return jagged_binary_op(self, other, "mul", [](const Tensor& a, const Tensor& b) { return at::mul(a, b); });
+}
+
+Tensor& mul_jagged_(Tensor& self, const Tensor& other) {
+  return jagged_binary_op_(self, other, "mul_", [](Tensor& a, const Tensor& b) { return a.mul_(b); });
+}
+
+Tensor div_jagged(const Tensor& self, const Tensor& other) {
+  return jagged_binary_op(self, other, "div", [](const Tensor& a, const Tensor& b) { return at::div(a, b); });
+}
+
+Tensor& div_jagged_(Tensor& self, const Tensor& other) {
+  return jagged_binary_op_(self, other, "div_", [](Tensor& a, const Tensor& b) { return a.div_(b); });
+}
+
+Tensor threshold_backward_jagged(const Tensor& grad, const Tensor& self, Scalar threshold) {
+  return jagged_binary_op(grad, self, "threshold_backward", [&](const Tensor& a, const Tensor& b) {
+    return at::threshold_backward(a, b, threshold);
+  });
+}
+
+Tensor sigmoid_backward_jagged(const Tensor& grad_output, const Tensor& output) {
+  return jagged_binary_op(grad_output, output, "sigmoid_backward", [](const Tensor& a, const Tensor& b) {
+    return at::sigmoid_backward(a, b);
+  });
+}
+
+Tensor tanh_backward_jagged(const Tensor& grad_output, const Tensor& output) {
+  return jagged_binary_op(grad_output, output, "tanh_backward", [](const Tensor& a, const Tensor& b) {
+    return at::tanh_backward(a, b);
+  });
+}
+
+Tensor neg_jagged(const JaggedTensor& self) {
+  return jagged_unary_op(self, [](const Tensor& v) { return at::neg(v); });
+}
+
+Tensor relu_jagged(const JaggedTensor& self) {
+  return jagged_unary_op(self, [](const Tensor& v) { return at::relu(v); });
+}
+
+Tensor sigmoid_jagged(const JaggedTensor& self) {
+  return jagged_unary_op(self, [](const Tensor& v) { return at::sigmoid(v); });
+}
+
+Tensor tanh_jagged(const JaggedTensor& self) {
+  return jagged_unary_op(self, [](const Tensor& v) { return at::tanh(v); });
+}
+
+Tensor clone_jagged(const JaggedTensor& self, c10::optional<c10::MemoryFormat> optional_memory_format) {
+  TORCH_CHECK(!optional_memory_format.has_value() || *optional_memory_format == MemoryFormat::Preserve,
+      "unsupported memory format option ", optional_memory_format.value());
+  return jagged_unary_op(self, [](const Tensor& v) { return v.clone(); });
+}
+
+/******************************************************************************
+ * reductions
+ ******************************************************************************/
+
+namespace {
+
+Tensor jagged_reduce(
+    const JaggedTensor& self,
+    IntArrayRef dims,
+    bool keepdim,
+    c10::optional<ScalarType> dtype,
+    SegmentReductionType reduction,
+    const char* name) {
+  auto impl = get_jagged_impl(self);
+  const int64_t ndim = self.dim();
+  const DimMask mask = make_dim_mask(dims, ndim);
+  TORCH_CHECK(mask[1], name, "(): jagged tensors can only be reduced along their jagged dimension 1, but got dim=", dims);
+  Tensor values = dtype.has_value() ? impl->values().to(*dtype) : impl->values();
+  if (reduction == SegmentReductionType::SUM && !dtype.has_value() && at::isIntegralType(values.scalar_type(), /*includeBool=*/true)) {
+    // Like for strided tensors, integers are summed as int64.
+    values = values.to(kLong);
+  }
+  if (reduction == SegmentReductionType::MEAN) {
+    TORCH_CHECK(at::isFloatingType(values.scalar_type()),
+        name, "(): expected a floating point input dtype, but got ", values.scalar_type());
+  }
+  auto dense_reduce = [&](const Tensor& t, IntArrayRef reduce_dims) {
+    switch (reduction) {
+      case SegmentReductionType::SUM: return t.sum(reduce_dims);
+      case SegmentReductionType::MEAN: return t.mean(reduce_dims);
+      default: return t.amax(reduce_dims);
+    }
+  };
+
+  // The inner dimension d of self is dimension d - 1 of values and of the
+  // reduced sequences.
+  std::vector<int64_t> inner_dims;
+  for (int64_t d = 2; d < ndim; d++) {
+    if (mask[d]) {
+      inner_dims.push_back(d - 1);
+    }
+  }
+
+  Tensor result;
+  if (mask[0]) {
+    // Reducing all the sequences together is a reduction of all the values.
+    inner_dims.insert(inner_dims.begin(), 0);
+    result = dense_reduce(values, inner_dims);
+  } else {
+    const int64_t batch_size = impl->batch_size();
+    const Tensor& offsets = impl->offsets();
+    if (reduction == SegmentReductionType::MAX && batch_size > 0) {
+      const int64_t shortest = (offsets.slice(0, 1) - offsets.slice(0, 0, batch_size)).min().item<int64_t>();
+      TORCH_CHECK(shortest > 0, name, "(): cannot reduce an empty sequence");
+    }
+    Tensor values_contig = values.contiguous();
+    const int64_t inner_size = inner_size_of(values_contig);
+    Tensor reduced = at::empty({batch_size, inner_size}, values_contig.options());
+    // The sequences are the segments of the values.
+    segment_reduce_stub(
+        kCPU, reduced.view({1, batch_size, inner_size}), values_contig.view({1, values_contig.size(0), inner_size}),
+        offsets, reduction, c10::nullopt);
+
+    std::vector<int64_t> reduced_size = {batch_size};
+    reduced_size.insert(reduced_size.end(), values.sizes().begin() + 1, values.sizes().end());
+    result = reduced.view(reduced_size);
+    if (!inner_dims.empty()) {
+      result = dense_reduce(result, inner_dims);
+    }
+  }
+  if (keepdim) {
+    for (int64_t d = 0; d < ndim; d++) {
+      if (mask[d]) {
+        result = result.unsqueeze(d);
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+Tensor sum_jagged(const JaggedTensor& self, IntArrayRef dim, bool keepdim, c10::optional<ScalarType> dtype) {
+  return jagged_reduce(self, dim, keepdim, dtype, SegmentReductionType::SUM, "sum");
+}
+
+Tensor sum_jagged(const JaggedTensor& self, c10::optional<ScalarType> dtype) {
+  return jagged_reduce(self, {}, false, dtype, SegmentReductionType::SUM, "sum");
+}
+
+Tensor mean_jagged(const JaggedTensor& self, IntArrayRef dim, bool keepdim, c10::optional<ScalarType> dtype) {
+  return jagged_reduce(self, dim, keepdim, dtype, SegmentReductionType::MEAN, "mean");
+}
+
+Tensor mean_jagged(const JaggedTensor& self, c10::optional<ScalarType> dtype) {
+  return jagged_reduce(self, {}, false, dtype, SegmentReductionType::MEAN, "mean");
+}
+
+Tensor amax_jagged(const JaggedTensor& self, IntArrayRef dim, bool keepdim) {
+  return jagged_reduce(self, dim, keepdim, c10::nullopt, SegmentReductionType::MAX, "amax");
+}
+
+/******************************************************************************
+ * matrix products
+ ******************************************************************************/
+
+namespace {
+
+// Calls f(begin, end) on ranges of sequences.  When there are fewer sequences
+// than threads, the sequences are processed one after the other so that each
+// product can use all the threads instead.
+template <typename index_t, typename F>
+void for_each_sequence_range(const index_t* offsets, int64_t batch_size, int64_t cost_per_element, const F& f) {
+  if (batch_size >= at::get_num_threads()) {
+    parallel_for_sequences(offsets, batch_size, cost_per_element, f);
+  } else {
+    f(0, batch_size);
+  }
+}
+
+} // namespace
+
+// Each sequence of self is multiplied by its own matrix in mat2.  The result
+// is a jagged tensor with the same offsets, so no product is computed for
+// the padding.
+JaggedTensor bmm_jagged(const JaggedTensor& self, const Tensor& mat2_) {
+  TORCH_CHECK(self.dim() == 3, "bmm: expected a 3-D jagged tensor, but got a ", self.dim(), "-D jagged tensor");
+  TORCH_CHECK(mat2_.layout() == kStrided && mat2_.dim() == 3, "bmm: expected mat2 to be a 3-D strided tensor");
+  TORCH_CHECK(mat2_.size(0) == self.size(0),
+      "bmm: expected mat2 to have ", self.size(0), " matrices, one per sequence, but got ", mat2_.size(0));
+  TORCH_CHECK(self.size(2) == mat2_.size(1),
+      "Incompatible matrix sizes for bmm (", self.size(1), "x", self.size(2), " and ", mat2_.size(1), "x", mat2_.size(2), ")");
+  TORCH_CHECK(self.scalar_type() == mat2_.scalar_type(),
+      "bmm: expected self and mat2 to have the same dtype, but got ", self.scalar_type(), " and ", mat2_.scalar_type());
+  auto impl = get_jagged_impl(self);
+  const Tensor& offsets = impl->offsets();
+  const int64_t batch_size = impl->batch_size();
+  const int64_t k = self.size(2);
+  const int64_t n = mat2_.size(2);
+  Tensor values = impl->values().contiguous();
+  Tensor mat2 = mat2_.contiguous();
+  Tensor result = at::empty({values.size(0), n}, values.options());
+  if (k == 0 || n == 0) {
+    result.zero_();
+  } else {
+    AT_DISPATCH_INDEX_TYPES(offsets.scalar_type(), "bmm_jagged", [&] {
+      const index_t* offsets_data = offsets.data_ptr<index_t>();
+      AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(values.scalar_type(), "bmm_jagged", [&] {
+        const scalar_t* values_data = values.data_ptr<scalar_t>();
+        const scalar_t* mat2_data = mat2.data_ptr<scalar_t>();
+        scalar_t* result_data = result.data_ptr<scalar_t>();
+        for_each_sequence_range(offsets_data, batch_size, k * n, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            const int64_t start = offsets_data[i];
+            const int64_t length = offsets_data[i + 1] - offsets_data[i];
+            if (length == 0) {
+              continue;
+            }
+            // In the column-major convention of BLAS, the row-major product
+            // values_i @ mat2[i] is mat2[i]^T @ values_i^T.
+            cpublas::gemm(
+                cpublas::NoTranspose, cpublas::NoTranspose,
+                n, length, k,
+                scalar_t(1),
+                mat2_data + i * k * n, n,
+                values_data + start * k, k,
+                scalar_t(0),
+                result_data + start * n, n);
+          }
+        });
+      });
+    });
+  }
+  return at::native::_jagged_tensor_unsafe(result, offsets, impl->max_length());
+}
+
+// The gradient of mat2 in bmm(self, mat2): values_i^H @ grad_i for each
+// sequence i.
+Tensor _jagged_bmm_mat2_backward(const Tensor& grad, const JaggedTensor& self) {
+  TORCH_CHECK(grad.is_jagged() && grad.dim() == 3, "_jagged_bmm_mat2_backward: expected a 3-D jagged grad");
+  auto impl = get_jagged_impl(self);
+  const Tensor& offsets = impl->offsets();
+  TORCH_CHECK(same_offsets(get_jagged_impl(grad)->offsets(), offsets),
+      "_jagged_bmm_mat2_backward: expected grad and self to have the same offsets");
+  const int64_t batch_size = impl->batch_size();
+  const int64_t k = self.size(2);
+  const int64_t n = grad.size(2);
+  // cpublas::gemm has no conjugate transpose.
+  Tensor values = impl->values().conj().contiguous();
+  Tensor grad_values = get_jagged_impl(grad)->values().contiguous();
+  Tensor result = at::empty({batch_size, k, n}, values.options());
+  if (k == 0 || n == 0) {
+    return result;
+  }
+  AT_DISPATCH_INDEX_TYPES(offsets.scalar_type(), "_jagged_bmm_mat2_backward", [&] {
+    const index_t* offsets_data = offsets.data_ptr<index_t>();
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(values.scalar_type(), "_jagged_bmm_mat2_backward", [&] {
+      const scalar_t* values_data = values.data_ptr<scalar_t>();
+      const scalar_t* grad_data = grad_values.data_ptr<scalar_t>();
+      scalar_t* result_data = result.data_ptr<scalar_t>();
+      for_each_sequence_range(offsets_data, batch_size, k * n, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          const int64_t start = offsets_data[i];
+          const int64_t length = offsets_data[i + 1] - offsets_data[i];
+          scalar_t* result_i = result_data + i * k * n;
+          if (length == 0) {
+            std::fill(result_i, result_i + k * n, scalar_t(0));
+            continue;
+          }
+          // values_i^H @ grad_i is grad_i^T @ conj(values_i) in column-major.
+          cpublas::gemm(
+              cpublas::NoTranspose, cpublas::Transpose,
+              n, k, length,
+              scalar_t(1),
+              grad_data + start * n, n,
+              values_data + start * k, k,
+              scalar_t(0),
+              result_i, n);
+        }
+      });
+    });
+  });
+  return result;
+}
+
+}} // namespace at::native
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/JaggedTensorUtils.h>
+#include <ATen/native/SegmentReduce.h>
+
+namespace at { namespace native {
+
+// The sequences of a jagged tensor are the segments of its values, so they
+// are split among the threads like segments (see SegmentReduce.h), each
+// thread getting about the same number of elements.  f is called with the
+// range of sequences [begin, end) given to a thread.
+template <typename index_t, typename F>
+void parallel_for_sequences(const index_t* offsets, int64_t batch_size, int64_t cost_per_element, const F& f) {
+  parallel_for_segments(offsets, batch_size, /*outer_size=*/1, cost_per_element,
+      [&](int64_t /*outer*/, int64_t begin, int64_t end) { f(begin, end); });
+}
+
+}} // namespace at::native
@@ -9,7 +9,6 @@
 #include <ATen/native/ReduceOpsUtils.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/NamedTensorUtils.h>
-#include <ATen/native/TensorDimApply.h>
 #include <ATen/native/SharedReduceOps.h>
 
 #include <algorithm>
@@ -40,6 +39,8 @@ DEFINE_DISPATCH(argmin_stub);
 DEFINE_DISPATCH(cumsum_stub);
 DEFINE_DISPATCH(cumprod_stub);
 DEFINE_DISPATCH(logcumsumexp_stub);
+DEFINE_DISPATCH(cummax_stub);
+DEFINE_DISPATCH(cummin_stub);
 
 Tensor _logcumsumexp_cpu(const Tensor& self, int64_t dim) {
   Tensor result = at::empty_like(self, MemoryFormat::Contiguous);
@@ -299,48 +300,8 @@ Tensor cumprod_backward(const Tensor& grad, const Tensor& input, int64_t dim) {
   return grad_input;
 }
 
-// Implement std::is_nan<IntegralType> for MSVC.
-namespace {
-#ifdef _MSC_VER
-template<typename T>
-inline typename std::enable_if<std::is_integral<T>::value, bool>::type isnan_(T x) {
-  return false;
-}
-template<typename T>
-inline typename std::enable_if<!std::is_integral<T>::value, bool>::type isnan_(T x) {
-  return std::isnan(x);
-}
-#else
-template<typename T>
-inline bool isnan_(T x) {
-  return std::isnan(x);
-}
-#endif
-}
-
-template<typename T1, typename T2, typename Operation>
-void cummax_cummin_helper(const T1* self_data, T1* values_data, T2* indices_data,
-          int self_dim_size, int self_stride, int values_stride, int indices_stride) {
-      Operation op;
-      T1 out = self_data[0];
-      int idx = 0;
-      for(int i = 0; i < self_dim_size; i++) {
-        T1 curr_elem = self_data[i*self_stride];
-        if(isnan_(curr_elem) || (!isnan_(out) && op(curr_elem, out))) {
-            out = self_data[i*self_stride];
-            idx = i;
-        }
-        values_data[i*values_stride] = out;
-        indices_data[i*indices_stride] = idx;
-      }
-}
-
 void cummax_helper_cpu(const Tensor& self, Tensor& values, Tensor& indices, int64_t dim) {
-  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool,
-    self.scalar_type(), "cummax_cpu",
-    [&] {
-      at::native::tensor_dim_apply3<scalar_t, int64_t>(self, values, indices, dim, cummax_cummin_helper<scalar_t, int64_t, std::greater_equal<scalar_t>>);
-    });
+  cummax_stub(kCPU, self, values, indices, dim);
 }
 
 std::tuple<Tensor&, Tensor&> cummax_out(Tensor& values, Tensor& indices, const Tensor& self, int64_t dim) {
@@ -371,11 +332,7 @@ std::tuple<Tensor, Tensor> cummax(const Tensor& self, int64_t dim) {
 }
 
 void cummin_helper_cpu(const Tensor& self, Tensor& values, Tensor& indices, int64_t dim) {
-  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool,
-    self.scalar_type(), "cummin_cpu",
-    [&] {
-      at::native::tensor_dim_apply3<scalar_t, int64_t>(self, values, indices, dim, cummax_cummin_helper<scalar_t, int64_t, std::less_equal<scalar_t>>);
-    });
+  cummin_stub(kCPU, self, values, indices, dim);
 }
 
 std::tuple<Tensor&, Tensor&> cummin_out(Tensor& values, Tensor& indices, const Tensor& self, int64_t dim) {
@@ -39,4 +39,8 @@ DECLARE_DISPATCH(cum_fn, cumsum_stub);
 DECLARE_DISPATCH(cum_fn, cumprod_stub);
 DECLARE_DISPATCH(cum_fn, logcumsumexp_stub);
 
+using cum_with_indices_fn = void (*)(const Tensor&, Tensor&, Tensor&, int64_t);
+DECLARE_DISPATCH(cum_with_indices_fn, cummax_stub);
+DECLARE_DISPATCH(cum_with_indices_fn, cummin_stub);
+
 }} // namespace at::native
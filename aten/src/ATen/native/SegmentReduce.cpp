@@ -0,0 +1,141 @@
+#include <ATen/native/SegmentReduce.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/WrapDimUtils.h>
+#include <c10/util/accumulate.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(segment_reduce_stub);
+DEFINE_DISPATCH(segment_reduce_backward_stub);
+
+SegmentReductionType get_reduction_enum(const std::string& reduce) {
+  if (reduce == "max") {
+    return SegmentReductionType::MAX;
+  } else if (reduce == "mean") {
+    return SegmentReductionType::MEAN;
+  } else if (reduce == "sum") {
+    return SegmentReductionType::SUM;
+  } else {
+    TORCH_CHECK(false, "segment_reduce: unsupported reduction ", reduce, ", expected max, mean or sum");
+  }
+}
+
+namespace {
+
+// Returns the contiguous offsets of the segments along a dimension of the
+// given size, from either their lengths or their offsets.  Unless unsafe is
+// set, checks that the segments cover the whole dimension.
+Tensor segment_offsets(
+    const c10::optional<Tensor>& lengths,
+    const c10::optional<Tensor>& offsets,
+    int64_t axis_size,
+    bool unsafe) {
+  const bool has_lengths = lengths.has_value() && lengths->defined();
+  const bool has_offsets = offsets.has_value() && offsets->defined();
+  TORCH_CHECK(has_lengths != has_offsets, "segment_reduce: expected exactly one of lengths and offsets");
+  const Tensor& given = has_lengths ? *lengths : *offsets;
+  TORCH_CHECK(given.device().type() == DeviceType::CPU,
+      "segment_reduce: expected ", has_lengths ? "lengths" : "offsets", " on CPU, but got ", given.device());
+  TORCH_CHECK(given.scalar_type() == kInt || given.scalar_type() == kLong,
+      "segment_reduce: expected int32 or int64 ", has_lengths ? "lengths" : "offsets", ", but got ", given.scalar_type());
+  TORCH_CHECK(given.dim() == 1, "segment_reduce: expected 1-D ", has_lengths ? "lengths" : "offsets",
+      ", but got a ", given.dim(), "-D tensor");
+
+  Tensor result;
+  if (has_lengths) {
+    if (!unsafe) {
+      TORCH_CHECK(given.numel() == 0 || given.min().item<int64_t>() >= 0, "segment_reduce: lengths must be non-negative");
+    }
+    result = at::cat({at::zeros({1}, given.options().dtype(kLong)), given.cumsum(0, kLong)});
+  } else {
+    TORCH_CHECK(given.numel() >= 1, "segment_reduce: offsets must have at least one element");
+    result = given.contiguous();
+  }
+  if (!unsafe) {
+    AT_DISPATCH_INDEX_TYPES(result.scalar_type(), "segment_reduce", [&] {
+      const index_t* offsets_data = result.data_ptr<index_t>();
+      const int64_t num_segments = result.numel() - 1;
+      TORCH_CHECK(offsets_data[0] == 0, "segment_reduce: offsets must start with 0, but got ", offsets_data[0]);
+      TORCH_CHECK(offsets_data[num_segments] == axis_size,
+          "segment_reduce: the segments must cover the ", axis_size, " elements of the reduced axis, but they cover ",
+          offsets_data[num_segments]);
+      for (int64_t s = 0; s < num_segments; s++) {
+        TORCH_CHECK(offsets_data[s] <= offsets_data[s + 1],
+            "segment_reduce: offsets must be non-decreasing, but offsets[", s, "] = ", offsets_data[s],
+            " > offsets[", s + 1, "] = ", offsets_data[s + 1]);
+      }
+    });
+  }
+  return result;
+}
+
+// Views a contiguous tensor as (outer_size, size of axis, inner_size).
+Tensor view_around_axis(const Tensor& t, int64_t axis) {
+  const int64_t outer_size = c10::multiply_integers(t.sizes().begin(), t.sizes().begin() + axis);
+  const int64_t inner_size = c10::multiply_integers(t.sizes().begin() + axis + 1, t.sizes().end());
+  return t.view({outer_size, t.size(axis), inner_size});
+}
+
+} // namespace
+
+// Reduces the segments of data along axis.  Unlike scatter_add or index_add,
+// which look up the destination of every element, the segments are
+// consecutive ranges of rows, so each one is reduced by a single thread in a
+// single pass over its rows.
+Tensor segment_reduce_kernel(
+    const Tensor& data,
+    std::string reduce,
+    const c10::optional<Tensor>& lengths,
+    const c10::optional<Tensor>& offsets,
+    int64_t axis,
+    bool unsafe,
+    c10::optional<Scalar> initial) {
+  TORCH_CHECK(data.dim() >= 1, "segment_reduce: expected data of at least 1 dimension");
+  axis = maybe_wrap_dim(axis, data.dim());
+  const SegmentReductionType reduction = get_reduction_enum(reduce);
+  TORCH_CHECK(reduction != SegmentReductionType::MEAN || at::isFloatingType(data.scalar_type()),
+      "segment_reduce: mean expects a floating point data dtype, but got ", data.scalar_type());
+  Tensor segment_offsets_ = segment_offsets(lengths, offsets, data.size(axis), unsafe);
+  const int64_t num_segments = segment_offsets_.numel() - 1;
+
+  std::vector<int64_t> output_size = data.sizes().vec();
+  output_size[axis] = num_segments;
+  Tensor output = at::empty(output_size, data.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+  segment_reduce_stub(
+      data.device().type(), view_around_axis(output, axis), view_around_axis(data.contiguous(), axis),
+      segment_offsets_, reduction, initial);
+  return output;
+}
+
+Tensor _segment_reduce_backward_kernel(
+    const Tensor& grad,
+    const Tensor& output,
+    const Tensor& data,
+    std::string reduce,
+    const c10::optional<Tensor>& lengths,
+    const c10::optional<Tensor>& offsets,
+    int64_t axis) {
+  axis = maybe_wrap_dim(axis, data.dim());
+  const SegmentReductionType reduction = get_reduction_enum(reduce);
+  TORCH_CHECK(at::isFloatingType(data.scalar_type()),
+      "segment_reduce: backward expects a floating point data dtype, but got ", data.scalar_type());
+  // The offsets were checked by the forward.
+  Tensor segment_offsets_ = segment_offsets(lengths, offsets, data.size(axis), /*unsafe=*/true);
+  Tensor grad_data = at::empty(data.sizes(), data.options());
+  if (data.numel() == 0) {
+    return grad_data;
+  }
+  segment_reduce_backward_stub(
+      data.device().type(), view_around_axis(grad_data, axis), view_around_axis(grad.contiguous(), axis),
+      view_around_axis(output.contiguous(), axis), view_around_axis(data.contiguous(), axis),
+      segment_offsets_, reduction);
+  return grad_data;
+}
+
+}} // namespace at::native
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+enum class SegmentReductionType { MAX, MEAN, SUM };
+
+TORCH_API SegmentReductionType get_reduction_enum(const std::string& reduce);
+
+// The segments are consecutive ranges of rows of data: segment s holds rows
+// offsets[s]:offsets[s + 1].  data is a contiguous (outer_size, total_length,
+// inner_size) tensor, output a contiguous (outer_size, num_segments,
+// inner_size) tensor, and output[o][s] is the reduction of data[o][offsets[s]:
+// offsets[s + 1]] along its first dimension.  If given, initial is the
+// starting value of the reduction of every segment, and the mean of a segment
+// is that of its sum.  Empty segments are set to initial, or by default to
+// the identity of the reduction: 0 for a sum, nan for a mean and -inf (or the
+// lowest integer) for a max.
+using segment_reduce_fn = void(*)(const Tensor& output, const Tensor& data, const Tensor& offsets, SegmentReductionType reduction, const c10::optional<Scalar>& initial);
+DECLARE_DISPATCH(segment_reduce_fn, segment_reduce_stub);
+
+// grad_data = the gradient of data given grad, the gradient of output, with
+// the same layout as above.  The gradient of a max is split evenly between
+// the elements equal to it.
+using segment_reduce_backward_fn = void(*)(const Tensor& grad_data, const Tensor& grad, const Tensor& output, const Tensor& data, const Tensor& offsets, SegmentReductionType reduction);
+DECLARE_DISPATCH(segment_reduce_backward_fn, segment_reduce_backward_stub);
+
+// Segments can have very different lengths, so splitting them evenly among
+// the threads can leave most of the work to a single thread.  Instead, they
+// are split so that each thread gets about the same number of rows, like the
+// rows of a sparse CSR matrix (see SparseCsrKernel.cpp): the work of the
+// first s segments, counting one unit per row plus one per segment for its
+// overhead, is offsets[s] + s.
+template <typename index_t>
+int64_t first_segment_with_work(const index_t* offsets, int64_t num_segments, int64_t work) {
+  int64_t lo = 0, hi = num_segments;
+  while (lo < hi) {
+    int64_t mid = lo + (hi - lo) / 2;
+    if (static_cast<int64_t>(offsets[mid]) + mid < work) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Calls f(o, begin, end) on ranges [begin, end) of the segments of the outer
+// slice o, about the same amount of work per thread.  cost_per_row is the
+// number of elements of a row.
+template <typename index_t, typename F>
+void parallel_for_segments(const index_t* offsets, int64_t num_segments, int64_t outer_size, int64_t cost_per_row, const F& f) {
+  const int64_t work_per_slice = static_cast<int64_t>(offsets[num_segments]) + num_segments;
+  if (work_per_slice == 0) {
+    return;
+  }
+  const int64_t grain_size = std::max<int64_t>(at::internal::GRAIN_SIZE / std::max<int64_t>(cost_per_row, 1), 1);
+  at::parallel_for(0, outer_size * work_per_slice, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t o = begin / work_per_slice; o < outer_size && o * work_per_slice < end; o++) {
+      const int64_t slice_begin = std::max<int64_t>(begin - o * work_per_slice, 0);
+      const int64_t slice_end = std::min<int64_t>(end - o * work_per_slice, work_per_slice);
+      const int64_t seg_begin = first_segment_with_work(offsets, num_segments, slice_begin);
+      const int64_t seg_end = first_segment_with_work(offsets, num_segments, slice_end);
+      if (seg_begin < seg_end) {
+        f(o, seg_begin, seg_end);
+      }
+    }
+  });
+}
+
+}} // namespace at::native
@@ -59,6 +59,7 @@
 #include <ATen/native/BinaryOps.h>
 #include <ATen/native/Copy.h>
 #include <ATen/Parallel.h>
+#include <c10/util/accumulate.h>
 
 #include <algorithm>
 #include <functional>
@@ -71,10 +72,12 @@ DEFINE_DISPATCH(index_stub);
 DEFINE_DISPATCH(index_fill_stub);
 DEFINE_DISPATCH(index_put_stub);
 DEFINE_DISPATCH(index_put_accum_stub);
+DEFINE_DISPATCH(index_add_stub);
 DEFINE_DISPATCH(masked_fill_stub);
 REGISTER_NO_CPU_DISPATCH(index_put_accum_stub, index_put_accum_fn);
-DEFINE_DISPATCH(masked_select_serial_stub);
 DEFINE_DISPATCH(masked_select_stub);
+DEFINE_DISPATCH(masked_select_compact_stub);
+DEFINE_DISPATCH(nonzero_stub);
 DEFINE_DISPATCH(masked_scatter_stub);
 
 DEFINE_DISPATCH(gather_stub);
@@ -283,9 +286,44 @@ static TensorIterator make_index_out_iterator(const AdvancedIndex& info, Tensor&
   return config.build();
 }
 
+// self[mask], where mask is a single bool mask over the leading dimensions
+// of a contiguous CPU tensor, selects whole rows of the view of self as
+// (mask.numel(), *self.shape[mask.dim():]).  Such rows are indexed by the
+// flat positions of the true elements of the mask, found by the parallel
+// stream compaction of nonzero(), rather than by the mask.dim() index tensors
+// expandTensors builds from nonzero().
+static bool is_leading_bool_mask(const Tensor & self, const torch::List<c10::optional<Tensor>>& indices) {
+  if (indices.size() != 1 || self.device().type() != kCPU || self.layout() != kStrided ||
+      self.is_quantized() || !self.is_contiguous()) {
+    return false;
+  }
+  const c10::optional<Tensor> mask = indices.get(0);
+  return mask.has_value() && mask->defined() && mask->scalar_type() == kBool &&
+      mask->device().type() == kCPU && mask->dim() > 0 && mask->dim() <= self.dim() &&
+      mask->sizes().equals(self.sizes().slice(0, mask->dim()));
+}
+
+static Tensor bool_mask_positions(const Tensor & mask) {
+  return at::nonzero(mask.reshape({-1})).view({-1});
+}
+
+static Tensor view_as_rows(const Tensor & self, int64_t num_leading_dims) {
+  DimVector rows_shape{c10::multiply_integers(self.sizes().begin(), self.sizes().begin() + num_leading_dims)};
+  rows_shape.append(self.sizes().begin() + num_leading_dims, self.sizes().end());
+  return self.view(rows_shape);
+}
+
 Tensor index(const Tensor & self, const torch::List<c10::optional<Tensor>>& indices) {
   TORCH_CHECK_INDEX(indices.size() <= (size_t)self.dim(), "too many indices for tensor of dimension ", self.dim(), " (got ", indices.size(), ")");
 
+  if (is_leading_bool_mask(self, indices)) {
+    const Tensor mask = *indices.get(0);
+    if (mask.dim() == self.dim()) {
+      return at::masked_select(self, mask);
+    }
+    return at::index_select(view_as_rows(self, mask.dim()), 0, bool_mask_positions(mask));
+  }
+
   auto info = make_info(self, indices);
   auto iter = make_index_iterator(info);
   index_stub(iter.device_type(), iter, info.indexed_sizes, info.indexed_strides);
@@ -355,6 +393,24 @@ Tensor & _index_put_impl_(Tensor & self, const torch::List<c10::optional<Tensor>
       return self;
   }
 
+  if (is_leading_bool_mask(self, indices)) {
+    const Tensor positions = bool_mask_positions(*indices.get(0));
+    Tensor rows = view_as_rows(self, indices.get(0)->dim());
+    DimVector indexed_shape(rows.sizes().begin(), rows.sizes().end());
+    indexed_shape[0] = positions.numel();
+    // The positions are distinct, so accumulating them is an index_add_,
+    // which is parallel, unlike the accumulating index_put_ kernel.
+    const auto dtype = self.scalar_type();
+    if (accumulate && value.scalar_type() == dtype && value.device().type() == kCPU &&
+        is_expandable_to(value.sizes(), indexed_shape) &&
+        dtype != ScalarType::Bool && dtype != ScalarType::Half && dtype != ScalarType::BFloat16) {
+      rows.index_add_(0, positions, value.expand(indexed_shape));
+    } else {
+      at::_index_put_impl_(rows, toListOfOptionalTensors(ArrayRef<Tensor>(positions)), value, accumulate, unsafe);
+    }
+    return self;
+  }
+
   auto info = make_info(self, indices);
   auto iter = make_index_put_iterator(info, value);
   index_put_stub(iter.device_type(), iter, info.indexed_sizes, info.indexed_strides, accumulate);
@@ -436,6 +492,29 @@ Tensor& index_add_cpu_(Tensor & self, int64_t dim, const Tensor & index, const T
 
   auto index_contig = index.contiguous();
 
+  // The kernel splits the indices among the threads without write conflicts
+  // (see index_add_kernel in cpu/IndexKernel.cpp), but it needs the slices of
+  // self and source to have the same sizes and self to be contiguous.
+  const bool same_slice_sizes = self.dim() <= 1
+    ? source.dim() <= 1
+    : source.dim() == self.dim() && [&] {
+        for (int64_t d = 0; d < self.dim(); d++) {
+          if (d != dim && self.size(d) != source.size(d)) {
+            return false;
+          }
+        }
+        return true;
+      }();
+  const auto dtype = self.scalar_type();
+  if (numel > 0 && same_slice_sizes && self.is_contiguous() &&
+      dtype != ScalarType::Half && dtype != ScalarType::BFloat16 && dtype != ScalarType::Bool) {
+    const int64_t self_dim_size = self.dim() == 0 ? 1 : self.size(dim);
+    TORCH_CHECK_INDEX(index_contig.min().item<int64_t>() >= 0 && index_contig.max().item<int64_t>() < self_dim_size,
+                      "index out of range in self");
+    index_add_stub(self.device().type(), self, dim, index_contig, source.contiguous());
+    return self;
+  }
+
   if (self.dim() > 1) {
     // Equivalent to:
     //   for (auto i = 0; i < numel; i++) {
@@ -1007,6 +1086,13 @@ static Tensor & masked_select_out_impl_cpu(Tensor & result, const Tensor & self,
   Tensor _mask, _self;
   std::tie(_mask, _self) = expand_outplace(mask, self);
 
+  // Contiguous inputs are compacted directly, in parallel when they are
+  // large, without first counting the mask with sum().
+  if (_self.is_contiguous() && _mask.is_contiguous()) {
+    masked_select_compact_stub(_self.device().type(), result, _self, _mask);
+    return result;
+  }
+
   auto shape = _self.sizes();
   int64_t numel = _mask.sum().item().toLong();
   result.resize_({numel});
@@ -1019,27 +1105,6 @@ static Tensor & masked_select_out_impl_cpu(Tensor & result, const Tensor & self,
   auto orig_stride = result.strides()[0];
   auto result_strided = result.as_strided(shape, strides);
 
-  // serial kernel
-  // serial kernel requires that src is traversed in its logical order. However, TensorIterator might
-  // have reordered dimensions so that src would be traversed in its physical order, producing wrong
-  // answers. A sufficient condition that no reorder happened is that both _self and _mask is contiguous.
-  // If it is not satisfied, use parallel kernel that handles permutations correctly
-  bool use_serial_kernel = (self.numel() < at::internal::GRAIN_SIZE || at::get_num_threads() == 1 ) &&
-  _self.is_contiguous() && _mask.is_contiguous();
-  if (use_serial_kernel) {
-    auto iter = TensorIteratorConfig()
-      .set_check_mem_overlap(false)  // result is intenionally zero-strided above
-      .check_all_same_dtype(false)
-      .resize_outputs(false)
-      .add_output(result_strided)
-      .add_input(_self)
-      .add_input(_mask)
-      .build();
-
-    masked_select_serial_stub(iter.device_type(), iter, orig_stride);
-    return result;
-  }
-
   // Use a prefix sum to record the output locations of the masked elements,
   // so as to parallel with TensorIterator.
   auto mask_long = at::empty(shape, self.options().dtype(at::kLong)).copy_(_mask);
@@ -1184,6 +1249,31 @@ Tensor _gather_sparse_backward(const Tensor& self, int64_t dim, const Tensor& in
     return at::_sparse_coo_tensor_unsafe(sparse_ind, grad.reshape(-1), self.sizes());
 }
 
+Tensor& nonzero_out_cpu(Tensor& result, const Tensor& self) {
+  TORCH_CHECK(result.scalar_type() == kLong,
+              "nonzero(): Expected out tensor to have scalar type Long but got scalar type ", result.scalar_type());
+  at::assert_no_internal_overlap(result);
+  at::assert_no_overlap(result, self);
+
+  // The kernel writes the coordinates row after row, so a result that isn't
+  // contiguous gets them through a temporary.  A contiguous result stays
+  // contiguous when the kernel resizes it.
+  if (!result.is_contiguous()) {
+    Tensor contiguous_result = at::empty({0}, result.options());
+    nonzero_stub(kCPU, contiguous_result, self.contiguous());
+    result.resize_(contiguous_result.sizes());
+    result.copy_(contiguous_result);
+    return result;
+  }
+  nonzero_stub(kCPU, result, self.contiguous());
+  return result;
+}
+
+Tensor nonzero_cpu(const Tensor& self) {
+  Tensor result = at::empty({0}, self.options().dtype(kLong));
+  return nonzero_out_cpu(result, self);
+}
+
 std::vector<Tensor> nonzero_numpy(const Tensor& self) {
   // special case scalar for compatibility with numpy:
   //
@@ -17,8 +17,20 @@ using index_fn = void(*)(TensorIterator &, IntArrayRef indexed_sizes, IntArrayRe
 using index_fill_fn = void(*)(TensorIterator & iter, int64_t dim, int64_t self_dim_size, int64_t self_dim_stride, Scalar source);
 using index_put_fn = void(*)(TensorIterator &, IntArrayRef indexed_sizes, IntArrayRef indexed_strides, bool accumulate);
 using index_put_accum_fn = void(*)(Tensor &, const c10::List<c10::optional<Tensor>> &, const Tensor &, bool unsafe);
+// self.select(dim, index[i]) += source.select(dim, i) for each i, where self
+// and source are contiguous and index is a contiguous 1-D tensor of indices
+// already checked to be in range.  Duplicate indices are accumulated.
+using index_add_fn = void(*)(Tensor & self, int64_t dim, const Tensor & index, const Tensor & source);
 using masked_fill_fn = void(*)(TensorIterator &, Scalar scalar);
 using masked_select_fn = void(*)(TensorIterator &, int64_t orig_stride);
+// Stream compaction of contiguous tensors, in a parallel pass counting the
+// selected elements of each thread's chunk and a second pass writing them at
+// the offsets given by the prefix sum of the counts.  nonzero resizes result
+// to (number of nonzero elements, self.dim()) and writes their coordinates;
+// masked_select_compact resizes result to the number of true elements of
+// mask, which has the same shape as self, and writes them in order.
+using nonzero_fn = void(*)(Tensor & result, const Tensor & self);
+using masked_select_compact_fn = void(*)(Tensor & result, const Tensor & self, const Tensor & mask);
 using masked_scatter_fn = void(*)(TensorIterator &, const Tensor &);
 
 using gather_fn = void (*)(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index);
@@ -34,9 +46,11 @@ DECLARE_DISPATCH(index_fn, index_stub);
 DECLARE_DISPATCH(index_fill_fn, index_fill_stub);
 DECLARE_DISPATCH(index_put_fn, index_put_stub);
 DECLARE_DISPATCH(index_put_accum_fn, index_put_accum_stub);
+DECLARE_DISPATCH(index_add_fn, index_add_stub);
 DECLARE_DISPATCH(masked_fill_fn, masked_fill_stub);
-DECLARE_DISPATCH(masked_select_fn, masked_select_serial_stub);
 DECLARE_DISPATCH(masked_select_fn, masked_select_stub);
+DECLARE_DISPATCH(masked_select_compact_fn, masked_select_compact_stub);
+DECLARE_DISPATCH(nonzero_fn, nonzero_stub);
 DECLARE_DISPATCH(masked_scatter_fn, masked_scatter_stub);
 
 DECLARE_DISPATCH(gather_fn, gather_stub);
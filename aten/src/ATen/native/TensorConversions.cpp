@@ -107,6 +107,8 @@ Tensor to_dense_backward(const Tensor& grad, const Tensor& input_) {
     return grad.sparse_mask(input);
   } else if (input_.layout() == c10::kMkldnn) {
     return grad.to_mkldnn(input_.scalar_type());
+  } else if (input_.layout() == c10::kJagged) {
+    return grad.to_jagged(input_.offsets(), input_.size(1));
   } else {
     AT_ERROR("Unsupported input layout: ", input_.layout());
   }
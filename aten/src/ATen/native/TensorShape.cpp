@@ -13,6 +13,7 @@
 #include <ATen/native/TypeProperties.h>
 #include <ATen/native/cpu/CatKernel.h>
 #include <ATen/native/cpu/StackKernel.h>
+#include <ATen/native/sparse/SparseCsrTensorMath.h>
 #include <ATen/quantized/QTensorImpl.h>
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
@@ -1599,6 +1600,8 @@ Tensor & transpose_(Tensor & self, int64_t dim0, int64_t dim1) {
     return sparse_transpose_(self, dim0, dim1);
   }
 
+  TORCH_CHECK(!self.is_sparse_csr(), "transpose_: in-place transpose is not supported for sparse CSR tensors");
+
   if (self.is_mkldnn()) {
     return at::_mkldnn_transpose_(self, dim0, dim1);
   }
@@ -1623,6 +1626,10 @@ Tensor transpose(const Tensor & self, int64_t dim0, int64_t dim1) {
     return sparse_transpose_(self_clone, dim0, dim1);
   }
 
+  if (self.is_sparse_csr()) {
+    return sparse_csr_transpose(self);
+  }
+
   if (self.is_mkldnn()) {
     return at::_mkldnn_transpose(self, dim0, dim1);
   }
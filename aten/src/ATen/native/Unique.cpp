@@ -2,17 +2,92 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 
-#include <set>
+#include <numeric>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Mixes the bits of std::hash, which is the identity for integers in some
+// standard libraries, so that both its high bits (which pick a partition)
+// and its low bits (which pick a slot) are usable.
+template <typename scalar_t>
+inline uint64_t _unique_hash(scalar_t value) {
+  uint64_t h = static_cast<uint64_t>(std::hash<scalar_t>{}(value));
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Number of chunks the input is split into for the parallel passes.
+inline int64_t _unique_num_chunks(int64_t numel) {
+  return std::max<int64_t>(
+      std::min<int64_t>(at::get_num_threads(), numel / at::internal::GRAIN_SIZE), 1);
+}
+
+// Open addressing hash set of the unique values of one partition, which
+// numbers the values in the order they are first inserted.
+template <typename scalar_t>
+class UniqueHashSet {
+ public:
+  UniqueHashSet() : slots_(kInitialCapacity, -1) {}
+
+  int64_t insert(scalar_t value) {
+    uint64_t slot = _unique_hash<scalar_t>(value) & (slots_.size() - 1);
+    while (true) {
+      const int64_t id = slots_[slot];
+      if (id < 0) {
+        break;
+      }
+      if (values_[id] == value) {
+        return id;
+      }
+      slot = (slot + 1) & (slots_.size() - 1);
+    }
+    const int64_t id = values_.size();
+    values_.push_back(value);
+    slots_[slot] = id;
+    // keep the load factor under 1/2
+    if (2 * values_.size() > slots_.size()) {
+      grow();
+    }
+    return id;
+  }
+
+  const std::vector<scalar_t>& values() const {
+    return values_;
+  }
+
+ private:
+  static constexpr size_t kInitialCapacity = 64;
+
+  void grow() {
+    std::vector<int64_t>(2 * slots_.size(), -1).swap(slots_);
+    for (size_t id = 0; id < values_.size(); id++) {
+      uint64_t slot = _unique_hash<scalar_t>(values_[id]) & (slots_.size() - 1);
+      while (slots_[slot] >= 0) {
+        slot = (slot + 1) & (slots_.size() - 1);
+      }
+      slots_[slot] = id;
+    }
+  }
+
+  std::vector<int64_t> slots_;
+  std::vector<scalar_t> values_;
+};
+
+// The elements are scattered into one partition per thread by their hash,
+// keeping their positions for the inverse indices, so that every thread
+// deduplicates its own partition without locks.  The unique values are
+// numbered by partition, then by first occurrence within the partition;
+// sorted output sorts the unique values only, not the input.
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
@@ -22,53 +97,132 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output;
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
 
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data_ptr<scalar_t>();
-
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
-  } else {
-    std::copy(set.begin(), set.end(), output_data);
+  const int64_t num_partitions = _unique_num_chunks(numel);
+  auto partition_of = [&](scalar_t value) -> int64_t {
+    return (_unique_hash<scalar_t>(value) >> 32) % num_partitions;
+  };
+
+  // partition p is partition_values[partition_offsets[p]:partition_offsets[p + 1]],
+  // and partition_positions holds the position of each of its elements in input
+  const scalar_t* partition_values = input_data;
+  Tensor partition_values_buffer;
+  std::vector<int64_t> partition_positions;
+  std::vector<int64_t> partition_offsets = {0, numel};
+  if (num_partitions > 1) {
+    auto chunk_begin = [&](int64_t c) { return numel * c / num_partitions; };
+    std::vector<int64_t> chunk_offsets(num_partitions * num_partitions, 0);
+    at::parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* chunk_counts = chunk_offsets.data() + c * num_partitions;
+        for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+          chunk_counts[partition_of(input_data[i])]++;
+        }
+      }
+    });
+    partition_offsets.assign(num_partitions + 1, 0);
+    int64_t offset = 0;
+    for (int64_t p = 0; p < num_partitions; p++) {
+      partition_offsets[p] = offset;
+      for (int64_t c = 0; c < num_partitions; c++) {
+        const int64_t count = chunk_offsets[c * num_partitions + p];
+        chunk_offsets[c * num_partitions + p] = offset;
+        offset += count;
+      }
+    }
+    partition_offsets[num_partitions] = numel;
+
+    partition_values_buffer = at::empty({numel}, input.options());
+    scalar_t* buffer_data = partition_values_buffer.data_ptr<scalar_t>();
+    partition_positions.resize(numel);
+    at::parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* chunk_offset = chunk_offsets.data() + c * num_partitions;
+        for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+          const int64_t pos = chunk_offset[partition_of(input_data[i])]++;
+          buffer_data[pos] = input_data[i];
+          partition_positions[pos] = i;
+        }
+      }
+    });
+    partition_values = buffer_data;
   }
 
-  if (return_inverse || return_counts) {
-    inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
-    }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
-    }
-    if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
+  // ids[k] is the id of partition_values[k] within its partition
+  std::vector<int64_t> ids(return_inverse ? numel : 0);
+  std::vector<UniqueHashSet<scalar_t>> sets(num_partitions);
+  std::vector<std::vector<int64_t>> partition_counts(num_partitions);
+  at::parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      auto& set = sets[p];
+      auto& set_counts = partition_counts[p];
+      for (int64_t k = partition_offsets[p]; k < partition_offsets[p + 1]; k++) {
+        const int64_t id = set.insert(partition_values[k]);
+        if (return_counts) {
+          if (id == static_cast<int64_t>(set_counts.size())) {
+            set_counts.push_back(0);
+          }
+          set_counts[id]++;
+        }
+        if (return_inverse) {
+          ids[k] = id;
+        }
       }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+    }
+  });
+
+  std::vector<int64_t> unique_offsets(num_partitions + 1, 0);
+  for (int64_t p = 0; p < num_partitions; p++) {
+    unique_offsets[p + 1] = unique_offsets[p] + sets[p].values().size();
+  }
+  const int64_t num_unique = unique_offsets[num_partitions];
+  Tensor output = at::empty({num_unique}, input.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* counts_data = nullptr;
+  if (return_counts) {
+    counts.resize_({num_unique});
+    counts_data = counts.data_ptr<int64_t>();
+  }
+  int64_t* inverse_indices_data = nullptr;
+  if (return_inverse) {
+    inverse_indices.resize_(input.sizes());
+    inverse_indices_data = inverse_indices.data_ptr<int64_t>();
+  }
+  at::parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      const auto& values = sets[p].values();
+      std::copy(values.begin(), values.end(), output_data + unique_offsets[p]);
+      if (return_counts) {
+        std::copy(partition_counts[p].begin(), partition_counts[p].end(), counts_data + unique_offsets[p]);
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data_ptr<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+      if (return_inverse) {
+        for (int64_t k = partition_offsets[p]; k < partition_offsets[p + 1]; k++) {
+          const int64_t pos = num_partitions > 1 ? partition_positions[k] : k;
+          inverse_indices_data[pos] = unique_offsets[p] + ids[k];
+        }
       }
     }
+  });
+
+  if (sorted) {
+    Tensor perm;
+    std::tie(output, perm) = output.sort();
+    if (return_counts) {
+      counts = counts.index_select(0, perm);
+    }
+    if (return_inverse) {
+      // rank[i] is the position of the i-th unsorted unique value in output
+      Tensor rank = at::empty_like(perm).scatter_(0, perm, at::arange(num_unique, perm.options()));
+      inverse_indices = rank.index_select(0, inverse_indices.view(-1)).view(input.sizes());
+    }
   }
   return std::make_tuple(output, inverse_indices, counts);
 }
 
+// The groups of equal consecutive elements are counted by chunk in a first
+// pass, so that a second pass can write every chunk's groups in parallel.
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
     const Tensor& self,
@@ -77,7 +231,7 @@ std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output = at::empty({numel}, input.options());
+  Tensor output = at::empty({0}, input.options());
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
 
@@ -86,68 +240,62 @@ std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
   }
 
   if (numel > 0) {
-    scalar_t *output_data = output.data_ptr<scalar_t>();
-    int64_t *inverse_data = inverse_indices.data_ptr<int64_t>();;
-    int64_t *counts_data = nullptr;
-    *output_data = *input_data;
-
-    if (return_counts) {
-      counts.resize_({numel});
-      counts_data = counts.data_ptr<int64_t>();
-    }
-    scalar_t *p = output_data;
-    int64_t *q = counts_data;
-    int64_t last = 0;
-    for (int64_t i = 0; i < numel; i++) {
-      if (input_data[i] != *p) {
-        *(++p) = input_data[i];
-        if (return_counts) {
-          *(q++) = i - last;
-          last = i;
+    const int64_t num_chunks = _unique_num_chunks(numel);
+    auto chunk_begin = [&](int64_t c) { return numel * c / num_chunks; };
+    auto starts_group = [&](int64_t i) {
+      return i == 0 || input_data[i] != input_data[i - 1];
+    };
+
+    // chunk_groups[c] is the number of groups starting before chunk c
+    std::vector<int64_t> chunk_groups(num_chunks + 1, 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t num_groups = 0;
+        for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+          num_groups += starts_group(i);
         }
+        chunk_groups[c + 1] = num_groups;
       }
-      if (return_inverse) {
-        inverse_data[i] = p - output_data;
+    });
+    std::partial_sum(chunk_groups.begin(), chunk_groups.end(), chunk_groups.begin());
+    const int64_t output_size = chunk_groups[num_chunks];
+
+    output.resize_({output_size});
+    scalar_t* output_data = output.data_ptr<scalar_t>();
+    int64_t* inverse_data = return_inverse ? inverse_indices.data_ptr<int64_t>() : nullptr;
+    std::vector<int64_t> group_starts(return_counts ? output_size + 1 : 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t group = chunk_groups[c] - 1;
+        for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+          if (starts_group(i)) {
+            output_data[++group] = input_data[i];
+            if (return_counts) {
+              group_starts[group] = i;
+            }
+          }
+          if (return_inverse) {
+            inverse_data[i] = group;
+          }
+        }
       }
-    }
-    int64_t output_size = p - output_data + 1;
+    });
+
     if (return_counts) {
-      *q = numel - last;
+      group_starts[output_size] = numel;
       counts.resize_({output_size});
+      int64_t* counts_data = counts.data_ptr<int64_t>();
+      at::parallel_for(0, output_size, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        for (int64_t g = begin; g < end; g++) {
+          counts_data[g] = group_starts[g + 1] - group_starts[g];
+        }
+      });
     }
-    output.resize_({output_size});
   }
 
   return std::make_tuple(output, inverse_indices, counts);
 }
 
-template<class ForwardIt>
-ForwardIt _unique_dim_cpu_impl(ForwardIt first, ForwardIt last,
-  std::vector<int64_t>& indices, Tensor inverse_indices_vec, Tensor counts) {
-    if (first == last) {
-      return last;
-    }
-    // save to calculate distance to iterators
-    ForwardIt begin = first;
-
-    // set first inverse index and count
-    inverse_indices_vec[indices[0]] = 0;
-    counts[0] += 1;
-
-    ForwardIt result = first;
-    while (++first != last) {
-      if (!at::equal(*result, *first) && ++result != first) {
-          *result = std::move(*first);
-      }
-      int64_t idx_result = std::distance(begin, result);
-      int64_t idx_first = std::distance(begin, first);
-      inverse_indices_vec[indices[idx_first]] = idx_result;
-      counts[idx_result] += 1;
-    }
-
-    return ++result;
-  }
-
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu_template(
     const Tensor& self,
@@ -181,14 +329,15 @@ std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu_template(
   auto orig_sizes = input_flat.sizes().vec();
   input_flat = input_flat.contiguous().view({input_flat.size(0), -1});
 
-  std::vector<int64_t> indices(input_flat.size(0));
-  std::iota(indices.begin(), indices.end(), 0);
+  const int64_t num_rows = input_flat.size(0);
+  Tensor indices = at::arange(num_rows, self.options().dtype(kLong));
+  int64_t* indices_data = indices.data_ptr<int64_t>();
   int64_t numel = input_flat.size(1);
   scalar_t* input_flat_ptr = ((scalar_t*)input_flat.data_ptr());
 
   // sort indices using data
   if (!consecutive) {
-    std::sort(indices.begin(), indices.end(),
+    std::sort(indices_data, indices_data + num_rows,
       [&](int64_t a, int64_t b) -> bool {
         for (int64_t i = 0; i < numel; ++i) {
           scalar_t lhs = input_flat_ptr[i + a * numel];
@@ -203,26 +352,38 @@ std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu_template(
       });
   }
 
-  Tensor input_sorted;
-  if (!consecutive) {
-    input_sorted = at::empty(input_flat.sizes(), input_flat.options());
-    for (size_t i = 0; i < indices.size(); ++i) {
-      input_sorted[i] = input_flat[indices[i]];
+  Tensor input_sorted = consecutive ? input_flat : input_flat.index_select(0, indices);
+  const scalar_t* input_sorted_ptr = input_sorted.data_ptr<scalar_t>();
+
+  // flag the rows that differ from the previous one
+  std::vector<uint8_t> starts_group(num_rows);
+  at::parallel_for(0, num_rows, std::max<int64_t>(at::internal::GRAIN_SIZE / std::max<int64_t>(numel, 1), 1),
+    [&](int64_t begin, int64_t end) {
+      for (int64_t r = begin; r < end; r++) {
+        starts_group[r] = r == 0 || !std::equal(
+          input_sorted_ptr + r * numel, input_sorted_ptr + (r + 1) * numel,
+          input_sorted_ptr + (r - 1) * numel);
+      }
+    });
+
+  Tensor inverse_indices = at::empty({num_rows}, self.options().dtype(kLong));
+  Tensor counts = at::zeros({num_rows}, self.options().dtype(kLong));
+  int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
+  int64_t* counts_data = counts.data_ptr<int64_t>();
+  std::vector<int64_t> unique_rows;
+  for (int64_t r = 0; r < num_rows; r++) {
+    if (starts_group[r]) {
+      unique_rows.push_back(r);
     }
-  } else {
-    input_sorted = input_flat;
+    const int64_t group = unique_rows.size() - 1;
+    inverse_indices_data[indices_data[r]] = group;
+    counts_data[group] += 1;
   }
-
-  Tensor inverse_indices = at::empty(indices.size(), self.options().dtype(kLong));
-  Tensor counts = at::zeros(indices.size(), self.options().dtype(kLong));
-  std::vector<Tensor> input_unbind = at::unbind(input_sorted, 0);
-  auto last = _unique_dim_cpu_impl(
-    input_unbind.begin(), input_unbind.end(), indices, inverse_indices, counts);
-  input_unbind.erase(last, input_unbind.end());
-  counts = at::narrow(counts, 0, 0, input_unbind.size());
+  counts = at::narrow(counts, 0, 0, unique_rows.size());
 
   // reshape back
-  auto output = at::stack(input_unbind, 0);
+  auto output = input_sorted.index_select(
+      0, at::tensor(unique_rows, self.options().dtype(kLong)));
   auto new_sizes = std::vector<int64_t>(orig_sizes);
   new_sizes[0] = -1;
   output = output.view(new_sizes);
@@ -5,8 +5,11 @@
 #include <algorithm>
 
 #include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vml.h>
+#include <ATen/native/CPUBlas.h>
 
 namespace at { namespace native { namespace {
 
@@ -437,11 +440,206 @@ static void cdist_backward_kernel_impl(Tensor& result, const Tensor& grad, const
 }
 
 
+// Number of rows of x1 and of x2 whose scores are computed by a single GEMM.
+// A block of float scores takes 64 KB, so it stays in cache with the heaps of
+// its rows while they are updated.
+constexpr int64_t kTopkRowBlock = 32;
+constexpr int64_t kTopkColBlock = 512;
+
+// Whether the candidate a, a pair of a cost and a row of x2, is nearer than b.
+// Smaller costs are nearer, nan costs are the farthest, and ties go to the
+// lower row like in topk.
+template <typename scalar_t>
+inline bool topk_nearer(const std::pair<scalar_t, int64_t>& a, const std::pair<scalar_t, int64_t>& b) {
+  if (_isnan(b.first)) {
+    return !_isnan(a.first) || a.second < b.second;
+  }
+  return a.first < b.first || (a.first == b.first && a.second < b.second);
+}
+
+template <typename scalar_t>
+inline scalar_t dot_rows(const scalar_t* a, const scalar_t* b, int64_t size) {
+  using Vec = vec256::Vec256<scalar_t>;
+  if (size == 0) {
+    return scalar_t(0);
+  }
+  return vec256::map2_reduce_all<scalar_t>(
+      [](Vec x, Vec y) { return x * y; }, [](Vec x, Vec y) { return x + y; }, a, b, size);
+}
+
+template <typename scalar_t>
+inline scalar_t squared_dist_rows(const scalar_t* a, const scalar_t* b, int64_t size) {
+  using Vec = vec256::Vec256<scalar_t>;
+  if (size == 0) {
+    return scalar_t(0);
+  }
+  return vec256::map2_reduce_all<scalar_t>(
+      [](Vec x, Vec y) { return (x - y) * (x - y); }, [](Vec x, Vec y) { return x + y; }, a, b, size);
+}
+
+// The k nearest rows of x2 for each row of x1.  The scores of a block of
+// kTopkRowBlock rows of x1 against kTopkColBlock rows of x2 are inner products,
+// computed by a GEMM and turned into costs that rank the rows of x2 like the
+// metric does:
+//
+//     euclidean:      |b|^2 - 2 a.b          (|a|^2 is the same for the row)
+//     inner product:  -a.b
+//     cosine:         -a.b / sqrt(max(|a|^2 |b|^2, eps^2))
+//
+// Each row of x1 keeps a max-heap of its k nearest candidates so far, so
+// memory is O(N k) plus a block of scores per thread, instead of the N x M
+// matrix of cdist.  The values of the k rows found are then computed exactly
+// from the rows, which avoids the cancellation in |a|^2 + |b|^2 - 2 a.b.
+template <typename scalar_t>
+void cdist_topk_impl(
+    const Tensor& values,
+    const Tensor& indices,
+    const Tensor& x1,
+    const Tensor& x2,
+    int64_t k,
+    DistanceMetric metric,
+    double eps_) {
+  using Vec = vec256::Vec256<scalar_t>;
+  using Entry = std::pair<scalar_t, int64_t>;
+  const int64_t n = x1.size(0);
+  const int64_t m = x2.size(0);
+  const int64_t d = x1.size(1);
+  const scalar_t* x1_data = x1.data_ptr<scalar_t>();
+  const scalar_t* x2_data = x2.data_ptr<scalar_t>();
+  scalar_t* values_data = values.data_ptr<scalar_t>();
+  int64_t* indices_data = indices.data_ptr<int64_t>();
+  const scalar_t eps = static_cast<scalar_t>(eps_);
+  const bool is_euclidean = metric == DistanceMetric::EUCLIDEAN;
+
+  std::vector<scalar_t> x2_sq(m);
+  parallel_for(0, m, internal::GRAIN_SIZE / std::max<int64_t>(d, 1), [&](int64_t begin, int64_t end) {
+    for (int64_t j = begin; j < end; j++) {
+      x2_sq[j] = dot_rows(x2_data + j * d, x2_data + j * d, d);
+    }
+  });
+
+  const int64_t num_row_blocks = (n + kTopkRowBlock - 1) / kTopkRowBlock;
+  const int64_t block_cost = kTopkRowBlock * m * std::max<int64_t>(d, 1);
+  const int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / block_cost, 1);
+  parallel_for(0, num_row_blocks, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> scores(kTopkRowBlock * kTopkColBlock);
+    std::vector<Entry> heaps(kTopkRowBlock * k);
+    std::vector<scalar_t> x1_sq(kTopkRowBlock);
+    for (int64_t block = begin; block < end; block++) {
+      const int64_t i0 = block * kTopkRowBlock;
+      const int64_t rows = std::min(kTopkRowBlock, n - i0);
+      const scalar_t* x1_block = x1_data + i0 * d;
+      for (int64_t i = 0; i < rows; i++) {
+        x1_sq[i] = dot_rows(x1_block + i * d, x1_block + i * d, d);
+      }
+
+      // All the rows of the block see the same rows of x2, so their heaps
+      // have the same size.
+      int64_t heap_size = 0;
+      for (int64_t j0 = 0; j0 < m; j0 += kTopkColBlock) {
+        const int64_t cols = std::min(kTopkColBlock, m - j0);
+        // scores[i * cols + j] = x1[i0 + i] . x2[j0 + j], as the column-major
+        // (cols, rows) product of the transposed block of x2 and the block of x1.
+        if (d > 0) {
+          cpublas::gemm(
+              cpublas::Transpose, cpublas::NoTranspose,
+              cols, rows, d,
+              scalar_t(1),
+              x2_data + j0 * d, d,
+              x1_block, d,
+              scalar_t(0),
+              scores.data(), cols);
+        } else {
+          std::fill(scores.begin(), scores.begin() + rows * cols, scalar_t(0));
+        }
+
+        for (int64_t i = 0; i < rows; i++) {
+          scalar_t* row = scores.data() + i * cols;
+          const scalar_t* b_sq = x2_sq.data() + j0;
+          switch (metric) {
+            case DistanceMetric::EUCLIDEAN:
+              vec256::map2([](Vec dot, Vec sq) { return sq - dot - dot; }, row, row, b_sq, cols);
+              break;
+            case DistanceMetric::INNER_PRODUCT:
+              vec256::map([](Vec dot) { return Vec(0) - dot; }, row, row, cols);
+              break;
+            case DistanceMetric::COSINE: {
+              const Vec a_sq(x1_sq[i]);
+              const Vec eps_sq(eps * eps);
+              vec256::map2([&](Vec dot, Vec sq) {
+                return Vec(0) - dot / vec256::maximum(a_sq * sq, eps_sq).sqrt();
+              }, row, row, b_sq, cols);
+              break;
+            }
+          }
+
+          Entry* heap = heaps.data() + i * k;
+          int64_t size = heap_size;
+          for (int64_t j = 0; j < cols; j++) {
+            const Entry candidate(row[j], j0 + j);
+            if (size < k) {
+              heap[size++] = candidate;
+              std::push_heap(heap, heap + size, topk_nearer<scalar_t>);
+            } else if (topk_nearer(candidate, heap[0])) {
+              std::pop_heap(heap, heap + k, topk_nearer<scalar_t>);
+              heap[k - 1] = candidate;
+              std::push_heap(heap, heap + k, topk_nearer<scalar_t>);
+            }
+          }
+        }
+        heap_size = std::min(k, heap_size + cols);
+      }
+
+      for (int64_t i = 0; i < rows; i++) {
+        const scalar_t* a = x1_block + i * d;
+        Entry* heap = heaps.data() + i * k;
+        for (int64_t t = 0; t < k; t++) {
+          const scalar_t* b = x2_data + heap[t].second * d;
+          scalar_t value;
+          switch (metric) {
+            case DistanceMetric::EUCLIDEAN:
+              value = std::sqrt(squared_dist_rows(a, b, d));
+              break;
+            case DistanceMetric::INNER_PRODUCT:
+              value = dot_rows(a, b, d);
+              break;
+            case DistanceMetric::COSINE:
+              value = dot_rows(a, b, d) / std::sqrt(std::max(x1_sq[i] * x2_sq[heap[t].second], eps * eps));
+              break;
+          }
+          heap[t].first = is_euclidean ? value : -value;
+        }
+        std::sort(heap, heap + k, topk_nearer<scalar_t>);
+        scalar_t* values_row = values_data + (i0 + i) * k;
+        int64_t* indices_row = indices_data + (i0 + i) * k;
+        for (int64_t t = 0; t < k; t++) {
+          values_row[t] = is_euclidean ? heap[t].first : -heap[t].first;
+          indices_row[t] = heap[t].second;
+        }
+      }
+    }
+  });
+}
+
+static void cdist_topk_kernel_impl(
+    const Tensor& values,
+    const Tensor& indices,
+    const Tensor& x1,
+    const Tensor& x2,
+    int64_t k,
+    DistanceMetric metric,
+    double eps) {
+  AT_DISPATCH_FLOATING_TYPES(x1.scalar_type(), "cdist_topk", [&] {
+    cdist_topk_impl<scalar_t>(values, indices, x1, x2, k, metric, eps);
+  });
+}
+
 }  // anonymous namespace
 
 REGISTER_DISPATCH(pdist_forward_stub, &pdist_forward_kernel_impl);
 REGISTER_DISPATCH(pdist_backward_stub, &pdist_backward_kernel_impl);
 REGISTER_DISPATCH(cdist_stub, &cdist_kernel_impl);
 REGISTER_DISPATCH(cdist_backward_stub, &cdist_backward_kernel_impl);
+REGISTER_DISPATCH(cdist_topk_stub, &cdist_topk_kernel_impl);
 
 }}  // namespace at::native
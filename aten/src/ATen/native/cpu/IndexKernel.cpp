@@ -2,11 +2,16 @@
 
 #include <cmath>
 #include <iostream>
+#include <numeric>
+#include <vector>
 #include <ATen/Dispatch.h>
+#include <ATen/native/SegmentReduce.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/cpu/AtomicAddFloat.h>
+#include <c10/util/accumulate.h>
 
 namespace at { namespace native {
 namespace {
@@ -278,81 +283,336 @@ void masked_scatter_kernel(TensorIterator& iter, const Tensor& source) {
 }
 
 template <typename scalar_t, typename mask_t, typename func_t>
-void cpu_masked_select_serial_kernel(TensorIterator& iter, const func_t& f) {
+void cpu_masked_select_kernel(TensorIterator& iter, const func_t& f) {
   auto is_mask_bool = std::is_same<mask_t, bool>::value;
-  int64_t offset = 0;
   auto loop = [&](char** data, const int64_t* strides, int64_t n) {
     char* dst = data[0];
     char* src = data[1];
     char* mask = data[2];
+    char* mask_prefix_sum = data[3];
     for (int64_t i = 0; i < n; i++) {
       mask_t mask_value = *(mask_t*)(mask + strides[2] * i);
       if (!is_mask_bool) {
         TORCH_CHECK(mask_value == 0 || mask_value == 1, "Mask tensor can take 0 and 1 values only");
       }
       if (mask_value) {
-        int64_t offset_bytes = offset * sizeof(scalar_t);
+        int64_t offset = *(int64_t*)(mask_prefix_sum + strides[3] * i);
+        int64_t offset_bytes = (offset - 1) * sizeof(scalar_t);
         f(dst, src + strides[1] * i, offset_bytes);
-        offset++;
       }
     }
   };
-  iter.serial_for_each(loop, {0, iter.numel()});
+  iter.for_each(loop);
 }
 
-void masked_select_serial_kernel(TensorIterator& iter, int64_t result_stride) {
+void masked_select_kernel(TensorIterator& iter, int64_t result_stride) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(ScalarType::Bool, ScalarType::BFloat16, ScalarType::Half,
     iter.dtype(), "masked_select", [&] {
       auto mask_dtype = iter.input_dtype(1);
       if (mask_dtype == ScalarType::Bool) {
-        cpu_masked_select_serial_kernel<scalar_t, bool>(iter, [result_stride](char* dst, char* src, int64_t offset) {
+        cpu_masked_select_kernel<scalar_t, bool>(iter, [result_stride](char* dst, char* src, int64_t offset) {
           *(scalar_t*)(dst + offset*result_stride) = *(scalar_t*)src;
         });
       } else {
-        cpu_masked_select_serial_kernel<scalar_t, unsigned char>(iter, [result_stride](char* dst, char* src, int64_t offset) {
+        cpu_masked_select_kernel<scalar_t, unsigned char>(iter, [result_stride](char* dst, char* src, int64_t offset) {
           *(scalar_t*)(dst + offset*result_stride) = *(scalar_t*)src;
         });
       }
     });
 }
 
-template <typename scalar_t, typename mask_t, typename func_t>
-void cpu_masked_select_kernel(TensorIterator& iter, const func_t& f) {
-  auto is_mask_bool = std::is_same<mask_t, bool>::value;
-  auto loop = [&](char** data, const int64_t* strides, int64_t n) {
-    char* dst = data[0];
-    char* src = data[1];
-    char* mask = data[2];
-    char* mask_prefix_sum = data[3];
-    for (int64_t i = 0; i < n; i++) {
-      mask_t mask_value = *(mask_t*)(mask + strides[2] * i);
-      if (!is_mask_bool) {
-        TORCH_CHECK(mask_value == 0 || mask_value == 1, "Mask tensor can take 0 and 1 values only");
-      }
-      if (mask_value) {
-        int64_t offset = *(int64_t*)(mask_prefix_sum + strides[3] * i);
-        int64_t offset_bytes = (offset - 1) * sizeof(scalar_t);
-        f(dst, src + strides[1] * i, offset_bytes);
+// Bitmask of the nonzero elements of the block_size elements at data, for the
+// types with a movemask-style instruction: bit j is set if data[j] != 0.  The
+// compaction loops test a whole block at once, skip it if the mask is 0 and
+// otherwise find the nonzero elements by scanning its set bits, instead of
+// branching on every element.  block_size is 0 for the other types.
+template <typename scalar_t, typename = void>
+struct NonzeroMask {
+  static constexpr int64_t block_size = 0;
+  static uint64_t bits(const scalar_t* data) { return 0; }
+};
+
+#if defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+template <typename scalar_t>
+struct NonzeroMask<scalar_t, typename std::enable_if<sizeof(scalar_t) == 1 && std::is_integral<scalar_t>::value>::type> {
+  static constexpr int64_t block_size = 32;
+  static uint64_t bits(const scalar_t* data) {
+    const __m256i zeros = _mm256_cmpeq_epi8(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), _mm256_setzero_si256());
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(zeros));
+  }
+};
+
+template <typename scalar_t>
+struct NonzeroMask<scalar_t, typename std::enable_if<std::is_same<scalar_t, float>::value || std::is_same<scalar_t, double>::value>::type> {
+  static constexpr int64_t block_size = Vec256<scalar_t>::size();
+  static uint64_t bits(const scalar_t* data) {
+    return ~static_cast<uint64_t>(Vec256<scalar_t>::loadu(data).zero_mask()) & ((uint64_t(1) << block_size) - 1);
+  }
+};
+#endif
+
+template <typename scalar_t>
+int64_t count_nonzero_range(const scalar_t* data, int64_t begin, int64_t end) {
+  int64_t count = 0;
+  int64_t i = begin;
+#if defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+  using Mask = NonzeroMask<scalar_t>;
+  if (Mask::block_size > 0) {
+    for (; i + Mask::block_size <= end; i += Mask::block_size) {
+      count += __builtin_popcountll(Mask::bits(data + i));
+    }
+  }
+#endif
+  for (; i < end; i++) {
+    count += data[i] != scalar_t(0);
+  }
+  return count;
+}
+
+// Calls f(i) for each i in [begin, end) such that data[i] != 0, in order.
+template <typename scalar_t, typename func_t>
+void for_each_nonzero(const scalar_t* data, int64_t begin, int64_t end, const func_t& f) {
+  int64_t i = begin;
+#if defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+  using Mask = NonzeroMask<scalar_t>;
+  if (Mask::block_size > 0) {
+    for (; i + Mask::block_size <= end; i += Mask::block_size) {
+      for (uint64_t bits = Mask::bits(data + i); bits != 0; bits &= bits - 1) {
+        f(i + __builtin_ctzll(bits));
       }
     }
-  };
-  iter.for_each(loop);
+  }
+#endif
+  for (; i < end; i++) {
+    if (data[i] != scalar_t(0)) {
+      f(i);
+    }
+  }
 }
 
-void masked_select_kernel(TensorIterator& iter, int64_t result_stride) {
+// Stream compaction of [0, n) in two passes over one chunk per thread:
+// count(begin, end) returns the number of elements of a chunk to keep, then
+// alloc(total) allocates the output, and write(begin, end, offset) writes the
+// kept elements of a chunk from offset on, the number kept by the chunks
+// before it.  The output is in the order of the input, as with a serial loop.
+template <typename count_t, typename alloc_t, typename write_t>
+void two_pass_compaction(int64_t n, const count_t& count, const alloc_t& alloc, const write_t& write) {
+  const int64_t num_chunks = (n < at::internal::GRAIN_SIZE || at::in_parallel_region())
+    ? 1 : std::min<int64_t>(at::get_num_threads(), at::divup(n, at::internal::GRAIN_SIZE));
+  auto chunk_begin = [&](int64_t c) { return c * n / num_chunks; };
+  std::vector<int64_t> offsets(num_chunks + 1, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      offsets[c + 1] = count(chunk_begin(c), chunk_begin(c + 1));
+    }
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  alloc(offsets[num_chunks]);
+  if (offsets[num_chunks] == 0) {
+    return;
+  }
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      write(chunk_begin(c), chunk_begin(c + 1), offsets[c]);
+    }
+  });
+}
+
+void nonzero_kernel(Tensor& result, const Tensor& self) {
+  const int64_t ndim = self.dim();
+  const auto sizes = self.sizes();
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(ScalarType::Bool, ScalarType::BFloat16, ScalarType::Half,
-    iter.dtype(), "masked_select", [&] {
-      auto mask_dtype = iter.input_dtype(1);
-      if (mask_dtype == ScalarType::Bool) {
-        cpu_masked_select_kernel<scalar_t, bool>(iter, [result_stride](char* dst, char* src, int64_t offset) {
-          *(scalar_t*)(dst + offset*result_stride) = *(scalar_t*)src;
+    self.scalar_type(), "nonzero_cpu", [&] {
+      // bool is compared as bytes, for which there is a movemask.
+      using data_t = typename std::conditional<std::is_same<scalar_t, bool>::value, uint8_t, scalar_t>::type;
+      const data_t* data = reinterpret_cast<const data_t*>(self.data_ptr<scalar_t>());
+      two_pass_compaction(self.numel(),
+        [&](int64_t begin, int64_t end) {
+          return count_nonzero_range(data, begin, end);
+        },
+        [&](int64_t total) {
+          result.resize_({total, ndim});
+        },
+        [&](int64_t begin, int64_t end, int64_t offset) {
+          int64_t* out = result.data_ptr<int64_t>() + offset * ndim;
+          if (ndim == 1) {
+            for_each_nonzero(data, begin, end, [&](int64_t i) { *out++ = i; });
+            return;
+          }
+          for_each_nonzero(data, begin, end, [&](int64_t i) {
+            for (int64_t d = ndim - 1; d >= 0; d--) {
+              out[d] = i % sizes[d];
+              i /= sizes[d];
+            }
+            out += ndim;
+          });
+        });
+    });
+}
+
+void masked_select_compact_kernel(Tensor& result, const Tensor& self, const Tensor& mask) {
+  // A bool mask is read as bytes, like a uint8 one, which can only hold 0 and 1.
+  const uint8_t* mask_data = reinterpret_cast<const uint8_t*>(mask.data_ptr());
+  const bool is_mask_bool = mask.scalar_type() == ScalarType::Bool;
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(ScalarType::Bool, ScalarType::BFloat16, ScalarType::Half,
+    self.scalar_type(), "masked_select", [&] {
+      const scalar_t* self_data = self.data_ptr<scalar_t>();
+      two_pass_compaction(self.numel(),
+        [&](int64_t begin, int64_t end) {
+          if (!is_mask_bool) {
+            TORCH_CHECK(std::all_of(mask_data + begin, mask_data + end, [](uint8_t m) { return m <= 1; }),
+                        "Mask tensor can take 0 and 1 values only");
+          }
+          return count_nonzero_range(mask_data, begin, end);
+        },
+        [&](int64_t total) {
+          result.resize_({total});
+        },
+        [&](int64_t begin, int64_t end, int64_t offset) {
+          const int64_t result_stride = result.stride(0);
+          scalar_t* out = result.data_ptr<scalar_t>() + offset * result_stride;
+          for_each_nonzero(mask_data, begin, end, [&](int64_t i) {
+            *out = self_data[i];
+            out += result_stride;
+          });
+        });
+    });
+}
+
+// dst[k] += src[k] for k < n.
+template <typename scalar_t>
+inline void index_add_row(scalar_t* dst, const scalar_t* src, int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  if (n < Vec::size()) {
+    for (int64_t k = 0; k < n; k++) {
+      dst[k] += src[k];
+    }
+  } else {
+    vec256::map2([](Vec x, Vec y) { return x + y; }, dst, dst, src, n);
+  }
+}
+
+// self is viewed as (outer_size, self_dim_size, inner_size) and source as
+// (outer_size, num_indices, inner_size); row i of source is added to row
+// index[i] of self.  Rows of self hit by several indices can't be updated by
+// several threads at once, so the work is split in one of three ways:
+//
+//   - along outer_size, when there are enough outer slices for all the
+//     threads, since different slices never share rows;
+//   - when self is small compared to the work, each thread accumulates its
+//     share of the indices into a private zeroed copy of self, and the copies
+//     are then summed into self in parallel over its elements;
+//   - otherwise the indices are partitioned by destination, like a counting
+//     sort: the rows of self are split into buckets of consecutive rows and
+//     the positions of the indices are grouped by bucket, keeping their
+//     order.  Each bucket is then handled by a single thread, and the buckets
+//     are split among the threads by their number of indices, so that a few
+//     hot rows (as with the gradient of an embedding) don't leave a thread
+//     with most of the work.  The rows of self are summed in the same order
+//     as in the serial loop.
+void index_add_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& source) {
+  const int64_t self_dim_size = self.dim() == 0 ? 1 : self.size(dim);
+  const int64_t outer_size = self.dim() == 0 ? 1 :
+    c10::multiply_integers(self.sizes().begin(), self.sizes().begin() + dim);
+  const int64_t inner_size = self.dim() == 0 ? 1 :
+    c10::multiply_integers(self.sizes().begin() + dim + 1, self.sizes().end());
+  const int64_t num_indices = index.numel();
+  const int64_t work = outer_size * num_indices * inner_size;
+  const int64_t self_numel = outer_size * self_dim_size * inner_size;
+  const int64_t num_threads = at::get_num_threads();
+
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "index_add_cpu_", [&] {
+    scalar_t* self_ptr = self.data_ptr<scalar_t>();
+    const scalar_t* source_ptr = source.data_ptr<scalar_t>();
+    AT_DISPATCH_INDEX_TYPES(index.scalar_type(), "index_add_cpu_", [&] {
+      const index_t* index_data = index.data_ptr<index_t>();
+
+      auto add_slices = [&](scalar_t* dst, int64_t o, int64_t i_begin, int64_t i_end) {
+        for (int64_t i = i_begin; i < i_end; i++) {
+          index_add_row(dst + (o * self_dim_size + index_data[i]) * inner_size,
+                        source_ptr + (o * num_indices + i) * inner_size, inner_size);
+        }
+      };
+
+      if (num_threads == 1 || work < at::internal::GRAIN_SIZE || at::in_parallel_region()) {
+        for (int64_t o = 0; o < outer_size; o++) {
+          add_slices(self_ptr, o, 0, num_indices);
+        }
+      } else if (outer_size >= num_threads) {
+        const int64_t grain_size = std::max<int64_t>(at::internal::GRAIN_SIZE / (num_indices * inner_size), 1);
+        at::parallel_for(0, outer_size, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t o = begin; o < end; o++) {
+            add_slices(self_ptr, o, 0, num_indices);
+          }
+        });
+      } else if (num_threads * self_numel <= work) {
+        Tensor buffer = at::zeros({num_threads, self_numel}, self.options());
+        scalar_t* buffer_ptr = buffer.data_ptr<scalar_t>();
+        const int64_t grain_size = std::max<int64_t>(at::internal::GRAIN_SIZE / (outer_size * inner_size), 1);
+        at::parallel_for(0, num_indices, grain_size, [&](int64_t begin, int64_t end) {
+          scalar_t* dst = buffer_ptr + at::get_thread_num() * self_numel;
+          for (int64_t o = 0; o < outer_size; o++) {
+            add_slices(dst, o, begin, end);
+          }
+        });
+        at::parallel_for(0, self_numel, std::max<int64_t>(at::internal::GRAIN_SIZE / num_threads, 1), [&](int64_t begin, int64_t end) {
+          for (int64_t t = 0; t < num_threads; t++) {
+            index_add_row(self_ptr + begin, buffer_ptr + t * self_numel + begin, end - begin);
+          }
         });
       } else {
-        cpu_masked_select_kernel<scalar_t, unsigned char>(iter, [result_stride](char* dst, char* src, int64_t offset) {
-          *(scalar_t*)(dst + offset*result_stride) = *(scalar_t*)src;
+        // Row v of self belongs to bucket v * num_buckets / self_dim_size.
+        const int64_t num_buckets = std::min<int64_t>(self_dim_size, 64 * num_threads);
+        const int64_t num_chunks = std::min<int64_t>(num_threads, at::divup(num_indices, at::internal::GRAIN_SIZE));
+        auto bucket = [&](int64_t i) {
+          return static_cast<int64_t>(index_data[i]) * num_buckets / self_dim_size;
+        };
+        auto chunk_begin = [&](int64_t c) { return c * num_indices / num_chunks; };
+
+        // positions[c * num_buckets + b] is first the number of indices of
+        // chunk c in bucket b, then where the next one goes in order.
+        std::vector<int64_t> positions(num_chunks * num_buckets, 0);
+        at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+          for (int64_t c = begin; c < end; c++) {
+            int64_t* counts = positions.data() + c * num_buckets;
+            for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+              counts[bucket(i)]++;
+            }
+          }
+        });
+        std::vector<int64_t> bucket_offsets(num_buckets + 1);
+        int64_t offset = 0;
+        for (int64_t b = 0; b < num_buckets; b++) {
+          bucket_offsets[b] = offset;
+          for (int64_t c = 0; c < num_chunks; c++) {
+            const int64_t count = positions[c * num_buckets + b];
+            positions[c * num_buckets + b] = offset;
+            offset += count;
+          }
+        }
+        bucket_offsets[num_buckets] = offset;
+        std::vector<int64_t> order(num_indices);
+        at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+          for (int64_t c = begin; c < end; c++) {
+            int64_t* next = positions.data() + c * num_buckets;
+            for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+              order[next[bucket(i)]++] = i;
+            }
+          }
+        });
+
+        parallel_for_segments(bucket_offsets.data(), num_buckets, outer_size, inner_size,
+                              [&](int64_t o, int64_t begin, int64_t end) {
+          for (int64_t p = bucket_offsets[begin]; p < bucket_offsets[end]; p++) {
+            const int64_t i = order[p];
+            index_add_row(self_ptr + (o * self_dim_size + index_data[i]) * inner_size,
+                          source_ptr + (o * num_indices + i) * inner_size, inner_size);
+          }
         });
       }
     });
+  });
 }
 
 } // anonymous namespace
@@ -360,9 +620,11 @@ void masked_select_kernel(TensorIterator& iter, int64_t result_stride) {
 REGISTER_DISPATCH(index_stub, &index_kernel);
 REGISTER_DISPATCH(index_fill_stub, &index_fill_kernel);
 REGISTER_DISPATCH(index_put_stub, &index_put_kernel);
+REGISTER_DISPATCH(index_add_stub, &index_add_kernel);
 REGISTER_DISPATCH(masked_fill_stub, &masked_fill_kernel);
-REGISTER_DISPATCH(masked_select_serial_stub, &masked_select_serial_kernel);
 REGISTER_DISPATCH(masked_select_stub, &masked_select_kernel);
+REGISTER_DISPATCH(masked_select_compact_stub, &masked_select_compact_kernel);
+REGISTER_DISPATCH(nonzero_stub, &nonzero_kernel);
 REGISTER_DISPATCH(masked_scatter_stub, &masked_scatter_kernel);
 
 }} // namespace at::native
@@ -3,6 +3,9 @@
 #include <algorithm>
 
 #include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
 #include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/ReduceOps.h>
 #include <ATen/native/ReduceOpsUtils.h>
@@ -18,12 +21,64 @@ namespace at { namespace native { namespace {
 
 using namespace vec256;
 
+// Scans at least this long are split between the threads when there are too
+// few of them to keep every thread busy.
+constexpr int64_t kParallelScanMinSize = at::internal::GRAIN_SIZE;
+
+// Computes a scan over [0, n).  scan(state, begin, end) scans [begin, end)
+// starting from state, reduce(begin, end) returns the total state of
+// [begin, end), and combine(a, b) folds the total b of a range into the
+// total a of the range just before it.
+//
+// A parallel scan splits [0, n) into one block per thread: the first pass
+// reduces every block but the last, the block totals are combined serially
+// into the state each block starts from, and the second pass scans every
+// block from its starting state.  Each element is read twice but written
+// once, and every element is folded into the scan in order, so the result
+// only differs from a serial scan by floating point rounding.
+template <typename state_t, typename reduce_t, typename combine_t, typename scan_t>
+static inline void cpu_cum_scan(
+    int64_t n,
+    bool parallel,
+    state_t init,
+    const reduce_t& reduce,
+    const combine_t& combine,
+    const scan_t& scan) {
+  const int64_t num_blocks = parallel
+    ? std::max<int64_t>(std::min<int64_t>(at::get_num_threads(), n / kParallelScanMinSize), 1)
+    : 1;
+  if (num_blocks == 1) {
+    scan(init, 0, n);
+    return;
+  }
+  auto block_begin = [&](int64_t b) { return n * b / num_blocks; };
+
+  std::vector<state_t> block_init(num_blocks, init);
+  at::parallel_for(0, num_blocks - 1, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      block_init[b + 1] = reduce(block_begin(b), block_begin(b + 1));
+    }
+  });
+  for (int64_t b = 1; b < num_blocks; b++) {
+    block_init[b] = combine(block_init[b - 1], block_init[b]);
+  }
+  at::parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t b = begin; b < end; b++) {
+      scan(block_init[b], block_begin(b), block_begin(b + 1));
+    }
+  });
+}
+
+// Calls f(result_data, result_dim_stride, self_data, self_dim_stride,
+// dim_size, parallel) for every slice of self along dim.  Slices are handed
+// to the threads whole unless they are long and too few to keep every thread
+// busy, in which case they are processed one after the other and f is asked
+// to scan each of them in parallel.
 template <typename scalar_t, typename func_t>
 static inline void cpu_cum_base_kernel(Tensor& result,
     const Tensor& self,
     int64_t dim,
-    const func_t& f,
-    scalar_t init_val) {
+    const func_t& f) {
   if (result.sizes() != self.sizes()) {
     result.resize_as_(self);
   }
@@ -46,6 +101,9 @@ static inline void cpu_cum_base_kernel(Tensor& result,
 
   auto result_dim_stride = ensure_nonempty_stride(result, dim);
   auto self_dim_stride = ensure_nonempty_stride(self, dim);
+  auto dim_size = ensure_nonempty_size(self, dim);
+  const bool parallel_within_slices =
+    dim_size >= kParallelScanMinSize && iter.numel() < at::get_num_threads();
 
   auto loop = [&](char** data, const int64_t* strides, int64_t n) {
     auto* result_data_bytes = data[0];
@@ -54,73 +112,294 @@ static inline void cpu_cum_base_kernel(Tensor& result,
     for (int64_t i = 0; i < n; ++i) {
       f(
         (scalar_t*)result_data_bytes, result_dim_stride,
-        (scalar_t*)self_data_bytes, self_dim_stride, init_val
+        (scalar_t*)self_data_bytes, self_dim_stride,
+        dim_size, parallel_within_slices
       );
       result_data_bytes += strides[0];
       self_data_bytes += strides[1];
     }
   };
 
-  iter.for_each(loop);
+  const int64_t grain_size = parallel_within_slices
+    ? std::numeric_limits<int64_t>::max()
+    : std::max<int64_t>(at::internal::GRAIN_SIZE / dim_size, 1);
+  at::parallel_for(0, iter.numel(), grain_size, [&](int64_t begin, int64_t end) {
+    iter.serial_for_each(loop, {begin, end});
+  });
+}
+
+// Reduces a contiguous block with the vectorized op when the scan accumulates
+// in scalar_t; returns false if it did not.
+template <typename scalar_t, typename acc_t, typename vec_op_t>
+static inline typename std::enable_if<
+    std::is_same<scalar_t, acc_t>::value && std::is_arithmetic<scalar_t>::value, bool>::type
+cum_vec_reduce(const vec_op_t& vec_op, const scalar_t* data, int64_t size, acc_t& out) {
+  out = vec256::reduce_all<scalar_t>(vec_op, data, size);
+  return true;
+}
+
+template <typename scalar_t, typename acc_t, typename vec_op_t>
+static inline typename std::enable_if<
+    !(std::is_same<scalar_t, acc_t>::value && std::is_arithmetic<scalar_t>::value), bool>::type
+cum_vec_reduce(const vec_op_t& vec_op, const scalar_t* data, int64_t size, acc_t& out) {
+  return false;
+}
+
+template <typename scalar_t, typename acc_t>
+static inline bool cum_vec_reduce(std::nullptr_t, const scalar_t* data, int64_t size, acc_t& out) {
+  return false;
+}
+
+// Shifts the lanes of x up by k, i.e. towards the higher indices, filling the
+// lowest k lanes with those of fill.
+template <typename scalar_t>
+static inline Vec256<scalar_t> cum_shift_lanes(const Vec256<scalar_t>& x, const Vec256<scalar_t>& fill, int k) {
+  constexpr int size = Vec256<scalar_t>::size();
+  __at_align32__ scalar_t buffer[2 * size];
+  fill.store(buffer);
+  x.store(buffer + size);
+  return Vec256<scalar_t>::loadu(buffer + size - k);
+}
+
+// Broadcasts the highest lane of x.
+template <typename scalar_t>
+static inline Vec256<scalar_t> cum_broadcast_last(const Vec256<scalar_t>& x) {
+  constexpr int size = Vec256<scalar_t>::size();
+  __at_align32__ scalar_t buffer[size];
+  x.store(buffer);
+  return Vec256<scalar_t>(buffer[size - 1]);
+}
+
+#if defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+
+static inline Vec256<double> cum_shift_lanes(const Vec256<double>& x, const Vec256<double>& fill, int k) {
+  if (k == 1) {
+    return _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x93), fill, 0x1);
+  }
+  return _mm256_permute2f128_pd(x, fill, 0x02);
+}
+
+static inline Vec256<double> cum_broadcast_last(const Vec256<double>& x) {
+  return _mm256_permute4x64_pd(x, 0xff);
+}
+
+static inline Vec256<int64_t> cum_shift_lanes(const Vec256<int64_t>& x, const Vec256<int64_t>& fill, int k) {
+  if (k == 1) {
+    return _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x93), fill, 0x3);
+  }
+  return _mm256_permute2x128_si256(x, fill, 0x02);
+}
+
+static inline Vec256<int64_t> cum_broadcast_last(const Vec256<int64_t>& x) {
+  return _mm256_permute4x64_epi64(x, 0xff);
+}
+
+#endif
+
+// Scans the contiguous data into the contiguous result with the vectorized op
+// when the scan accumulates in scalar_t.  Every vector is scanned in registers
+// in log2(size) shift and op steps, then combined with the broadcast total of
+// the previous ones.  Updates acc and returns the number of elements scanned,
+// the remainder is left to the scalar loop.
+template <typename scalar_t, typename acc_t, typename vec_op_t>
+static inline typename std::enable_if<
+    std::is_same<scalar_t, acc_t>::value && std::is_arithmetic<scalar_t>::value, int64_t>::type
+cum_vec_scan(const vec_op_t& vec_op, const scalar_t* data, scalar_t* out, int64_t size, acc_t identity, acc_t& acc) {
+  using Vec = Vec256<scalar_t>;
+  const Vec fill(identity);
+  Vec carry(acc);
+  int64_t d = 0;
+  for (; d < size - (size % Vec::size()); d += Vec::size()) {
+    Vec x = Vec::loadu(data + d);
+    for (int k = 1; k < Vec::size(); k *= 2) {
+      Vec shifted = cum_shift_lanes(x, fill, k);
+      x = vec_op(x, shifted);
+    }
+    x = vec_op(carry, x);
+    x.store(out + d);
+    carry = cum_broadcast_last(x);
+  }
+  if (d > 0) {
+    acc = out[d - 1];
+  }
+  return d;
+}
+
+template <typename scalar_t, typename acc_t, typename vec_op_t>
+static inline typename std::enable_if<
+    !(std::is_same<scalar_t, acc_t>::value && std::is_arithmetic<scalar_t>::value), int64_t>::type
+cum_vec_scan(const vec_op_t& vec_op, const scalar_t* data, scalar_t* out, int64_t size, acc_t identity, acc_t& acc) {
+  return 0;
+}
+
+template <typename scalar_t, typename acc_t>
+static inline int64_t cum_vec_scan(std::nullptr_t, const scalar_t* data, scalar_t* out, int64_t size, acc_t identity, acc_t& acc) {
+  return 0;
+}
+
+// Scans with an associative op on acc_t, of which init_val is the identity.
+// vec_op is the same op on Vec256<scalar_t>, or nullptr if there is none.
+template <typename scalar_t, typename acc_t, typename op_t, typename vec_op_t>
+static inline void cpu_cum_op_kernel(Tensor& result,
+    const Tensor& self,
+    int64_t dim,
+    const op_t& op,
+    acc_t init_val,
+    const vec_op_t& vec_op) {
+  cpu_cum_base_kernel<scalar_t>(result, self, dim, [&] (
+    scalar_t* result_data, int64_t result_dim_stride,
+    const scalar_t* self_data, int64_t self_dim_stride,
+    int64_t dim_size, bool parallel) {
+      auto reduce = [&](int64_t begin, int64_t end) -> acc_t {
+        acc_t acc = init_val;
+        if (self_dim_stride == 1 && cum_vec_reduce<scalar_t, acc_t>(vec_op, self_data + begin, end - begin, acc)) {
+          return acc;
+        }
+        for (int64_t i = begin; i < end; ++i) {
+          acc = op(acc, static_cast<acc_t>(self_data[i * self_dim_stride]));
+        }
+        return acc;
+      };
+      auto scan = [&](acc_t acc, int64_t begin, int64_t end) {
+        if (self_dim_stride == 1 && result_dim_stride == 1) {
+          begin += cum_vec_scan<scalar_t, acc_t>(
+            vec_op, self_data + begin, result_data + begin, end - begin, init_val, acc);
+        }
+        for (int64_t i = begin; i < end; ++i) {
+          acc = op(acc, static_cast<acc_t>(self_data[i * self_dim_stride]));
+          result_data[i * result_dim_stride] = static_cast<scalar_t>(acc);
+        }
+      };
+      cpu_cum_scan(dim_size, parallel, init_val, reduce, op, scan);
+    }
+  );
 }
 
 static void cumsum_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "cumsum_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          cum_number += self_data[i * self_dim_stride];
-          result_data[i * result_dim_stride] = (scalar_t)cum_number;
-        }
-      }, /*init_val=*/ 0
-    );
+    using acc_t = at::acc_type<scalar_t, false>;
+    cpu_cum_op_kernel<scalar_t, acc_t>(result, self, wrap_dim,
+      [](acc_t x, acc_t y) { return x + y; }, /*init_val=*/ acc_t(0),
+      [](Vec256<scalar_t>& x, Vec256<scalar_t>& y) { return x + y; });
   });
 }
 
 static void cumprod_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(self.scalar_type(), "cumprod_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        auto cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          cum_number *= self_data[i * self_dim_stride];
-          result_data[i * result_dim_stride] = (scalar_t)cum_number;
-        }
-      }, /*init_val=*/ 1
-    );
+    using acc_t = at::acc_type<scalar_t, false>;
+    cpu_cum_op_kernel<scalar_t, acc_t>(result, self, wrap_dim,
+      [](acc_t x, acc_t y) { return x * y; }, /*init_val=*/ acc_t(1),
+      [](Vec256<scalar_t>& x, Vec256<scalar_t>& y) { return x * y; });
   });
 }
 
 static void logcumsumexp_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
   auto wrap_dim = maybe_wrap_dim(dim, self.dim());
-  int64_t self_dim_size = ensure_nonempty_size(self, wrap_dim);
 
   AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "logcumsumexp_out_cpu", [&] {
-    cpu_cum_base_kernel<scalar_t>(result, self, wrap_dim, [&] (
-      scalar_t* result_data, auto result_dim_stride,
-      const scalar_t* self_data, auto self_dim_stride, scalar_t init_val) {
-        scalar_t cum_number = (at::acc_type<scalar_t, false>)init_val;
-        for (int64_t i = 0; i < self_dim_size; ++i) {
-          scalar_t x = self_data[i * self_dim_stride];
+    // Reference : https://www.tensorflow.org/api_docs/python/tf/math/cumulative_logsumexp
+    // -inf is the identity, including for -inf itself, so that blocks of a
+    // parallel scan may start with it.
+    auto log_add_exp = [](scalar_t x, scalar_t y) -> scalar_t {
+      scalar_t min = std::min(x, y);
+      scalar_t max = std::max(x, y);
+      if (min == max && std::isinf(min)) {
+        return min;
+      }
+      return std::log1p(std::exp(min - max)) + max;
+    };
+    cpu_cum_op_kernel<scalar_t, scalar_t>(result, self, wrap_dim,
+      log_add_exp, /*init_val=*/ -std::numeric_limits<scalar_t>::infinity(),
+      /*vec_op=*/ nullptr);
+  });
+}
+
+// Scans of the running maximum (or minimum) and of its index.  An element
+// replaces the running value if it is NaN, or if the running value is not
+// NaN and the element is greater (or less) or equal, so that the index of
+// the last occurrence is reported.
+template <typename scalar_t, typename Operation>
+static inline void cpu_cummax_cummin_kernel(
+    const Tensor& self,
+    Tensor& values,
+    Tensor& indices,
+    int64_t dim) {
+  using state_t = std::pair<scalar_t, int64_t>;
+  Operation op;
+  auto replaces = [&](scalar_t x, scalar_t out) {
+    return _isnan(x) || (!_isnan(out) && op(x, out));
+  };
+
+  auto iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .resize_outputs(false)
+    .declare_static_shape(self.sizes(), /*squash_dim=*/dim)
+    .add_output(values)
+    .add_output(indices)
+    .add_input(self)
+    .build();
 
-          // Reference : https://www.tensorflow.org/api_docs/python/tf/math/cumulative_logsumexp
-          auto log_add_exp = [](scalar_t x, scalar_t y) -> scalar_t {
-            return std::log1p(std::exp(std::min(x, y) - std::max(x, y))) + std::max(x, y);
-          };
-          cum_number = log_add_exp(x, cum_number);
-          result_data[i * result_dim_stride] = static_cast<scalar_t>(cum_number);
+  auto values_dim_stride = ensure_nonempty_stride(values, dim);
+  auto indices_dim_stride = ensure_nonempty_stride(indices, dim);
+  auto self_dim_stride = ensure_nonempty_stride(self, dim);
+  auto dim_size = ensure_nonempty_size(self, dim);
+  const bool parallel_within_slices =
+    dim_size >= kParallelScanMinSize && iter.numel() < at::get_num_threads();
+
+  auto loop = [&](char** data, const int64_t* strides, int64_t n) {
+    for (int64_t k = 0; k < n; ++k) {
+      auto* values_data = (scalar_t*)(data[0] + k * strides[0]);
+      auto* indices_data = (int64_t*)(data[1] + k * strides[1]);
+      const auto* self_data = (const scalar_t*)(data[2] + k * strides[2]);
+
+      auto reduce = [&](int64_t begin, int64_t end) {
+        state_t out(self_data[begin * self_dim_stride], begin);
+        for (int64_t i = begin + 1; i < end; ++i) {
+          scalar_t x = self_data[i * self_dim_stride];
+          if (replaces(x, out.first)) {
+            out = state_t(x, i);
+          }
         }
-      }, /*init_val=*/ -std::numeric_limits<scalar_t>::infinity()
-    );
+        return out;
+      };
+      auto combine = [&](const state_t& before, const state_t& after) {
+        return replaces(after.first, before.first) ? after : before;
+      };
+      auto scan = [&](state_t out, int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          scalar_t x = self_data[i * self_dim_stride];
+          if (replaces(x, out.first)) {
+            out = state_t(x, i);
+          }
+          values_data[i * values_dim_stride] = out.first;
+          indices_data[i * indices_dim_stride] = out.second;
+        }
+      };
+      cpu_cum_scan(dim_size, parallel_within_slices, state_t(self_data[0], 0), reduce, combine, scan);
+    }
+  };
+
+  const int64_t grain_size = parallel_within_slices
+    ? std::numeric_limits<int64_t>::max()
+    : std::max<int64_t>(at::internal::GRAIN_SIZE / dim_size, 1);
+  at::parallel_for(0, iter.numel(), grain_size, [&](int64_t begin, int64_t end) {
+    iter.serial_for_each(loop, {begin, end});
+  });
+}
+
+static void cummax_cpu_kernel(const Tensor& self, Tensor& values, Tensor& indices, int64_t dim) {
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "cummax_cpu", [&] {
+    cpu_cummax_cummin_kernel<scalar_t, std::greater_equal<scalar_t>>(self, values, indices, dim);
+  });
+}
+
+static void cummin_cpu_kernel(const Tensor& self, Tensor& values, Tensor& indices, int64_t dim) {
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "cummin_cpu", [&] {
+    cpu_cummax_cummin_kernel<scalar_t, std::less_equal<scalar_t>>(self, values, indices, dim);
   });
 }
 
@@ -400,5 +679,7 @@ REGISTER_DISPATCH(argmin_stub, &argmin_kernel_impl);
 REGISTER_DISPATCH(cumprod_stub, &cumprod_cpu_kernel);
 REGISTER_DISPATCH(cumsum_stub, &cumsum_cpu_kernel);
 REGISTER_DISPATCH(logcumsumexp_stub, &logcumsumexp_cpu_kernel);
+REGISTER_DISPATCH(cummax_stub, &cummax_cpu_kernel);
+REGISTER_DISPATCH(cummin_stub, &cummin_cpu_kernel);
 
 }}  // namespace at::native
@@ -294,7 +294,9 @@ struct cpu_scatter_gather_base_kernel {
             }
           }
         };
-        iter.for_each(loop);
+        // Each element of the iterator does index_dim_size updates, and
+        // different elements never update the same element of self.
+        iter.for_each(loop, std::max<int64_t>(at::internal::GRAIN_SIZE / index_dim_size, 1));
       }
     );
   }
@@ -316,7 +318,50 @@ void scatter_fill_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, Sca
     self, dim, index, value, "scatter_fill_cpu_", tensor_assign);
 }
 
+// When index is the same along every dimension but dim, such as
+// indices.view(-1, 1).expand(-1, d) in the gradient of an embedding,
+// scatter_add_ adds whole slices of src to slices of self, like index_add_.
+// The generic kernel can only split the work along the other dimensions, so
+// such updates are sent to index_add_stub, which also splits the indices
+// among the threads.  Returns false if the update is not of this form.
+bool scatter_add_as_index_add(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  const auto dtype = self.scalar_type();
+  if (self.dim() == 0 || !self.is_contiguous() ||
+      dtype == ScalarType::Bool || dtype == ScalarType::Half || dtype == ScalarType::BFloat16) {
+    return false;
+  }
+  for (int64_t d = 0; d < self.dim(); d++) {
+    if (d != dim && (index.size(d) != self.size(d) || (index.size(d) > 1 && index.stride(d) != 0))) {
+      return false;
+    }
+  }
+  Tensor index_1d = index.as_strided({index.size(dim)}, {index.stride(dim)}).contiguous();
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t min_index = index_1d.min().item<int64_t>();
+  const int64_t max_index = index_1d.max().item<int64_t>();
+  TORCH_CHECK(min_index >= 0 && max_index < self_dim_size,
+    "index ", min_index < 0 ? min_index : max_index,
+    " is out of bounds for dimension ", dim,
+    " with size ", self_dim_size);
+  Tensor source = src;
+  for (int64_t d = 0; d < self.dim(); d++) {
+    if (source.size(d) != index.size(d)) {
+      source = source.narrow(d, 0, index.size(d));
+    }
+  }
+  index_add_stub(kCPU, self, dim, index_1d, source.contiguous());
+  return true;
+}
+
 void scatter_add_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  if (index.numel() > 0) {
+    dim = maybe_wrap_dim(dim, self.dim());
+    scatter_gather_dtype_check("scatter_add_", self, index, src);
+    scatter_shape_check(self, dim, index, src);
+    if (scatter_add_as_index_add(self, dim, index, src)) {
+      return;
+    }
+  }
   cpu_scatter_gather_base_kernel<>()(
     self, dim, index, src,
     "scatter_add_", reduce_add);
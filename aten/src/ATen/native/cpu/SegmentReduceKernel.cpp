@@ -0,0 +1,209 @@
+#include <ATen/native/SegmentReduce.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <limits>
+
+namespace at { namespace native {
+
+namespace {
+
+template <typename scalar_t>
+inline scalar_t max_propagate_nan(scalar_t a, scalar_t b) {
+  return (_isnan(a) || a > b) ? a : b;
+}
+
+template <typename scalar_t>
+scalar_t empty_segment_value(SegmentReductionType reduction, const c10::optional<Scalar>& initial) {
+  if (initial.has_value()) {
+    return initial->to<scalar_t>();
+  }
+  switch (reduction) {
+    case SegmentReductionType::MAX:
+      return std::numeric_limits<scalar_t>::has_infinity
+          ? -std::numeric_limits<scalar_t>::infinity() : std::numeric_limits<scalar_t>::lowest();
+    case SegmentReductionType::MEAN:
+      return std::numeric_limits<scalar_t>::quiet_NaN();
+    default:
+      return scalar_t(0);
+  }
+}
+
+// Reduces the length rows of inner_size elements starting at data into out,
+// starting from initial if it is not null.  The rows of a segment are
+// contiguous, so they are read once in order; the inner loops are vectorized
+// along the rows, or along the segment when it is a single column.
+template <typename scalar_t>
+void segment_reduce_rows(
+    SegmentReductionType reduction,
+    const scalar_t* data,
+    int64_t length,
+    int64_t inner_size,
+    const scalar_t* initial,
+    scalar_t* out) {
+  using Vec = vec256::Vec256<scalar_t>;
+  if (reduction == SegmentReductionType::MAX) {
+    if (inner_size == 1) {
+      out[0] = vec256::reduce_all<scalar_t>(
+          [](Vec& x, Vec& y) { return vec256::maximum(x, y); }, data, length);
+    } else {
+      std::copy(data, data + inner_size, out);
+      for (int64_t j = 1; j < length; j++) {
+        const scalar_t* row = data + j * inner_size;
+        int64_t k = 0;
+        for (; k < inner_size - (inner_size % Vec::size()); k += Vec::size()) {
+          vec256::maximum(Vec::loadu(out + k), Vec::loadu(row + k)).store(out + k);
+        }
+        for (; k < inner_size; k++) {
+          out[k] = max_propagate_nan(out[k], row[k]);
+        }
+      }
+    }
+    if (initial) {
+      const scalar_t init = *initial;
+      vec256::map([init](Vec x) { return vec256::maximum(x, Vec(init)); }, out, out, inner_size);
+    }
+    return;
+  }
+  // SUM and MEAN
+  if (inner_size == 1) {
+    out[0] = vec256::reduce_all<scalar_t>(
+        [](Vec& x, Vec& y) { return x + y; }, data, length);
+  } else {
+    std::copy(data, data + inner_size, out);
+    for (int64_t j = 1; j < length; j++) {
+      const scalar_t* row = data + j * inner_size;
+      int64_t k = 0;
+      for (; k < inner_size - (inner_size % Vec::size()); k += Vec::size()) {
+        (Vec::loadu(out + k) + Vec::loadu(row + k)).store(out + k);
+      }
+      for (; k < inner_size; k++) {
+        out[k] += row[k];
+      }
+    }
+  }
+  if (initial) {
+    const scalar_t init = *initial;
+    vec256::map([init](Vec x) { return x + Vec(init); }, out, out, inner_size);
+  }
+  if (reduction == SegmentReductionType::MEAN) {
+    const scalar_t scale = scalar_t(1) / static_cast<scalar_t>(length);
+    vec256::map([scale](Vec x) { return x * Vec(scale); }, out, out, inner_size);
+  }
+}
+
+void segment_reduce_cpu_kernel(
+    const Tensor& output,
+    const Tensor& data,
+    const Tensor& offsets,
+    SegmentReductionType reduction,
+    const c10::optional<Scalar>& initial) {
+  const int64_t outer_size = output.size(0);
+  const int64_t num_segments = output.size(1);
+  const int64_t inner_size = output.size(2);
+  const int64_t total_length = data.size(1);
+  AT_DISPATCH_INDEX_TYPES(offsets.scalar_type(), "segment_reduce", [&] {
+    const index_t* offsets_data = offsets.data_ptr<index_t>();
+    AT_DISPATCH_ALL_TYPES(data.scalar_type(), "segment_reduce", [&] {
+      const scalar_t* data_ptr = data.data_ptr<scalar_t>();
+      scalar_t* output_ptr = output.data_ptr<scalar_t>();
+      const scalar_t empty = empty_segment_value<scalar_t>(reduction, initial);
+      const scalar_t* initial_ptr = initial.has_value() ? &empty : nullptr;
+      // Each segment is reduced by a single thread, into its own row of the
+      // output, so no synchronization is needed.
+      parallel_for_segments(offsets_data, num_segments, outer_size, inner_size, [&](int64_t o, int64_t begin, int64_t end) {
+        for (int64_t s = begin; s < end; s++) {
+          const int64_t start = offsets_data[s];
+          const int64_t length = offsets_data[s + 1] - offsets_data[s];
+          scalar_t* out = output_ptr + (o * num_segments + s) * inner_size;
+          if (length == 0) {
+            std::fill(out, out + inner_size, empty);
+            continue;
+          }
+          segment_reduce_rows<scalar_t>(
+              reduction, data_ptr + (o * total_length + start) * inner_size, length, inner_size, initial_ptr, out);
+        }
+      });
+    });
+  });
+}
+
+void segment_reduce_backward_cpu_kernel(
+    const Tensor& grad_data,
+    const Tensor& grad,
+    const Tensor& output,
+    const Tensor& data,
+    const Tensor& offsets,
+    SegmentReductionType reduction) {
+  const int64_t outer_size = grad.size(0);
+  const int64_t num_segments = grad.size(1);
+  const int64_t inner_size = grad.size(2);
+  const int64_t total_length = data.size(1);
+  AT_DISPATCH_INDEX_TYPES(offsets.scalar_type(), "segment_reduce_backward", [&] {
+    const index_t* offsets_data = offsets.data_ptr<index_t>();
+    AT_DISPATCH_FLOATING_TYPES(data.scalar_type(), "segment_reduce_backward", [&] {
+      using Vec = vec256::Vec256<scalar_t>;
+      const scalar_t* grad_ptr = grad.data_ptr<scalar_t>();
+      const scalar_t* output_ptr = output.data_ptr<scalar_t>();
+      const scalar_t* data_ptr = data.data_ptr<scalar_t>();
+      scalar_t* grad_data_ptr = grad_data.data_ptr<scalar_t>();
+      parallel_for_segments(offsets_data, num_segments, outer_size, inner_size, [&](int64_t o, int64_t begin, int64_t end) {
+        // Number of elements equal to the max, for each column of a segment.
+        std::vector<scalar_t> counts(reduction == SegmentReductionType::MAX ? inner_size : 0);
+        for (int64_t s = begin; s < end; s++) {
+          const int64_t start = offsets_data[s];
+          const int64_t length = offsets_data[s + 1] - offsets_data[s];
+          const scalar_t* g = grad_ptr + (o * num_segments + s) * inner_size;
+          const scalar_t* out = output_ptr + (o * num_segments + s) * inner_size;
+          const scalar_t* rows = data_ptr + (o * total_length + start) * inner_size;
+          scalar_t* grad_rows = grad_data_ptr + (o * total_length + start) * inner_size;
+          if (reduction == SegmentReductionType::SUM) {
+            for (int64_t j = 0; j < length; j++) {
+              std::copy(g, g + inner_size, grad_rows + j * inner_size);
+            }
+          } else if (reduction == SegmentReductionType::MEAN) {
+            const scalar_t scale = scalar_t(1) / static_cast<scalar_t>(length);
+            for (int64_t j = 0; j < length; j++) {
+              vec256::map([scale](Vec x) { return x * Vec(scale); }, grad_rows + j * inner_size, g, inner_size);
+            }
+          } else {
+            const int64_t vec_end = inner_size - (inner_size % Vec::size());
+            std::fill(counts.begin(), counts.end(), scalar_t(0));
+            for (int64_t j = 0; j < length; j++) {
+              const scalar_t* row = rows + j * inner_size;
+              int64_t k = 0;
+              for (; k < vec_end; k += Vec::size()) {
+                (Vec::loadu(counts.data() + k) + Vec::loadu(row + k).eq(Vec::loadu(out + k))).store(counts.data() + k);
+              }
+              for (; k < inner_size; k++) {
+                counts[k] += row[k] == out[k];
+              }
+            }
+            for (int64_t j = 0; j < length; j++) {
+              const scalar_t* row = rows + j * inner_size;
+              scalar_t* grad_row = grad_rows + j * inner_size;
+              int64_t k = 0;
+              for (; k < vec_end; k += Vec::size()) {
+                const Vec share = Vec::loadu(g + k) / Vec::loadu(counts.data() + k);
+                Vec::blendv(Vec(0), share, Vec::loadu(row + k) == Vec::loadu(out + k)).store(grad_row + k);
+              }
+              for (; k < inner_size; k++) {
+                grad_row[k] = row[k] == out[k] ? g[k] / counts[k] : scalar_t(0);
+              }
+            }
+          }
+        }
+      });
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(segment_reduce_stub, &segment_reduce_cpu_kernel);
+REGISTER_DISPATCH(segment_reduce_backward_stub, &segment_reduce_backward_cpu_kernel);
+
+}} // namespace at::native
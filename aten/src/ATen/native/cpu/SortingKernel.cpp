@@ -7,6 +7,12 @@
 #include <ATen/native/CompositeRandomAccessor.h>
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
+#include <ATen/native/ReduceOpsUtils.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <cstring>
+#include <limits>
+#include <queue>
 
 namespace at { namespace native {
 
@@ -29,6 +35,7 @@ void _dim_apply(
     Tensor& indices,
     int64_t dim,
     const std::string& method_name,
+    int64_t grain_size,
     const func_t& f) {
   dim = maybe_wrap_dim(dim, values.dim());
   TORCH_CHECK(
@@ -69,7 +76,11 @@ void _dim_apply(
         }
       };
 
-      iter.for_each(loop);
+      // TensorIterator::for_each only goes parallel with at least GRAIN_SIZE
+      // slices, which leaves a few long slices to a single thread.
+      at::parallel_for(0, iter.numel(), grain_size, [&](int64_t begin, int64_t end) {
+        iter.serial_for_each(loop, {begin, end});
+      });
     }
   );
 }
@@ -92,21 +103,296 @@ struct KeyValueCompDesc {
   }
 };
 
+// Slices with at least this many elements are sorted (or searched for their
+// top k) one at a time with all the threads working on each slice; smaller
+// slices are processed in parallel with each other.
+constexpr int64_t kParallelSortMinSize = 1 << 16;
+
+// Maps scalar_t to an unsigned integer whose order is the ascending order of
+// the values used by sort, with NaN sorted last, so that the values can be
+// sorted with a radix sort on the bits of their keys.  Keys are not decoded:
+// the sorted values are gathered from the input, which keeps the bits of
+// every value, e.g. NaN payloads, intact.
+template <typename scalar_t, typename Enable = void>
+struct RadixSortKey;
+
+template <typename scalar_t>
+struct RadixSortKey<scalar_t, typename std::enable_if<std::is_integral<scalar_t>::value>::type> {
+  using key_t = typename std::make_unsigned<
+    typename std::conditional<std::is_same<scalar_t, bool>::value, uint8_t, scalar_t>::type>::type;
+  static constexpr key_t kSignBit = std::is_signed<scalar_t>::value
+    ? static_cast<key_t>(key_t(1) << (sizeof(key_t) * 8 - 1)) : key_t(0);
+
+  static key_t encode(scalar_t value) {
+    return static_cast<key_t>(static_cast<key_t>(value) ^ kSignBit);
+  }
+};
+
+template <>
+struct RadixSortKey<float> {
+  using key_t = uint32_t;
+  static constexpr key_t kSignBit = key_t(1) << 31;
+
+  // Flipping the sign bit of positive values and all the bits of negative
+  // values orders the bit patterns like the values.  NaNs, whatever their sign
+  // and payload, map to the largest key.
+  static key_t encode(float value) {
+    if (_isnan(value)) {
+      return std::numeric_limits<key_t>::max();
+    }
+    key_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & kSignBit) ? ~bits : (bits | kSignBit);
+  }
+};
+
+template <typename scalar_t>
+struct can_radix_sort : std::integral_constant<bool,
+  std::is_integral<scalar_t>::value || std::is_same<scalar_t, float>::value> {};
+
+// Splits [0, n) into one chunk per thread.
+inline std::vector<int64_t> _chunk_bounds(int64_t n, int64_t min_chunk_size) {
+  const int64_t num_chunks = std::max<int64_t>(
+    std::min<int64_t>(at::get_num_threads(), n / min_chunk_size), 1);
+  std::vector<int64_t> bounds(num_chunks + 1);
+  for (int64_t c = 0; c <= num_chunks; c++) {
+    bounds[c] = n * c / num_chunks;
+  }
+  return bounds;
+}
+
+// LSD radix sort of a slice, one byte per pass.  Each pass counts the digits
+// of every chunk of keys in parallel, turns the counts into per-chunk output
+// offsets, and scatters the chunks in parallel, which keeps every pass stable.
+// Passes in which all the keys share the same digit, e.g. the high bytes of
+// small int64 ids, are skipped.
+template <typename scalar_t>
+void _radix_sort_slice(
+    scalar_t* values, int64_t values_dim_stride,
+    int64_t* indices, int64_t indices_dim_stride,
+    int64_t dim_size, bool descending) {
+  using Key = RadixSortKey<scalar_t>;
+  using key_t = typename Key::key_t;
+  constexpr int kRadixBits = 8;
+  constexpr int64_t kRadix = 1 << kRadixBits;
+
+  std::vector<scalar_t> input(dim_size);
+  std::vector<key_t> keys(dim_size), keys_tmp(dim_size);
+  std::vector<int64_t> idx(dim_size), idx_tmp(dim_size);
+  at::parallel_for(0, dim_size, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      input[i] = values[i * values_dim_stride];
+      const key_t key = Key::encode(input[i]);
+      // NaN is sorted first in descending order, and inverting the keys
+      // reverses their order.
+      keys[i] = descending ? static_cast<key_t>(~key) : key;
+      idx[i] = i;
+    }
+  });
+
+  const auto bounds = _chunk_bounds(dim_size, at::internal::GRAIN_SIZE);
+  const int64_t num_chunks = bounds.size() - 1;
+  std::vector<int64_t> counts(num_chunks * kRadix);
+  key_t* src_keys = keys.data();
+  key_t* dst_keys = keys_tmp.data();
+  int64_t* src_idx = idx.data();
+  int64_t* dst_idx = idx_tmp.data();
+
+  for (int shift = 0; shift < static_cast<int>(sizeof(key_t) * 8); shift += kRadixBits) {
+    std::fill(counts.begin(), counts.end(), 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+      for (int64_t c = chunk_begin; c < chunk_end; c++) {
+        int64_t* chunk_counts = counts.data() + c * kRadix;
+        for (int64_t i = bounds[c]; i < bounds[c + 1]; i++) {
+          chunk_counts[(src_keys[i] >> shift) & (kRadix - 1)]++;
+        }
+      }
+    });
+
+    // counts[c][d] becomes the position of the first key of chunk c with
+    // digit d: keys are ordered by digit first and by chunk second.
+    bool single_digit = false;
+    int64_t offset = 0;
+    for (int64_t d = 0; d < kRadix; d++) {
+      const int64_t offset_begin = offset;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        const int64_t count = counts[c * kRadix + d];
+        counts[c * kRadix + d] = offset;
+        offset += count;
+      }
+      single_digit |= (offset - offset_begin == dim_size);
+    }
+    if (single_digit) {
+      continue;
+    }
+
+    at::parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+      for (int64_t c = chunk_begin; c < chunk_end; c++) {
+        int64_t* chunk_offsets = counts.data() + c * kRadix;
+        for (int64_t i = bounds[c]; i < bounds[c + 1]; i++) {
+          const int64_t pos = chunk_offsets[(src_keys[i] >> shift) & (kRadix - 1)]++;
+          dst_keys[pos] = src_keys[i];
+          dst_idx[pos] = src_idx[i];
+        }
+      }
+    });
+    std::swap(src_keys, dst_keys);
+    std::swap(src_idx, dst_idx);
+  }
+
+  at::parallel_for(0, dim_size, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      values[i * values_dim_stride] = input[src_idx[i]];
+      indices[i * indices_dim_stride] = src_idx[i];
+    }
+  });
+}
+
+// Returns the number of elements of a that are among the first k elements of
+// the stable merge of a and b.
+template <typename T, typename Comp>
+int64_t _merge_path_split(
+    const T* a, int64_t a_size, const T* b, int64_t b_size, int64_t k, const Comp& comp) {
+  int64_t lo = std::max<int64_t>(0, k - b_size);
+  int64_t hi = std::min<int64_t>(k, a_size);
+  while (lo < hi) {
+    const int64_t mid = lo + (hi - lo) / 2;
+    // a[mid] is merged before b[k - mid - 1] unless it is greater.
+    if (!comp(b[k - mid - 1], a[mid])) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Merges a and b into out, splitting the output evenly among the threads.
+template <typename T, typename Comp>
+void _parallel_merge(
+    const T* a, int64_t a_size, const T* b, int64_t b_size, T* out, const Comp& comp) {
+  at::parallel_for(0, a_size + b_size, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    const int64_t a_begin = _merge_path_split(a, a_size, b, b_size, begin, comp);
+    const int64_t a_end = _merge_path_split(a, a_size, b, b_size, end, comp);
+    std::merge(
+      a + a_begin, a + a_end,
+      b + (begin - a_begin), b + (end - a_end),
+      out + begin, comp);
+  });
+}
+
+// Merge sort of a slice: every thread sorts a chunk of a contiguous copy of
+// the (value, index) pairs, and the sorted runs are merged pairwise until one
+// is left.
+template <typename scalar_t>
+void _merge_sort_slice(
+    scalar_t* values, int64_t values_dim_stride,
+    int64_t* indices, int64_t indices_dim_stride,
+    int64_t dim_size, bool descending) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  std::vector<elem_t> buffer(dim_size), buffer_tmp(dim_size);
+  at::parallel_for(0, dim_size, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      buffer[i] = elem_t(values[i * values_dim_stride], i);
+    }
+  });
+
+  auto sort_and_merge = [&](const auto& comp) {
+    auto bounds = _chunk_bounds(dim_size, at::internal::GRAIN_SIZE);
+    at::parallel_for(0, bounds.size() - 1, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+      for (int64_t c = chunk_begin; c < chunk_end; c++) {
+        std::sort(buffer.data() + bounds[c], buffer.data() + bounds[c + 1], comp);
+      }
+    });
+
+    elem_t* src = buffer.data();
+    elem_t* dst = buffer_tmp.data();
+    while (bounds.size() > 2) {
+      const int64_t num_runs = bounds.size() - 1;
+      std::vector<int64_t> merged_bounds;
+      for (int64_t r = 0; r < num_runs; r += 2) {
+        const int64_t begin = bounds[r];
+        const int64_t mid = bounds[r + 1];
+        if (r + 1 < num_runs) {
+          const int64_t end = bounds[r + 2];
+          _parallel_merge(src + begin, mid - begin, src + mid, end - mid, dst + begin, comp);
+        } else {
+          std::copy(src + begin, src + mid, dst + begin);
+        }
+        merged_bounds.push_back(begin);
+      }
+      merged_bounds.push_back(dim_size);
+      bounds = std::move(merged_bounds);
+      std::swap(src, dst);
+    }
+
+    at::parallel_for(0, dim_size, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        values[i * values_dim_stride] = src[i].first;
+        indices[i * indices_dim_stride] = src[i].second;
+      }
+    });
+  };
+
+  if (descending) {
+    sort_and_merge([](const elem_t& x, const elem_t& y) -> bool {
+      return (_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first);
+    });
+  } else {
+    sort_and_merge([](const elem_t& x, const elem_t& y) -> bool {
+      return (!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first);
+    });
+  }
+}
+
+template <typename scalar_t>
+typename std::enable_if<can_radix_sort<scalar_t>::value, void>::type
+_parallel_sort_slice(
+    scalar_t* values, int64_t values_dim_stride,
+    int64_t* indices, int64_t indices_dim_stride,
+    int64_t dim_size, bool descending) {
+  _radix_sort_slice(values, values_dim_stride, indices, indices_dim_stride, dim_size, descending);
+}
+
+// double would take twice as many radix passes as float, and Half has no
+// cheap key, so they are merge sorted.
+template <typename scalar_t>
+typename std::enable_if<!can_radix_sort<scalar_t>::value, void>::type
+_parallel_sort_slice(
+    scalar_t* values, int64_t values_dim_stride,
+    int64_t* indices, int64_t indices_dim_stride,
+    int64_t dim_size, bool descending) {
+  _merge_sort_slice(values, values_dim_stride, indices, indices_dim_stride, dim_size, descending);
+}
+
 static void sort_kernel(
     Tensor& values,
     Tensor& indices,
     int64_t dim,
     bool descending) {
   dim = maybe_wrap_dim(dim, values.dim());
-  _fill_indices(indices, dim);
+  const int64_t slice_size = values.dim() == 0 ? 1 : values.size(dim);
+  const bool parallel_within_slices = slice_size >= kParallelSortMinSize;
+  if (!parallel_within_slices) {
+    _fill_indices(indices, dim);
+  }
+  // Large slices are sorted one after the other, each by all the threads.
+  const int64_t grain_size = parallel_within_slices
+    ? std::numeric_limits<int64_t>::max()
+    : std::max<int64_t>(at::internal::GRAIN_SIZE / std::max<int64_t>(slice_size, 1), 1);
   _dim_apply(
     values, indices, dim,
-    "sort_cpu", [&](
+    "sort_cpu", grain_size, [&](
       auto* values, int64_t values_dim_stride,
       auto* indices, int64_t indices_dim_stride,
       int64_t dim_size
     ) {
       using scalar_t = typename std::remove_pointer<decltype(values)>::type;
+      if (parallel_within_slices) {
+        _parallel_sort_slice(
+          values, values_dim_stride, indices, indices_dim_stride, dim_size, descending);
+        return;
+      }
       auto values_accessor = StridedRandomAccessor<scalar_t>(
         values, values_dim_stride);
       auto indices_accessor = StridedRandomAccessor<int64_t>(
@@ -127,6 +413,173 @@ static void sort_kernel(
   );
 }
 
+// Calls f with the comparator that orders the elements of topk: NaN is the
+// largest value, as in sort.
+template <typename scalar_t, typename func_t>
+void _topk_dispatch_comp(bool largest, const func_t& f) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  if (largest) {
+    f([](const elem_t& x, const elem_t& y) -> bool {
+      return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+    });
+  } else {
+    f([](const elem_t& x, const elem_t& y) -> bool {
+      return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
+    });
+  }
+}
+
+// Collects the top k elements of data[begin:end] in queue, unordered.
+// Elements are only kept if they beat the k-th best element seen so far, so
+// for k much smaller than the slice most of it is skipped after a short
+// warmup; contiguous data is checked a block at a time with the vectorized
+// maximum (or minimum) of the block, which propagates NaN.
+template <typename scalar_t, typename Comp>
+void _topk_select(
+    const scalar_t* data, int64_t stride, int64_t begin, int64_t end,
+    int64_t k, bool largest, const Comp& comp,
+    std::vector<std::pair<scalar_t, int64_t>>& queue) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  using Vec = vec256::Vec256<scalar_t>;
+  constexpr int64_t kBlockSize = 4 * Vec::size();
+  const int64_t capacity = std::max<int64_t>(2 * k, kBlockSize);
+
+  queue.clear();
+  queue.reserve(std::min<int64_t>(capacity, end - begin));
+  bool full = false;
+  scalar_t threshold = scalar_t(0);
+  auto beats_threshold = [&](scalar_t x) {
+    return !full || comp(elem_t(x, 0), elem_t(threshold, 0));
+  };
+  auto shrink = [&]() {
+    std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(), comp);
+    queue.resize(k);
+    threshold = queue[k - 1].first;
+    full = true;
+  };
+  auto push = [&](int64_t i) {
+    const scalar_t x = data[i * stride];
+    if (beats_threshold(x)) {
+      queue.emplace_back(x, i);
+      if (static_cast<int64_t>(queue.size()) >= capacity) {
+        shrink();
+      }
+    }
+  };
+
+  int64_t i = begin;
+  if (stride == 1) {
+    for (; i + kBlockSize <= end; i += kBlockSize) {
+      if (full) {
+        const scalar_t* block = data + i;
+        Vec bound = Vec::loadu(block);
+        for (int64_t j = Vec::size(); j < kBlockSize; j += Vec::size()) {
+          bound = largest ? vec256::maximum(bound, Vec::loadu(block + j))
+                          : vec256::minimum(bound, Vec::loadu(block + j));
+        }
+        __at_align32__ scalar_t bound_arr[Vec::size()];
+        bound.store(bound_arr);
+        bool may_beat = false;
+        for (int64_t j = 0; j < Vec::size(); j++) {
+          may_beat |= _isnan<scalar_t>(bound_arr[j]) || beats_threshold(bound_arr[j]);
+        }
+        if (!may_beat) {
+          continue;
+        }
+      }
+      for (int64_t j = i; j < i + kBlockSize; j++) {
+        push(j);
+      }
+    }
+  }
+  for (; i < end; i++) {
+    push(i);
+  }
+  if (static_cast<int64_t>(queue.size()) > k) {
+    shrink();
+  }
+}
+
+template <typename scalar_t>
+void _topk_slice(
+    const scalar_t* self_data, int64_t self_dim_stride, int64_t dim_size,
+    scalar_t* values, int64_t values_dim_stride,
+    int64_t* indices, int64_t indices_dim_stride,
+    int64_t k, bool largest, bool sorted, bool parallel) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  const auto bounds = parallel
+    ? _chunk_bounds(dim_size, at::internal::GRAIN_SIZE)
+    : std::vector<int64_t>{0, dim_size};
+  const int64_t num_chunks = bounds.size() - 1;
+
+  // When the threads would keep about as many candidates as there are
+  // elements, sorting the whole slice is cheaper.
+  if (num_chunks > 1 && k * num_chunks > dim_size) {
+    std::vector<scalar_t> sorted_values(dim_size);
+    std::vector<int64_t> sorted_indices(dim_size);
+    at::parallel_for(0, dim_size, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        sorted_values[i] = self_data[i * self_dim_stride];
+      }
+    });
+    _parallel_sort_slice(
+      sorted_values.data(), 1, sorted_indices.data(), 1, dim_size, /*descending=*/largest);
+    for (int64_t i = 0; i < k; i++) {
+      values[i * values_dim_stride] = sorted_values[i];
+      indices[i * indices_dim_stride] = sorted_indices[i];
+    }
+    return;
+  }
+
+  _topk_dispatch_comp<scalar_t>(largest, [&](const auto& comp) {
+    if (num_chunks == 1) {
+      std::vector<elem_t> queue;
+      _topk_select(self_data, self_dim_stride, 0, dim_size, k, largest, comp, queue);
+      if (sorted) {
+        std::sort(queue.begin(), queue.end(), comp);
+      }
+      for (int64_t i = 0; i < k; i++) {
+        values[i * values_dim_stride] = queue[i].first;
+        indices[i * indices_dim_stride] = queue[i].second;
+      }
+      return;
+    }
+
+    // Every thread selects and sorts the top k of its chunk, and the sorted
+    // candidates are merged until k elements are out.
+    std::vector<std::vector<elem_t>> queues(num_chunks);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t chunk_begin, int64_t chunk_end) {
+      for (int64_t c = chunk_begin; c < chunk_end; c++) {
+        _topk_select(self_data, self_dim_stride, bounds[c], bounds[c + 1], k, largest, comp, queues[c]);
+        std::sort(queues[c].begin(), queues[c].end(), comp);
+      }
+    });
+
+    using head_t = std::pair<elem_t, int64_t>;
+    auto head_comp = [&](const head_t& x, const head_t& y) {
+      // the priority queue pops its largest element first
+      return comp(y.first, x.first);
+    };
+    std::priority_queue<head_t, std::vector<head_t>, decltype(head_comp)> heads(head_comp);
+    std::vector<int64_t> positions(num_chunks, 0);
+    for (int64_t c = 0; c < num_chunks; c++) {
+      if (!queues[c].empty()) {
+        heads.emplace(queues[c][0], c);
+      }
+    }
+    for (int64_t i = 0; i < k; i++) {
+      const head_t head = heads.top();
+      heads.pop();
+      values[i * values_dim_stride] = head.first.first;
+      indices[i * indices_dim_stride] = head.first.second;
+      const int64_t c = head.second;
+      if (++positions[c] < static_cast<int64_t>(queues[c].size())) {
+        heads.emplace(queues[c][positions[c]], c);
+      }
+    }
+  });
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -135,69 +588,43 @@ static void topk_kernel(
     int64_t dim,
     bool largest,
     bool sorted) {
+  if (k == 0) {
+    return;
+  }
+  const int64_t dim_size = self.dim() == 0 ? 1 : self.size(dim);
+  // Like sort, large slices are processed one at a time by all the threads.
+  const bool parallel_within_slices = dim_size >= kParallelSortMinSize;
+  const int64_t grain_size = parallel_within_slices
+    ? std::numeric_limits<int64_t>::max()
+    : std::max<int64_t>(at::internal::GRAIN_SIZE / dim_size, 1);
+
+  auto self_restrided = restride_dim(self, dim, values.sizes());
+  auto iter = TensorIteratorConfig()
+    .check_all_same_dtype(false)
+    .resize_outputs(false)
+    .declare_static_shape(values.sizes(), /*squash_dim=*/dim)
+    .add_output(values)
+    .add_output(indices)
+    .add_input(self_restrided)
+    .build();
+
+  const int64_t values_dim_stride = values.dim() == 0 ? 1 : values.stride(dim);
+  const int64_t indices_dim_stride = indices.dim() == 0 ? 1 : indices.stride(dim);
+  const int64_t self_dim_stride = self.dim() == 0 ? 1 : self.stride(dim);
+
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
-    dim_apply(
-        {self, values, indices},
-        dim,
-        [&](int64_t i, TensorList tl) {
-          auto tmp_values = tl[0].accessor<scalar_t, 1>();
-          auto mode_values = tl[1].accessor<scalar_t, 1>();
-          auto mode_indices = tl[2].accessor<int64_t, 1>();
-
-          auto n = tmp_values.size(0);
-          auto use_partial_sort = k * 64 <= n;
-
-          using elem_t = std::pair<scalar_t, int64_t>;
-          std::vector<elem_t> queue(n);
-          for (int64_t j = 0; j < n; j++) {
-            queue[j].first = tmp_values[j];
-            queue[j].second = j;
-          }
-
-          // we want NaN to be sorted as top for numpy compatibility
-          if (use_partial_sort) {
-            if (largest) {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-            } else {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-            }
-          } else {
-            if (largest) {
-              std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k - 1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                  });
-              }
-            } else {
-              std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k -1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                  });
-              }
-            }
-          }
-
-          for (int64_t j = 0; j < k; j++) {
-            mode_values[j] = queue[j].first;
-            mode_indices[j] = queue[j].second;
-          }
-        });
+    auto loop = [&](char** data, const int64_t* strides, int64_t n) {
+      for (int64_t i = 0; i < n; ++i) {
+        _topk_slice(
+          reinterpret_cast<const scalar_t*>(data[2] + i * strides[2]), self_dim_stride, dim_size,
+          reinterpret_cast<scalar_t*>(data[0] + i * strides[0]), values_dim_stride,
+          reinterpret_cast<int64_t*>(data[1] + i * strides[1]), indices_dim_stride,
+          k, largest, sorted, parallel_within_slices);
+      }
+    };
+    at::parallel_for(0, iter.numel(), grain_size, [&](int64_t begin, int64_t end) {
+      iter.serial_for_each(loop, {begin, end});
+    });
   });
 }
 
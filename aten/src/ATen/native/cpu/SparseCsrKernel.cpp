@@ -0,0 +1,201 @@
+#include <ATen/native/sparse/SparseCsrTensorMath.h>
+
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/TensorIterator.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native {
+
+namespace {
+
+// Rows of a sparse matrix can have very different numbers of elements, so
+// splitting the rows evenly among the threads can leave most of the work to a
+// single thread.  Instead, rows are split so that each thread gets about the
+// same number of elements: the work of the first i rows, counting one unit
+// per element plus one per row for its overhead, is crow[i] + i.  It is
+// strictly increasing in i, so the rows whose work starts in the range
+// [begin, end) that parallel_for gives to a thread are found by binary search.
+template <typename index_t>
+int64_t first_row_with_work(const index_t* crow, int64_t nrows, int64_t work) {
+  int64_t lo = 0, hi = nrows;
+  while (lo < hi) {
+    int64_t mid = lo + (hi - lo) / 2;
+    if (static_cast<int64_t>(crow[mid]) + mid < work) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+template <typename index_t, typename F>
+void parallel_for_rows(const index_t* crow, int64_t nrows, int64_t cost_per_unit, const F& f) {
+  const int64_t total_work = static_cast<int64_t>(crow[nrows]) + nrows;
+  const int64_t grain_size = std::max<int64_t>(at::internal::GRAIN_SIZE / std::max<int64_t>(cost_per_unit, 1), 1);
+  at::parallel_for(0, total_work, grain_size, [&](int64_t begin, int64_t end) {
+    const int64_t row_begin = first_row_with_work(crow, nrows, begin);
+    const int64_t row_end = first_row_with_work(crow, nrows, end);
+    for (int64_t i = row_begin; i < row_end; i++) {
+      f(i);
+    }
+  });
+}
+
+// y += a * x
+template <typename scalar_t>
+inline void axpy_row(int64_t n, scalar_t a, const scalar_t* x, scalar_t* y) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const Vec a_vec(a);
+  int64_t j = 0;
+  for (; j < n - (n % Vec::size()); j += Vec::size()) {
+    Vec y_vec = vec256::fmadd(a_vec, Vec::loadu(x + j), Vec::loadu(y + j));
+    y_vec.store(y + j);
+  }
+  for (; j < n; j++) {
+    y[j] += a * x[j];
+  }
+}
+
+void sparse_csr_addmm_kernel(
+    const Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    Scalar alpha) {
+  const int64_t nrows = result.size(0);
+  const int64_t dim_k = result.size(1);
+  AT_DISPATCH_INDEX_TYPES(crow_indices.scalar_type(), "sparse_csr_addmm", [&] {
+    const index_t* crow = crow_indices.data_ptr<index_t>();
+    const index_t* col = col_indices.data_ptr<index_t>();
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX(values.scalar_type(), "sparse_csr_addmm", [&] {
+      const scalar_t* values_data = values.data_ptr<scalar_t>();
+      const int64_t values_stride = values.stride(0);
+      const scalar_t* dense_data = dense.data_ptr<scalar_t>();
+      scalar_t* result_data = result.data_ptr<scalar_t>();
+      const scalar_t alpha_ = alpha.to<scalar_t>();
+      // Each row of the result is owned by one thread.
+      parallel_for_rows(crow, nrows, dim_k, [&](int64_t i) {
+        scalar_t* result_row = result_data + i * dim_k;
+        for (int64_t p = crow[i]; p < crow[i + 1]; p++) {
+          axpy_row<scalar_t>(dim_k, alpha_ * values_data[p * values_stride], dense_data + col[p] * dim_k, result_row);
+        }
+      });
+    });
+  });
+}
+
+void dense_sparse_csr_addmm_kernel(
+    const Tensor& result,
+    const Tensor& dense,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    Scalar alpha) {
+  const int64_t nrows = result.size(0);
+  const int64_t dim_j = dense.size(1);
+  const int64_t dim_k = result.size(1);
+  AT_DISPATCH_INDEX_TYPES(crow_indices.scalar_type(), "dense_sparse_csr_addmm", [&] {
+    const index_t* crow = crow_indices.data_ptr<index_t>();
+    const index_t* col = col_indices.data_ptr<index_t>();
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX(values.scalar_type(), "dense_sparse_csr_addmm", [&] {
+      const scalar_t* values_data = values.data_ptr<scalar_t>();
+      const int64_t values_stride = values.stride(0);
+      const scalar_t* dense_data = dense.data_ptr<scalar_t>();
+      scalar_t* result_data = result.data_ptr<scalar_t>();
+      const scalar_t alpha_ = alpha.to<scalar_t>();
+      // Row r of the result is the sum of the rows of sparse weighted by row
+      // r of dense, so each thread scatters the sparse rows into the result
+      // rows it owns, without transposing sparse.
+      const int64_t cost_per_row = static_cast<int64_t>(crow[dim_j]) + dim_j;
+      const int64_t grain_size = std::max<int64_t>(at::internal::GRAIN_SIZE / std::max<int64_t>(cost_per_row, 1), 1);
+      at::parallel_for(0, nrows, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t r = begin; r < end; r++) {
+          const scalar_t* dense_row = dense_data + r * dim_j;
+          scalar_t* result_row = result_data + r * dim_k;
+          for (int64_t j = 0; j < dim_j; j++) {
+            const scalar_t a = alpha_ * dense_row[j];
+            for (int64_t p = crow[j]; p < crow[j + 1]; p++) {
+              result_row[col[p]] += a * values_data[p * values_stride];
+            }
+          }
+        }
+      });
+    });
+  });
+}
+
+void sparse_csr_sampled_mm_kernel(
+    const Tensor& values,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& mat1,
+    const Tensor& mat2_t,
+    Scalar alpha) {
+  const int64_t nrows = mat1.size(0);
+  const int64_t dim_k = mat1.size(1);
+  AT_DISPATCH_INDEX_TYPES(crow_indices.scalar_type(), "sparse_csr_sampled_mm", [&] {
+    const index_t* crow = crow_indices.data_ptr<index_t>();
+    const index_t* col = col_indices.data_ptr<index_t>();
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX(values.scalar_type(), "sparse_csr_sampled_mm", [&] {
+      using acc_t = at::acc_type<scalar_t, /*is_cuda=*/false>;
+      const scalar_t* mat1_data = mat1.data_ptr<scalar_t>();
+      const scalar_t* mat2_t_data = mat2_t.data_ptr<scalar_t>();
+      scalar_t* values_data = values.data_ptr<scalar_t>();
+      const acc_t alpha_ = alpha.to<acc_t>();
+      parallel_for_rows(crow, nrows, dim_k, [&](int64_t i) {
+        const scalar_t* mat1_row = mat1_data + i * dim_k;
+        for (int64_t p = crow[i]; p < crow[i + 1]; p++) {
+          const scalar_t* mat2_row = mat2_t_data + col[p] * dim_k;
+          acc_t dot = 0;
+          for (int64_t k = 0; k < dim_k; k++) {
+            dot += static_cast<acc_t>(mat1_row[k]) * static_cast<acc_t>(mat2_row[k]);
+          }
+          values_data[p] = static_cast<scalar_t>(alpha_ * dot);
+        }
+      });
+    });
+  });
+}
+
+void sparse_csr_addmv_kernel(
+    const Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& vec,
+    Scalar alpha) {
+  const int64_t nrows = result.size(0);
+  AT_DISPATCH_INDEX_TYPES(crow_indices.scalar_type(), "sparse_csr_addmv", [&] {
+    const index_t* crow = crow_indices.data_ptr<index_t>();
+    const index_t* col = col_indices.data_ptr<index_t>();
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX(values.scalar_type(), "sparse_csr_addmv", [&] {
+      using acc_t = at::acc_type<scalar_t, /*is_cuda=*/false>;
+      const scalar_t* values_data = values.data_ptr<scalar_t>();
+      const int64_t values_stride = values.stride(0);
+      const scalar_t* vec_data = vec.data_ptr<scalar_t>();
+      scalar_t* result_data = result.data_ptr<scalar_t>();
+      const acc_t alpha_ = alpha.to<acc_t>();
+      parallel_for_rows(crow, nrows, 1, [&](int64_t i) {
+        acc_t dot = 0;
+        for (int64_t p = crow[i]; p < crow[i + 1]; p++) {
+          dot += static_cast<acc_t>(values_data[p * values_stride]) * static_cast<acc_t>(vec_data[col[p]]);
+        }
+        result_data[i] += static_cast<scalar_t>(alpha_ * dot);
+      });
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(sparse_csr_addmm_stub, &sparse_csr_addmm_kernel);
+REGISTER_DISPATCH(dense_sparse_csr_addmm_stub, &dense_sparse_csr_addmm_kernel);
+REGISTER_DISPATCH(sparse_csr_sampled_mm_stub, &sparse_csr_sampled_mm_kernel);
+REGISTER_DISPATCH(sparse_csr_addmv_stub, &sparse_csr_addmv_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,240 @@
+// Basic functions on sparse CSR tensors
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/SparseTensorUtils.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+using at::sparse::SparseTensor;
+
+// NOTE [ Sparse CSR tensors ]
+//
+// A sparse CSR tensor is a 2-D matrix in compressed sparse row format, see
+// SparseCsrTensorImpl.h for its invariants.  Only CPU tensors with scalar
+// values are supported.  The layout is meant for sparse-dense products, so the
+// ops it supports are:
+//
+//   - construction with sparse_csr_tensor, and conversions from and to dense
+//     and COO tensors with to_sparse_csr, to_dense and to_sparse;
+//   - the accessors crow_indices, col_indices, values and _nnz;
+//   - transpose and t, which return a new CSR tensor;
+//   - mm and addmm with a dense matrix on either side, and mv.
+//
+// Autograd only flows to the dense operands of the products.  Like indices()
+// of a COO tensor, crow_indices() and col_indices() are non-differentiable.
+
+/******************************************************************************
+ * access methods
+ ******************************************************************************/
+
+int64_t _nnz_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->nnz();
+}
+
+Tensor crow_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->crow_indices().alias();
+}
+
+Tensor col_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->col_indices().alias();
+}
+
+Tensor values_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->values().alias();
+}
+
+/******************************************************************************
+ * creation methods
+ ******************************************************************************/
+
+void _validate_sparse_csr_tensor_args(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, IntArrayRef size) {
+  // the following checks are redundant because they are also checked in
+  // SparseCsrTensorImpl::set_member_tensors, but we need them to read the indices.
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be 2-D, but got size ", size);
+  TORCH_CHECK(crow_indices.layout() == kStrided && col_indices.layout() == kStrided && values.layout() == kStrided,
+      "expected crow_indices, col_indices and values to be strided tensors");
+  TORCH_CHECK(crow_indices.dim() == 1 && col_indices.dim() == 1 && values.dim() == 1,
+      "crow_indices, col_indices and values must be 1-D, but got ", crow_indices.dim(), "-D, ",
+      col_indices.dim(), "-D and ", values.dim(), "-D tensors");
+  TORCH_CHECK(crow_indices.scalar_type() == col_indices.scalar_type(),
+      "crow_indices and col_indices must have the same dtype, but got ", crow_indices.scalar_type(), " and ", col_indices.scalar_type());
+  TORCH_CHECK(crow_indices.scalar_type() == kInt || crow_indices.scalar_type() == kLong,
+      "crow_indices and col_indices must be int32 or int64 tensors, but got ", crow_indices.scalar_type());
+  TORCH_CHECK(crow_indices.size(0) == size[0] + 1,
+      "crow_indices must have nrows + 1 = ", size[0] + 1, " elements, but got ", crow_indices.size(0));
+  TORCH_CHECK(col_indices.size(0) == values.size(0),
+      "col_indices and values must have the same number of elements, but got ", col_indices.size(0), " and ", values.size(0));
+
+  const int64_t nrows = size[0];
+  const int64_t ncols = size[1];
+  const int64_t nnz = col_indices.size(0);
+  AT_DISPATCH_INDEX_TYPES(crow_indices.scalar_type(), "_validate_sparse_csr_tensor_args", [&] {
+    Tensor crow = crow_indices.contiguous();
+    Tensor col = col_indices.contiguous();
+    const index_t* crow_data = crow.data_ptr<index_t>();
+    const index_t* col_data = col.data_ptr<index_t>();
+    TORCH_CHECK(crow_data[0] == 0, "crow_indices must start with 0, but got ", crow_data[0]);
+    TORCH_CHECK(crow_data[nrows] == nnz,
+        "crow_indices must end with nnz = ", nnz, ", but got ", crow_data[nrows]);
+    for (int64_t i = 0; i < nrows; i++) {
+      TORCH_CHECK(crow_data[i] <= crow_data[i + 1],
+          "crow_indices must be non-decreasing, but crow_indices[", i, "] = ", crow_data[i],
+          " > crow_indices[", i + 1, "] = ", crow_data[i + 1]);
+    }
+    for (int64_t p = 0; p < nnz; p++) {
+      TORCH_CHECK(col_data[p] >= 0 && col_data[p] < ncols,
+          "size is inconsistent with col_indices: there are ", ncols, " columns but found column index ", col_data[p]);
+    }
+  });
+}
+
+// NOTE: _sparse_csr_tensor_unsafe() differs from sparse_csr_tensor() in that
+// we don't check the indices, see _sparse_coo_tensor_unsafe.
+Tensor _sparse_csr_tensor_unsafe(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values_, IntArrayRef size, const TensorOptions& options) {
+  TORCH_CHECK(!options.has_layout() || options.layout() == kSparseCsr, "expected sparse CSR layout, but got layout ", options.layout());
+  TORCH_CHECK(!options.pinned_memory(), "Only dense CPU tensors can be pinned");
+  TORCH_CHECK(values_.device().type() == DeviceType::CPU, "sparse CSR tensors are only supported on CPU, but values are on ", values_.device());
+  Tensor values = options.has_dtype() ? values_.to(typeMetaToScalarType(options.dtype())) : values_;
+
+  SparseCsrTensor self = at::detail::make_tensor<SparseCsrTensorImpl>(
+      DispatchKeySet(DispatchKey::SparseCsrCPU), values.dtype());
+  // NOTE: like in new_with_dims_and_tensor_sparse, we shallow-copy the member
+  // tensors so that they don't contain AutogradMeta.
+  auto shallow_copy = [](const Tensor& t) {
+    return Tensor(t.unsafeGetTensorImpl()->shallow_copy_and_detach(
+        /*version_counter=*/t.unsafeGetTensorImpl()->version_counter(),
+        /*allow_tensor_metadata_change=*/true));
+  };
+  get_sparse_csr_impl(self)->set_member_tensors(
+      shallow_copy(crow_indices), shallow_copy(col_indices), shallow_copy(values), size);
+  return self;
+}
+
+Tensor sparse_csr_tensor(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, IntArrayRef size, const TensorOptions& options) {
+  at::native::_validate_sparse_csr_tensor_args(crow_indices, col_indices, values, size);
+  // Dispatched, so that the gradient flows back to values.
+  return at::_sparse_csr_tensor_unsafe(crow_indices, col_indices, values, size, options);
+}
+
+Tensor sparse_csr_tensor(const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, const TensorOptions& options) {
+  // If the size is not given, the number of columns is inferred as the max
+  // column index + 1.
+  TORCH_CHECK(crow_indices.dim() == 1, "crow_indices must be 1-D, but got ", crow_indices.dim(), "-D tensor");
+  int64_t nrows = crow_indices.size(0) - 1;
+  int64_t ncols = col_indices.numel() > 0 ? col_indices.max().item<int64_t>() + 1 : 0;
+  return at::native::sparse_csr_tensor(crow_indices, col_indices, values, {nrows, ncols}, options);
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+namespace {
+
+// Compresses the row indices of nnz elements, sorted by row, into nrows + 1
+// row offsets.
+template <typename index_t>
+Tensor compress_rows(const Tensor& rows_, int64_t nrows) {
+  Tensor rows = rows_.contiguous();
+  Tensor crow_indices = at::zeros({nrows + 1}, rows.options());
+  const index_t* rows_data = rows.data_ptr<index_t>();
+  index_t* crow_data = crow_indices.data_ptr<index_t>();
+  for (int64_t p = 0; p < rows.numel(); p++) {
+    crow_data[rows_data[p] + 1]++;
+  }
+  for (int64_t i = 0; i < nrows; i++) {
+    crow_data[i + 1] += crow_data[i];
+  }
+  return crow_indices;
+}
+
+// The inverse of compress_rows.
+template <typename index_t>
+Tensor expand_rows(const Tensor& crow_indices, int64_t nnz) {
+  Tensor rows = at::empty({nnz}, crow_indices.options());
+  const index_t* crow_data = crow_indices.data_ptr<index_t>();
+  index_t* rows_data = rows.data_ptr<index_t>();
+  const int64_t nrows = crow_indices.size(0) - 1;
+  at::parallel_for(0, nrows, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      std::fill(rows_data + crow_data[i], rows_data + crow_data[i + 1], static_cast<index_t>(i));
+    }
+  });
+  return rows;
+}
+
+} // namespace
+
+Tensor sparse_csr_to_dense(const SparseCsrTensor& self, c10::optional<ScalarType> dtype) {
+  TORCH_CHECK(!dtype.has_value(), "dtype argument is not supported by sparse_csr_to_dense");
+  auto impl = get_sparse_csr_impl(self);
+  const Tensor& values = impl->values();
+  Tensor result = at::zeros(self.sizes(), values.options());
+  const int64_t nrows = self.size(0);
+  const int64_t ncols = self.size(1);
+  AT_DISPATCH_INDEX_TYPES(impl->crow_indices().scalar_type(), "sparse_csr_to_dense", [&] {
+    const index_t* crow_data = impl->crow_indices().data_ptr<index_t>();
+    const index_t* col_data = impl->col_indices().data_ptr<index_t>();
+    AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(kHalf, kBFloat16, kBool, values.scalar_type(), "sparse_csr_to_dense", [&] {
+      const scalar_t* values_data = values.data_ptr<scalar_t>();
+      const int64_t values_stride = values.stride(0);
+      scalar_t* result_data = result.data_ptr<scalar_t>();
+      // Rows are written by a single thread, so duplicates can be summed
+      // without synchronization.
+      at::parallel_for(0, nrows, at::internal::GRAIN_SIZE / std::max<int64_t>(ncols, 1), [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          scalar_t* row = result_data + i * ncols;
+          for (int64_t p = crow_data[i]; p < crow_data[i + 1]; p++) {
+            row[col_data[p]] += values_data[p * values_stride];
+          }
+        }
+      });
+    });
+  });
+  return result;
+}
+
+SparseTensor sparse_csr_to_sparse(const SparseCsrTensor& self) {
+  auto impl = get_sparse_csr_impl(self);
+  Tensor rows = AT_DISPATCH_INDEX_TYPES(impl->crow_indices().scalar_type(), "sparse_csr_to_sparse", [&] {
+    return expand_rows<index_t>(impl->crow_indices(), impl->nnz());
+  });
+  Tensor indices = at::stack({rows, impl->col_indices()}).to(kLong);
+  return at::_sparse_coo_tensor_unsafe(indices, impl->values().clone(), self.sizes()).coalesce();
+}
+
+SparseCsrTensor dense_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.dim() == 2, "to_sparse_csr: expected a 2-D tensor, but got ", self.dim(), "-D tensor");
+  // nonzero returns the indices in row-major order.
+  Tensor nz = self.nonzero();
+  Tensor rows = nz.select(1, 0);
+  Tensor col_indices = nz.select(1, 1).contiguous();
+  Tensor values = self.index({rows, col_indices});
+  Tensor crow_indices = compress_rows<int64_t>(rows, self.size(0));
+  return at::native::_sparse_csr_tensor_unsafe(crow_indices, col_indices, values, self.sizes(), values.options().layout(kSparseCsr));
+}
+
+SparseCsrTensor sparse_to_sparse_csr(const SparseTensor& self) {
+  TORCH_CHECK(self.sparse_dim() == 2 && self.dense_dim() == 0,
+      "to_sparse_csr: expected a sparse tensor with 2 sparse and 0 dense dimensions, but got ",
+      self.sparse_dim(), " sparse and ", self.dense_dim(), " dense dimensions");
+  // Coalescing sorts the indices by row.
+  SparseTensor coalesced = self.coalesce();
+  Tensor indices = coalesced._indices();
+  Tensor col_indices = indices.select(0, 1).contiguous();
+  Tensor crow_indices = compress_rows<int64_t>(indices.select(0, 0), self.size(0));
+  return at::native::_sparse_csr_tensor_unsafe(
+      crow_indices, col_indices, coalesced._values(), self.sizes(), coalesced._values().options().layout(kSparseCsr));
+}
+
+SparseCsrTensor sparse_csr_to_sparse_csr(const SparseCsrTensor& self) {
+  return self;
+}
+
+}} // namespace at::native
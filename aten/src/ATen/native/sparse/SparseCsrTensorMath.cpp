@@ -0,0 +1,261 @@
+#include <ATen/native/sparse/SparseCsrTensorMath.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+DEFINE_DISPATCH(sparse_csr_addmm_stub);
+DEFINE_DISPATCH(dense_sparse_csr_addmm_stub);
+DEFINE_DISPATCH(sparse_csr_sampled_mm_stub);
+DEFINE_DISPATCH(sparse_csr_addmv_stub);
+
+// --------------------------------------------------------------------
+// transpose(SparseCsrTensor)
+// --------------------------------------------------------------------
+
+SparseCsrTensor sparse_csr_transpose(const SparseCsrTensor& self) {
+  auto impl = get_sparse_csr_impl(self);
+  const int64_t nrows = self.size(0);
+  const int64_t ncols = self.size(1);
+  const int64_t nnz = impl->nnz();
+  const Tensor& crow_indices = impl->crow_indices();
+  Tensor t_crow_indices = at::zeros({ncols + 1}, crow_indices.options());
+  Tensor t_col_indices = at::empty({nnz}, crow_indices.options());
+  Tensor perm = at::empty({nnz}, crow_indices.options().dtype(kLong));
+
+  // Counting sort of the elements by column: the rows of the transpose are
+  // the columns of self, and visiting the rows of self in order leaves the
+  // column indices of the transpose sorted.
+  AT_DISPATCH_INDEX_TYPES(crow_indices.scalar_type(), "sparse_csr_transpose", [&] {
+    const index_t* crow_data = crow_indices.data_ptr<index_t>();
+    const index_t* col_data = impl->col_indices().data_ptr<index_t>();
+    index_t* t_crow_data = t_crow_indices.data_ptr<index_t>();
+    index_t* t_col_data = t_col_indices.data_ptr<index_t>();
+    int64_t* perm_data = perm.data_ptr<int64_t>();
+    for (int64_t p = 0; p < nnz; p++) {
+      t_crow_data[col_data[p] + 1]++;
+    }
+    for (int64_t j = 0; j < ncols; j++) {
+      t_crow_data[j + 1] += t_crow_data[j];
+    }
+    std::vector<index_t> next(t_crow_data, t_crow_data + ncols);
+    for (int64_t i = 0; i < nrows; i++) {
+      for (int64_t p = crow_data[i]; p < crow_data[i + 1]; p++) {
+        const index_t q = next[col_data[p]]++;
+        t_col_data[q] = static_cast<index_t>(i);
+        perm_data[q] = p;
+      }
+    }
+  });
+
+  return at::native::_sparse_csr_tensor_unsafe(
+      t_crow_indices, t_col_indices, impl->values().index_select(0, perm), {ncols, nrows},
+      impl->values().options().layout(kSparseCsr));
+}
+
+// --------------------------------------------------------------------
+// addmm(Tensor, SparseCsrTensor, Tensor, Scalar, Scalar)  [broadcasts]
+// --------------------------------------------------------------------
+
+namespace {
+
+// r = beta * t + alpha * sparse @ dense
+Tensor& s_addmm_out_sparse_csr_dense_cpu(
+    Tensor& r,
+    const Tensor& t,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha
+) {
+  TORCH_CHECK(dense.layout() == kStrided, "addmm: expected 'mat2' to be a strided tensor, but got layout ", dense.layout());
+  TORCH_CHECK(t.layout() == kStrided, "addmm: expected 'self' to be a strided tensor, but got layout ", t.layout());
+  TORCH_CHECK(r.layout() == kStrided, "addmm: expected 'out' to be a strided tensor, but got layout ", r.layout());
+  TORCH_CHECK(!dense.is_cuda() && !t.is_cuda() && !r.is_cuda(), "addmm: expected CPU tensors, but got CUDA tensors");
+  TORCH_CHECK(dense.dim() == 2, "addmm: matrices expected, got ", dense.dim(), "D tensor");
+  TORCH_CHECK(sparse.scalar_type() == dense.scalar_type() && r.scalar_type() == dense.scalar_type(),
+      "addmm: expected 'mat1', 'mat2' and 'out' to have the same dtype, but got ",
+      sparse.scalar_type(), ", ", dense.scalar_type(), " and ", r.scalar_type());
+
+  // ixj * jxk = ixk
+  int64_t dim_i = sparse.size(0);
+  int64_t dim_j = sparse.size(1);
+  int64_t dim_k = dense.size(1);
+
+  TORCH_CHECK(dense.size(0) == dim_j,
+      "addmm: Argument #3 (dense): Expected dim 0 size ", dim_j, ", got ", dense.size(0));
+  TORCH_CHECK(t.size(0) == dim_i,
+      "addmm: Argument #1 (t): Expected dim 0 size ", dim_i, ", got ", t.size(0));
+  TORCH_CHECK(t.size(1) == dim_k,
+      "addmm: Argument #1 (t): Expected dim 1 size ", dim_k, ", got ", t.size(1));
+
+  r.resize_({dim_i, dim_k});
+  // The kernel accumulates into contiguous rows.
+  Tensor out = r.is_contiguous() ? r : at::empty({dim_i, dim_k}, r.options());
+  if (beta.toComplexDouble() == 0.) {
+    // As for dense addmm, nan and inf in t are not propagated when beta is 0.
+    out.zero_();
+  } else {
+    at::mul_out(out, t, at::scalar_tensor(beta, r.options()));
+  }
+
+  auto impl = get_sparse_csr_impl(sparse);
+  if (impl->nnz() > 0 && dim_k > 0) {
+    sparse_csr_addmm_stub(kCPU, out, impl->crow_indices(), impl->col_indices(), impl->values(), dense.contiguous(), alpha);
+  }
+  if (!out.is_same(r)) {
+    r.copy_(out);
+  }
+  return r;
+}
+
+// r = beta * t + alpha * dense @ sparse
+Tensor& s_addmm_out_dense_sparse_csr_cpu(
+    Tensor& r,
+    const Tensor& t,
+    const Tensor& dense,
+    const SparseCsrTensor& sparse,
+    Scalar beta,
+    Scalar alpha
+) {
+  TORCH_CHECK(dense.layout() == kStrided, "addmm: expected 'mat1' to be a strided tensor, but got layout ", dense.layout());
+  TORCH_CHECK(t.layout() == kStrided, "addmm: expected 'self' to be a strided tensor, but got layout ", t.layout());
+  TORCH_CHECK(r.layout() == kStrided, "addmm: expected 'out' to be a strided tensor, but got layout ", r.layout());
+  TORCH_CHECK(!dense.is_cuda() && !t.is_cuda() && !r.is_cuda(), "addmm: expected CPU tensors, but got CUDA tensors");
+  TORCH_CHECK(dense.dim() == 2, "addmm: matrices expected, got ", dense.dim(), "D tensor");
+  TORCH_CHECK(sparse.scalar_type() == dense.scalar_type() && r.scalar_type() == dense.scalar_type(),
+      "addmm: expected 'mat1', 'mat2' and 'out' to have the same dtype, but got ",
+      dense.scalar_type(), ", ", sparse.scalar_type(), " and ", r.scalar_type());
+
+  // ixj * jxk = ixk
+  int64_t dim_i = dense.size(0);
+  int64_t dim_j = sparse.size(0);
+  int64_t dim_k = sparse.size(1);
+
+  TORCH_CHECK(dense.size(1) == dim_j,
+      "addmm: Argument #2 (dense): Expected dim 1 size ", dim_j, ", got ", dense.size(1));
+  TORCH_CHECK(t.size(0) == dim_i,
+      "addmm: Argument #1 (t): Expected dim 0 size ", dim_i, ", got ", t.size(0));
+  TORCH_CHECK(t.size(1) == dim_k,
+      "addmm: Argument #1 (t): Expected dim 1 size ", dim_k, ", got ", t.size(1));
+
+  r.resize_({dim_i, dim_k});
+  // The kernel scatters into contiguous rows.
+  Tensor out = r.is_contiguous() ? r : at::empty({dim_i, dim_k}, r.options());
+  if (beta.toComplexDouble() == 0.) {
+    out.zero_();
+  } else {
+    at::mul_out(out, t, at::scalar_tensor(beta, r.options()));
+  }
+
+  auto impl = get_sparse_csr_impl(sparse);
+  if (impl->nnz() > 0 && dim_i > 0) {
+    dense_sparse_csr_addmm_stub(kCPU, out, dense.contiguous(), impl->crow_indices(), impl->col_indices(), impl->values(), alpha);
+  }
+  if (!out.is_same(r)) {
+    r.copy_(out);
+  }
+  return r;
+}
+
+} // namespace
+
+Tensor& addmm_out_sparse_csr_dense_cpu(
+    Tensor& result,
+    const Tensor& self,
+    const Tensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha
+) {
+  TORCH_CHECK(mat1.dim() == 2, "mat1 must be a matrix, got ", mat1.dim(), "-D tensor");
+  TORCH_CHECK(mat2.dim() == 2, "mat2 must be a matrix, got ", mat2.dim(), "-D tensor");
+  Tensor b_self;
+  std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+  if (mat1.is_sparse_csr()) {
+    return s_addmm_out_sparse_csr_dense_cpu(result, b_self, mat1, mat2, beta, alpha);
+  }
+  TORCH_CHECK(mat2.is_sparse_csr(), "addmm: expected 'mat1' or 'mat2' to be a sparse CSR tensor");
+  return s_addmm_out_dense_sparse_csr_cpu(result, b_self, mat1, mat2, beta, alpha);
+}
+
+Tensor addmm_sparse_csr_dense_cpu(
+    const Tensor& self,
+    const Tensor& mat1,
+    const Tensor& mat2,
+    Scalar beta,
+    Scalar alpha
+) {
+  const Tensor& dense = mat1.is_sparse_csr() ? mat2 : mat1;
+  Tensor result = at::empty({mat1.size(0), mat2.size(1)}, dense.options());
+  return addmm_out_sparse_csr_dense_cpu(result, self, mat1, mat2, beta, alpha);
+}
+
+Tensor sparse_csr_mm(const Tensor& self, const Tensor& mat2) {
+  const Tensor& dense = self.is_sparse_csr() ? mat2 : self;
+  Tensor result = at::empty({self.size(0), mat2.size(1)}, dense.options());
+  return addmm_out_sparse_csr_dense_cpu(result, result, self, mat2, 0, 1);
+}
+
+Tensor& sparse_csr_mm_out(Tensor& result, const Tensor& self, const Tensor& mat2) {
+  TORCH_CHECK(self.dim() == 2, "self must be a matrix");
+  TORCH_CHECK(mat2.dim() == 2, "mat2 must be a matrix");
+  result.resize_({self.size(0), mat2.size(1)});
+  return addmm_out_sparse_csr_dense_cpu(result, result, self, mat2, 0, 1);
+}
+
+// --------------------------------------------------------------------
+// _sparse_csr_sampled_mm(SparseCsrTensor, Tensor, Tensor, Scalar)
+// --------------------------------------------------------------------
+
+SparseCsrTensor sparse_csr_sampled_mm_cpu(const SparseCsrTensor& mask, const Tensor& mat1, const Tensor& mat2, Scalar alpha) {
+  TORCH_CHECK(mask.is_sparse_csr() && mat1.layout() == kStrided && mat2.layout() == kStrided,
+      "_sparse_csr_sampled_mm: expected 'mask' to be a sparse CSR tensor and 'mat1' and 'mat2' to be strided tensors");
+  TORCH_CHECK(mat1.dim() == 2 && mat2.dim() == 2,
+      "_sparse_csr_sampled_mm: matrices expected, got ", mat1.dim(), "D and ", mat2.dim(), "D tensors");
+  TORCH_CHECK(mat1.size(0) == mask.size(0) && mat2.size(1) == mask.size(1) && mat1.size(1) == mat2.size(0),
+      "_sparse_csr_sampled_mm: cannot compute the ", mask.sizes(), " elements of the product of ",
+      mat1.sizes(), " and ", mat2.sizes(), " matrices");
+  TORCH_CHECK(mat1.scalar_type() == mat2.scalar_type(),
+      "_sparse_csr_sampled_mm: expected 'mat1' and 'mat2' to have the same dtype, but got ",
+      mat1.scalar_type(), " and ", mat2.scalar_type());
+
+  auto impl = get_sparse_csr_impl(mask);
+  Tensor values = at::empty({impl->nnz()}, mat1.options());
+  if (impl->nnz() > 0) {
+    sparse_csr_sampled_mm_stub(kCPU, values, impl->crow_indices(), impl->col_indices(), mat1.contiguous(), mat2.t().contiguous(), alpha);
+  }
+  // Shares the indices of mask, see sparse_csr_constructor_values_backward.
+  return at::native::_sparse_csr_tensor_unsafe(
+      impl->crow_indices(), impl->col_indices(), values, mask.sizes(), values.options().layout(kSparseCsr));
+}
+
+// --------------------------------------------------------------------
+// mv(SparseCsrTensor, Tensor)
+// --------------------------------------------------------------------
+
+Tensor sparse_csr_mv(const SparseCsrTensor& self, const Tensor& vec) {
+  TORCH_CHECK(self.is_sparse_csr() && vec.layout() == kStrided,
+      "mv: expected 'self' to be a sparse CSR tensor and 'vec' to be a strided tensor");
+  TORCH_CHECK(vec.dim() == 1, "mv: vector expected, got ", vec.dim(), "D tensor");
+  TORCH_CHECK(vec.size(0) == self.size(1),
+      "mv: expected self.size(-1) == vec.size(-1), but got ", self.size(1), " and ", vec.size(0));
+  TORCH_CHECK(self.scalar_type() == vec.scalar_type(),
+      "mv: expected 'self' and 'vec' to have the same dtype, but got ", self.scalar_type(), " and ", vec.scalar_type());
+
+  Tensor result = at::zeros({self.size(0)}, vec.options());
+  auto impl = get_sparse_csr_impl(self);
+  if (impl->nnz() > 0) {
+    sparse_csr_addmv_stub(kCPU, result, impl->crow_indices(), impl->col_indices(), impl->values(), vec.contiguous(), 1);
+  }
+  return result;
+}
+
+}} // namespace at::native
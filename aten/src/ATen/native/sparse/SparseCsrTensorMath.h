@@ -0,0 +1,35 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// result += alpha * sparse @ dense, where sparse is the (nrows x ncols) CSR
+// matrix given by crow_indices, col_indices and values, and result and dense
+// are contiguous matrices.
+using sparse_csr_addmm_fn = void(*)(const Tensor& result, const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, const Tensor& dense, Scalar alpha);
+DECLARE_DISPATCH(sparse_csr_addmm_fn, sparse_csr_addmm_stub);
+
+// result += alpha * dense @ sparse, where sparse is the (dense.size(1) x
+// result.size(1)) CSR matrix given by crow_indices, col_indices and values,
+// and result and dense are contiguous matrices.
+using dense_sparse_csr_addmm_fn = void(*)(const Tensor& result, const Tensor& dense, const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, Scalar alpha);
+DECLARE_DISPATCH(dense_sparse_csr_addmm_fn, dense_sparse_csr_addmm_stub);
+
+// values[p] = alpha * dot(mat1[i], mat2_t[col_indices[p]]) for every element p
+// of every row i of the CSR matrix given by crow_indices and col_indices,
+// where mat1 and mat2_t are contiguous matrices.
+using sparse_csr_sampled_mm_fn = void(*)(const Tensor& values, const Tensor& crow_indices, const Tensor& col_indices, const Tensor& mat1, const Tensor& mat2_t, Scalar alpha);
+DECLARE_DISPATCH(sparse_csr_sampled_mm_fn, sparse_csr_sampled_mm_stub);
+
+// result += alpha * sparse @ vec, where result and vec are contiguous vectors.
+using sparse_csr_addmv_fn = void(*)(const Tensor& result, const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, const Tensor& vec, Scalar alpha);
+DECLARE_DISPATCH(sparse_csr_addmv_fn, sparse_csr_addmv_stub);
+
+// Returns the transpose of a CSR tensor as a new CSR tensor.  The column
+// indices of its rows are sorted.
+TORCH_API sparse_csr::SparseCsrTensor sparse_csr_transpose(const sparse_csr::SparseCsrTensor& self);
+
+}}
@@ -254,7 +254,7 @@ class TORCH_API Tensor {
       bool channels_last_strides_exact_match = false) const {
     // Setting channels_last_strides_exact_match to true forces function to
     // check 0,1 - sized dimension strides.
-    if (!is_mkldnn() && !is_sparse()) {
+    if (!is_mkldnn() && !is_sparse() && !is_sparse_csr() && !is_jagged()) {
       if (impl_->is_strides_like_channels_last()) {
         if (!channels_last_strides_exact_match ||
             get_channels_last_strides_2d(sizes()) == strides()) {
@@ -352,6 +352,12 @@ class TORCH_API Tensor {
   /// Returns if a `Tensor` has sparse backend.
   bool is_sparse() const;
 
+  /// Returns if a `Tensor` has sparse CSR backend.
+  bool is_sparse_csr() const;
+
+  /// Returns if a `Tensor` has jagged backend.
+  bool is_jagged() const;
+
   /// Returns if a `Tensor` is mkldnn tensor.
   bool is_mkldnn() const;
 
@@ -368,6 +374,10 @@ class TORCH_API Tensor {
   /// also have other designations.
   bool is_meta() const;
 
+  /// Returns if a `Tensor` is an inference tensor, i.e. it was created in
+  /// InferenceMode. See Note [Inference tensors] in ATen/InferenceMode.h.
+  bool is_inference() const;
+
   /// If a tensor is a quantized tensor, returns its quantizer
   /// TODO: it's not in native_functions.yaml yet as it's not exposed to python
   QuantizerPtr quantizer() const;
@@ -130,6 +130,24 @@ bool is_sparse(Tensor self) {
   return self.is_sparse();
 }
 
+bool Tensor::is_sparse_csr() const {
+  // NB: this is not a native function to avoid dispatching overhead.
+  return impl_->is_sparse_csr();
+}
+
+bool is_sparse_csr(Tensor self) {
+  return self.is_sparse_csr();
+}
+
+bool Tensor::is_jagged() const {
+  // NB: this is not a native function to avoid dispatching overhead.
+  return impl_->is_jagged();
+}
+
+bool is_jagged(Tensor self) {
+  return self.is_jagged();
+}
+
 bool Tensor::is_mkldnn() const {
   // NB: this is not a native function to avoid dispatching overhead.
   return impl_->is_mkldnn();
@@ -167,6 +185,10 @@ bool Tensor::is_meta() const {
   return impl_->is_meta();
 }
 
+bool Tensor::is_inference() const {
+  return impl_->is_inference();
+}
+
 bool is_quantized(Tensor self) {
   return self.is_quantized();
 }
@@ -210,3 +210,91 @@ TEST(TensorIteratorTest, FailNonPromotingBinaryOp) {
   config.add_input(at::ones({1,1}, at::dtype(at::kInt)));
   ASSERT_ANY_THROW(config.build());
 }
+
+TensorIterator build_binary_iter_with_plan_cache(
+    TensorIteratorPlanCache* plan_cache, const Tensor& out, const Tensor& a, const Tensor& b) {
+  return at::TensorIteratorConfig()
+      .set_plan_cache(plan_cache)
+      .add_output(out)
+      .add_input(a)
+      .add_input(b)
+      .build();
+}
+
+void expect_same_iteration(const TensorIterator& iter, const TensorIterator& expected) {
+  EXPECT_EQ(iter.shape(), expected.shape());
+  ASSERT_EQ(iter.ntensors(), expected.ntensors());
+  for (int i = 0; i < iter.ntensors(); i++) {
+    EXPECT_EQ(iter.strides(i), expected.strides(i));
+    EXPECT_EQ(iter.dtype(i), expected.dtype(i));
+    EXPECT_EQ(iter.device(i), expected.device(i));
+  }
+  EXPECT_EQ(iter.output().sizes(), expected.output().sizes());
+  EXPECT_EQ(iter.output().strides(), expected.output().strides());
+}
+
+TEST(TensorIteratorTest, PlanCacheReusesPlan) {
+  TensorIteratorPlanCache plan_cache;
+  // Permuted and broadcasted inputs don't take the fast setup
+  auto a = at::randn({4, 3, 5}).permute({2, 0, 1});
+  auto b = at::randn({4, 1});
+  auto expected = build_binary_iter_with_plan_cache(nullptr, Tensor(), a, b);
+  auto first = build_binary_iter_with_plan_cache(&plan_cache, Tensor(), a, b);
+  EXPECT_EQ(plan_cache.size(), 1);
+  expect_same_iteration(first, expected);
+
+  auto c = at::randn({4, 3, 5}).permute({2, 0, 1});
+  auto d = at::randn({4, 1});
+  auto second = build_binary_iter_with_plan_cache(&plan_cache, Tensor(), c, d);
+  EXPECT_EQ(plan_cache.size(), 1);
+  expect_same_iteration(second, expected);
+  EXPECT_FALSE(second.output().is_same(first.output()));
+  at::native::cpu_serial_kernel(second, [](float a, float b) -> float { return a + b; });
+  EXPECT_TRUE(second.output().equal(c + d));
+}
+
+TEST(TensorIteratorTest, PlanCacheKeys) {
+  TensorIteratorPlanCache plan_cache;
+  build_binary_iter_with_plan_cache(&plan_cache, Tensor(), at::ones({2, 3}), at::ones({2, 3}));
+  EXPECT_EQ(plan_cache.size(), 1);
+  build_binary_iter_with_plan_cache(&plan_cache, Tensor(), at::ones({3, 2}), at::ones({3, 2}));
+  EXPECT_EQ(plan_cache.size(), 2);
+  build_binary_iter_with_plan_cache(&plan_cache, Tensor(), at::ones({3, 2}).t(), at::ones({3, 2}).t());
+  EXPECT_EQ(plan_cache.size(), 3);
+  build_binary_iter_with_plan_cache(&plan_cache, Tensor(), at::ones({2, 3}, kDouble), at::ones({2, 3}, kDouble));
+  EXPECT_EQ(plan_cache.size(), 4);
+  build_binary_iter_with_plan_cache(&plan_cache, Tensor(), at::ones({2, 3}), at::ones({2, 3}));
+  EXPECT_EQ(plan_cache.size(), 4);
+
+  // Outputs are resized by the cached plans too
+  build_binary_iter_with_plan_cache(&plan_cache, at::empty({0}), at::ones({2, 3}), at::ones({2, 3}));
+  EXPECT_EQ(plan_cache.size(), 5);
+  auto out = at::empty({0});
+  auto iter = build_binary_iter_with_plan_cache(&plan_cache, out, at::ones({2, 3}), at::ones({2, 3}));
+  EXPECT_EQ(plan_cache.size(), 5);
+  EXPECT_EQ(out.sizes(), IntArrayRef({2, 3}));
+  EXPECT_TRUE(iter.output().is_same(out));
+}
+
+TEST(TensorIteratorTest, PlanCacheSkipsCasts) {
+  TensorIteratorPlanCache plan_cache;
+  auto iter = at::TensorIteratorConfig()
+      .set_plan_cache(&plan_cache)
+      .add_output(Tensor())
+      .add_input(at::ones({2, 3}, kFloat))
+      .add_input(at::ones({2, 3}, kDouble))
+      .promote_inputs_to_common_dtype(true)
+      .build();
+  EXPECT_EQ(iter.dtype(1), kDouble);
+  EXPECT_EQ(plan_cache.size(), 0);
+}
+
+TEST(TensorIteratorTest, PlanCacheEviction) {
+  TensorIteratorPlanCache plan_cache(2);
+  for (int64_t size = 1; size <= 3; size++) {
+    build_binary_iter_with_plan_cache(&plan_cache, Tensor(), at::ones({size}), at::ones({size}));
+  }
+  EXPECT_EQ(plan_cache.size(), 2);
+  plan_cache.clear();
+  EXPECT_EQ(plan_cache.size(), 0);
+}
@@ -0,0 +1,128 @@
+"""
+Stress test of the RRef bookkeeping of the RPC agent. A driver creates RRefs
+owned by the "owner" worker, forks each of them to the "user" worker and then
+deletes them, from a growing number of threads. The throughput of every
+create/fork/delete cycle is reported for every thread count, which shows how
+well the RRefContext scales with concurrency.
+
+Example:
+    python benchmark.py --threads 1,2,4,8,16,32 --iters 200
+"""
+
+import argparse
+import json
+import os
+import threading
+import time
+
+import torch
+import torch.distributed.rpc as rpc
+import torch.multiprocessing as mp
+from torch._C._distributed_rpc import _rref_context_get_debug_info
+
+
+def fork_rref(rref):
+    # Receiving the RRef creates a UserRRef on this worker, which is deleted
+    # when the function returns.
+    return rref.owner().id
+
+
+def num_owner_rrefs():
+    return int(_rref_context_get_debug_info()["num_owner_rrefs"])
+
+
+def run_thread(iters, tensor, barrier, latencies):
+    barrier.wait()
+    for _ in range(iters):
+        start = time.perf_counter()
+        rref = rpc.remote("owner", torch.add, args=(tensor, 1))
+        rpc.rpc_sync("user", fork_rref, args=(rref,))
+        del rref
+        latencies.append(time.perf_counter() - start)
+
+
+def run_driver(thread_counts, iters):
+    tensor = torch.ones(1)
+    results = []
+    for num_threads in thread_counts:
+        barrier = threading.Barrier(num_threads + 1)
+        latencies = [[] for _ in range(num_threads)]
+        threads = [
+            threading.Thread(
+                target=run_thread, args=(iters, tensor, barrier, latencies[i])
+            )
+            for i in range(num_threads)
+        ]
+        for thread in threads:
+            thread.start()
+        barrier.wait()
+        start = time.perf_counter()
+        for thread in threads:
+            thread.join()
+        # Deletions are asynchronous, a cycle is only complete once the owner
+        # dropped its OwnerRRef.
+        while rpc.rpc_sync("owner", num_owner_rrefs) > 0:
+            time.sleep(0.001)
+        elapsed = time.perf_counter() - start
+
+        merged = sorted(sum(latencies, []))
+        results.append({
+            "threads": num_threads,
+            "rrefs_per_sec": num_threads * iters / elapsed,
+            "p50_ms": merged[len(merged) // 2] * 1e3,
+            "p99_ms": merged[int(len(merged) * 0.99)] * 1e3,
+        })
+    return results
+
+
+def run_worker(rank, args, queue):
+    os.environ["MASTER_ADDR"] = args.master_addr
+    os.environ["MASTER_PORT"] = args.master_port
+    options = rpc.ProcessGroupRpcBackendOptions(
+        num_send_recv_threads=args.num_send_recv_threads,
+    )
+    name = ["driver", "owner", "user"][rank]
+    rpc.init_rpc(
+        name,
+        backend=rpc.BackendType.PROCESS_GROUP,
+        rank=rank,
+        world_size=3,
+        rpc_backend_options=options,
+    )
+    if rank == 0:
+        queue.put(run_driver(args.threads, args.iters))
+    rpc.shutdown()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="PyTorch RRef stress benchmark")
+    parser.add_argument("--threads", type=str, default="1,2,4,8,16,32",
+                        help="comma separated numbers of driver threads")
+    parser.add_argument("--iters", type=int, default=200,
+                        help="create/fork/delete cycles per thread")
+    parser.add_argument("--num_send_recv_threads", type=int, default=32)
+    parser.add_argument("--master_addr", type=str, default="127.0.0.1")
+    parser.add_argument("--master_port", type=str, default="29503")
+    parser.add_argument("--json", type=str, default=None,
+                        help="write the results to this file")
+    args = parser.parse_args()
+    args.threads = [int(threads) for threads in args.threads.split(",")]
+
+    ctx = mp.get_context("spawn")
+    queue = ctx.SimpleQueue()
+    mp.spawn(run_worker, args=(args, queue), nprocs=3, join=True)
+    results = queue.get()
+
+    print("{:>8} {:>14} {:>10} {:>10}".format("threads", "rrefs/s", "p50 ms", "p99 ms"))
+    for result in results:
+        print("{:>8} {:>14.1f} {:>10.3f} {:>10.3f}".format(
+            result["threads"], result["rrefs_per_sec"],
+            result["p50_ms"], result["p99_ms"]))
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
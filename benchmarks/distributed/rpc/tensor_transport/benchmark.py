@@ -0,0 +1,114 @@
+"""
+Measures the latency and throughput of RPCs carrying tensors between two
+workers on the same host, with and without the shared memory tensor
+transport of the ProcessGroup RPC backend.
+
+Example:
+    python benchmark.py --sizes 1024,1048576,16777216 --iters 50
+"""
+
+import argparse
+import json
+import os
+import time
+
+import torch
+import torch.distributed.rpc as rpc
+import torch.multiprocessing as mp
+
+
+def identity(tensor):
+    return tensor
+
+
+def run_trainer(sizes, iters, warmup):
+    results = []
+    for size in sizes:
+        tensor = torch.rand(size // 4)
+        for _ in range(warmup):
+            rpc.rpc_sync("server", identity, args=(tensor,))
+        latencies = []
+        for _ in range(iters):
+            start = time.perf_counter()
+            rpc.rpc_sync("server", identity, args=(tensor,))
+            latencies.append(time.perf_counter() - start)
+        latencies.sort()
+        mean = sum(latencies) / len(latencies)
+        results.append({
+            "bytes": size,
+            "p50_ms": latencies[len(latencies) // 2] * 1e3,
+            "p90_ms": latencies[int(len(latencies) * 0.9)] * 1e3,
+            "mean_ms": mean * 1e3,
+            # Every RPC carries the tensor to the server and back.
+            "throughput_gbps": 2 * size / mean / 1e9,
+        })
+    return results
+
+
+def run_worker(rank, args, shm_threshold_bytes, queue):
+    os.environ["MASTER_ADDR"] = args.master_addr
+    os.environ["MASTER_PORT"] = args.master_port
+    options = rpc.ProcessGroupRpcBackendOptions(
+        num_send_recv_threads=args.num_send_recv_threads,
+        shm_threshold_bytes=shm_threshold_bytes,
+    )
+    name = "trainer" if rank == 0 else "server"
+    rpc.init_rpc(
+        name,
+        backend=rpc.BackendType.PROCESS_GROUP,
+        rank=rank,
+        world_size=2,
+        rpc_backend_options=options,
+    )
+    if rank == 0:
+        queue.put(run_trainer(args.sizes, args.iters, args.warmup))
+    rpc.shutdown()
+
+
+def benchmark(args, shm_threshold_bytes):
+    ctx = mp.get_context("spawn")
+    queue = ctx.SimpleQueue()
+    mp.spawn(
+        run_worker,
+        args=(args, shm_threshold_bytes, queue),
+        nprocs=2,
+        join=True,
+    )
+    return queue.get()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="PyTorch RPC tensor transport benchmark")
+    parser.add_argument("--sizes", type=str, default="4096,65536,1048576,16777216",
+                        help="comma separated tensor sizes in bytes")
+    parser.add_argument("--iters", type=int, default=50)
+    parser.add_argument("--warmup", type=int, default=5)
+    parser.add_argument("--num_send_recv_threads", type=int, default=4)
+    parser.add_argument("--shm_threshold_bytes", type=int, default=65536)
+    parser.add_argument("--master_addr", type=str, default="127.0.0.1")
+    parser.add_argument("--master_port", type=str, default="29502")
+    parser.add_argument("--json", type=str, default=None,
+                        help="write the results to this file")
+    args = parser.parse_args()
+    args.sizes = [int(size) for size in args.sizes.split(",")]
+
+    report = {
+        "process_group": benchmark(args, -1),
+        "shared_memory": benchmark(args, args.shm_threshold_bytes),
+    }
+
+    print("{:>12} {:>22} {:>22}".format("bytes", "process_group p50/GBps", "shared_memory p50/GBps"))
+    for pg, shm in zip(report["process_group"], report["shared_memory"]):
+        print("{:>12} {:>13.3f}/{:<8.3f} {:>13.3f}/{:<8.3f}".format(
+            pg["bytes"],
+            pg["p50_ms"], pg["throughput_gbps"],
+            shm["p50_ms"], shm["throughput_gbps"],
+        ))
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(report, f, indent=2)
+
+
+if __name__ == "__main__":
+    main()
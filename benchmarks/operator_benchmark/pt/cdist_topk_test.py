@@ -0,0 +1,64 @@
+import operator_benchmark as op_bench
+import torch
+
+"""Microbenchmarks for cdist_topk, against cdist followed by topk."""
+
+# N queries of size D, searched among M rows for their K nearest.
+cdist_topk_configs_short = op_bench.cross_product_configs(
+    N=[256],
+    M=[10000],
+    D=[64],
+    K=[1, 10],
+    metric=['euclidean', 'inner_product'],
+    tags=['short']
+)
+
+cdist_topk_configs_long = op_bench.cross_product_configs(
+    N=[1, 1024, 4096],
+    M=[1000, 100000],
+    D=[16, 128],
+    K=[1, 10, 100],
+    metric=['euclidean', 'inner_product', 'cosine'],
+    tags=['long']
+)
+
+
+class CdistTopkBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, N, M, D, K, metric):
+        self.inputs = {
+            "x1": torch.randn(N, D),
+            "x2": torch.randn(M, D),
+            "k": K,
+            "metric": metric
+        }
+        self.set_module_name("cdist_topk")
+
+    def forward(self, x1, x2, k: int, metric: str):
+        return torch.cdist_topk(x1, x2, k, metric)
+
+
+class CdistThenTopkBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, N, M, D, K, metric):
+        self.inputs = {
+            "x1": torch.randn(N, D),
+            "x2": torch.randn(M, D),
+            "k": K,
+            "metric": metric
+        }
+        self.set_module_name("cdist_then_topk")
+
+    def forward(self, x1, x2, k: int, metric: str):
+        if metric == 'euclidean':
+            return torch.cdist(x1, x2).topk(k, dim=1, largest=False)
+        if metric == 'cosine':
+            x1 = torch.nn.functional.normalize(x1, dim=1)
+            x2 = torch.nn.functional.normalize(x2, dim=1)
+        return x1.mm(x2.t()).topk(k, dim=1)
+
+
+op_bench.generate_pt_test(cdist_topk_configs_short + cdist_topk_configs_long, CdistTopkBenchmark)
+op_bench.generate_pt_test(cdist_topk_configs_short + cdist_topk_configs_long, CdistThenTopkBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
@@ -0,0 +1,71 @@
+import operator_benchmark as op_bench
+import torch
+
+"""Microbenchmarks for index_add_ and scatter_add_ operators."""
+
+# M is the number of rows of the destination, N the number of indices and D
+# the size of a row. With zipf=0 the indices are uniform; otherwise row r is
+# picked with a probability proportional to 1 / (r + 1) ** zipf, so that a few
+# hot rows get most of the updates, as in the gradient of an embedding.
+index_add_configs_short = op_bench.cross_product_configs(
+    M=[64, 100000],
+    N=[100000],
+    D=[1, 64],
+    zipf=[0, 1.1],
+    device=['cpu', 'cuda'],
+    tags=['short']
+)
+
+index_add_configs_long = op_bench.cross_product_configs(
+    M=[16, 4096, 1000000],
+    N=[10000, 1000000],
+    D=[1, 16, 256],
+    zipf=[0, 0.8, 1.1, 2.0],
+    device=['cpu', 'cuda'],
+    tags=['long']
+)
+
+
+def make_indices(M, N, zipf, device):
+    torch.manual_seed(42)
+    if zipf == 0:
+        index = torch.randint(M, (N,))
+    else:
+        weights = torch.arange(1, M + 1, dtype=torch.double).pow(-zipf)
+        # Spread the hot rows over the destination.
+        index = torch.randperm(M)[torch.multinomial(weights, N, replacement=True)]
+    return index.to(device)
+
+
+class IndexAddBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, M, N, D, zipf, device):
+        self.inputs = {
+            "input_one": torch.zeros(M, D, device=device),
+            "index": make_indices(M, N, zipf, device),
+            "source": torch.rand(N, D, device=device)
+        }
+        self.set_module_name("index_add_")
+
+    def forward(self, input_one, index, source):
+        return input_one.index_add_(0, index, source)
+
+
+class ScatterAddBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, M, N, D, zipf, device):
+        self.inputs = {
+            "input_one": torch.zeros(M, D, device=device),
+            "index": make_indices(M, N, zipf, device).view(N, 1).expand(N, D),
+            "source": torch.rand(N, D, device=device)
+        }
+        self.set_module_name("scatter_add_")
+
+    def forward(self, input_one, index, source):
+        return input_one.scatter_add_(0, index, source)
+
+
+op_bench.generate_pt_test(index_add_configs_short + index_add_configs_long, IndexAddBenchmark)
+op_bench.generate_pt_test(index_add_configs_short + index_add_configs_long, ScatterAddBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
@@ -0,0 +1,51 @@
+import operator_benchmark as op_bench
+import torch
+
+"""Microbenchmarks for topk operator."""
+
+# Configs for PT topk operator. K is given as a fraction of N so that the
+# selection-heavy (small k) and sort-heavy (large k) regimes are both covered.
+topk_configs_short = op_bench.cross_product_configs(
+    M=[1, 256],  # Number of slices
+    N=[1024],  # Length of each slice
+    k_ratio=[0.001, 0.1, 0.5],
+    largest=[True],
+    device=['cpu', 'cuda'],
+    tags=['short']
+)
+
+topk_configs_long = op_bench.cross_product_configs(
+    M=[1],
+    N=[1 << 20, 10000000],
+    k_ratio=[0.00001, 0.001, 0.01, 0.1, 0.5],
+    largest=[True, False],
+    device=['cpu', 'cuda'],
+    tags=['long']
+) + op_bench.cross_product_configs(
+    M=[64],
+    N=[1 << 16],
+    k_ratio=[0.001, 0.1],
+    largest=[True],
+    device=['cpu', 'cuda'],
+    tags=['long']
+)
+
+
+class TopkBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, M, N, k_ratio, largest, device):
+        self.inputs = {
+            "input_tensor": torch.rand(M, N, device=device),
+            "k": max(int(N * k_ratio), 1),
+            "largest": largest
+        }
+        self.set_module_name("topk")
+
+    def forward(self, input_tensor, k: int, largest: bool):
+        return torch.topk(input_tensor, k, dim=1, largest=largest)
+
+
+op_bench.generate_pt_test(topk_configs_short + topk_configs_long, TopkBenchmark)
+
+
+if __name__ == "__main__":
+    op_bench.benchmark_runner.main()
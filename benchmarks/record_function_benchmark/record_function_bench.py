@@ -36,6 +36,11 @@ MODELS = {
 
 NUM_THREADS = [1, 2, 4, 8, 16, 32]
 
+# without_rec_fn - RecordFunction disabled;
+# with_rec_fn - an empty observer sampled with prob. 0.0001;
+# sampling_profiler - the continuous sampling profiler, see --sampling_prob
+MODES = ["with_rec_fn", "without_rec_fn", "sampling_profiler"]
+
 def run_bench(model_names, bench_args):
     results = []
     for model_name in model_names:
@@ -50,23 +55,27 @@ def run_bench(model_names, bench_args):
         print("finished")
 
         for num_threads in NUM_THREADS:
-            for with_rec_fn in [True, False]:
+            for mode in MODES:
+                with_rec_fn = mode != "without_rec_fn"
                 torch.autograd._enable_record_function(with_rec_fn)
                 torch.autograd._clear_callbacks()
-                if with_rec_fn:
+                if mode == "with_rec_fn":
                     torch.autograd._set_empty_test_observer(True, 0.0001)
+                elif mode == "sampling_profiler":
+                    torch.autograd._enable_sampling_profiler(bench_args.sampling_prob)
 
-                print("Running {} RecordFunction, num threads {} ...".format(
-                    "with" if with_rec_fn else "without", num_threads), end=" ")
+                print("Running {}, num threads {} ...".format(mode, num_threads), end=" ")
                 sys.stdout.flush()
                 timer = benchmark_utils.Timer(
                     stmt="model(*inputs)",
                     globals={"model": model, "inputs": inputs},
                     description=model_name,
                     label="Record function overhead",
-                    sub_label=f"with{'' if with_rec_fn else 'out'}_rec_fn, num_threads {num_threads}",
+                    sub_label=f"{mode}, num_threads {num_threads}",
                     num_threads=num_threads)
                 result = timer.blocked_autorange(min_run_time=bench_args.timer_min_run_time)
+                if mode == "sampling_profiler":
+                    torch.autograd._disable_sampling_profiler()
                 print("finished")
                 print(result)
                 sys.stdout.flush()
@@ -93,6 +102,8 @@ if __name__ == '__main__':
     parser.add_argument('--warmup', default='2', type=int)
     parser.add_argument('--nloops', default='50', type=int)
     parser.add_argument('--timer_min_run_time', default=120, type=int)
+    parser.add_argument('--sampling_prob', default=0.001, type=float,
+                        help='Sampling probability of the sampling profiler')
 
     args = parser.parse_args()
 
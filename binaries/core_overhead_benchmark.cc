@@ -16,6 +16,8 @@
 
 #include "benchmark/benchmark.h"
 
+#include <ATen/ATen.h>
+#include <ATen/InferenceMode.h>
 #include <c10/util/Logging.h>
 
 #if defined(__GNUC__)
@@ -55,4 +57,101 @@ static void BM_NoAPILogging(benchmark::State& state) {
 }
 BENCHMARK(BM_NoAPILogging);
 
+// Per op dispatcher overhead, on tensors small enough for the kernels to be
+// negligible.
+static void BM_DispatchEmpty(benchmark::State& state) {
+  while (state.KeepRunning()) {
+    auto t = at::empty({1});
+    benchmark::DoNotOptimize(t);
+  }
+}
+BENCHMARK(BM_DispatchEmpty);
+
+static void BM_DispatchAddOut(benchmark::State& state) {
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  auto out = at::empty({1});
+  while (state.KeepRunning()) {
+    at::add_out(out, a, b);
+  }
+  benchmark::DoNotOptimize(out);
+}
+BENCHMARK(BM_DispatchAddOut);
+
+static void BM_DispatchAddOutNoGrad(benchmark::State& state) {
+  at::NoGradGuard no_grad;
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  auto out = at::empty({1});
+  while (state.KeepRunning()) {
+    at::add_out(out, a, b);
+  }
+  benchmark::DoNotOptimize(out);
+}
+BENCHMARK(BM_DispatchAddOutNoGrad);
+
+static void BM_DispatchMulInplace(benchmark::State& state) {
+  auto a = at::ones({1});
+  while (state.KeepRunning()) {
+    a.mul_(1);
+  }
+  benchmark::DoNotOptimize(a);
+}
+BENCHMARK(BM_DispatchMulInplace);
+
+// InferenceMode skips the autograd kernels that NoGradGuard still goes
+// through, on both inference tensors and normal tensors.
+static void BM_DispatchAddInplaceNoGrad(benchmark::State& state) {
+  at::NoGradGuard no_grad;
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  while (state.KeepRunning()) {
+    a.add_(b);
+  }
+  benchmark::DoNotOptimize(a);
+}
+BENCHMARK(BM_DispatchAddInplaceNoGrad);
+
+static void BM_DispatchAddInplaceInferenceMode(benchmark::State& state) {
+  // Arg 0: normal tensors, whose version InferenceMode still bumps.
+  // Arg 1: inference tensors, created in InferenceMode.
+  auto a = at::ones({1});
+  auto b = at::ones({1});
+  at::InferenceMode guard;
+  if (state.range(0)) {
+    a = at::ones({1});
+    b = at::ones({1});
+  }
+  while (state.KeepRunning()) {
+    a.add_(b);
+  }
+  benchmark::DoNotOptimize(a);
+}
+BENCHMARK(BM_DispatchAddInplaceInferenceMode)->Arg(0)->Arg(1);
+
+static void BM_DispatchViewNoGrad(benchmark::State& state) {
+  at::NoGradGuard no_grad;
+  auto a = at::ones({2, 3});
+  while (state.KeepRunning()) {
+    auto v = a.view({3, 2});
+    benchmark::DoNotOptimize(v);
+  }
+}
+BENCHMARK(BM_DispatchViewNoGrad);
+
+static void BM_DispatchViewInferenceMode(benchmark::State& state) {
+  // Arg 0: a normal tensor, whose views InferenceMode still tracks.
+  // Arg 1: an inference tensor, created in InferenceMode.
+  auto a = at::ones({2, 3});
+  at::InferenceMode guard;
+  if (state.range(0)) {
+    a = at::ones({2, 3});
+  }
+  while (state.KeepRunning()) {
+    auto v = a.view({3, 2});
+    benchmark::DoNotOptimize(v);
+  }
+}
+BENCHMARK(BM_DispatchViewInferenceMode)->Arg(0)->Arg(1);
+
 BENCHMARK_MAIN();
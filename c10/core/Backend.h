@@ -45,6 +45,8 @@ enum class Backend {
   QuantizedXPU,
   Undefined,
   MkldnnCPU,
+  SparseCsrCPU,
+  JaggedCPU,
   NumOptions
 };
 
@@ -93,6 +95,10 @@ static inline Backend toDense(Backend b) {
       return Backend::CUDA;
     case Backend::SparseHIP:
       return Backend::HIP;
+    case Backend::SparseCsrCPU:
+      return Backend::CPU;
+    case Backend::JaggedCPU:
+      return Backend::CPU;
     case Backend::QuantizedCPU:
       return Backend::QuantizedCPU;
     case Backend::QuantizedCUDA:
@@ -129,6 +135,10 @@ static inline Backend dispatchKeyToBackend(DispatchKey t) {
     return Backend::SparseHIP;
   } else if (t == DispatchKey::MkldnnCPU) {
     return Backend::MkldnnCPU;
+  } else if (t == DispatchKey::SparseCsrCPU) {
+    return Backend::SparseCsrCPU;
+  } else if (t == DispatchKey::JaggedCPU) {
+    return Backend::JaggedCPU;
   } else if (t == DispatchKey::QuantizedCPU) {
     return Backend::QuantizedCPU;
   } else if (t == DispatchKey::QuantizedCUDA) {
@@ -172,6 +182,10 @@ static inline DispatchKey backendToDispatchKey(Backend b) {
       return DispatchKey::SparseHIP;
     case Backend::MkldnnCPU:
       return DispatchKey::MkldnnCPU;
+    case Backend::SparseCsrCPU:
+      return DispatchKey::SparseCsrCPU;
+    case Backend::JaggedCPU:
+      return DispatchKey::JaggedCPU;
     case Backend::Vulkan:
       return DispatchKey::Vulkan;
     case Backend::Metal:
@@ -212,6 +226,8 @@ static inline DeviceType backendToDeviceType(Backend b) {
     case Backend::QuantizedXPU:
       return DeviceType::XPU;
     case Backend::MkldnnCPU:
+    case Backend::SparseCsrCPU:
+    case Backend::JaggedCPU:
     case Backend::QuantizedCPU:
       return DeviceType::CPU;
     case Backend::QuantizedCUDA:
@@ -252,6 +268,10 @@ static inline Backend backendToCPU(Backend b) {
       return Backend::CPU;
     case Backend::MkldnnCPU:
       return Backend::MkldnnCPU;
+    case Backend::SparseCsrCPU:
+      return Backend::SparseCsrCPU;
+    case Backend::JaggedCPU:
+      return Backend::JaggedCPU;
     case Backend::QuantizedCPU:
       return Backend::QuantizedCPU;
     case Backend::QuantizedCUDA:
@@ -364,6 +384,10 @@ static inline const char* toString(Backend b) {
       return "SparseXPU";
     case Backend::MkldnnCPU:
       return "MkldnnCPU";
+    case Backend::SparseCsrCPU:
+      return "SparseCsrCPU";
+    case Backend::JaggedCPU:
+      return "JaggedCPU";
     case Backend::Vulkan:
       return "Vulkan";
     case Backend::Metal:
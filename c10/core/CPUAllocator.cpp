@@ -124,6 +124,16 @@ ProfiledCPUMemoryReporter& profiledCPUMemoryReporter() {
   return reporter_;
 }
 
+static std::atomic<CPUMemoryTracker*> cpu_memory_tracker{nullptr};
+
+void SetCPUMemoryTracker(CPUMemoryTracker* tracker) {
+  cpu_memory_tracker.store(tracker, std::memory_order_release);
+}
+
+CPUMemoryTracker* GetCPUMemoryTracker() {
+  return cpu_memory_tracker.load(std::memory_order_acquire);
+}
+
 // QNNPACK AND XNNPACK may out-of-bound access the input and / or output
 // tensors. This is by-design, and chosen to make the implementation of
 // micro-kernels both simpler and faster as a result of not having to
@@ -263,6 +273,9 @@ void ProfiledCPUMemoryReporter::New(void* ptr, size_t nbytes) {
   if (nbytes == 0) {
     return;
   }
+  if (auto* tracker = GetCPUMemoryTracker()) {
+    tracker->trackAlloc(ptr, nbytes);
+  }
   auto profile_memory = memoryProfilingEnabled();
   size_t allocated = 0;
   if (FLAGS_caffe2_report_cpu_memory_usage || profile_memory) {
@@ -281,6 +294,9 @@ void ProfiledCPUMemoryReporter::New(void* ptr, size_t nbytes) {
 }
 
 void ProfiledCPUMemoryReporter::Delete(void* ptr) {
+  if (auto* tracker = GetCPUMemoryTracker()) {
+    tracker->trackFree(ptr);
+  }
   size_t nbytes = 0;
   auto profile_memory = memoryProfilingEnabled();
   size_t allocated = 0;
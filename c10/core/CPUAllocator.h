@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <unordered_map>
 
@@ -53,6 +54,23 @@ class C10_API ProfiledCPUMemoryReporter {
 
 C10_API ProfiledCPUMemoryReporter& profiledCPUMemoryReporter();
 
+// An interface for tracking the allocations of all the threads reported by
+// ProfiledCPUMemoryReporter, unlike the profiler which only sees the
+// allocations of the threads it is enabled on.
+class C10_API CPUMemoryTracker {
+ public:
+  virtual ~CPUMemoryTracker() {}
+  virtual void trackAlloc(void* ptr, size_t nbytes) = 0;
+  // Called for all the freed blocks, including the ones allocated before the
+  // tracker was set.
+  virtual void trackFree(void* ptr) = 0;
+};
+
+// Sets the memory tracker, nullptr disables tracking. The tracker may still be
+// called by other threads after it is unset, so it should never be destroyed.
+C10_API void SetCPUMemoryTracker(CPUMemoryTracker* tracker);
+C10_API CPUMemoryTracker* GetCPUMemoryTracker();
+
 // Get the CPU Allocator.
 C10_API at::Allocator* GetCPUAllocator();
 // Sets the CPU allocator to the given allocator: the caller gives away the
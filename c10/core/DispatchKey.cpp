@@ -58,6 +58,10 @@ const char* toString(DispatchKey t) {
       return "SparseHIP";
     case DispatchKey::SparseXPU:
       return "SparseXPU";
+    case DispatchKey::SparseCsrCPU:
+      return "SparseCsrCPU";
+    case DispatchKey::JaggedCPU:
+      return "JaggedCPU";
 
     case DispatchKey::NestedTensor:
       return "NestedTensor";
@@ -94,6 +98,8 @@ const char* toString(DispatchKey t) {
       return "BackendSelect";
     case DispatchKey::Named:
       return "Named";
+    case DispatchKey::InferenceMode:
+      return "InferenceMode";
 
     case DispatchKey::Tracer:
       return "Tracer";
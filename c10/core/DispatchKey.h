@@ -109,6 +109,8 @@ enum class DispatchKey : uint8_t {
   SparseHIP, // TODO: I think this is not actually used, due to Note
   // [Masquerading as CUDA]
   SparseXPU, // For out of tree Intel's heterogeneous computing plug-in
+  SparseCsrCPU, // registered at build/aten/src/ATen/RegisterSparseCsrCPU.cpp
+  JaggedCPU, // registered at build/aten/src/ATen/RegisterJaggedCPU.cpp
 
   NestedTensor, // lives out of tree at https://github.com/pytorch/nestedtensor
   // Here are reserved backends for user-defined backends, see Note [Private use
@@ -195,6 +197,15 @@ enum class DispatchKey : uint8_t {
   // constituent parts.
   Named,
 
+  // Inference tensors, i.e. the tensors created in InferenceMode, have this
+  // key instead of an autograd key, and InferenceMode adds it to the
+  // thread local included set (while excluding the autograd keys).  Ops that
+  // neither mutate nor alias their inputs fall through it; the others keep the
+  // version counters of normal tensors correct in InferenceMode, and reject
+  // inplace updates of inference tensors outside of it.
+  // See Note [Inference tensors] in ATen/InferenceMode.h.
+  InferenceMode,
+
   // Note [Alias Dispatch Key : Autograd]
   // All backends are oblivious to autograd; autograd is handled as a
   // layer which happens on top of all backends. It inspects the autograd
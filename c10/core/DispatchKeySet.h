@@ -101,7 +101,7 @@ public:
   bool empty() const {
     return repr_ == 0;
   }
-  uint64_t raw_repr() { return repr_; }
+  uint64_t raw_repr() const { return repr_; }
   // Return the type id in this set with the highest priority (i.e.,
   // is the largest in the DispatchKey enum).  Intuitively, this
   // type id is the one that should handle dispatch (assuming there
@@ -223,6 +223,8 @@ constexpr DispatchKeySet autogradother_backends = DispatchKeySet({
   DispatchKey::SparseCPU,
   DispatchKey::SparseCUDA,
   DispatchKey::SparseHIP,
+  DispatchKey::SparseCsrCPU,
+  DispatchKey::JaggedCPU,
   DispatchKey::Meta,
 });
 
@@ -261,7 +263,9 @@ static inline DispatchKey legacyExtractDispatchKey(DispatchKeySet s) {
   // is the most likely key that will need this treatment;
   // After Autograd keys are moved from globally enabled set to TensorImpl,
   // we should remove all Autograd keys before taking highestPriority.
-  return (s - autograd_dispatch_keyset).highestPriorityTypeId();
+  // Inference tensors have the InferenceMode key in place of an Autograd key.
+  return (s - autograd_dispatch_keyset).remove(DispatchKey::InferenceMode)
+      .highestPriorityTypeId();
 }
 
 template<class T>
@@ -64,9 +64,25 @@ TensorImpl::TensorImpl(
 TensorImpl::TensorImpl(DispatchKeySet key_set, const caffe2::TypeMeta data_type, c10::optional<c10::Device> device_opt)
     : TensorImpl({}, key_set, data_type, std::move(device_opt)) {}
 
+namespace {
+
+// Tensors created in InferenceMode are inference tensors, and so are the
+// tensors created with the key set of an inference tensor (e.g. its views).
+bool is_inference_key_set(DispatchKeySet key_set) {
+  return !key_set.empty() &&
+      (key_set.has(DispatchKey::InferenceMode) ||
+       impl::tls_local_dispatch_key_set().included_.has(DispatchKey::InferenceMode));
+}
+
+} // namespace
+
 TensorImpl::TensorImpl(Storage&& storage, DispatchKeySet key_set, const caffe2::TypeMeta data_type,
                        c10::optional<c10::Device> device_opt)
     : storage_(std::move(storage)),
+      version_counter_(
+          is_inference_key_set(key_set)
+              ? VariableVersion(VariableVersion::DISABLED)
+              : VariableVersion(/*version=*/0)),
       storage_offset_(0),
       numel_(0),
       data_type_(data_type),
@@ -86,7 +102,13 @@ TensorImpl::TensorImpl(Storage&& storage, DispatchKeySet key_set, const caffe2::
   // TODO: Ideally this logic fits best in Variable/Autograd layer so that we only
   // add AutogradBackend key when the tensor requires grad.
   DispatchKey k = key_set.highestPriorityBackendTypeId();
-  key_set_ = key_set.add(getAutogradKeyFromBackend(k));
+  if (!version_counter_.enabled()) {
+    // Inference tensors skip the autograd layer entirely, see
+    // Note [Inference tensors] in ATen/InferenceMode.h.
+    key_set_ = (key_set - autograd_dispatch_keyset).add(DispatchKey::InferenceMode);
+  } else {
+    key_set_ = key_set.add(getAutogradKeyFromBackend(k));
+  }
 
   // we would also like to check that non-cpu devices have an index, but some Caffe2 operators create
   // Storages with default devices.
@@ -279,6 +301,10 @@ AutogradMetaInterface::~AutogradMetaInterface() {}
 
 void TensorImpl::set_requires_grad(bool requires_grad) {
   if (!requires_grad && !autograd_meta_) return;
+  TORCH_CHECK(
+      !requires_grad || !is_inference(),
+      "Setting requires_grad=True on inference tensor is not allowed. "
+      "You can make a clone outside InferenceMode to get a normal tensor.");
   if (!autograd_meta_) autograd_meta_ = impl::GetAutogradMetaFactory()->make();
   // NB: In principle, setting requires_grad to false could result in
   // the AutogradMeta becoming equal to a default constructed state,
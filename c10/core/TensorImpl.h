@@ -229,6 +229,10 @@ struct C10_API VariableVersion {
   c10::intrusive_ptr<VersionCounter> version_counter_;
 
  public:
+  // Inference tensors don't track their version, and don't allocate a
+  // version counter. See Note [Inference tensors] in ATen/InferenceMode.h.
+  enum Disabled { DISABLED };
+
   bool unique() const {
     return 1 == version_counter_.use_count();
   }
@@ -237,12 +241,24 @@ struct C10_API VariableVersion {
   // https://cplusplus.github.io/LWG/issue2334.
   VariableVersion(uint32_t version = 0)
       : version_counter_(c10::make_intrusive<VersionCounter>(version)) {}
+  VariableVersion(Disabled) noexcept {}
+
+  bool enabled() const noexcept {
+    return version_counter_.defined();
+  }
 
-  void bump() noexcept {
+  void bump() {
+    TORCH_CHECK(
+        version_counter_,
+        "Inplace update to inference tensor outside InferenceMode is not allowed. "
+        "You can make a clone to get a normal tensor before doing inplace update.");
     ++version_counter_->version_;
   }
 
-  uint32_t current_version() const noexcept {
+  uint32_t current_version() const {
+    TORCH_CHECK(
+        version_counter_,
+        "Inference tensors do not track version counter.");
     return version_counter_->version_;
   }
 };
@@ -490,6 +506,19 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
         key_set_.has(DispatchKey::SparseXPU);
   }
 
+  // Whether this is a sparse tensor in CSR format, see SparseCsrTensorImpl.
+  // Note that is_sparse() is only true for sparse COO tensors.
+  bool is_sparse_csr() const {
+    // NB: This method is not virtual and avoid dispatches for performance reasons.
+    return key_set_.has(DispatchKey::SparseCsrCPU);
+  }
+
+  // Whether this is a jagged tensor, see JaggedTensorImpl.
+  bool is_jagged() const {
+    // NB: This method is not virtual and avoid dispatches for performance reasons.
+    return key_set_.has(DispatchKey::JaggedCPU);
+  }
+
   bool is_quantized() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::QuantizedCPU) ||
@@ -502,6 +531,16 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     return key_set_.has(DispatchKey::Meta);
   }
 
+  /**
+   * Whether this is an inference tensor, i.e. it was created in InferenceMode.
+   * Inference tensors have no autograd dispatch key and no version counter,
+   * see Note [Inference tensors] in ATen/InferenceMode.h.
+   */
+  bool is_inference() const {
+    // NB: This method is not virtual and avoid dispatches for performance reasons.
+    return key_set_.has(DispatchKey::InferenceMode);
+  }
+
   bool is_cuda() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::CUDA) ||
@@ -563,6 +602,10 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     // NB: This method is not virtual and avoid dispatches for perf.
     if (is_sparse()) {
       return kSparse;
+    } else if (is_sparse_csr()) {
+      return kSparseCsr;
+    } else if (is_jagged()) {
+      return kJagged;
     } else if (is_mkldnn()) {
       return kMkldnn;
     } else {
@@ -1054,7 +1097,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     return version_counter_;
   }
 
-  void bump_version() noexcept {
+  void bump_version() {
     version_counter_.bump();
   }
 
@@ -657,6 +657,20 @@ inline DispatchKey computeDispatchKey(c10::optional<ScalarType> dtype, c10::opti
           default:
             AT_ERROR("Unsupported device type for mkldnn layout: ", device_.type());
         }
+      case Layout::SparseCsr:
+        switch (device_.type()) {
+          case DeviceType::CPU:
+            return DispatchKey::SparseCsrCPU;
+          default:
+            AT_ERROR("Unsupported device type for sparse CSR layout: ", device_.type());
+        }
+      case Layout::Jagged:
+        switch (device_.type()) {
+          case DeviceType::CPU:
+            return DispatchKey::JaggedCPU;
+          default:
+            AT_ERROR("Unsupported device type for jagged layout: ", device_.type());
+        }
       default:
         AT_ERROR("Unsupported layout: ", layout_);
     }
@@ -695,6 +709,10 @@ inline DeviceType computeDeviceType(DispatchKey tid) {
     return DeviceType::HIP;
   } else if (tid == DispatchKey::MkldnnCPU) {
     return DeviceType::CPU;
+  } else if (tid == DispatchKey::SparseCsrCPU) {
+    return DeviceType::CPU;
+  } else if (tid == DispatchKey::JaggedCPU) {
+    return DeviceType::CPU;
   } else if (tid == DispatchKey::Vulkan) {
     return DeviceType::Vulkan;
   } else if (tid == DispatchKey::Metal) {
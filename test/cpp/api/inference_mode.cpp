@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <torch/torch.h>
+
+#include <test/cpp/api/support.h>
+
+using namespace torch::test;
+
+TEST(InferenceModeTest, TestTLSState) {
+  ASSERT_FALSE(torch::InferenceMode::is_enabled());
+  {
+    torch::InferenceMode guard;
+    ASSERT_TRUE(torch::InferenceMode::is_enabled());
+    ASSERT_FALSE(at::GradMode::is_enabled());
+    {
+      torch::InferenceMode disable(false);
+      ASSERT_FALSE(torch::InferenceMode::is_enabled());
+    }
+    ASSERT_TRUE(torch::InferenceMode::is_enabled());
+  }
+  ASSERT_FALSE(torch::InferenceMode::is_enabled());
+  ASSERT_TRUE(at::GradMode::is_enabled());
+}
+
+TEST(InferenceModeTest, TestInferenceTensors) {
+  auto x = torch::ones({2, 3}, torch::requires_grad());
+  torch::Tensor y;
+  {
+    torch::InferenceMode guard;
+    y = x * x;
+    ASSERT_TRUE(y.is_inference());
+    ASSERT_FALSE(y.requires_grad());
+    ASSERT_FALSE(y.unsafeGetTensorImpl()->version_counter().enabled());
+    ASSERT_FALSE(y.key_set().has(c10::DispatchKey::AutogradCPU));
+    ASSERT_TRUE(y.view({3, 2}).is_inference());
+    y.add_(1);
+  }
+  ASSERT_FALSE(x.is_inference());
+  // Functional ops on inference tensors create normal tensors.
+  auto z = y * 2;
+  ASSERT_FALSE(z.is_inference());
+  ASSERT_TRUE(torch::allclose(z, torch::full({2, 3}, 4.)));
+}
+
+TEST(InferenceModeTest, TestMixingWithNormalTensors) {
+  auto x = torch::ones({2, 3}, torch::requires_grad());
+  torch::Tensor y;
+  {
+    torch::InferenceMode guard;
+    y = torch::ones({2, 3});
+  }
+  ASSERT_THROWS_WITH(x * y, "Inference tensors cannot be saved for backward");
+  ASSERT_THROWS_WITH(
+      y.add_(1), "Inplace update to inference tensor outside InferenceMode");
+  ASSERT_THROWS_WITH(
+      y.add_(x), "Inplace update to inference tensor outside InferenceMode");
+  ASSERT_THROWS_WITH(
+      y.requires_grad_(), "Setting requires_grad=True on inference tensor");
+  ASSERT_THROWS_WITH(y._version(), "Inference tensors do not track version counter");
+
+  // Add doesn't save its inputs.
+  (x + y).sum().backward();
+  ASSERT_TRUE(torch::allclose(x.grad(), torch::ones({2, 3})));
+
+  auto w = y.clone();
+  ASSERT_FALSE(w.is_inference());
+  w.add_(1);
+  ASSERT_EQ(w._version(), 1);
+}
+
+TEST(InferenceModeTest, TestNormalTensorsVersionCounter) {
+  auto x = torch::ones({2, 3}, torch::requires_grad());
+  auto a = torch::ones({2, 3});
+  // Saves a for backward.
+  auto y = x * a;
+  {
+    torch::InferenceMode guard;
+    a.add_(1);
+    // Views of normal tensors share their version counter.
+    auto v = a.view({6});
+    ASSERT_TRUE(v.is_inference());
+    v.mul_(2);
+    auto parts = a.split(1);
+    parts[0].mul_(2);
+    // Views of inference tensors don't track their version either.
+    auto w = torch::ones({2, 3}).view({6});
+    ASSERT_FALSE(w.unsafeGetTensorImpl()->version_counter().enabled());
+    w.mul_(2);
+  }
+  ASSERT_EQ(a._version(), 3);
+  ASSERT_THROWS_WITH(
+      y.sum().backward(), "modified by an inplace operation");
+}
@@ -236,6 +236,16 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_set_get(self, fs):
+        fs.multi_set(["multi_key0", "multi_key1"], ["value0", "value1"])
+        self.assertEqual(
+            [b"value0", b"value1"], fs.multi_get(["multi_key0", "multi_key1"])
+        )
+        self.assertEqual([], fs.multi_get([]))
+
+    def test_multi_set_get(self):
+        self._test_multi_set_get(self._create_store())
+
     # This is the number of keys used in test_set_get. Adding this as a class
     # property instead of hardcoding in the test since some Store
     # implementations will have differing number of keys. In the base case,
@@ -3997,6 +4007,94 @@ class DistributedDataParallelTest(MultiProcessTestCase):
         ):
             model.register_comm_hook(None, dummy_hook)
 
+    @requires_gloo()
+    def test_builtin_compression_comm_hooks_gloo(self):
+        """
+        This unit test verifies whether the built-in gradient compression hooks give
+        the same result as no hook on the gloo backend, both before and after the
+        compression starts. The gradient of ``ModuleForDdpCommHook`` is a constant
+        rank-1 matrix, so it can be compressed losslessly by every hook.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        for comm_hook_type in [
+            dist.BuiltinCommHookType.POWER_SGD,
+            dist.BuiltinCommHookType.TOPK_SPARSIFY,
+            dist.BuiltinCommHookType.INT8_QUANTIZE,
+        ]:
+            options = dist._GradCompressionOptions()
+            options.start_iter = 2
+            options.topk_ratio = 1.0
+            cpu_model = DistributedDataParallel(
+                ModuleForDdpCommHook().cpu(), process_group=process_group
+            )
+            cpu_model._register_builtin_comm_hook(comm_hook_type, options)
+
+            for _ in range(4):
+                cpu_model.zero_grad()
+                self._run_and_verify_hook(cpu_model, 8, 0.25 * torch.ones(2, 2))
+
+            # The iteration counter and the per-bucket error are checkpointed.
+            state_dict = dist._get_builtin_comm_hook_state_dict(cpu_model.reducer)
+            self.assertEqual(state_dict["iter"].item(), 4)
+            self.assertEqual(state_dict["bucket.0.error"], torch.zeros(4))
+            dist._load_builtin_comm_hook_state_dict(cpu_model.reducer, state_dict)
+
+    @requires_gloo()
+    def test_builtin_topk_sparsify_comm_hook_error_feedback_gloo(self):
+        """
+        With ``topk_ratio < 1``, only half of the constant gradient of
+        ``ModuleForDdpCommHook`` is communicated at every compressed iteration, and
+        the rest is carried over by error feedback. Every rank has the same
+        gradient, so the communicated gradients plus the local error add up to the
+        sum of the true gradients.
+        """
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        options = dist._GradCompressionOptions()
+        options.start_iter = 2
+        options.topk_ratio = 0.5
+        cpu_model = DistributedDataParallel(
+            ModuleForDdpCommHook().cpu(), process_group=process_group
+        )
+        cpu_model._register_builtin_comm_hook(
+            dist.BuiltinCommHookType.TOPK_SPARSIFY, options
+        )
+
+        true_grad = 0.25 * torch.ones(2, 2)
+        communicated = torch.zeros(2, 2)
+        for i in range(6):
+            cpu_model.zero_grad()
+            cpu_model(8, self.rank).mean().backward()
+            grad = cpu_model.module.t0.p.grad
+            if i < options.start_iter:
+                self.assertEqual(grad, true_grad)
+            else:
+                # Only 2 of the 4 elements are communicated.
+                self.assertEqual((grad != 0).sum().item(), 2)
+                communicated += grad
+
+        state_dict = dist._get_builtin_comm_hook_state_dict(cpu_model.reducer)
+        error = state_dict["bucket.0.error"].view(2, 2)
+        self.assertNotEqual(error, torch.zeros(2, 2))
+        self.assertEqual(communicated + error, 4 * true_grad)
+
+    @requires_gloo()
+    def test_builtin_compression_comm_hook_invalid_options(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+        cpu_model = DistributedDataParallel(
+            ModuleForDdpCommHook().cpu(), process_group=process_group
+        )
+        options = dist._GradCompressionOptions()
+        options.start_iter = 1
+        with self.assertRaisesRegex(RuntimeError, "Expect startIter > 1"):
+            cpu_model._register_builtin_comm_hook(
+                dist.BuiltinCommHookType.POWER_SGD, options
+            )
+
     @requires_gloo()
     def test_ddp_comm_hook_sparse_gradients(self):
         """
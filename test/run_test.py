@@ -63,6 +63,8 @@ TESTS = [
     'test_xnnpack_integration',
     'test_vulkan',
     'test_sparse',
+    'test_sparse_csr',
+    'test_jagged',
     'test_quantization',
     'test_pruning_op',
     'test_spectral_ops',
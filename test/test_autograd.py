@@ -1097,6 +1097,81 @@ class TestAutograd(TestCase):
             w = adder(x, y)
             self.assertFalse(torch.is_grad_enabled())
 
+    def test_inference_mode(self):
+        x = torch.ones(2, 3, requires_grad=True)
+        with torch.inference_mode():
+            self.assertTrue(torch._C._autograd._is_inference_mode_enabled())
+            self.assertFalse(torch.is_grad_enabled())
+            y = x * x
+            self.assertTrue(y.is_inference)
+            self.assertFalse(y.requires_grad)
+            self.assertIsNone(y.grad_fn)
+            # views of inference tensors are inference tensors
+            self.assertTrue(y.view(3, 2).is_inference)
+            y.add_(1)
+            with torch.inference_mode(False):
+                self.assertFalse(torch._C._autograd._is_inference_mode_enabled())
+            self.assertTrue(torch._C._autograd._is_inference_mode_enabled())
+        self.assertFalse(torch._C._autograd._is_inference_mode_enabled())
+        self.assertTrue(torch.is_grad_enabled())
+        self.assertFalse(x.is_inference)
+        self.assertEqual(y, torch.full((2, 3), 2.))
+
+        @torch.inference_mode()
+        def square(x):
+            return x * x
+
+        self.assertTrue(square(x).is_inference)
+
+        @torch.inference_mode(False)
+        def square_no_inference(x):
+            return x * x
+
+        with torch.inference_mode():
+            self.assertFalse(square_no_inference(x).is_inference)
+
+    def test_inference_mode_mixed_with_normal_tensors(self):
+        x = torch.ones(2, 3, requires_grad=True)
+        with torch.inference_mode():
+            y = torch.ones(2, 3)
+
+        # functional ops on inference tensors create normal tensors
+        self.assertFalse((y * 2).is_inference)
+        with self.assertRaisesRegex(RuntimeError, "Inference tensors cannot be saved for backward"):
+            x * y
+        with self.assertRaisesRegex(RuntimeError, "Inplace update to inference tensor outside InferenceMode"):
+            y.add_(1)
+        with self.assertRaisesRegex(RuntimeError, "Inplace update to inference tensor outside InferenceMode"):
+            y.add_(x)
+        with self.assertRaisesRegex(RuntimeError, "Setting requires_grad=True on inference tensor"):
+            y.requires_grad_()
+        with self.assertRaisesRegex(RuntimeError, "Inference tensors do not track version counter"):
+            y._version
+
+        # add doesn't save its inputs
+        (x + y).sum().backward()
+        self.assertEqual(x.grad, torch.ones(2, 3))
+
+        w = y.clone()
+        self.assertFalse(w.is_inference)
+        w.add_(1)
+        self.assertEqual(w._version, 1)
+
+    def test_inference_mode_normal_tensors_version_counter(self):
+        x = torch.ones(2, 3, requires_grad=True)
+        a = torch.ones(2, 3)
+        # saves a for backward
+        y = x * a
+        with torch.inference_mode():
+            a.add_(1)
+            # views of normal tensors share their version counter
+            v = a.view(6)
+            self.assertTrue(v.is_inference)
+            v.mul_(2)
+        self.assertEqual(a._version, 2)
+        with self.assertRaisesRegex(RuntimeError, "modified by an inplace operation"):
+            y.sum().backward()
+
     def test_set_grad_generator_functions(self):
         @torch.no_grad()
         def gen_no_grad():
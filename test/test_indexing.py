@@ -695,6 +695,27 @@ class TestIndexing(TestCase):
         y.index_put_((mask, ), y[mask], accumulate=True)
         self.assertEqual(y, torch.ones(size=(10, 10), device=device))
 
+    # A bool mask over the leading dimensions, large enough for the CPU
+    # kernels to split the work among the threads.
+    def test_bool_indices_large(self, device):
+        v = torch.randn(1000, 70, 3, device=device)
+        for p in (0.01, 0.5):
+            for mask in (torch.rand(1000, device=device) < p, torch.rand(1000, 70, device=device) < p,
+                         torch.rand(1000, 70, 3, device=device) < p):
+                indices = mask.nonzero(as_tuple=True)
+                self.assertEqual(v[mask], v[indices], atol=0, rtol=0)
+
+                values = torch.randn(v[indices].shape, device=device)
+                for accumulate in (False, True):
+                    for value in (values, values[0], torch.tensor(2., device=device)):
+                        self.assertEqual(v.index_put((mask,), value, accumulate=accumulate),
+                                         v.index_put(indices, value, accumulate=accumulate), atol=0, rtol=0)
+
+        v = torch.arange(1000, device=device).view(100, 10)
+        mask = (v % 3 == 0)[:, 0]
+        v[mask] += 1
+        self.assertEqual(v[mask][:, 0] % 3, torch.ones(mask.sum(), dtype=v.dtype, device=device))
+
     def test_multiple_bool_indices(self, device):
         v = torch.randn(5, 7, 3, device=device)
         # note: these broadcast together and are transposed to the first dim
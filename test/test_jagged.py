@@ -0,0 +1,246 @@
+import torch
+
+import itertools
+from torch.testing._internal.common_utils import TestCase, run_tests, load_tests, gradcheck
+from torch.testing._internal.common_device_type import \
+    (instantiate_device_type_tests, onlyCPU, dtypes)
+
+# load_tests from torch.testing._internal.common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+
+class TestJagged(TestCase):
+
+    def _gen_jagged(self, lengths, inner, dtype, index_dtype=torch.int64, requires_grad=False):
+        lengths = torch.tensor(lengths, dtype=torch.int64)
+        offsets = torch.cat([torch.zeros(1, dtype=torch.int64), lengths.cumsum(0)])
+        values_size = (int(offsets[-1]),) + tuple(inner)
+        if dtype.is_floating_point:
+            values = torch.randn(values_size, dtype=dtype)
+        else:
+            values = torch.randint(-5, 5, values_size, dtype=dtype)
+        values.requires_grad_(requires_grad)
+        return torch.jagged_tensor(values, offsets.to(index_dtype)), values
+
+    def _to_padded_reference(self, j, padding_value=0):
+        offsets = j.offsets().tolist()
+        values = j.values()
+        dense = torch.full(j.shape, padding_value, dtype=j.dtype)
+        for i in range(j.shape[0]):
+            dense[i, :offsets[i + 1] - offsets[i]] = values[offsets[i]:offsets[i + 1]]
+        return dense
+
+    # Skewed lengths, so that a few sequences hold most of the elements.
+    _lengths = [[], [0], [3, 0, 5], [0, 0, 0], [1] * 20 + [200] + [7] * 30]
+
+    @onlyCPU
+    def test_jagged_layout(self, device):
+        self.assertEqual(str(torch.jagged), 'torch.jagged')
+        self.assertEqual(type(torch.jagged), torch.layout)
+
+    @onlyCPU
+    @dtypes(torch.double, torch.float, torch.int64)
+    def test_jagged_constructor(self, device, dtype):
+        values = torch.arange(10, dtype=dtype).view(5, 2)
+        offsets = torch.tensor([0, 2, 2, 5])
+        j = torch.jagged_tensor(values, offsets)
+        self.assertTrue(j.is_jagged)
+        self.assertFalse(j.is_sparse)
+        self.assertEqual(j.layout, torch.jagged)
+        self.assertEqual(j.shape, (3, 3, 2))
+        self.assertEqual(j.dtype, dtype)
+        self.assertEqual(j.values(), values)
+        self.assertEqual(j.offsets(), offsets)
+        self.assertEqual(torch.jagged_tensor(values, offsets, max_length=6).shape, (3, 6, 2))
+
+        # int32 offsets
+        j32 = torch.jagged_tensor(values, offsets.int())
+        self.assertEqual(j32.offsets().dtype, torch.int32)
+        self.assertEqual(j32.to_padded_dense(), j.to_padded_dense())
+
+    @onlyCPU
+    def test_jagged_constructor_errors(self, device):
+        values = torch.randn(5, 2)
+        with self.assertRaisesRegex(RuntimeError, "start with 0"):
+            torch.jagged_tensor(values, torch.tensor([1, 2, 5]))
+        with self.assertRaisesRegex(RuntimeError, "end with the total length"):
+            torch.jagged_tensor(values, torch.tensor([0, 2, 4]))
+        with self.assertRaisesRegex(RuntimeError, "non-decreasing"):
+            torch.jagged_tensor(values, torch.tensor([0, 3, 2, 5]))
+        with self.assertRaisesRegex(RuntimeError, "int32 or int64"):
+            torch.jagged_tensor(values, torch.tensor([0., 5.]))
+        with self.assertRaisesRegex(RuntimeError, "max_length"):
+            torch.jagged_tensor(values, torch.tensor([0, 1, 5]), max_length=3)
+        with self.assertRaisesRegex(RuntimeError, "at least 1-D"):
+            torch.jagged_tensor(torch.tensor(1.), torch.tensor([0]))
+
+    @onlyCPU
+    @dtypes(torch.double, torch.float, torch.int64)
+    def test_jagged_conversions(self, device, dtype):
+        for index_dtype, lengths, inner in itertools.product(
+                [torch.int32, torch.int64], self._lengths, [(), (3,), (2, 3)]):
+            j, values = self._gen_jagged(lengths, inner, dtype, index_dtype)
+            expected = self._to_padded_reference(j)
+            self.assertEqual(j.to_padded_dense(), expected)
+            self.assertEqual(j.to_dense(), expected)
+            self.assertEqual(j.to_padded_dense(-1), self._to_padded_reference(j, -1))
+
+            # Round trip through a padded tensor, with garbage in the padding.
+            padded = j.to_padded_dense(7, j.shape[1] + 2)
+            j2 = padded.to_jagged(j.offsets())
+            self.assertEqual(j2.values(), values)
+            self.assertEqual(j2.shape[1], j.shape[1] + 2)
+            self.assertEqual(padded.to_jagged(j.offsets(), j.shape[1]).to_padded_dense(), expected)
+
+        with self.assertRaisesRegex(RuntimeError, "longest sequence"):
+            torch.zeros(2, 3).to_jagged(torch.tensor([0, 4, 5]))
+        with self.assertRaisesRegex(RuntimeError, "expected offsets of size"):
+            torch.zeros(2, 3).to_jagged(torch.tensor([0, 1]))
+
+    @onlyCPU
+    @dtypes(torch.double, torch.float)
+    def test_jagged_elementwise(self, device, dtype):
+        for lengths, inner in itertools.product(self._lengths, [(), (4,)]):
+            a, _ = self._gen_jagged(lengths, inner, dtype)
+            b = torch.jagged_tensor(torch.randn(a.values().shape, dtype=dtype).abs() + 1, a.offsets())
+            bias = torch.randn(inner, dtype=dtype)
+            padded_a = a.to_padded_dense()
+            padded_b = b.to_padded_dense()
+
+            def check(result, expected):
+                self.assertTrue(result.is_jagged)
+                self.assertEqual(result.offsets(), a.offsets())
+                self.assertEqual(result.to_padded_dense(), expected.masked_fill(padded_b == 0, 0))
+
+            check(a + b, padded_a + padded_b)
+            check(a - b, padded_a - padded_b)
+            check(a * b, padded_a * padded_b)
+            check(a / b, padded_a / padded_b)
+            check(a + bias, padded_a + bias)
+            check(bias * a, bias * padded_a)
+            check(a * 2, padded_a * 2)
+            check(a.add(b, alpha=2), padded_a.add(padded_b, alpha=2))
+            check(-a, -padded_a)
+            check(a.relu(), padded_a.relu())
+            check(a.sigmoid(), padded_a.sigmoid())
+            check(a.tanh(), padded_a.tanh())
+
+            c = a.clone()
+            c.mul_(b).add_(bias)
+            check(c, padded_a * padded_b + bias)
+            self.assertEqual(a.to_padded_dense(), padded_a)
+
+        a, _ = self._gen_jagged([2, 3], (4,), dtype)
+        with self.assertRaisesRegex(RuntimeError, "same offsets"):
+            a + torch.jagged_tensor(a.values(), torch.tensor([0, 3, 5]))
+        with self.assertRaisesRegex(RuntimeError, "inner dimensions"):
+            a + torch.randn(3, 4, dtype=dtype)
+        with self.assertRaisesRegex(RuntimeError, "in-place"):
+            torch.randn(4, dtype=dtype).add_(a)
+
+    @onlyCPU
+    @dtypes(torch.double, torch.float, torch.int64)
+    def test_jagged_reductions(self, device, dtype):
+        for index_dtype, lengths, inner in itertools.product(
+                [torch.int32, torch.int64], self._lengths, [(), (5,), (2, 17)]):
+            j, _ = self._gen_jagged(lengths, inner, dtype, index_dtype)
+            padded = j.to_padded_dense()
+            self.assertEqual(j.sum(1), padded.sum(1))
+            self.assertEqual(j.sum(1, keepdim=True), padded.sum(1, keepdim=True))
+            self.assertEqual(j.sum(), padded.sum())
+            if len(inner) > 0:
+                self.assertEqual(j.sum((1, 2)), padded.sum((1, 2)))
+            if dtype.is_floating_point:
+                lengths_t = torch.tensor(lengths, dtype=dtype).view((-1,) + (1,) * len(inner))
+                self.assertEqual(j.mean(1), padded.sum(1) / lengths_t)
+            if len(lengths) > 0 and all(l > 0 for l in lengths):
+                padded_min = j.to_padded_dense(torch.iinfo(dtype).min if not dtype.is_floating_point else float('-inf'))
+                self.assertEqual(j.amax(1), padded_min.amax(1))
+
+        j, _ = self._gen_jagged([2, 0, 3], (4,), dtype)
+        with self.assertRaisesRegex(RuntimeError, "jagged dimension"):
+            j.sum(2)
+        with self.assertRaisesRegex(RuntimeError, "empty sequence"):
+            j.amax(1)
+
+    @onlyCPU
+    @dtypes(torch.double, torch.float)
+    def test_jagged_bmm(self, device, dtype):
+        for index_dtype, lengths, (n, m) in itertools.product(
+                [torch.int32, torch.int64], self._lengths, [(0, 3), (5, 0), (5, 3), (33, 17)]):
+            j, _ = self._gen_jagged(lengths, (n,), dtype, index_dtype)
+            mat2 = torch.randn(len(lengths), n, m, dtype=dtype)
+            result = j.bmm(mat2)
+            self.assertTrue(result.is_jagged)
+            self.assertEqual(result.offsets(), j.offsets())
+            self.assertEqual(result.to_padded_dense(), j.to_padded_dense().bmm(mat2))
+            # Non-contiguous mat2
+            self.assertEqual(j.bmm(mat2.transpose(1, 2).contiguous().transpose(1, 2)).values(), result.values())
+
+        j, _ = self._gen_jagged([2, 3], (4,), dtype)
+        with self.assertRaisesRegex(RuntimeError, "one per sequence"):
+            j.bmm(torch.ones(3, 4, 2, dtype=dtype))
+
+    @onlyCPU
+    def test_jagged_backward(self, device):
+        lengths = [3, 0, 5, 1]
+        j, values = self._gen_jagged(lengths, (4,), torch.double, requires_grad=True)
+        offsets = j.offsets()
+        bias = torch.randn(4, dtype=torch.double, requires_grad=True)
+        mat2 = torch.randn(len(lengths), 4, 3, dtype=torch.double, requires_grad=True)
+
+        def jagged(v):
+            return torch.jagged_tensor(v, offsets)
+
+        gradcheck(lambda v: jagged(v).to_padded_dense(), (values,), check_batched_grad=False)
+        gradcheck(lambda v: (jagged(v) * 3).relu().to_padded_dense(), (values,), check_batched_grad=False)
+        gradcheck(lambda v, b: (jagged(v) * b).tanh().values(), (values, bias), check_batched_grad=False)
+        gradcheck(lambda v, b: (jagged(v) + b).sigmoid().to_dense(), (values, bias), check_batched_grad=False)
+        gradcheck(lambda v, m: jagged(v).bmm(m).values(), (values, mat2), check_batched_grad=False)
+        gradcheck(lambda d: d.to_jagged(offsets).values(), (torch.randn(4, 5, 4, dtype=torch.double, requires_grad=True),),
+                  check_batched_grad=False)
+
+        jagged(values).bmm(mat2).to_padded_dense().sum().backward()
+        self.assertEqual(mat2.grad, j.to_padded_dense().transpose(1, 2).bmm(torch.ones(4, 5, 3, dtype=torch.double)))
+
+        # amax needs non-empty sequences
+        nonempty_offsets = torch.tensor([0, 3, 8, 9])
+        values = torch.randn(9, 4, 2, dtype=torch.double, requires_grad=True)
+        for dim in [1, (1, 2), (1, 3), (0, 1), ()]:
+            gradcheck(lambda v: torch.jagged_tensor(v, nonempty_offsets).amax(dim), (values,), check_batched_grad=False)
+        gradcheck(lambda v: torch.jagged_tensor(v, nonempty_offsets).amax(1, keepdim=True), (values,), check_batched_grad=False)
+
+        values = torch.randn(9, 4, dtype=torch.cdouble, requires_grad=True)
+        mat2 = torch.randn(3, 4, 3, dtype=torch.cdouble, requires_grad=True)
+        gradcheck(lambda v, m: torch.jagged_tensor(v, nonempty_offsets).bmm(m).values(), (values, mat2),
+                  check_batched_grad=False)
+
+        values = torch.randn(9, 4, 2, dtype=torch.double, requires_grad=True)
+        for op in ("sum", "mean"):
+            for dim in [1, (1, 2), (1, 3), (0, 1)]:
+                gradcheck(lambda v: getattr(torch.jagged_tensor(v, nonempty_offsets), op)(dim), (values,),
+                          check_batched_grad=False)
+            gradcheck(lambda v: getattr(torch.jagged_tensor(v, nonempty_offsets), op)(1, keepdim=True), (values,),
+                      check_batched_grad=False)
+            gradcheck(lambda v: getattr(torch.jagged_tensor(v, nonempty_offsets), op)(), (values,),
+                      check_batched_grad=False)
+        # the gradient of an empty sequence is empty
+        values = j.values().detach().requires_grad_()
+        gradcheck(lambda v: jagged(v).sum(1), (values,), check_batched_grad=False)
+        jagged(values).sum(1).sum().backward()
+        self.assertEqual(values.grad, torch.ones_like(values))
+
+    @onlyCPU
+    def test_jagged_print(self, device):
+        j = torch.jagged_tensor(torch.tensor([1., 2., 3.]), torch.tensor([0, 1, 1, 3]))
+        self.assertExpectedInline(str(j), """\
+tensor(values=tensor([1., 2., 3.]),
+       offsets=tensor([0, 1, 1, 3]),
+       size=(3, 2), layout=torch.jagged)""")
+
+
+instantiate_device_type_tests(TestJagged, globals())
+
+if __name__ == '__main__':
+    run_tests()
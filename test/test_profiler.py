@@ -1,7 +1,9 @@
 import collections
 import gc
 import io
+import json
 import os
+import threading
 import unittest
 
 import torch
@@ -399,6 +401,26 @@ class TestProfiler(TestCase):
             sort_by="self_cuda_time_total", row_limit=-1)
         self.assertIn("FLOPS", profiler_output)
 
+    def test_perf_counters(self):
+        x = torch.randn(64, 64)
+        with _profile(with_perf_counters=True) as prof:
+            torch.mm(x, x)
+        mm_events = [e for e in prof.function_events if e.name == "aten::mm"]
+        self.assertEqual(len(mm_events), 1)
+        profiler_output = prof.key_averages().table(sort_by="cpu_time_total", row_limit=-1)
+        if not torch.autograd._perf_counters_available():
+            # Counters are silently dropped.
+            self.assertIsNone(mm_events[0].perf_counters)
+            self.assertNotIn("Cycles", profiler_output)
+            return
+        counters = mm_events[0].perf_counters
+        self.assertIsNotNone(counters)
+        for count in counters.values():
+            self.assertGreaterEqual(count, 0)
+        if "instructions" in counters:
+            self.assertGreater(counters["instructions"], 0)
+            self.assertIn("Instructions", profiler_output)
+
     @unittest.skipIf(not kineto_available(), "Kineto is required")
     @unittest.skipIf(not torch.cuda.is_available(), "CUDA is required")
     def test_kineto_profiler_api(self):
@@ -495,6 +517,109 @@ class TestProfiler(TestCase):
                 file_num += 1
             self.assertEqual(file_num, 3)
 
+    def test_sampling_profiler(self):
+        x = torch.randn(10, 10)
+        torch.autograd._enable_sampling_profiler(1.0)
+        try:
+            self.assertTrue(torch.autograd._sampling_profiler_enabled())
+            for _ in range(5):
+                torch.mm(x, x)
+            stats = {s.name: s for s in torch.autograd._sampling_profiler_snapshot(delta=True)}
+            self.assertEqual(stats["aten::mm"].count, 5)
+            self.assertEqual(sum(stats["aten::mm"].buckets), 5)
+            self.assertGreater(stats["aten::mm"].total_ns, 0)
+            self.assertGreater(stats["aten::mm"].quantile_ns(0.5), 0)
+
+            # Ops sampled on other threads are part of the snapshot, even
+            # after the threads exited.
+            def payload():
+                for _ in range(3):
+                    torch.mm(x, x)
+            threads = [threading.Thread(target=payload) for _ in range(2)]
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join()
+            stats = {s.name: s for s in torch.autograd._sampling_profiler_snapshot(delta=True)}
+            self.assertEqual(stats["aten::mm"].count, 6)
+
+            stats = {s.name: s for s in torch.autograd._sampling_profiler_snapshot()}
+            self.assertEqual(stats["aten::mm"].count, 11)
+        finally:
+            torch.autograd._disable_sampling_profiler()
+        self.assertFalse(torch.autograd._sampling_profiler_enabled())
+        self.assertEqual(torch.autograd._sampling_profiler_snapshot(), [])
+
+    def test_streaming_trace(self):
+        x = torch.randn(10, 10)
+        with TemporaryFileName(mode="w+") as fname:
+            torch.autograd._enable_streaming_trace(fname, buffer_events=1024, flush_interval_ms=10)
+            try:
+                self.assertTrue(torch.autograd._streaming_trace_enabled())
+                for _ in range(5):
+                    torch.mm(x, x)
+            finally:
+                stats = torch.autograd._disable_streaming_trace()
+            self.assertFalse(torch.autograd._streaming_trace_enabled())
+            self.assertEqual(stats.events_dropped, 0)
+
+            with io.open(fname, 'r') as f:
+                trace = json.load(f)
+            self.assertEqual(len(trace["traceEvents"]), stats.events_written)
+            mm_events = [e for e in trace["traceEvents"] if e["name"] == "aten::mm"]
+            self.assertEqual(len(mm_events), 5)
+            for e in mm_events:
+                self.assertEqual(e["ph"], "X")
+                self.assertGreaterEqual(e["dur"], 0)
+
+    def test_streaming_trace_bounded(self):
+        x = torch.randn(2, 2)
+        with TemporaryFileName(mode="w+") as fname:
+            # The flusher does not run before disabling, so all but the first
+            # events of the buffer are dropped.
+            torch.autograd._enable_streaming_trace(fname, buffer_events=16, flush_interval_ms=60000)
+            try:
+                for _ in range(100):
+                    torch.mm(x, x)
+            finally:
+                stats = torch.autograd._disable_streaming_trace()
+            self.assertEqual(stats.events_written, 16)
+            # torch.mm may record nested ops too.
+            self.assertGreaterEqual(stats.events_written + stats.events_dropped, 100)
+            with io.open(fname, 'r') as f:
+                self.assertEqual(len(json.load(f)["traceEvents"]), 16)
+
+    def test_memory_tracker(self):
+        from torch.utils import memory_tracker
+
+        model = nn.Sequential(nn.Linear(128, 256), nn.ReLU(), nn.Linear(256, 16))
+        x = torch.randn(64, 128)
+        with memory_tracker.track_memory(model) as tracker:
+            self.assertTrue(torch.autograd._memory_tracker_enabled())
+            y = model(x)
+            del y
+        self.assertFalse(torch.autograd._memory_tracker_enabled())
+
+        snapshot = tracker.snapshot()
+        # The output of the first linear layer, at least, is alive at peak.
+        self.assertGreaterEqual(snapshot["peak_bytes"], 64 * 256 * 4)
+        self.assertEqual(sum(site["peak_bytes"] for site in snapshot["sites"]), snapshot["peak_bytes"])
+        modules = {key for key, _, _ in memory_tracker.peak_breakdown([snapshot], group_by="module")}
+        self.assertIn("0 (Linear)", modules)
+        self.assertIn("2 (Linear)", modules)
+        self.assertIn("Peak memory", tracker.table(group_by="op"))
+
+        with TemporaryFileName(mode="w+") as fname:
+            tracker.save(fname)
+            trace = memory_tracker.load(fname)
+        self.assertEqual(trace["peak_bytes"], snapshot["peak_bytes"])
+        self.assertEqual(
+            memory_tracker.peak_breakdown([trace], group_by="scope"),
+            memory_tracker.peak_breakdown([snapshot], group_by="scope"))
+        self.assertEqual(
+            max(nbytes for _, nbytes in memory_tracker.timeline(trace)),
+            trace["peak_bytes"])
+
 
 if __name__ == '__main__':
     run_tests()
@@ -11,7 +11,7 @@ from itertools import product, combinations, permutations
 from torch._six import inf, nan
 from torch.testing._internal.common_utils import (
     TestCase, run_tests, TEST_SCIPY, slowTest, torch_to_numpy_dtype_dict,
-    IS_WINDOWS)
+    IS_WINDOWS, gradcheck)
 from torch.testing._internal.common_device_type import (
     instantiate_device_type_tests, onlyCPU, dtypes, dtypesIfCUDA, dtypesIfCPU,
     onlyOnCPUAndCUDA, onlyCUDA, expectedAlertNondeterministic, largeTensorTest)
@@ -610,6 +610,96 @@ class TestReductions(TestCase):
         self._test_minmax_helper(_amin_wrapper, np.amin, device, dtype)
         self._test_minmax_helper(_amax_wrapper, np.amax, device, dtype)
 
+    def _segment_reduce_reference(self, data, reduce, lengths, axis):
+        results = []
+        for segment in data.split(lengths.tolist(), axis):
+            if segment.size(axis) == 0:
+                empty = {'sum': 0, 'mean': nan, 'max': -inf if data.is_floating_point() else torch.iinfo(data.dtype).min}
+                size = list(data.shape)
+                size[axis] = 1
+                results.append(torch.full(size, empty[reduce], dtype=data.dtype, device=data.device))
+            elif reduce == 'max':
+                results.append(segment.amax(axis, keepdim=True))
+            else:
+                results.append(getattr(segment, reduce)(axis, keepdim=True))
+        size = list(data.shape)
+        size[axis] = 0
+        return torch.cat(results, axis) if results else torch.empty(size, dtype=data.dtype, device=data.device)
+
+    @onlyCPU
+    @dtypes(torch.float, torch.double, torch.long)
+    def test_segment_reduce(self, device, dtype):
+        # Skewed lengths, so that a few segments hold most of the rows.
+        all_lengths = [[], [0], [3], [2, 0, 5, 1], [1] * 50 + [300] + [0] * 10 + [7] * 40]
+        for lengths, inner, axis, index_dtype in product(all_lengths, [(), (1,), (5,), (2, 17)], [0, 1, -1],
+                                                         [torch.int, torch.long]):
+            length = sum(lengths)
+            shape = {0: (length,) + inner, 1: (3, length) + inner, -1: inner + (length,)}[axis]
+            axis_ = axis % len(shape)
+            data = _generate_input(shape, dtype, device, with_extremal=False)
+            lengths_t = torch.tensor(lengths, dtype=index_dtype, device=device)
+            offsets_t = torch.cat([lengths_t.new_zeros(1), lengths_t.cumsum(0).to(index_dtype)])
+            reductions = ['sum', 'max'] + (['mean'] if dtype.is_floating_point else [])
+            for reduce in reductions:
+                expected = self._segment_reduce_reference(data, reduce, lengths_t, axis_)
+                self.assertEqual(torch.segment_reduce(data, reduce, lengths=lengths_t, axis=axis), expected)
+                self.assertEqual(torch.segment_reduce(data, reduce, offsets=offsets_t, axis=axis), expected)
+                # Non-contiguous data
+                data_t = data.t().contiguous().t() if data.dim() == 2 else data
+                self.assertEqual(torch.segment_reduce(data_t, reduce, lengths=lengths_t, axis=axis), expected)
+
+        data = torch.randn(6, 3, dtype=torch.double, device=device) if dtype.is_floating_point else \
+            torch.randint(-5, 5, (6, 3), dtype=dtype, device=device)
+        lengths = torch.tensor([2, 0, 4], device=device)
+        self.assertEqual(torch.segment_reduce(data, 'sum', lengths=lengths, initial=7)[1], torch.full((3,), 7, dtype=data.dtype))
+        self.assertEqual(torch.segment_reduce(data, 'max', lengths=lengths, initial=-1)[1], torch.full((3,), -1, dtype=data.dtype))
+        # initial also starts the reduction of non-empty segments
+        for inner in (data, data[:, :1]):
+            segments = [inner[:2], inner[2:]]
+            self.assertEqual(torch.segment_reduce(inner, 'sum', lengths=lengths, initial=7)[::2],
+                             torch.stack([s.sum(0) + 7 for s in segments]))
+            self.assertEqual(torch.segment_reduce(inner, 'max', lengths=lengths, initial=0)[::2],
+                             torch.stack([s.amax(0).clamp(min=0) for s in segments]))
+            if dtype.is_floating_point:
+                self.assertEqual(torch.segment_reduce(inner, 'mean', lengths=lengths, initial=7)[::2],
+                                 torch.stack([(s.sum(0) + 7) / s.size(0) for s in segments]))
+
+    @onlyCPU
+    @dtypes(torch.double)
+    def test_segment_reduce_backward(self, device, dtype):
+        lengths = torch.tensor([2, 0, 3, 1], device=device)
+        for reduce, shape, axis in product(['sum', 'mean', 'max'], [(6,), (6, 4), (2, 6, 9)], [0, 1]):
+            if axis >= len(shape) or shape[axis] != 6:
+                continue
+            data = torch.randn(shape, dtype=dtype, device=device, requires_grad=True)
+            gradcheck(lambda x: torch.segment_reduce(x, reduce, lengths=lengths, axis=axis, initial=0), (data,))
+
+        # The gradient of a max is split evenly between the elements equal to it.
+        data = torch.tensor([[1., 3.], [3., 3.], [2., 3.], [5., 0.]], dtype=dtype, device=device, requires_grad=True)
+        torch.segment_reduce(data, 'max', lengths=torch.tensor([3, 1])).sum().backward()
+        self.assertEqual(data.grad, torch.tensor([[0., 1 / 3], [1., 1 / 3], [0., 1 / 3], [1., 1.]], dtype=dtype))
+
+    @onlyCPU
+    def test_segment_reduce_errors(self, device):
+        data = torch.randn(5, 2, device=device)
+        lengths = torch.tensor([2, 3])
+        with self.assertRaisesRegex(RuntimeError, "exactly one of lengths and offsets"):
+            torch.segment_reduce(data, 'sum')
+        with self.assertRaisesRegex(RuntimeError, "exactly one of lengths and offsets"):
+            torch.segment_reduce(data, 'sum', lengths=lengths, offsets=torch.tensor([0, 2, 5]))
+        with self.assertRaisesRegex(RuntimeError, "unsupported reduction"):
+            torch.segment_reduce(data, 'prod', lengths=lengths)
+        with self.assertRaisesRegex(RuntimeError, "cover the 5 elements"):
+            torch.segment_reduce(data, 'sum', lengths=torch.tensor([2, 2]))
+        with self.assertRaisesRegex(RuntimeError, "non-negative"):
+            torch.segment_reduce(data, 'sum', lengths=torch.tensor([6, -1]))
+        with self.assertRaisesRegex(RuntimeError, "non-decreasing"):
+            torch.segment_reduce(data, 'sum', offsets=torch.tensor([0, 3, 2, 5]))
+        with self.assertRaisesRegex(RuntimeError, "int32 or int64"):
+            torch.segment_reduce(data, 'sum', lengths=lengths.float())
+        with self.assertRaisesRegex(RuntimeError, "floating point"):
+            torch.segment_reduce(data.long(), 'mean', lengths=lengths)
+
     # TODO: bincount isn't a classic reduction -- maybe this test suite is
     #   reductions and summary ops?
     def test_bincount(self, device):
@@ -607,6 +607,24 @@ class TestShapeOps(TestCase):
         self.assertEqual(dst1, dst4, atol=0, rtol=0)
         self.assertEqual(strides, dst4.stride())
 
+    # Sizes large enough for the CPU kernel to split the tensor among the
+    # threads, with sparse, dense and clustered nonzero elements.
+    @dtypes(torch.bool, torch.uint8, torch.int8, torch.int32, torch.int64, torch.float, torch.double,
+            torch.half, torch.bfloat16)
+    def test_nonzero_large(self, device, dtype):
+        numel = 3 * 5 * 7 * 1001
+        clustered = torch.zeros(numel, device=device)
+        clustered[40000:70000] = 1
+        inputs = [(torch.rand(numel, device=device) < p).float() for p in (0.001, 0.5, 0.999)]
+        inputs += [clustered, torch.zeros(numel, device=device)]
+        for t in inputs:
+            t = t.to(dtype)
+            for shape in [(numel,), (3, 5, 7 * 1001), (15, 1, 7007)]:
+                # contiguous and discontiguous inputs
+                for x in (t.view(shape), t.view(shape).transpose(0, -1)):
+                    np_result = torch.from_numpy(np.stack(x.cpu().float().numpy().nonzero())).t()
+                    self.assertEqual(x.nonzero().cpu(), np_result, atol=0, rtol=0)
+
     def test_nonzero_non_diff(self, device):
         x = torch.randn(10, requires_grad=True)
         nz = x.nonzero()
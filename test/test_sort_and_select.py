@@ -113,6 +113,41 @@ class TestSortAndSelect(TestCase):
         self.assertIsOrdered('descending', x, res2val, res2ind,
                              'random with NaNs')
 
+    # Slices this long are sorted by several threads at once on CPU
+    @dtypes(*(torch.testing.get_all_int_dtypes() + [torch.bool, torch.half, torch.float, torch.double]))
+    def test_sort_large_slice(self, device, dtype):
+        n = 1 << 17
+        if dtype == torch.bool:
+            x = torch.randint(0, 2, (n,), device=device).to(dtype)
+        else:
+            x = make_tensor((n,), device, dtype, low=-100, high=100)
+        if dtype.is_floating_point:
+            x[torch.randperm(n, device=device)[:100]] = nan
+            x[torch.randperm(n, device=device)[:100]] = -float('inf')
+        for descending in (False, True):
+            values, indices = torch.sort(x, descending=descending)
+            expected = torch.from_numpy(np.sort(x.cpu().numpy()))
+            if descending:
+                # numpy sorts NaN last, we sort it first in descending order
+                expected = expected.flip(0)
+            self.assertEqual(values, expected.to(device))
+            self.assertEqual(x[indices], values)
+            self.assertEqual(indices.sort()[0], torch.arange(n, device=device))
+
+        # several large slices along a non-contiguous dimension
+        if dtype == torch.float:
+            x = make_tensor((n, 2), device, dtype, low=-100, high=100)
+            values, indices = torch.sort(x, dim=0)
+            self.assertEqual(values, torch.from_numpy(np.sort(x.cpu().numpy(), axis=0)).to(device))
+            self.assertEqual(x.gather(0, indices), values)
+
+            # the sorted values keep their bits, e.g. the sign and payload of NaNs
+            x = make_tensor((n,), device, dtype, low=-100, high=100)
+            x[:2].view(torch.int32).copy_(torch.tensor([-0x3fffff, 0x7fc00123], dtype=torch.int32))
+            for descending in (False, True):
+                values, indices = torch.sort(x, descending=descending)
+                self.assertEqual(values.view(torch.int32), x[indices].view(torch.int32))
+
     @dtypes(*(torch.testing.get_all_int_dtypes() + torch.testing.get_all_fp_dtypes(include_bfloat16=False)))
     def test_msort(self, device, dtype):
         def test(shape):
@@ -460,6 +495,30 @@ class TestSortAndSelect(TestCase):
         self.assertEqual(val, expected_val, atol=0, rtol=0)
         self.assertEqual(ind, expected_ind, atol=0, rtol=0)
 
+    # Slices this long are split between several threads on CPU
+    @dtypes(torch.int32, torch.int64, torch.float, torch.double)
+    def test_topk_large_slice(self, device, dtype):
+        n = 1 << 17
+        x = make_tensor((n,), device, dtype, low=-1000, high=1000)
+        if dtype.is_floating_point:
+            x[torch.randperm(n, device=device)[:10]] = nan
+        for k, largest in product((1, 10, 1000, n // 3, n), (True, False)):
+            values, indices = x.topk(k, largest=largest)
+            expected = x.sort(descending=largest)[0][:k]
+            self.assertEqual(values, expected)
+            self.assertEqual(x[indices], values)
+            self.assertEqual(indices.unique().numel(), k)
+
+            values, indices = x.topk(k, largest=largest, sorted=False)
+            self.assertEqual(values.sort(descending=largest)[0], expected)
+            self.assertEqual(x[indices], values)
+
+        # along a non-contiguous dimension
+        x = make_tensor((n, 3), device, dtype, low=-1000, high=1000)
+        values, indices = x.topk(5, dim=0)
+        self.assertEqual(values, x.sort(dim=0, descending=True)[0][:5])
+        self.assertEqual(x.gather(0, indices), values)
+
     def _test_unique_scalar_empty(self, dtype, device, f):
         # test scalar
         x = torch.tensor(0, dtype=dtype, device=device)
@@ -584,6 +643,36 @@ class TestSortAndSelect(TestCase):
             self._test_unique_with_expects(device, dtype, f, x, expected_unique, expected_inverse, expected_counts, (3, 3))
             self._test_unique_scalar_empty(dtype, device, f)
 
+    # Inputs this large are deduplicated by several threads on CPU
+    @dtypes(torch.bool, torch.int32, torch.int64, torch.float, torch.double)
+    def test_unique_large(self, device, dtype):
+        n = 1 << 18
+        if dtype == torch.bool:
+            x = torch.randint(0, 2, (n,), device=device).to(dtype)
+        else:
+            x = torch.randint(-5000, 5000, (n,), device=device).to(dtype)
+        x = x.view(64, -1)
+        expected_unique, expected_inverse, expected_counts = (
+            torch.from_numpy(t).to(device) for t in np.unique(
+                x.cpu().numpy(), return_inverse=True, return_counts=True))
+        expected_inverse = expected_inverse.view(x.shape)
+
+        unique, inverse, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+        self.assertEqual(unique, expected_unique)
+        self.assertEqual(inverse, expected_inverse)
+        self.assertEqual(counts, expected_counts)
+
+        unique, inverse, counts = torch.unique(x, sorted=False, return_inverse=True, return_counts=True)
+        self.assertEqual(unique.sort()[0], expected_unique)
+        self.assertEqual(unique[inverse], x)
+        self.assertEqual(counts, torch.bincount(inverse.view(-1), minlength=unique.numel()))
+
+        y = x.view(-1).sort()[0]
+        unique, inverse, counts = torch.unique_consecutive(y, return_inverse=True, return_counts=True)
+        self.assertEqual(unique, expected_unique)
+        self.assertEqual(unique[inverse], y)
+        self.assertEqual(counts, expected_counts)
+
     @dtypes(torch.double)
     def test_kthvalue(self, device, dtype):
         SIZE = 50
@@ -0,0 +1,257 @@
+import torch
+
+import itertools
+from torch.testing._internal.common_utils import TestCase, run_tests, load_tests, gradcheck
+from torch.testing._internal.common_device_type import \
+    (instantiate_device_type_tests, onlyCPU, dtypes)
+
+# load_tests from torch.testing._internal.common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+
+class TestSparseCSR(TestCase):
+
+    def _gen_sparse_csr(self, nrows, ncols, nnz, dtype, index_dtype=torch.int64, device='cpu'):
+        # Random CSR matrix with unsorted, possibly duplicate column indices;
+        # the rows are skewed so that some of them hold most of the elements.
+        rows = torch.randint(0, max(nrows, 1), (nnz,)) ** 2 // max(nrows, 1)
+        rows, _ = rows.sort()
+        counts = torch.bincount(rows, minlength=nrows) if nnz > 0 else torch.zeros(nrows, dtype=torch.int64)
+        crow_indices = torch.cat([torch.zeros(1, dtype=torch.int64), counts.cumsum(0)])
+        col_indices = torch.randint(0, max(ncols, 1), (nnz,))
+        values = torch.randn(nnz).to(dtype)
+        return torch.sparse_csr_tensor(crow_indices.to(index_dtype), col_indices.to(index_dtype), values,
+                                       (nrows, ncols), device=device)
+
+    def _to_dense_reference(self, s):
+        crow_indices = s.crow_indices().tolist()
+        col_indices = s.col_indices().tolist()
+        values = s.values()
+        dense = torch.zeros(s.shape, dtype=s.dtype)
+        for i in range(s.shape[0]):
+            for p in range(crow_indices[i], crow_indices[i + 1]):
+                dense[i, col_indices[p]] += values[p]
+        return dense
+
+    @onlyCPU
+    def test_csr_layout(self, device):
+        self.assertEqual(str(torch.sparse_csr), 'torch.sparse_csr')
+        self.assertEqual(type(torch.sparse_csr), torch.layout)
+
+    @onlyCPU
+    @dtypes(torch.double, torch.float, torch.int64)
+    def test_sparse_csr_constructor(self, device, dtype):
+        crow_indices = torch.tensor([0, 2, 2, 3])
+        col_indices = torch.tensor([0, 2, 1])
+        values = torch.tensor([1, 2, 3], dtype=dtype)
+        s = torch.sparse_csr_tensor(crow_indices, col_indices, values, (3, 4))
+        self.assertTrue(s.is_sparse_csr)
+        self.assertFalse(s.is_sparse)
+        self.assertEqual(s.layout, torch.sparse_csr)
+        self.assertEqual(s.shape, (3, 4))
+        self.assertEqual(s.dtype, dtype)
+        self.assertEqual(s._nnz(), 3)
+        self.assertEqual(s.crow_indices(), crow_indices)
+        self.assertEqual(s.col_indices(), col_indices)
+        self.assertEqual(s.values(), values)
+        self.assertEqual(s.to_dense(), torch.tensor([[1, 0, 2, 0], [0, 0, 0, 0], [0, 3, 0, 0]], dtype=dtype))
+
+        # Shape inference
+        self.assertEqual(torch.sparse_csr_tensor(crow_indices, col_indices, values).shape, (3, 3))
+
+        # dtype conversion of the values
+        self.assertEqual(torch.sparse_csr_tensor(crow_indices, col_indices, values, (3, 4),
+                                                 dtype=torch.float32).dtype, torch.float32)
+
+        # int32 indices
+        s32 = torch.sparse_csr_tensor(crow_indices.int(), col_indices.int(), values, (3, 4))
+        self.assertEqual(s32.crow_indices().dtype, torch.int32)
+        self.assertEqual(s32.to_dense(), s.to_dense())
+
+    @onlyCPU
+    def test_sparse_csr_constructor_errors(self, device):
+        crow_indices = torch.tensor([0, 2, 2, 3])
+        col_indices = torch.tensor([0, 2, 1])
+        values = torch.tensor([1., 2., 3.])
+        with self.assertRaisesRegex(RuntimeError, "must be 2-D"):
+            torch.sparse_csr_tensor(crow_indices, col_indices, values, (3, 4, 1))
+        with self.assertRaisesRegex(RuntimeError, "nrows \\+ 1"):
+            torch.sparse_csr_tensor(crow_indices, col_indices, values, (2, 4))
+        with self.assertRaisesRegex(RuntimeError, "same number of elements"):
+            torch.sparse_csr_tensor(crow_indices, col_indices, values[:2], (3, 4))
+        with self.assertRaisesRegex(RuntimeError, "same dtype"):
+            torch.sparse_csr_tensor(crow_indices.int(), col_indices, values, (3, 4))
+        with self.assertRaisesRegex(RuntimeError, "column index"):
+            torch.sparse_csr_tensor(crow_indices, col_indices, values, (3, 2))
+        with self.assertRaisesRegex(RuntimeError, "non-decreasing"):
+            torch.sparse_csr_tensor(torch.tensor([0, 2, 1, 3]), col_indices, values, (3, 4))
+        with self.assertRaisesRegex(RuntimeError, "must end with nnz"):
+            torch.sparse_csr_tensor(torch.tensor([0, 2, 2, 2]), col_indices, values, (3, 4))
+
+    @onlyCPU
+    @dtypes(torch.double, torch.float, torch.cdouble, torch.int64)
+    def test_sparse_csr_to_dense(self, device, dtype):
+        for index_dtype in [torch.int32, torch.int64]:
+            for nrows, ncols, nnz in [(0, 0, 0), (5, 0, 0), (0, 5, 0), (10, 7, 0), (10, 7, 30), (100, 30, 500)]:
+                s = self._gen_sparse_csr(nrows, ncols, nnz, dtype, index_dtype)
+                self.assertEqual(s.to_dense(), self._to_dense_reference(s))
+
+    @onlyCPU
+    @dtypes(torch.double, torch.float, torch.int64)
+    def test_sparse_csr_conversions(self, device, dtype):
+        dense = torch.tensor([[0, 0, 0], [9, 0, 10], [0, 0, 0], [1, 2, 3]], dtype=dtype)
+        s = dense.to_sparse_csr()
+        self.assertEqual(s.crow_indices(), torch.tensor([0, 0, 2, 2, 5]))
+        self.assertEqual(s.col_indices(), torch.tensor([0, 2, 0, 1, 2]))
+        self.assertEqual(s.values(), torch.tensor([9, 10, 1, 2, 3], dtype=dtype))
+        self.assertEqual(s.to_dense(), dense)
+        self.assertIs(s.to_sparse_csr(), s)
+
+        coo = s.to_sparse()
+        self.assertTrue(coo.is_sparse)
+        self.assertTrue(coo.is_coalesced())
+        self.assertEqual(coo.to_dense(), dense)
+        self.assertEqual(coo.to_sparse_csr().to_dense(), dense)
+
+        # Duplicates are summed when converting from an uncoalesced COO tensor.
+        uncoalesced = torch.sparse_coo_tensor([[1, 0, 1], [2, 1, 2]], torch.tensor([1, 2, 3], dtype=dtype), (2, 3))
+        self.assertEqual(uncoalesced.to_sparse_csr().to_dense(), uncoalesced.to_dense())
+
+        with self.assertRaisesRegex(RuntimeError, "2-D"):
+            torch.ones(2, 2, 2).to_sparse_csr()
+
+    @onlyCPU
+    @dtypes(torch.double, torch.float)
+    def test_sparse_csr_transpose(self, device, dtype):
+        for nrows, ncols, nnz in [(0, 0, 0), (10, 7, 0), (10, 7, 30), (50, 80, 400)]:
+            s = self._gen_sparse_csr(nrows, ncols, nnz, dtype)
+            t = s.t()
+            self.assertTrue(t.is_sparse_csr)
+            self.assertEqual(t.shape, (ncols, nrows))
+            self.assertEqual(t.to_dense(), s.to_dense().t())
+            self.assertEqual(s.transpose(0, 1).to_dense(), s.to_dense().t())
+            self.assertEqual(t.t().to_dense(), s.to_dense())
+
+    @onlyCPU
+    @dtypes(torch.double, torch.float, torch.cdouble, torch.int64)
+    def test_sparse_csr_mm(self, device, dtype):
+        def make_dense(*shape):
+            return torch.randn(*shape).to(dtype) if dtype.is_floating_point or dtype.is_complex \
+                else torch.randint(-5, 5, shape, dtype=dtype)
+
+        for index_dtype, (m, n, k, nnz) in itertools.product(
+                [torch.int32, torch.int64],
+                [(0, 0, 0, 0), (10, 7, 0, 20), (10, 7, 5, 0), (10, 7, 5, 30), (100, 60, 33, 1000)]):
+            s = self._gen_sparse_csr(m, n, nnz, dtype, index_dtype)
+            if not (dtype.is_floating_point or dtype.is_complex):
+                s = torch.sparse_csr_tensor(s.crow_indices(), s.col_indices(), make_dense(nnz), (m, n))
+            expected_s = s.to_dense()
+
+            d = make_dense(n, k)
+            self.assertEqual(s.mm(d), expected_s.mm(d))
+            self.assertEqual(torch.mm(s, d.t().contiguous().t()), expected_s.mm(d))
+            out = torch.empty(0, dtype=dtype)
+            torch.mm(s, d, out=out)
+            self.assertEqual(out, expected_s.mm(d))
+
+            # dense @ sparse
+            d2 = make_dense(k, m)
+            self.assertEqual(torch.mm(d2, s), d2.mm(expected_s))
+
+            # addmm
+            t = make_dense(m, k)
+            self.assertEqual(torch.addmm(t, s, d, beta=2, alpha=3), torch.addmm(t, expected_s, d, beta=2, alpha=3))
+            # broadcasting self
+            t1 = make_dense(k)
+            self.assertEqual(torch.addmm(t1, s, d), torch.addmm(t1, expected_s, d))
+            out = torch.empty(m, k, dtype=dtype).t()
+            torch.addmm(t, s, d, out=out)
+            self.assertEqual(out, torch.addmm(t, expected_s, d))
+
+            # mv
+            v = make_dense(n)
+            self.assertEqual(s.mv(v), expected_s.mv(v))
+            v2 = make_dense(2 * n)[::2]
+            self.assertEqual(torch.mv(s, v2), expected_s.mv(v2))
+
+    @onlyCPU
+    def test_sparse_csr_mm_beta_zero(self, device):
+        s = self._gen_sparse_csr(10, 7, 30, torch.double)
+        d = torch.randn(7, 5)
+        t = torch.full((10, 5), float('nan'))
+        self.assertEqual(torch.addmm(t, s, d, beta=0), s.to_dense().mm(d))
+
+    @onlyCPU
+    def test_sparse_csr_mm_errors(self, device):
+        s = self._gen_sparse_csr(10, 7, 30, torch.double)
+        with self.assertRaisesRegex(RuntimeError, "Expected dim 0 size"):
+            s.mm(torch.randn(6, 5))
+        with self.assertRaisesRegex(RuntimeError, "same dtype"):
+            s.mm(torch.randn(7, 5, dtype=torch.float))
+        with self.assertRaisesRegex(RuntimeError, "self.size\\(-1\\) == vec.size\\(-1\\)"):
+            s.mv(torch.randn(6))
+
+    @onlyCPU
+    def test_sparse_csr_mm_backward(self, device):
+        s = self._gen_sparse_csr(10, 7, 30, torch.double)
+        expected_s = s.to_dense()
+        d = torch.randn(7, 5, dtype=torch.double, requires_grad=True)
+        d2 = torch.randn(4, 10, dtype=torch.double, requires_grad=True)
+        v = torch.randn(7, dtype=torch.double, requires_grad=True)
+        gradcheck(lambda d: s.mm(d), (d,), check_batched_grad=False)
+        gradcheck(lambda d2: d2.mm(s), (d2,), check_batched_grad=False)
+        gradcheck(lambda v: s.mv(v), (v,), check_batched_grad=False)
+
+        s.mm(d).sum().backward()
+        self.assertEqual(d.grad, expected_s.t().mm(torch.ones(10, 5, dtype=torch.double)))
+
+    @onlyCPU
+    def test_sparse_csr_mm_sparse_backward(self, device):
+        s = self._gen_sparse_csr(10, 7, 30, torch.double)
+        crow_indices, col_indices = s.crow_indices(), s.col_indices()
+        values = s.values().clone().requires_grad_()
+        d = torch.randn(7, 5, dtype=torch.double, requires_grad=True)
+        d2 = torch.randn(4, 10, dtype=torch.double, requires_grad=True)
+        t = torch.randn(10, 5, dtype=torch.double, requires_grad=True)
+
+        def csr(values):
+            return torch.sparse_csr_tensor(crow_indices, col_indices, values, s.shape)
+
+        gradcheck(lambda v, d: csr(v).mm(d), (values, d), check_batched_grad=False)
+        gradcheck(lambda v, d2: d2.mm(csr(v)), (values, d2), check_batched_grad=False)
+        gradcheck(lambda t, v, d: torch.addmm(t, csr(v), d, beta=2, alpha=3), (t, values, d), check_batched_grad=False)
+
+        # The gradient of the sparse operand only has its specified elements,
+        # with the same indices.
+        x = csr(values)
+        grad_output = torch.randn(10, 5, dtype=torch.double)
+        grad_x, = torch.autograd.grad(x.mm(d), x, grad_output)
+        self.assertTrue(grad_x.is_sparse_csr)
+        self.assertEqual(grad_x.crow_indices(), crow_indices)
+        self.assertEqual(grad_x.col_indices(), col_indices)
+        rows = torch.repeat_interleave(crow_indices[1:] - crow_indices[:-1])
+        self.assertEqual(grad_x.values(), grad_output.mm(d.t())[rows, col_indices])
+
+    @onlyCPU
+    def test_sparse_csr_print(self, device):
+        s = torch.sparse_csr_tensor(torch.tensor([0, 2, 2, 3]), torch.tensor([0, 2, 1]), torch.tensor([1., 2., 3.]), (3, 4))
+        self.assertExpectedInline(str(s), """\
+tensor(crow_indices=tensor([0, 2, 2, 3]),
+       col_indices=tensor([0, 2, 1]),
+       values=tensor([1., 2., 3.]),
+       size=(3, 4), nnz=3, layout=torch.sparse_csr)""")
+
+    @onlyCPU
+    def test_sparse_csr_inference_mode(self, device):
+        s = self._gen_sparse_csr(10, 7, 30, torch.float)
+        d = torch.randn(7, 5)
+        with torch.inference_mode():
+            self.assertEqual(s.t().t().mm(d), s.to_dense().mm(d))
+            self.assertEqual(s.values(), s.values())
+
+
+instantiate_device_type_tests(TestSparseCSR, globals())
+
+if __name__ == '__main__':
+    run_tests()
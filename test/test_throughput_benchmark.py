@@ -1,4 +1,6 @@
 
+import json
+
 import torch
 from torch.utils import ThroughputBenchmark
 from torch.testing import assert_allclose
@@ -66,7 +68,76 @@ class TestThroughputBenchmark(TestCase):
         )
 
         print(stats)
+        self.assertGreaterEqual(stats.latency_p99_ms, stats.latency_p50_ms)
+
+    def batched_test(self, **kwargs):
+        D_in = 10
+        H = 5
+        D_out = 15
+        NUM_INPUTS = 4
+
+        module = TwoLayerNet(D_in, H, D_out).eval()
+        bench = ThroughputBenchmark(module)
+        for i in range(NUM_INPUTS):
+            # one row per request, batches are made of several requests
+            bench.add_input(torch.randn(1, D_in), torch.randn(1, D_in))
+
+        stats = bench.benchmark(
+            num_calling_threads=4,
+            num_warmup_iters=10,
+            num_iters=200,
+            max_batch_size=8,
+            max_batch_delay_us=2000,
+            num_worker_threads=2,
+            **kwargs
+        )
+        print(stats)
+        self.assertEqual(stats.num_iters, 200)
+        self.assertGreaterEqual(stats.avg_batch_size, 1)
+        self.assertLessEqual(stats.avg_batch_size, 8)
+        self.assertGreaterEqual(stats.latency_p90_ms, stats.latency_p50_ms)
+        self.assertGreaterEqual(stats.latency_p99_ms, stats.latency_p90_ms)
+
+    def test_batched(self):
+        self.batched_test()
+
+    def test_batched_open_loop(self):
+        self.batched_test(target_qps=2000)
+
+    def test_batched_static_runtime(self):
+        self.batched_test(use_static_runtime=True)
+
+    def test_open_loop(self):
+        module = TwoLayerNet(10, 5, 15)
+        bench = ThroughputBenchmark(module)
+        bench.add_input(torch.randn(8, 10), torch.randn(8, 10))
+        stats = bench.benchmark(
+            num_calling_threads=2,
+            num_warmup_iters=5,
+            num_iters=200,
+            target_qps=1000,
+            throughput_interval_ms=50,
+        )
+        print(stats)
+        self.assertEqual(stats.num_iters, 200)
+        self.assertEqual(stats.warmup_num_iters, 10)
+        self.assertGreaterEqual(stats.latency_p999_ms, stats.latency_p99_ms)
+        self.assertGreater(len(stats.interval_iters_per_second), 0)
+        self.assertTrue(all(qps >= 0 for qps in stats.interval_iters_per_second))
 
+        with TemporaryFileName() as fname:
+            stats.export_json(fname)
+            with open(fname) as f:
+                result = json.load(f)
+        self.assertEqual(result["config"]["target_qps"], 1000)
+        self.assertEqual(result["stats"]["num_iters"], 200)
+        self.assertEqual(result["warmup"]["num_iters"], 10)
+
+    def test_batched_module(self):
+        bench = ThroughputBenchmark(TwoLayerNetModule(10, 5, 15))
+        bench.add_input(torch.randn(1, 10), torch.randn(1, 10))
+        with self.assertRaisesRegex(RuntimeError, "only supported for ScriptModule"):
+            bench.benchmark(max_batch_size=8)
 
     def test_script_module(self):
         self.linear_test(TwoLayerNet)
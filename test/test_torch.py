@@ -3948,6 +3948,75 @@ class TestTorchDeviceType(TestCase):
             self.assertTrue(y.is_contiguous())
             self.assertEqual(expected, actual)
 
+    @onlyCPU
+    @dtypes(torch.float, torch.double)
+    def test_cdist_topk(self, device, dtype):
+        def reference(x1, x2, k, metric):
+            x1, x2 = x1.double(), x2.double()
+            if metric == 'euclidean':
+                return torch.cdist(x1, x2).topk(k, dim=1, largest=False)
+            elif metric == 'inner_product':
+                return x1.mm(x2.t()).topk(k, dim=1)
+            else:
+                return torch.cosine_similarity(x1.unsqueeze(1), x2.unsqueeze(0), dim=2).topk(k, dim=1)
+
+        # Sizes that span several blocks of rows and columns of the kernel.
+        for (n, m, d), metric in product([(0, 4, 3), (5, 4, 0), (1, 1, 1), (7, 10, 5), (70, 1300, 7), (33, 600, 64)],
+                                         ['euclidean', 'inner_product', 'cosine']):
+            x1 = torch.randn(n, d, dtype=dtype, device=device)
+            x2 = torch.randn(m, d, dtype=dtype, device=device)
+            for k in sorted({0, 1, min(m, 10), m}):
+                values, indices = torch.cdist_topk(x1, x2, k, metric=metric)
+                self.assertEqual(values.shape, (n, k))
+                self.assertEqual(indices.dtype, torch.long)
+                expected_values, expected_indices = reference(x1, x2, k, metric)
+                self.assertEqual(values, expected_values.to(dtype))
+                if d > 0 and dtype == torch.double:
+                    self.assertEqual(indices, expected_indices)
+                # Non-contiguous inputs
+                values2, indices2 = torch.cdist_topk(x1.t().contiguous().t(), x2.t().contiguous().t(), k, metric)
+                self.assertEqual(values2, values)
+                self.assertEqual(indices2, indices)
+
+        # Ties go to the lower index.
+        x2 = torch.tensor([[1., 0.], [0., 1.], [1., 0.], [2., 2.]], dtype=dtype, device=device)
+        x1 = torch.tensor([[1., 0.]], dtype=dtype, device=device)
+        self.assertEqual(torch.cdist_topk(x1, x2, 3).indices, [[0, 2, 1]])
+        self.assertEqual(torch.cdist_topk(x1, x2, 2, metric='cosine').indices, [[0, 2]])
+
+        # nan distances are the farthest.
+        x2[1, 0] = nan
+        values, indices = torch.cdist_topk(x1, x2, 4)
+        self.assertEqual(indices, [[0, 2, 3, 1]])
+        self.assertTrue(values[0, 3].isnan())
+
+    @onlyCPU
+    def test_cdist_topk_grad(self, device):
+        x1 = torch.randn(6, 4, dtype=torch.double, device=device, requires_grad=True)
+        x2 = torch.randn(9, 4, dtype=torch.double, device=device, requires_grad=True)
+        for metric in ['euclidean', 'inner_product', 'cosine']:
+            torch.autograd.gradcheck(lambda a, b: torch.cdist_topk(a, b, 3, metric).values, (x1, x2))
+        with torch.no_grad():
+            self.assertFalse(torch.cdist_topk(x1, x2, 3).values.requires_grad)
+
+    @onlyCPU
+    def test_cdist_topk_errors(self, device):
+        x1 = torch.randn(3, 4, device=device)
+        x2 = torch.randn(5, 4, device=device)
+        with self.assertRaisesRegex(RuntimeError, "2D tensors"):
+            torch.cdist_topk(x1.unsqueeze(0), x2, 2)
+        with self.assertRaisesRegex(RuntimeError, "same number of columns"):
+            torch.cdist_topk(x1, x2[:, :3], 2)
+        with self.assertRaisesRegex(RuntimeError, "between 0 and the number of rows"):
+            torch.cdist_topk(x1, x2, 6)
+        with self.assertRaisesRegex(RuntimeError, "unsupported metric"):
+            torch.cdist_topk(x1, x2, 2, metric='manhattan')
+        for dtype in (torch.long, torch.half, torch.bfloat16):
+            with self.assertRaisesRegex(RuntimeError, "float and double"):
+                torch.cdist_topk(x1.to(dtype), x2.to(dtype), 2)
+        with self.assertRaisesRegex(RuntimeError, "same dtype"):
+            torch.cdist_topk(x1, x2.double(), 2)
+
     def test_multinomial_constraints(self, device):
         x = torch.empty(1, 2, 3, dtype=torch.double, device=device)
         self.assertRaisesRegex(
@@ -4175,6 +4244,45 @@ class TestTorchDeviceType(TestCase):
                 'expected scalar_type Double but found Float'):
             torch.logcumsumexp(b, axis, out=inplace_out)
 
+    # Scans this long are split between several threads on CPU
+    @onlyCPU
+    def test_cumulative_ops_long_dim(self, device):
+        def check(actual, expected):
+            self.assertEqual(actual.cpu(), torch.from_numpy(expected), exact_dtype=False)
+
+        n = 1 << 18
+        for dtype in (torch.int32, torch.int64, torch.double):
+            x = torch.randint(-10, 10, (n,), device=device, dtype=dtype)
+            for t in (x, x.view(2, -1).t()):
+                t_np = t.cpu().numpy()
+                check(t.cumsum(0), np.cumsum(t_np, axis=0))
+
+                signs = t.sign()
+                signs[signs == 0] = 1
+                check(signs.cumprod(0), np.cumprod(signs.cpu().numpy(), axis=0))
+
+                # the index of the last occurrence of the running extremum
+                positions = np.arange(t_np.shape[0]).reshape((-1,) + (1,) * (t.dim() - 1))
+                for fn, np_fn in ((torch.cummax, np.maximum), (torch.cummin, np.minimum)):
+                    values, indices = fn(t, 0)
+                    expected_values = np_fn.accumulate(t_np, axis=0)
+                    check(values, expected_values)
+                    check(indices, np.maximum.accumulate(np.where(t_np == expected_values, positions, 0), axis=0))
+
+        # contiguous int64 and double scans are vectorized, but for their tail
+        for dtype in (torch.int64, torch.double):
+            for size in (1, 3, 4, 5, 8, 11, 33):
+                x = torch.randint(-10, 10, (size,), device=device, dtype=dtype)
+                check(x.cumsum(0), np.cumsum(x.cpu().numpy()))
+                signs = x.sign()
+                signs[signs == 0] = 1
+                check(signs.cumprod(0), np.cumprod(signs.cpu().numpy()))
+
+        x = torch.randn(n, device=device, dtype=torch.double)
+        check(x.logcumsumexp(0), np.logaddexp.accumulate(x.cpu().numpy()))
+        x[:1000] = -inf
+        check(x.logcumsumexp(0), np.logaddexp.accumulate(x.cpu().numpy()))
+
     def _test_diff_numpy(self, t, dims=None):
         # Helper for test_diff to compare with NumPy reference implementation
         def to_np(t):
@@ -4582,6 +4690,57 @@ class TestTorchDeviceType(TestCase):
                          torch.tensor([[3], [1]], device=device,
                                       dtype=torch.float32).repeat(1, width))
 
+    # Many duplicate indices, skewed so that a few rows get most of the
+    # updates, for sizes where the CPU kernel splits the indices among the
+    # threads (in parallel over the outer dimension, with per-thread buffers
+    # for a small destination, or by partitioning the indices by destination).
+    @dtypes(torch.double, torch.long, torch.int)
+    def test_index_add_scatter_add_skewed_indices(self, device, dtype):
+        def make_source(size):
+            if dtype.is_floating_point:
+                return torch.randn(size, dtype=dtype, device=device)
+            return torch.randint(-5, 5, size, dtype=dtype, device=device)
+
+        for num_dest, num_indices, inner, zipf in product([1, 8, 20000], [20000], [1, 3, 40], [0, 1.5]):
+            if zipf == 0:
+                index = torch.randint(num_dest, (num_indices,), device=device)
+            else:
+                weights = torch.arange(1, num_dest + 1, dtype=torch.double).pow(-zipf)
+                index = torch.multinomial(weights, num_indices, replacement=True).to(device)
+            source = make_source((num_indices, inner))
+            dest = make_source((num_dest, inner))
+            expected = dest.index_put((index,), source, accumulate=True)
+            self.assertEqual(dest.index_add(0, index, source), expected)
+            self.assertEqual(dest.index_add(0, index.int(), source), expected)
+            self.assertEqual(dest.scatter_add(0, index.view(-1, 1).expand(-1, inner), source), expected)
+            self.assertEqual(dest.t().contiguous().index_add(1, index, source.t()), expected.t())
+            self.assertEqual(dest.view(-1).index_add(0, index, source[:, 0]),
+                             dest.view(-1).index_put((index,), source[:, 0], accumulate=True))
+
+        # A batch of destinations along the outer dimension.
+        index = torch.randint(100, (5000,), device=device)
+        source = make_source((16, 5000, 4))
+        dest = make_source((16, 100, 4))
+        expected = dest.index_put((None, index), source, accumulate=True)
+        self.assertEqual(dest.index_add(1, index, source), expected)
+        self.assertEqual(dest.scatter_add(1, index.view(1, -1, 1).expand(16, -1, 4), source), expected)
+
+        # src larger than index along the other dimensions.
+        index = torch.randint(10, (3000,), device=device)
+        source = make_source((3000, 7))
+        dest = make_source((10, 5))
+        self.assertEqual(dest.scatter_add(0, index.view(-1, 1).expand(-1, 5), source),
+                         dest.index_put((index,), source[:, :5], accumulate=True))
+
+        if self.device_type != 'cpu':
+            return
+        dest = make_source((10, 5))
+        with self.assertRaisesRegex(RuntimeError, "index 10 is out of bounds for dimension 0 with size 10"):
+            dest.scatter_add(0, torch.tensor([0, 10], device=device).view(-1, 1).expand(-1, 5),
+                             make_source((2, 5)))
+        with self.assertRaisesRegex(IndexError, "out of range"):
+            dest.index_add(0, torch.tensor([0, -1], device=device), make_source((2, 5)))
+
     @dtypes(*(torch.testing.get_all_fp_dtypes(include_bfloat16=False, include_half=False) +
               torch.testing.get_all_complex_dtypes()))
     @dtypesIfCPU(*(torch.testing.get_all_fp_dtypes(include_bfloat16=False, include_half=True) +
@@ -4780,6 +4939,24 @@ class TestTorchDeviceType(TestCase):
                 self.assertEqual(out_dc, expected, atol=0, rtol=0)
 
 
+    # Sizes large enough for the CPU kernel to split the compaction among the
+    # threads, with sparse, dense and clustered masks.
+    @dtypes(torch.float, torch.double, torch.long, torch.uint8, torch.bool, torch.cfloat)
+    def test_masked_select_large(self, device, dtype):
+        numel = 100003
+        src = torch.arange(numel, device=device).to(dtype)
+        clustered = torch.zeros(numel, dtype=torch.bool, device=device)
+        clustered[40000:70000] = True
+        masks = [torch.rand(numel, device=device) < p for p in (0.001, 0.5, 0.999)]
+        masks += [clustered, torch.zeros(numel, dtype=torch.bool, device=device)]
+        for mask in masks:
+            expected = src[mask.nonzero(as_tuple=True)]
+            self.assertEqual(src.masked_select(mask), expected, atol=0, rtol=0)
+            self.assertEqual(src.view(7, -1).masked_select(mask.view(7, -1)), expected, atol=0, rtol=0)
+            out = torch.empty(2 * expected.numel(), dtype=dtype, device=device)[::2]
+            torch.masked_select(src, mask, out=out)
+            self.assertEqual(out, expected, atol=0, rtol=0)
+
     def test_masked_fill_bool_tensor(self, device):
         dst = torch.tensor([True, False, True], device=device)
         mask = torch.tensor([False, True, False], device=device)
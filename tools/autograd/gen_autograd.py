@@ -18,6 +18,7 @@ torch/csrc/autograd/generated/
 #
 #  gen_autograd_functions.py: generates subclasses of torch::autograd::Node
 #  gen_variable_type.py: generates VariableType.h which contains all tensor methods
+#  gen_inference_mode_type.py: generates the kernels of the InferenceMode key
 #  gen_python_functions.py: generates Python bindings to THPVariable
 #
 
@@ -58,6 +59,9 @@ VIEW_FUNCTIONS = {
     '_values': 'self',
     'indices': 'self',
     'values': 'self',
+    'crow_indices': 'self',
+    'col_indices': 'self',
+    'offsets': 'self',
     # sparse_coo ctor output should really be views of both indices and values,
     # but we only supports making as view of a single variable, and indices is
     # discrete anyways.
@@ -104,9 +108,12 @@ def gen_autograd(
     # Generate VariableType.h/cpp
     from .gen_trace_type import gen_trace_type
     from .gen_variable_type import gen_variable_type
+    from .gen_inference_mode_type import gen_inference_mode_type
     if not disable_autograd:
         gen_variable_type(out, native_functions_path, differentiability_infos, template_path, operator_selector)
 
+        gen_inference_mode_type(out, native_functions_path, template_path, operator_selector)
+
         # operator filter not applied as tracing sources are excluded in selective build
         gen_trace_type(out, native_functions_path, template_path)
 
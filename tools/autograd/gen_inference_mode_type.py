@@ -0,0 +1,172 @@
+# Generates InferenceModeType.cpp, the kernels of the InferenceMode key.
+#
+# In InferenceMode the autograd kernels are skipped, so the ops that mutate or
+# alias their inputs get a kernel for the InferenceMode key instead, which
+# does the bookkeeping of VariableType that is still needed for normal
+# tensors: it bumps the version of the mutated tensors, and makes the views
+# of a normal tensor share its version counter.  Inference tensors don't
+# track their version, so for them the kernels just redispatch.  The other ops
+# fall through the InferenceMode key.
+#
+# See Note [Inference tensors] in ATen/InferenceMode.h.
+#
+from typing import List, Optional, Sequence
+
+from .gen_autograd import VIEW_FUNCTIONS, RETURNS_VIEWS_OF_INPUT
+from .gen_trace_type import declare_returned_variables, tie_return_values, get_return_value, type_wrapper_name
+
+from tools.codegen.api.types import *
+import tools.codegen.api.cpp as cpp
+from tools.codegen.code_template import CodeTemplate
+from tools.codegen.context import with_native_function
+from tools.codegen.gen import parse_native_yaml, FileManager
+from tools.codegen.model import *
+from tools.codegen.selective_build.selector import SelectiveBuilder
+
+# Like their manual autograd kernels in VariableTypeManual.cpp, these ops don't
+# bump the version of the tensors they update.
+DONT_INCREMENT_VERSION = {
+    'resize_', 'resize_as_', 'detach_',
+}
+
+REDISPATCH = CodeTemplate("""\
+static auto op = c10::Dispatcher::singleton()
+    .findSchemaOrThrow("aten::${operator_name}", "${overload_name}")
+    .typed<${arg_types}>();
+${assign_return_values}c10::Dispatcher::singleton()
+    .redispatch<${ret_and_arg_types}>(${redispatch_args});
+""")
+
+INPLACE_BODY = CodeTemplate("""\
+const bool enabled = at::InferenceMode::is_enabled();
+${check_inplace}
+${declare_returned_variables}
+${redispatch}
+${increment_version}
+${return_value}
+""")
+
+INCREMENT_VERSION = CodeTemplate("""\
+if (enabled) {
+  ${increment_version}
+}
+""")
+
+VIEW_BODY = CodeTemplate("""\
+${redispatch}
+if (!at::InferenceMode::is_enabled() || !tracks_version(${base})) {
+  return tmp;
+}
+return torch::autograd::as_view(/* base */ ${base}, /* output */ tmp, /* is_bw_differentiable */ false,
+                                /* is_fw_differentiable */ false);
+""")
+
+METHOD_DEFINITION = CodeTemplate("""\
+${return_type} ${type_wrapper_name}(${formals}) {
+  ${type_definition_body}
+}
+""")
+
+WRAPPER_REGISTRATION = CodeTemplate("""\
+m.impl("${name}",
+       TORCH_FN(${class_type}::${type_wrapper_name})
+);
+""")
+
+def mutated_arguments(f: NativeFunction) -> List[Argument]:
+    return [a for a in f.func.schema_order_arguments() if a.annotation is not None and a.annotation.is_write]
+
+def view_base(f: NativeFunction) -> Optional[str]:
+    base_name = f.func.name.name.base
+    view_info = VIEW_FUNCTIONS.get(base_name, None)
+    if view_info is None and base_name in RETURNS_VIEWS_OF_INPUT:
+        view_info = 'self'
+    return view_info
+
+def needs_kernel(f: NativeFunction) -> bool:
+    # Like VariableType, only the ops that aren't implemented in terms of other
+    # ops need the bookkeeping, and the manually registered ones only handle
+    # metadata (e.g. requires_grad_ doesn't bump the version of self).
+    if not f.is_abstract or f.manual_kernel_registration:
+        return False
+    return len(mutated_arguments(f)) > 0 or view_base(f) is not None
+
+def emit_redispatch(f: NativeFunction, assign_return_values: str) -> str:
+    dispatcher_sig = DispatcherSignature.from_schema(f.func)
+    dispatcher_exprs = dispatcher_sig.exprs()
+
+    ret_and_arg_types = ', '.join([dispatcher_sig.returns_type()] + [a.type.cpp_type() for a in dispatcher_exprs])
+    # See Note [Plumbing Keys Through The Dispatcher] for details.
+    dispatch_key_set = 'ks & c10::DispatchKeySet(c10::DispatchKeySet::FULL_AFTER, c10::DispatchKey::InferenceMode)'
+    redispatch_args = ', '.join(['op', dispatch_key_set] + [a.expr for a in dispatcher_exprs])
+
+    return REDISPATCH.substitute(
+        operator_name=f.func.name.name,
+        overload_name=f.func.name.overload_name,
+        arg_types=dispatcher_sig.type(),
+        assign_return_values=assign_return_values,
+        ret_and_arg_types=ret_and_arg_types,
+        redispatch_args=redispatch_args,
+    )
+
+def emit_body(f: NativeFunction) -> List[str]:
+    mutated = mutated_arguments(f)
+    if not mutated:
+        base = view_base(f)
+        assert base is not None
+        return [VIEW_BODY.substitute(redispatch=emit_redispatch(f, 'auto tmp = '), base=base)]
+
+    assign_return_values = f'{tie_return_values(f)} = ' \
+                           if f.func.kind() == SchemaKind.functional and f.func.returns else ''
+    increment_version = ''
+    if cpp.name(f.func) not in DONT_INCREMENT_VERSION:
+        increment_version = INCREMENT_VERSION.substitute(
+            increment_version=[f'increment_version({a.name});' for a in mutated])
+    return [INPLACE_BODY.substitute(
+        check_inplace=[f'check_inplace({a.name}, enabled);' for a in mutated],
+        declare_returned_variables=declare_returned_variables(f),
+        redispatch=emit_redispatch(f, assign_return_values),
+        increment_version=increment_version,
+        return_value=f'return {get_return_value(f)};' if f.func.returns else '',
+    )]
+
+@with_native_function
+def method_definition(f: NativeFunction) -> str:
+    formals = ', '.join(
+        # See Note [Plumbing Keys Through The Dispatcher] for details.
+        ['c10::DispatchKeySet ks'] +
+        [f'{cpp.argument_type(a, binds="__placeholder__").cpp_type()} {a.name}'
+            for a in f.func.schema_order_arguments()]
+    )
+
+    return METHOD_DEFINITION.substitute(
+        return_type=cpp.returns_type(f.func.returns),
+        type_wrapper_name=type_wrapper_name(f),
+        formals=formals,
+        type_definition_body=emit_body(f),
+    )
+
+@with_native_function
+def method_registration(f: NativeFunction) -> str:
+    return WRAPPER_REGISTRATION.substitute(
+        name=f.func.name,
+        type_wrapper_name=type_wrapper_name(f),
+        class_type='InferenceModeType',
+    )
+
+def gen_inference_mode_type(
+    out: str,
+    native_yaml_path: str,
+    template_path: str,
+    operator_selector: SelectiveBuilder,
+) -> None:
+    native_functions: Sequence[NativeFunction] = list(sorted(filter(
+        lambda f: operator_selector.is_native_function_selected_for_training(f) and needs_kernel(f),
+        parse_native_yaml(native_yaml_path)), key=lambda f: cpp.name(f.func)))
+
+    fm = FileManager(install_dir=out, template_dir=template_path, dry_run=False)
+    fm.write_with_template('InferenceModeType.cpp', 'InferenceModeType.cpp', lambda: {
+        'generated_comment': '@' + f'generated from {fm.template_dir}/InferenceModeType.cpp',
+        'inference_mode_method_definitions': list(map(method_definition, native_functions)),
+        'inference_mode_wrapper_registrations': list(map(method_registration, native_functions)),
+    })
@@ -305,6 +305,13 @@ def saved_variables(
             'type': 'IntArrayRef',
             'expr': stride_expr,
         }),
+        # replace jagged_offsets(self) with self_jagged_offsets, which is only
+        # defined for jagged tensors so that strided tensors aren't saved
+        (r'jagged_offsets\({}\)', {
+            'suffix': '_jagged_offsets',
+            'type': 'at::Tensor',
+            'expr': lambda name: f'{name}.is_jagged() ? {name}.offsets() : at::Tensor()',
+        }),
     ]
 
     # find which arguments need to be saved
@@ -0,0 +1,64 @@
+#include "torch/csrc/autograd/VariableTypeUtils.h"
+
+#include <ATen/InferenceMode.h>
+#include <torch/library.h>
+
+// ${generated_comment}
+
+// The ops that mutate or alias their inputs go through these kernels, which
+// keep the version counters of normal tensors correct in InferenceMode. The
+// other ops fall through the InferenceMode key.
+// See Note [Inference tensors] in ATen/InferenceMode.h.
+
+using namespace at;
+
+namespace torch {
+
+namespace InferenceModeType {
+
+namespace {
+
+// Inference tensors don't track their version, so they can only be updated
+// inplace in InferenceMode, where nothing reads their version.
+void check_inplace(const Tensor& tensor, bool enabled) {
+  TORCH_CHECK(
+      enabled || !tensor.is_inference(),
+      "Inplace update to inference tensor outside InferenceMode is not allowed. "
+      "You can make a clone to get a normal tensor before doing inplace update.");
+}
+
+void check_inplace(TensorList tensors, bool enabled) {
+  for (const auto& tensor : tensors) {
+    check_inplace(tensor, enabled);
+  }
+}
+
+bool tracks_version(const Tensor& tensor) {
+  return tensor.unsafeGetTensorImpl()->version_counter().enabled();
+}
+
+void increment_version(const Tensor& tensor) {
+  if (tracks_version(tensor)) {
+    tensor.unsafeGetTensorImpl()->bump_version();
+  }
+}
+
+void increment_version(TensorList tensors) {
+  for (const auto& tensor : tensors) {
+    increment_version(tensor);
+  }
+}
+
+${inference_mode_method_definitions}
+}  // namespace
+}  // namespace InferenceModeType
+
+namespace {
+
+TORCH_LIBRARY_IMPL(aten, InferenceMode, m) {
+  ${inference_mode_wrapper_registrations};
+}
+
+}  // namespace
+
+} // namespace torch
@@ -832,6 +832,8 @@ def main() -> None:
         DispatchKey.CPU,
         DispatchKey.SparseCPU,
         DispatchKey.MkldnnCPU,
+        DispatchKey.SparseCsrCPU,
+        DispatchKey.JaggedCPU,
         DispatchKey.CUDA,
         DispatchKey.SparseCUDA,
         DispatchKey.QuantizedCPU,
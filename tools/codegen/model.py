@@ -78,6 +78,8 @@ class DispatchKey(Enum):
     SparseCUDA = auto()
     SparseHIP = auto()
     SparseXPU = auto()
+    SparseCsrCPU = auto()
+    JaggedCPU = auto()
     NestedTensor = auto()
     PrivateUse1 = auto()
     PrivateUse2 = auto()
@@ -87,6 +89,7 @@ class DispatchKey(Enum):
     Meta = auto()
     BackendSelect = auto()
     Named = auto()
+    InferenceMode = auto()
     AutogradOther = auto()
     AutogradCPU = auto()
     AutogradCUDA = auto()
@@ -26,7 +26,8 @@ class ProfilerConfig:
         report_input_shapes: bool,
         profile_memory: bool,
         with_stack: bool,
-        with_flops: bool
+        with_flops: bool,
+        with_perf_counters: bool = ...
     ) -> None: ...
     ...
 
@@ -46,6 +47,7 @@ class ProfilerEvent:
     def shapes(self) -> List[List[int]]: ...
     def thread_id(self) -> int: ...
     def flops(self) -> float: ...
+    def perf_counters(self) -> List[int]: ...
     ...
 
 class KinetoEvent:
@@ -64,9 +66,61 @@ def _enable_profiler(config: ProfilerConfig, activities: Set[ProfilerActivity])
 def _prepare_profiler(config: ProfilerConfig, activities: Set[ProfilerActivity]) -> None: ...
 def _disable_profiler() -> ProfilerResult: ...
 def _profiler_enabled() -> bool: ...
+def _perf_counters_available() -> bool: ...
 def kineto_available() -> bool: ...
 def _enable_record_function(enable: bool) -> None: ...
 def _set_empty_test_observer(is_global: bool, sampling_prob: float) -> None: ...
 
 def _enable_profiler_legacy(config: ProfilerConfig) -> None: ...
 def _disable_profiler_legacy() -> List[List[ProfilerEvent]]: ...
+
+class _SampledOpStats:
+    name: str
+    count: int
+    total_ns: int
+    buckets: List[int]
+    def quantile_ns(self, q: float) -> float: ...
+
+def _enable_sampling_profiler(sampling_prob: float = ...) -> None: ...
+def _disable_sampling_profiler() -> None: ...
+def _sampling_profiler_enabled() -> bool: ...
+def _sampling_profiler_snapshot(delta: bool = ...) -> List[_SampledOpStats]: ...
+
+class _StreamingTraceStats:
+    events_written: int
+    events_dropped: int
+
+def _enable_streaming_trace(
+    path: str,
+    buffer_events: int = ...,
+    flush_interval_ms: int = ...,
+    capture_delay_ms: int = ...,
+    capture_duration_ms: int = ...
+) -> None: ...
+def _disable_streaming_trace() -> _StreamingTraceStats: ...
+def _streaming_trace_enabled() -> bool: ...
+
+class _MemorySiteStats:
+    scope: List[str]
+    live_bytes: int
+    peak_bytes: int
+    total_bytes: int
+    num_allocs: int
+
+class _MemoryTrackerSnapshot:
+    current_bytes: int
+    peak_bytes: int
+    peak_time_ns: int
+    events_dropped: int
+    sites: List[_MemorySiteStats]
+
+def _enable_memory_tracker(max_events: int = ...) -> None: ...
+def _disable_memory_tracker() -> None: ...
+def _memory_tracker_enabled() -> bool: ...
+def _memory_tracker_snapshot() -> _MemoryTrackerSnapshot: ...
+def _save_memory_trace(path: str) -> None: ...
+
+class _InferenceMode:
+    def __init__(self, enabled: bool) -> None: ...
+
+def _is_inference_mode_enabled() -> bool: ...
@@ -1,6 +1,6 @@
 from torch import Tensor
 from enum import Enum
-from typing import Optional, List, Any, overload
+from typing import Optional, List, Any, Callable, Dict, overload
 from datetime import timedelta
 
 # This module is defined in torch/csrc/distributed/c10d/init.cpp
@@ -11,9 +11,26 @@ _DEFAULT_NO_TIMEOUT: timedelta
 class BuiltinCommHookType(Enum):
     ALLREDUCE = ...
     FP16_COMPRESS = ...
+    POWER_SGD = ...
+    TOPK_SPARSIFY = ...
+    INT8_QUANTIZE = ...
+
+class _GradCompressionOptions:
+    matrix_approximation_rank: int
+    topk_ratio: float
+    start_iter: int
+    use_error_feedback: bool
+    warm_start: bool
+    random_seed: int
+    def __init__(self): ...
 
 def _register_comm_hook(reducer: Reducer, state: Any, comm_hook: Any): ...
-def _register_builtin_comm_hook(reducer: Reducer, comm_hook_type: BuiltinCommHookType): ...
+def _register_builtin_comm_hook(
+    reducer: Reducer,
+    comm_hook_type: BuiltinCommHookType,
+    compression_options: _GradCompressionOptions = ...): ...
+def _get_builtin_comm_hook_state_dict(reducer: Reducer) -> Dict[str, Tensor]: ...
+def _load_builtin_comm_hook_state_dict(reducer: Reducer, state_dict: Dict[str, Tensor]): ...
 
 def _get_ddp_logging_data(reducer: Reducer): ...
 def _set_construction_logging_data(
@@ -94,6 +111,8 @@ class AllToAllOptions:
 class Store:
     def set(self, key: str, value: str): ...
     def get(self, key: str) -> bytes: ...
+    def multi_set(self, keys: List[str], values: List[str]): ...
+    def multi_get(self, keys: List[str]) -> List[bytes]: ...
     def add(self, key: str, value: int) -> int: ...
     def delete_key(self, key: str) -> bool: ...
     def num_keys(self) -> int: ...
@@ -310,9 +329,38 @@ def _round_robin_process_groups(
     process_groups: List[ProcessGroup],
 ) -> ProcessGroupRoundRobin: ...
 
+class ProcessGroupHierarchical(ProcessGroup):
+    class Options:
+        leader_process_group_factory: Callable[[Store, int, int], ProcessGroup]
+        buffer_bytes: int
+        timeout: timedelta
+        node_name: str
+        def __init__(self): ...
+    def __init__(
+        self,
+        store: Store,
+        rank: int,
+        size: int,
+        options: ProcessGroupHierarchical.Options,
+    ): ...
+    @property
+    def num_nodes(self) -> int: ...
+    @property
+    def node_index(self) -> int: ...
+    @property
+    def local_rank(self) -> int: ...
+    @property
+    def local_size(self) -> int: ...
+
 
 class ProcessGroupGloo(ProcessGroup):
     class Device: ...
+    class AllreduceTimeline:
+        tag: int
+        num_bytes: int
+        enqueue_time: int
+        chunk_start_times: List[int]
+        chunk_end_times: List[int]
     def __init__(
         self,
         store: Store,
@@ -322,6 +370,7 @@ class ProcessGroupGloo(ProcessGroup):
     ): ...
     @staticmethod
     def create_device(hostname = str(), interface = str()) -> Device: ...
+    def _get_allreduce_timelines(self) -> List[AllreduceTimeline]: ...
     ...
 
 class ProcessGroupNCCL(ProcessGroup):
@@ -9,6 +9,7 @@ from ._distributed_c10d import ProcessGroup, Store
 # This module is defined in torch/csrc/distributed/rpc/init.cpp
 
 _DEFAULT_NUM_SEND_RECV_THREADS: int
+_DEFAULT_SHM_THRESHOLD_BYTES: int
 _DEFAULT_INIT_METHOD: str
 _DEFAULT_NUM_WORKER_THREADS: int
 _UNSET_RPC_TIMEOUT: float
@@ -67,11 +68,13 @@ class PyRRef:
 
 class ProcessGroupRpcBackendOptions(RpcBackendOptions):
     num_send_recv_threads: int
+    shm_threshold_bytes: int
     def __init__(
         self,
         num_send_recv_threads: int,
         rpc_timeout: float,
-        init_method: str
+        init_method: str,
+        shm_threshold_bytes: int = ...
     ): ...
 
 class ProcessGroupAgent(RpcAgent):
@@ -80,7 +83,8 @@ class ProcessGroupAgent(RpcAgent):
         worker_name: str,
         pg: ProcessGroup,
         numSendRecvThreads: int,
-        rpcTimeout: timedelta
+        rpcTimeout: timedelta,
+        shmThresholdBytes: int = ...
     ): ...
     @overload
     def get_worker_info(self) -> WorkerInfo: ...
@@ -1599,6 +1599,32 @@ See also :meth:`Tensor.values`.
   :meth:`Tensor.coalesce` for details.
 """)
 
+add_docstr_all('crow_indices',
+               r"""
+crow_indices() -> Tensor
+
+Return the compressed row indices tensor of a :ref:`sparse CSR tensor
+<sparse-csr-docs>`: the elements of row ``i`` are stored at
+``crow_indices()[i]:crow_indices()[i + 1]`` in :meth:`Tensor.col_indices` and
+:meth:`Tensor.values`.
+
+.. warning::
+  Throws an error if :attr:`self` is not a sparse CSR tensor.
+""")
+
+add_docstr_all('col_indices',
+               r"""
+col_indices() -> Tensor
+
+Return the column indices tensor of a :ref:`sparse CSR tensor
+<sparse-csr-docs>`.
+
+.. warning::
+  Throws an error if :attr:`self` is not a sparse CSR tensor.
+
+See also :meth:`Tensor.crow_indices`.
+""")
+
 add_docstr_all('get_device',
                r"""
 get_device() -> Device ordinal (Integer)
@@ -1618,15 +1644,17 @@ add_docstr_all('values',
                r"""
 values() -> Tensor
 
-Return the values tensor of a :ref:`sparse COO tensor <sparse-coo-docs>`.
+Return the values tensor of a :ref:`sparse COO tensor <sparse-coo-docs>`,
+of a :ref:`sparse CSR tensor <sparse-csr-docs>` or of a :ref:`jagged
+tensor <jagged-docs>`.
 
 .. warning::
-  Throws an error if :attr:`self` is not a sparse COO tensor.
+  Throws an error if :attr:`self` is not a sparse or jagged tensor.
 
 See also :meth:`Tensor.indices`.
 
 .. note::
-  This method can only be called on a coalesced sparse tensor. See
+  This method can only be called on a coalesced sparse COO tensor. See
   :meth:`Tensor.coalesce` for details.
 """)
 
@@ -2594,6 +2622,17 @@ numel() -> int
 See :func:`torch.numel`
 """)
 
+add_docstr_all('offsets',
+               r"""
+offsets() -> Tensor
+
+Return the offsets tensor of a :ref:`jagged tensor <jagged-docs>`: sequence
+``i`` is stored at ``offsets()[i]:offsets()[i + 1]`` in :meth:`Tensor.values`.
+
+.. warning::
+  Throws an error if :attr:`self` is not a jagged tensor.
+""")
+
 add_docstr_all('numpy',
                r"""
 numpy() -> numpy.ndarray
@@ -3956,6 +3995,63 @@ Example::
            size=(3, 3), nnz=1, layout=torch.sparse_coo)
 """)
 
+add_docstr_all('to_sparse_csr',
+               r"""
+to_sparse_csr() -> Tensor
+Returns a copy of a 2-D strided tensor or sparse COO tensor in :ref:`CSR
+format <sparse-csr-docs>`.
+
+Example::
+
+    >>> d = torch.tensor([[0, 0, 0], [9, 0, 10], [0, 0, 0]])
+    >>> d.to_sparse_csr()
+    tensor(crow_indices=tensor([0, 0, 2, 2]),
+           col_indices=tensor([0, 2]),
+           values=tensor([ 9, 10]),
+           size=(3, 3), nnz=2, layout=torch.sparse_csr)
+""")
+
+add_docstr_all('to_jagged',
+               r"""
+to_jagged(offsets, max_length=None) -> Tensor
+Returns a :ref:`jagged <jagged-docs>` copy of a batch of sequences padded
+along dimension 1. Only the first ``offsets[i + 1] - offsets[i]`` elements of
+sequence ``i`` are copied, the rest is padding.
+
+Args:
+    offsets (Tensor): 1-D int32 or int64 tensor of size ``self.size(0) + 1``,
+        the offsets of the sequences in the values of the returned tensor.
+    max_length (int, optional): the size of dimension 1 of the returned tensor.
+        Default: ``self.size(1)``.
+
+Example::
+
+    >>> d = torch.tensor([[1, 2, 0], [0, 0, 0], [3, 4, 5]])
+    >>> d.to_jagged(torch.tensor([0, 2, 2, 5]))
+    tensor(values=tensor([1, 2, 3, 4, 5]),
+           offsets=tensor([0, 2, 2, 5]),
+           size=(3, 3), layout=torch.jagged)
+""")
+
+add_docstr_all('to_padded_dense',
+               r"""
+to_padded_dense(padding_value=0, max_length=None) -> Tensor
+Returns a strided copy of a :ref:`jagged tensor <jagged-docs>`, with the
+sequences padded with :attr:`padding_value` along dimension 1.
+
+Args:
+    padding_value (Number): the value of the padding elements. Default: 0.
+    max_length (int, optional): the length the sequences are padded to.
+        Default: ``self.size(1)``.
+
+Example::
+
+    >>> j = torch.jagged_tensor(torch.tensor([1., 2., 3.]), torch.tensor([0, 1, 3]))
+    >>> j.to_padded_dense(-1)
+    tensor([[ 1., -1.],
+            [ 2.,  3.]])
+""")
+
 add_docstr_all('to_mkldnn',
                r"""
 to_mkldnn() -> Tensor
@@ -4616,11 +4712,27 @@ Is ``True`` if the Tensor is a meta tensor, ``False`` otherwise.  Meta tensors
 are like normal tensors, but they carry no data.
 """)
 
+add_docstr_all('is_inference',
+               r"""
+Is ``True`` if the Tensor is an inference tensor, i.e. it was created in
+:class:`torch.inference_mode`, ``False`` otherwise.
+""")
+
 add_docstr_all('is_sparse',
                r"""
 Is ``True`` if the Tensor uses sparse storage layout, ``False`` otherwise.
 """)
 
+add_docstr_all('is_sparse_csr',
+               r"""
+Is ``True`` if the Tensor uses the sparse CSR storage layout, ``False`` otherwise.
+""")
+
+add_docstr_all('is_jagged',
+               r"""
+Is ``True`` if the Tensor is a :ref:`jagged tensor <jagged-docs>`, ``False`` otherwise.
+""")
+
 add_docstr_all('device',
                r"""
 Is the :class:`torch.device` where this Tensor is.
@@ -1540,6 +1540,59 @@ Example::
              -0.5790,  0.1497]])
 """.format(**common_args))
 
+add_docstr(torch.cdist_topk,
+           r"""
+cdist_topk(x1, x2, k, metric="euclidean", eps=1e-8) -> (Tensor, LongTensor)
+
+Returns a namedtuple ``(values, indices)`` of the :attr:`k` rows of :attr:`x2`
+nearest to each row of :attr:`x1`. Row ``i`` of ``indices`` holds the rows of
+:attr:`x2` nearest to ``x1[i]``, the nearest first, and row ``i`` of ``values``
+their distances or similarities to ``x1[i]``, depending on :attr:`metric`:
+
+- ``"euclidean"``: the euclidean distances, in increasing order.
+- ``"inner_product"``: the inner products, in decreasing order.
+- ``"cosine"``: the cosine similarities, in decreasing order, computed like
+  :func:`torch.nn.functional.cosine_similarity`.
+
+Ties are broken by the lower index, like in :func:`torch.topk`.
+
+This is equivalent to taking the :attr:`k` smallest values of
+``torch.cdist(x1, x2)`` along dimension 1, or the :attr:`k` largest inner
+products or cosine similarities, but the ``N x M`` matrix of distances is never
+materialized: it is computed by blocks, with matrix multiplications, and only
+the :attr:`k` nearest rows are kept for each row of :attr:`x1`. Gradients flow
+to :attr:`x1` and :attr:`x2` through ``values``.
+
+.. note::
+    Only supported on CPU, for float and double tensors.
+
+Args:
+    x1 (Tensor): the queries, of shape :math:`N \times D`.
+    x2 (Tensor): the rows to search, of shape :math:`M \times D`.
+    k (int): the number of nearest rows to return, at most :math:`M`.
+    metric (str, optional): ``"euclidean"``, ``"inner_product"`` or
+        ``"cosine"``. Default: ``"euclidean"``.
+    eps (float, optional): small value to avoid division by zero in the cosine
+        similarity. Default: 1e-8
+
+Example::
+
+    >>> x1 = torch.tensor([[0., 0.], [3., 4.]])
+    >>> x2 = torch.tensor([[1., 0.], [0., 2.], [3., 3.]])
+    >>> torch.cdist_topk(x1, x2, 2)
+    torch.return_types.cdist_topk(
+    values=tensor([[1.0000, 2.0000],
+            [1.0000, 3.6056]]),
+    indices=tensor([[0, 1],
+            [2, 1]]))
+    >>> torch.cdist_topk(x1, x2, 1, metric="inner_product")
+    torch.return_types.cdist_topk(
+    values=tensor([[ 0.],
+            [21.]]),
+    indices=tensor([[0],
+            [2]]))
+""")
+
 add_docstr(torch.ceil,
            r"""
 ceil(input, *, out=None) -> Tensor
@@ -7604,6 +7657,66 @@ scatter_add(input, dim, index, src) -> Tensor
 Out-of-place version of :meth:`torch.Tensor.scatter_add_`
 """)
 
+add_docstr(torch.segment_reduce,
+           r"""
+segment_reduce(data, reduce, *, lengths=None, offsets=None, axis=0, unsafe=False, initial=None) -> Tensor
+
+Reduces consecutive segments of :attr:`data` along dimension :attr:`axis`.
+The segments are given either by their :attr:`lengths` or by their
+:attr:`offsets`: segment ``i`` is made of the slices
+``offsets[i]:offsets[i + 1]`` of :attr:`data` along :attr:`axis`, where
+``offsets`` is the cumulative sum of :attr:`lengths` starting at 0. The
+segments must cover the whole dimension.
+
+The result has the same size as :attr:`data`, except in dimension
+:attr:`axis` where it has one element per segment. The segments are reduced
+in parallel, each one in a single pass over its slices, which is faster than
+emulating the reduction with :meth:`~Tensor.index_add_` or
+:meth:`~Tensor.scatter_add_` when the segments are sorted.
+
+The gradient of ``"max"`` is split evenly between the elements equal to the
+maximum of their segment, like for :func:`torch.amax`.
+
+.. note::
+    This function is only implemented on CPU.
+
+Args:
+    data (Tensor): the tensor to reduce.
+    reduce (str): the reduction, one of ``"sum"``, ``"mean"`` or ``"max"``.
+
+Keyword args:
+    lengths (Tensor, optional): 1-D int32 or int64 tensor of the lengths of the
+        segments.
+    offsets (Tensor, optional): 1-D int32 or int64 tensor of the offsets of the
+        segments, with one more element than there are segments. Exactly one of
+        :attr:`lengths` and :attr:`offsets` must be given.
+    axis (int, optional): the dimension to reduce. Default: 0.
+    unsafe (bool, optional): skip checking that the segments are valid.
+        Default: ``False``.
+    initial (Number, optional): the starting value of the reduction of every
+        segment: it is added to the sum of each segment, including before the
+        division of ``"mean"``, and it is a lower bound of each ``"max"``.
+        Empty segments are set to it. Default: none, and empty segments are
+        set to the identity of the reduction, 0 for ``"sum"``, ``nan`` for
+        ``"mean"`` and ``-inf`` for ``"max"``.
+
+Example::
+
+    >>> data = torch.tensor([[1., 2.], [3., 4.], [5., 6.], [7., 8.]])
+    >>> torch.segment_reduce(data, "sum", lengths=torch.tensor([1, 0, 3]))
+    tensor([[ 1.,  2.],
+            [ 0.,  0.],
+            [15., 18.]])
+    >>> torch.segment_reduce(data, "max", offsets=torch.tensor([0, 2, 4]), axis=0)
+    tensor([[3., 4.],
+            [7., 8.]])
+    >>> torch.segment_reduce(data, "mean", lengths=torch.tensor([1, 1]), axis=1)
+    tensor([[1., 2.],
+            [3., 4.],
+            [5., 6.],
+            [7., 8.]])
+""")
+
 add_docstr(torch.set_flush_denormal,
            r"""
 set_flush_denormal(mode) -> bool
@@ -7967,6 +8080,78 @@ Example::
             [-0.0881,  0.4370,  0.2275,  1.0284]])
 """.format(**common_args))
 
+add_docstr(torch.sparse_csr_tensor,
+           r"""
+sparse_csr_tensor(crow_indices, col_indices, values, size=None, *, dtype=None, device=None, requires_grad=False) -> Tensor
+
+Constructs a 2-D :ref:`sparse tensor in CSR (Compressed Sparse Row) format
+<sparse-csr-docs>` with specified values at the given :attr:`crow_indices` and
+:attr:`col_indices`.
+
+Args:
+    crow_indices (Tensor): 1-D int32 or int64 tensor of size ``nrows + 1``. The
+        column indices and the values of row ``i`` are stored at
+        ``crow_indices[i]:crow_indices[i + 1]`` in :attr:`col_indices` and
+        :attr:`values`. It starts with 0 and ends with the number of specified
+        elements.
+    col_indices (Tensor): 1-D tensor with the column index of each element, of
+        the same dtype as :attr:`crow_indices`.
+    values (Tensor): 1-D tensor with the value of each element.
+    size (list, tuple, or :class:`torch.Size`, optional): Size of the sparse tensor. If not
+        provided the number of columns will be inferred as the maximum column index + 1.
+
+Keyword args:
+    dtype (:class:`torch.dtype`, optional): the desired data type of returned tensor.
+        Default: if None, infers data type from :attr:`values`.
+    device (:class:`torch.device`, optional): the desired device of returned tensor.
+        Only the CPU is supported.
+    {requires_grad}
+
+Example::
+
+    >>> crow_indices = torch.tensor([0, 2, 2, 3])
+    >>> col_indices = torch.tensor([0, 2, 1])
+    >>> values = torch.tensor([1., 2., 3.])
+    >>> torch.sparse_csr_tensor(crow_indices, col_indices, values, [3, 4])
+    tensor(crow_indices=tensor([0, 2, 2, 3]),
+           col_indices=tensor([0, 2, 1]),
+           values=tensor([1., 2., 3.]),
+           size=(3, 4), nnz=3, layout=torch.sparse_csr)
+""".format(**factory_common_args))
+
+add_docstr(torch.jagged_tensor,
+           r"""
+jagged_tensor(values, offsets, *, max_length=None) -> Tensor
+
+Constructs a :ref:`jagged tensor <jagged-docs>`, a batch of variable-length
+sequences, from the elements of all the sequences and the offsets of each
+sequence in them. No data is copied.
+
+Args:
+    values (Tensor): tensor of size ``(total_length, *)`` with the elements of
+        the sequences, one sequence after the other.
+    offsets (Tensor): 1-D int32 or int64 tensor of size ``batch_size + 1``.
+        Sequence ``i`` is ``values[offsets[i]:offsets[i + 1]]``. It starts with 0
+        and ends with ``total_length``.
+
+Keyword args:
+    max_length (int, optional): the size of the jagged dimension 1 of the
+        returned tensor, the length sequences are padded to by
+        :meth:`Tensor.to_padded_dense`. Default: the length of the longest
+        sequence.
+
+Example::
+
+    >>> values = torch.tensor([[1., 2.], [3., 4.], [5., 6.]])
+    >>> offsets = torch.tensor([0, 2, 2, 3])
+    >>> torch.jagged_tensor(values, offsets)
+    tensor(values=tensor([[1., 2.],
+                          [3., 4.],
+                          [5., 6.]]),
+           offsets=tensor([0, 2, 2, 3]),
+           size=(3, 2, 2), layout=torch.jagged)
+""")
+
 add_docstr(torch.sparse_coo_tensor,
            r"""
 sparse_coo_tensor(indices, values, size=None, *, dtype=None, device=None, requires_grad=False) -> Tensor
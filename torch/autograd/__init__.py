@@ -15,7 +15,7 @@ from typing import Any, Callable, List, Optional, Sequence, Tuple, Union
 from .variable import Variable
 from .function import Function, NestedIOFunction
 from .gradcheck import gradcheck, gradgradcheck
-from .grad_mode import no_grad, enable_grad, set_grad_enabled
+from .grad_mode import no_grad, enable_grad, set_grad_enabled, inference_mode
 from .anomaly_mode import detect_anomaly, set_detect_anomaly
 from ..overrides import has_torch_function, handle_torch_function
 from . import functional
@@ -253,7 +253,12 @@ if not torch._C._autograd_init():
 # Import all native method/classes
 from torch._C._autograd import (DeviceType, ProfilerActivity, ProfilerState, ProfilerConfig, ProfilerEvent,
                                 _enable_profiler_legacy, _disable_profiler_legacy, _profiler_enabled,
-                                _enable_record_function, _set_empty_test_observer, kineto_available)
+                                _perf_counters_available,
+                                _enable_record_function, _set_empty_test_observer, kineto_available,
+                                _enable_sampling_profiler, _disable_sampling_profiler, _sampling_profiler_enabled,
+                                _sampling_profiler_snapshot, _enable_streaming_trace, _disable_streaming_trace,
+                                _streaming_trace_enabled, _enable_memory_tracker, _disable_memory_tracker,
+                                _memory_tracker_enabled, _memory_tracker_snapshot, _save_memory_trace)
 
 if kineto_available():
     from torch._C._autograd import (ProfilerResult, KinetoEvent,
@@ -5,7 +5,7 @@ import inspect
 from typing import Any, Callable, TypeVar, cast
 
 
-__all__ = ['no_grad', 'enable_grad', 'set_grad_enabled']
+__all__ = ['no_grad', 'enable_grad', 'set_grad_enabled', 'inference_mode']
 
 
 # Used for annotating the decorator usage of 'no_grad' and 'enable_grad'.
@@ -23,7 +23,7 @@ class _DecoratorContextManager:
 
         @functools.wraps(func)
         def decorate_context(*args, **kwargs):
-            with self.__class__():
+            with self.clone():
                 return func(*args, **kwargs)
         return cast(F, decorate_context)
 
@@ -37,10 +37,9 @@ class _DecoratorContextManager:
             # make sure the grad mode is properly set every time the execution
             # flow returns into the wrapped generator and restored when it
             # returns through our `yield` to our caller (see PR #49017).
-            cls = type(self)
             try:
                 # Issuing `None` to a generator fires it up
-                with cls():
+                with self.clone():
                     response = gen.send(None)
 
                 while True:
@@ -50,18 +49,18 @@ class _DecoratorContextManager:
 
                     except GeneratorExit:
                         # Inform the still active generator about its imminent closure
-                        with cls():
+                        with self.clone():
                             gen.close()
                         raise
 
                     except BaseException:
                         # Propagate the exception thrown at us by the caller
-                        with cls():
+                        with self.clone():
                             response = gen.throw(*sys.exc_info())
 
                     else:
                         # Pass the last request to the generator and get its response
-                        with cls():
+                        with self.clone():
                             response = gen.send(request)
 
             # We let the exceptions raised above by the generator's `.throw` or
@@ -80,6 +79,10 @@ class _DecoratorContextManager:
     def __exit__(self, exc_type: Any, exc_value: Any, traceback: Any) -> None:
         raise NotImplementedError
 
+    def clone(self):
+        # override this method if your children class takes __init__ parameters
+        return self.__class__()
+
 
 class no_grad(_DecoratorContextManager):
     r"""Context-manager that disabled gradient calculation.
@@ -206,3 +209,64 @@ class set_grad_enabled(object):
 
     def __exit__(self, exc_type: Any, exc_value: Any, traceback: Any) -> None:
         torch._C._set_grad_enabled(self.prev)
+
+
+class inference_mode(_DecoratorContextManager):
+    r"""Context-manager that enables or disables inference mode.
+
+    InferenceMode is a stricter :class:`~no_grad` for code that never uses
+    autograd, e.g. serving: ops skip the autograd bookkeeping entirely (no
+    autograd metadata checks, no version counter bumps of the outputs, no view
+    tracking), and the tensors created in this mode, called inference tensors,
+    don't allocate a version counter. Check them with :attr:`Tensor.is_inference`.
+
+    Inference tensors can be used outside of inference mode, with the
+    following restrictions:
+
+    - they can't require grad, nor be saved for backward by an op on tensors
+      that require grad;
+    - they can't be modified inplace.
+
+    Clone an inference tensor outside of inference mode to get a normal tensor.
+
+    This context manager is thread local; it will not affect computation
+    in other threads.
+
+    Also functions as a decorator. (Make sure to instantiate with parenthesis.)
+
+    Args:
+        mode (bool): Flag whether to enable (``True``), or disable (``False``)
+                     inference mode.
+
+    Example::
+
+        >>> x = torch.ones(1, 2, 3, requires_grad=True)
+        >>> with torch.inference_mode():
+        ...   y = x * x
+        >>> y.requires_grad
+        False
+        >>> y.is_inference
+        True
+        >>> y.add_(1)
+        RuntimeError: Inplace update to inference tensor outside InferenceMode is not allowed. ...
+        >>> @torch.inference_mode()
+        ... def func(x):
+        ...   return x * x
+        >>> out = func(x)
+        >>> out.is_inference
+        True
+
+    """
+    def __init__(self, mode: bool = True) -> None:
+        if not torch._jit_internal.is_scripting():
+            super().__init__()
+        self.mode = mode
+
+    def __enter__(self) -> None:
+        self._inference_mode_guard = torch._C._autograd._InferenceMode(self.mode)
+
+    def __exit__(self, exc_type: Any, exc_value: Any, traceback: Any) -> None:
+        del self._inference_mode_guard
+
+    def clone(self):
+        return self.__class__(self.mode)
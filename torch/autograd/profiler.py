@@ -10,6 +10,7 @@ from operator import attrgetter
 from typing import Dict, List, Tuple, Optional
 
 import math
+import warnings
 
 try:
     # Available in Python >= 3.2
@@ -372,6 +373,12 @@ class profile(object):
 
         with_stack (bool, optional): record source information (file and line number) for the ops.
 
+        with_perf_counters (bool, optional): count the CPU cycles, instructions, last level
+            cache misses and branch misses of the ops with Linux hardware performance counters
+            (``perf_event_open``). Only the work done by the thread running an op is counted,
+            including its child ops. Counters that are not available on the machine are
+            omitted. Not supported with ``use_kineto=True``.
+
         use_kineto (bool, optional): experimental, enable profiling with Kineto profiler.
 
         use_cpu (bool, optional): profile CPU events; setting to ``False`` requires
@@ -419,6 +426,7 @@ class profile(object):
             with_flops=False,
             profile_memory=False,
             with_stack=False,
+            with_perf_counters=False,
             use_kineto=False,
             use_cpu=True):
         self.enabled: bool = enabled
@@ -432,6 +440,7 @@ class profile(object):
         self.record_shapes |= self.with_flops
         self.profile_memory = profile_memory
         self.with_stack = with_stack
+        self.with_perf_counters = with_perf_counters
         self.use_cpu = use_cpu
         self.kineto_results = None
         if not self.use_cpu:
@@ -441,6 +450,9 @@ class profile(object):
         self.profiler_kind = None
         self.kineto_activities = set()
         if use_kineto:
+            assert not self.with_perf_counters, \
+                "Hardware performance counters are not supported with Kineto"
+
             self.profiler_kind = torch.autograd.ProfilerState.KINETO
             if self.use_cpu:
                 self.kineto_activities.add(torch.autograd.ProfilerActivity.CPU)
@@ -469,7 +481,8 @@ class profile(object):
             self.record_shapes,
             self.profile_memory,
             self.with_stack,
-            self.with_flops)
+            self.with_flops,
+            self.with_perf_counters)
 
     def __enter__(self):
         if not self.enabled:
@@ -481,6 +494,10 @@ class profile(object):
             torch.autograd._prepare_profiler(self.config(), self.kineto_activities)
             torch.autograd._enable_profiler(self.config(), self.kineto_activities)
         else:
+            if self.with_perf_counters and not torch.autograd._perf_counters_available():
+                warnings.warn(
+                    "Hardware performance counters are not available, check "
+                    "kernel.perf_event_paranoid; they won't be reported")
             torch.autograd._enable_profiler_legacy(self.config())
         return self
 
@@ -804,6 +821,17 @@ def format_memory(nbytes):
     else:
         return str(nbytes) + ' b'
 
+def format_count(count):
+    """Returns a formatted event count string"""
+    if (abs(count) >= 1e9):
+        return '{:.2f}G'.format(count / 1e9)
+    elif (abs(count) >= 1e6):
+        return '{:.2f}M'.format(count / 1e6)
+    elif (abs(count) >= 1e3):
+        return '{:.2f}K'.format(count / 1e3)
+    else:
+        return str(count)
+
 def attr_formatter(name):
     return property(lambda self: format_time(getattr(self, name)))
 
@@ -847,7 +875,7 @@ class FunctionEvent(FormattedTimesMixin):
             self, id, name, thread, start_us, end_us, fwd_thread=None, input_shapes=None,
             stack=None, scope=0, cpu_memory_usage=0, cuda_memory_usage=0, is_async=False,
             is_remote=False, sequence_nr=-1, node_id=-1, device_type=DeviceType.CPU, device_index=0,
-            is_legacy=False, flops=None, trace_name=None):
+            is_legacy=False, flops=None, trace_name=None, perf_counters=None):
         self.id: int = id
         self.node_id: int = node_id
         self.name: str = name
@@ -871,6 +899,8 @@ class FunctionEvent(FormattedTimesMixin):
         self.device_index: int = device_index
         self.is_legacy: bool = is_legacy
         self.flops: Optional[float] = flops
+        # hardware counter name -> count, including children
+        self.perf_counters: Optional[Dict[str, int]] = perf_counters
 
     def append_kernel(self, name, device, start, end):
         assert self.device_type == DeviceType.CPU
@@ -1014,6 +1044,7 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.device_type: DeviceType = DeviceType.CPU
         self.is_legacy: bool = False
         self.flops: float = 0.0
+        self.perf_counters: Optional[Dict[str, int]] = None
 
     def add(self, other):
         if self.key is None:
@@ -1047,6 +1078,11 @@ class FunctionEventAvg(FormattedTimesMixin):
             self.flops = other.flops
         elif other.flops is not None:
             self.flops += other.flops
+        if other.perf_counters is not None:
+            if self.perf_counters is None:
+                self.perf_counters = {}
+            for name, count in other.perf_counters.items():
+                self.perf_counters[name] = self.perf_counters.get(name, 0) + count
         return self
 
     def __iadd__(self, other):
@@ -1225,6 +1261,24 @@ def parse_kineto_results(result):
     return function_events
 
 # Parsing of legacy profiler events
+# Same order as PerfCounter in torch/csrc/autograd/profiler_perf.h
+PERF_COUNTERS = ['cycles', 'instructions', 'llc_misses', 'branch_misses']
+
+
+def perf_counters_delta(start, end):
+    start_counters = start.perf_counters()
+    end_counters = end.perf_counters()
+    if len(start_counters) == 0 or len(end_counters) == 0:
+        return None
+    # negative values are unavailable counters
+    counters = {
+        name: end_counters[idx] - start_counters[idx]
+        for idx, name in enumerate(PERF_COUNTERS)
+        if start_counters[idx] >= 0 and end_counters[idx] >= 0
+    }
+    return counters if len(counters) > 0 else None
+
+
 def parse_legacy_records(thread_records):
     def get_record_key(record):
         """
@@ -1311,6 +1365,10 @@ def parse_legacy_records(thread_records):
                 is_async = start.thread_id() != record.thread_id()
                 is_remote_event = record.is_remote()
                 start_flops = start.flops()
+                # counters are per thread, so async events have none
+                perf_counters = None
+                if not is_async:
+                    perf_counters = perf_counters_delta(start, record)
 
                 fe = FunctionEvent(
                     id=record.handle(),
@@ -1332,6 +1390,7 @@ def parse_legacy_records(thread_records):
                     device_type=DeviceType.CPU,
                     is_legacy=True,
                     flops=start_flops,
+                    perf_counters=perf_counters,
                 )
                 # note: async events have only cpu total time
                 if not is_async and start.has_cuda():
@@ -1482,6 +1541,10 @@ def build_table(
     has_cuda_mem = any([event.self_cuda_memory_usage > 0 for event in events])
     has_input_shapes = any(
         [(event.input_shapes is not None and len(event.input_shapes) > 0) for event in events])
+    perf_counters = [
+        name for name in PERF_COUNTERS
+        if any([event.perf_counters is not None and name in event.perf_counters for event in events])]
+    has_ipc = 'cycles' in perf_counters and 'instructions' in perf_counters
 
     if sort_by is not None:
         events = EventList(sorted(
@@ -1533,6 +1596,16 @@ def build_table(
                 'CUDA Mem',
                 'Self CUDA Mem',
             ])
+    perf_counter_headers = {
+        'cycles': 'Cycles',
+        'instructions': 'Instructions',
+        'llc_misses': 'LLC Misses',
+        'branch_misses': 'Branch Misses',
+    }
+    for name in perf_counters:
+        headers.append(perf_counter_headers[name])
+        if name == 'instructions' and has_ipc:
+            headers.append('IPC')
     headers.append(
         '# of Calls'
     )
@@ -1684,6 +1757,15 @@ def build_table(
                     # Self CUDA Mem Total
                     format_memory(evt.self_cuda_memory_usage),
                 ])
+        for name in perf_counters:
+            counters = evt.perf_counters if evt.perf_counters is not None else {}
+            row_values.append(format_count(counters[name]) if name in counters else "--")
+            if name == 'instructions' and has_ipc:
+                # Instructions per cycle
+                if counters.get('cycles', 0) > 0 and 'instructions' in counters:
+                    row_values.append('{:.2f}'.format(counters['instructions'] / counters['cycles']))
+                else:
+                    row_values.append("--")
         row_values.append(
             evt.count,  # Number of calls
         )
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <ATen/InferenceMode.h>
 #include <ATen/Parallel.h>
 #include <ATen/record_function.h>
 #include <torch/csrc/autograd/grad_mode.h>
@@ -66,6 +67,24 @@ using NoGradGuard = at::NoGradGuard;
 /// @endcode
 using AutoGradMode = at::AutoGradMode;
 
+/// A RAII, thread-local guard that enables or disables inference mode.
+///
+/// Ops in inference mode skip the autograd bookkeeping, and the tensors they
+/// create are inference tensors: they have no version counter, can't require
+/// grad and can't be modified inplace outside of inference mode. See
+/// Note [Inference tensors] in ATen/InferenceMode.h.
+///
+/// Example:
+/// @code
+/// auto x = torch::ones({2, 3}, torch::requires_grad());
+/// {
+///   torch::InferenceMode guard;
+///   auto y = x * 2;
+///   std::cout << y.is_inference() << std::endl; // prints `true`
+/// }
+/// @endcode
+using InferenceMode = at::InferenceMode;
+
 /// Sets the global random seed for all newly created CPU and CUDA tensors.
 using at::manual_seed;
 
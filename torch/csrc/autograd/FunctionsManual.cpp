@@ -629,6 +629,9 @@ Tensor clamp_backward(const Tensor & grad, const Tensor &self, const optional<Sc
 //
 // This function does not support `self` derivatives for inplace functions.
 //
+// Sparse CSR tensors have no strides either, so formulas that accept them
+// must not use the strides in that case, see mm_mat1_sparse_csr_backward.
+//
 // Args:
 //  input              Tensor to call .strides() on
 //  input_name         Name of `input` tensor, from derivative formula
@@ -643,7 +646,7 @@ at::IntArrayRef strides_or_error(const Tensor & input, c10::string_view const &
       "' tensor to be strided, but a sparse tensor was given instead. ",
       "Please either use a strided tensor or set requires_grad=False for '",
       input_name, "'");
-    if (input.is_mkldnn()) return IntArrayRef({});
+    if (input.is_mkldnn() || input.is_sparse_csr()) return IntArrayRef({});
     return input.strides();
   } else {
     return IntArrayRef({});
@@ -679,6 +682,18 @@ Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef si
   }
 }
 
+// The gradient of a sparse CSR matrix product with respect to its sparse
+// operand is (grad @ mat2^H) masked to the specified elements of mat1 (resp.
+// (mat1^H @ grad) masked to mat2), returned as a sparse CSR tensor with the
+// indices of that operand. Only the masked elements are computed.
+Tensor mm_mat1_sparse_csr_backward(const Tensor& grad, const Tensor& mat1, const Tensor& mat2, const Scalar& alpha) {
+  return at::_sparse_csr_sampled_mm(mat1, grad, mat2.t().conj(), alpha.conj());
+}
+
+Tensor mm_mat2_sparse_csr_backward(const Tensor& grad, const Tensor& mat1, const Tensor& mat2, const Scalar& alpha) {
+  return at::_sparse_csr_sampled_mm(mat2, mat1.t().conj(), grad, alpha.conj());
+}
+
 Tensor _sparse_addmm_sparse_backward(const Tensor& grad, const Tensor& sparse_, const Tensor& dense, const Scalar& alpha) {
   AT_ASSERT(sparse_.is_sparse());
   auto sparse = sparse_.coalesce();
@@ -2941,6 +2956,134 @@ Tensor sparse_constructor_values_backward(const Tensor& sparse_grad_out, const T
   return _sparse_mask_helper(sparse_grad_out.coalesce(), indices.contiguous());
 }
 
+// The sparse CSR gradients computed by the formulas above share the indices of
+// their input, so their values are the gradient of the values. Otherwise, the
+// gradient is gathered at the specified elements.
+Tensor sparse_csr_constructor_values_backward(const Tensor& grad, const Tensor& crow_indices, const Tensor& col_indices) {
+  if (grad.is_sparse_csr() &&
+      grad.crow_indices().data_ptr() == crow_indices.data_ptr() &&
+      grad.col_indices().data_ptr() == col_indices.data_ptr()) {
+    return grad.values();
+  }
+  Tensor dense_grad = grad.is_sparse_csr() ? grad.to_dense() : grad;
+  const int64_t nrows = crow_indices.size(0) - 1;
+  Tensor crow = crow_indices.to(at::kLong);
+  Tensor rows = at::repeat_interleave(crow.narrow(0, 1, nrows) - crow.narrow(0, 0, nrows));
+  Tensor flat_indices = rows * dense_grad.size(1) + col_indices.to(at::kLong);
+  return dense_grad.reshape(-1).index_select(0, flat_indices);
+}
+
+// The gradient of values() is a sparse tensor with the same indices as self,
+// or a jagged tensor with the same offsets.
+Tensor values_backward(const Tensor& grad, const Tensor& self) {
+  if (self.is_jagged()) {
+    return at::_jagged_tensor_unsafe(grad, self.offsets(), self.size(1));
+  }
+  if (self.is_sparse_csr()) {
+    return at::_sparse_csr_tensor_unsafe(self.crow_indices(), self.col_indices(), grad, self.sizes(), grad.options().layout(at::kSparseCsr));
+  }
+  return at::_sparse_coo_tensor_unsafe(self.indices(), grad, self.sizes())._coalesced_(true);
+}
+
+// The gradient of amax of a jagged tensor is a jagged tensor with the same
+// offsets.  Like for strided tensors, it is evenly distributed between the
+// elements equal to the maximum of each sequence, over the reduced inner
+// dimensions too.
+Tensor amax_jagged_backward(const Tensor& grad, const Tensor& self, const Tensor& result, IntArrayRef dim, bool keepdim) {
+  const int64_t ndim = self.dim();
+  std::vector<int64_t> dims;
+  for (int64_t d = 0; d < ndim; d++) {
+    if (dim.empty() || std::any_of(dim.begin(), dim.end(), [&](int64_t i) { return at::maybe_wrap_dim(i, ndim) == d; })) {
+      dims.push_back(d);
+    }
+  }
+  // Dimension d >= 2 of self is dimension d - 1 of the values, and the jagged
+  // dimension 1 is always reduced.
+  Tensor g = restore_reduced_dims(grad, dims, keepdim).squeeze(1);
+  Tensor max = restore_reduced_dims(result, dims, keepdim).squeeze(1);
+  std::vector<int64_t> inner_dims;
+  for (int64_t d : dims) {
+    if (d >= 2) {
+      inner_dims.push_back(d - 1);
+    }
+  }
+  const Tensor values = self.values();
+  const Tensor offsets = self.offsets();
+  Tensor grad_values;
+  if (dims[0] == 0) {
+    // All the sequences were reduced together.
+    inner_dims.insert(inner_dims.begin(), 0);
+    grad_values = scale_grad_by_count(g, values == max, inner_dims);
+  } else if (inner_dims.empty()) {
+    grad_values = at::_segment_reduce_backward(g, max, values, "max", c10::nullopt, offsets, 0);
+  } else {
+    // The backward of a segment sum copies the row of each segment to all the
+    // rows of the segment.
+    std::vector<int64_t> segments_size = values.sizes().vec();
+    segments_size[0] = g.size(0);
+    auto to_rows = [&](const Tensor& t) {
+      Tensor segments = t.expand(segments_size);
+      return at::_segment_reduce_backward(segments, segments, values, "sum", c10::nullopt, offsets, 0);
+    };
+    Tensor mask = values == to_rows(max);
+    Tensor count = at::segment_reduce(mask.to(values.scalar_type()), "sum", c10::nullopt, offsets).sum(inner_dims, /*keepdim=*/true);
+    grad_values = to_rows(g / count) * mask;
+  }
+  return at::_jagged_tensor_unsafe(grad_values, offsets, self.size(1));
+}
+
+// The gradient of sum or mean of a jagged tensor of the given sizes and
+// offsets is a jagged tensor with the same offsets, whose rows are the rows
+// of grad broadcast over each sequence.
+static Tensor jagged_reduce_backward(const Tensor& grad, const Tensor& offsets, IntArrayRef sizes, IntArrayRef dim, bool keepdim, bool mean) {
+  const int64_t ndim = sizes.size();
+  std::vector<int64_t> dims;
+  for (int64_t d = 0; d < ndim; d++) {
+    if (dim.empty() || std::any_of(dim.begin(), dim.end(), [&](int64_t i) { return at::maybe_wrap_dim(i, ndim) == d; })) {
+      dims.push_back(d);
+    }
+  }
+  Tensor g = restore_reduced_dims(grad, dims, keepdim).squeeze(1);
+  int64_t inner_count = 1;
+  for (int64_t d : dims) {
+    if (d >= 2) {
+      inner_count *= sizes[d];
+    }
+  }
+  std::vector<int64_t> values_size = sizes.slice(1).vec();
+  values_size[0] = offsets[-1].item<int64_t>();
+  Tensor grad_values;
+  if (dims[0] == 0) {
+    // All the sequences were reduced together.
+    grad_values = g.expand(values_size);
+    if (mean) {
+      grad_values = grad_values / (values_size[0] * inner_count);
+    }
+  } else {
+    // The backward of a segment sum copies the row of each segment to all
+    // the rows of the segment, and the backward of a segment mean also
+    // divides it by the length of the segment.  The data is only read by
+    // the backward of max.
+    std::vector<int64_t> segments_size = values_size;
+    segments_size[0] = sizes[0];
+    Tensor segments = g.expand(segments_size);
+    if (mean) {
+      segments = segments / inner_count;
+    }
+    grad_values = at::_segment_reduce_backward(
+        segments, segments, at::empty(values_size, segments.options()), mean ? "mean" : "sum", c10::nullopt, offsets, 0);
+  }
+  return at::_jagged_tensor_unsafe(grad_values, offsets, sizes[1]);
+}
+
+Tensor sum_jagged_backward(const Tensor& grad, const Tensor& offsets, IntArrayRef sizes, IntArrayRef dim, bool keepdim) {
+  return jagged_reduce_backward(grad, offsets, sizes, dim, keepdim, /*mean=*/false);
+}
+
+Tensor mean_jagged_backward(const Tensor& grad, const Tensor& offsets, IntArrayRef sizes, IntArrayRef dim, bool keepdim) {
+  return jagged_reduce_backward(grad, offsets, sizes, dim, keepdim, /*mean=*/true);
+}
+
 // Because the backward of pad(input, pads) is just pad(grad_output, [-p for p in pads])
 Tensor constant_pad_nd_backward(const Tensor& grad, IntArrayRef pad) {
   auto negated_pad = pad.vec();
@@ -11,7 +11,7 @@
 namespace torch { namespace autograd {
 
 #define CHECK_RESULT(RESULT, VAR) \
-  if (!(RESULT.is_sparse() || VAR.is_sparse())) { \
+  if (!(RESULT.is_sparse() || VAR.is_sparse() || RESULT.is_jagged())) { \
     if (!utils::obeys_layout_contract(RESULT, VAR)) { \
       TORCH_WARN_ONCE("grad and param do not obey the gradient layout contract. " \
                       "This is not an error, but may impair performance.\n" \
@@ -100,8 +100,8 @@ struct TORCH_API AccumulateGrad : public Node {
       if (!GradMode::is_enabled() &&
           !new_grad.is_sparse() &&
           new_grad.use_count() <= num_expected_refs &&
-          ((!new_grad.is_mkldnn() && utils::obeys_layout_contract(new_grad, variable))
-           || new_grad.is_mkldnn())){
+          ((!new_grad.is_mkldnn() && !new_grad.is_jagged() && utils::obeys_layout_contract(new_grad, variable))
+           || new_grad.is_mkldnn() || new_grad.is_jagged())){
         // we aren't setting up for double-backward
         // not sparse
         // no other user-visible tensor references new_grad
@@ -135,7 +135,7 @@ struct TORCH_API AccumulateGrad : public Node {
         if (new_grad.is_sparse()) {
           update_grad(new_grad.clone());
         } else {
-          if (new_grad.is_mkldnn()) {
+          if (new_grad.is_mkldnn() || new_grad.is_jagged()) {
             update_grad(new_grad.clone());
           } else {
             // Deep copies new_grad according to the "Gradient Layout Contract."
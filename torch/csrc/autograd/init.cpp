@@ -5,6 +5,7 @@
 #include <torch/csrc/utils/pybind.h>
 #include <torch/csrc/autograd/autograd.h>
 #include <torch/csrc/autograd/grad_mode.h>
+#include <ATen/InferenceMode.h>
 #include <ATen/autocast_mode.h>
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/autograd/python_function.h>
@@ -60,7 +61,8 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .value("CUDA", ActivityType::CUDA);
 
   py::class_<ProfilerConfig>(m, "ProfilerConfig")
-      .def(py::init<ProfilerState, bool, bool, bool, bool>());
+      .def(py::init<ProfilerState, bool, bool, bool, bool>())
+      .def(py::init<ProfilerState, bool, bool, bool, bool, bool>());
 
   py::class_<LegacyEvent>(m, "ProfilerEvent")
       .def("kind", &LegacyEvent::kindStr)
@@ -82,7 +84,8 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .def("scope", &LegacyEvent::scope)
       .def("correlation_id", &LegacyEvent::correlationId)
       .def("start_us", &LegacyEvent::cpuUs)
-      .def("flops", &LegacyEvent::flops);
+      .def("flops", &LegacyEvent::flops)
+      .def("perf_counters", &LegacyEvent::perfCounters);
 
   py::enum_<c10::DeviceType>(m, "DeviceType")
       .value("CPU", c10::DeviceType::CPU)
@@ -185,6 +188,7 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       disableProfilerLegacy,
       py::arg("profiler_disable_options") = ProfilerDisableOptions());
   m.def("_profiler_enabled", profilerEnabled);
+  m.def("_perf_counters_available", perfCountersAvailable);
   m.def("_enable_record_function", [](bool enable) {
     at::enableRecordFunction(enable);
   });
@@ -202,6 +206,87 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
     at::clearCallbacks();
   });
 
+  py::class_<SampledOpStats>(m, "_SampledOpStats")
+      .def_readonly("name", &SampledOpStats::name)
+      .def_readonly("count", &SampledOpStats::count)
+      .def_readonly("total_ns", &SampledOpStats::total_ns)
+      .def_readonly("buckets", &SampledOpStats::buckets)
+      .def("quantile_ns", &SampledOpStats::quantileNs);
+  m.def(
+      "_enable_sampling_profiler",
+      [](double sampling_prob) { enableSamplingProfiler(sampling_prob); },
+      py::arg("sampling_prob") = kDefaultSamplingProb);
+  m.def("_disable_sampling_profiler", disableSamplingProfiler);
+  m.def("_sampling_profiler_enabled", samplingProfilerEnabled);
+  m.def(
+      "_sampling_profiler_snapshot",
+      samplingProfilerSnapshot,
+      py::arg("delta") = false);
+
+  py::class_<StreamingTraceStats>(m, "_StreamingTraceStats")
+      .def_readonly("events_written", &StreamingTraceStats::events_written)
+      .def_readonly("events_dropped", &StreamingTraceStats::events_dropped);
+  m.def(
+      "_enable_streaming_trace",
+      [](const std::string& path,
+         size_t buffer_events,
+         int64_t flush_interval_ms,
+         int64_t capture_delay_ms,
+         int64_t capture_duration_ms) {
+        StreamingTraceConfig config;
+        config.path = path;
+        config.buffer_events = buffer_events;
+        config.flush_interval = std::chrono::milliseconds(flush_interval_ms);
+        config.capture_delay = std::chrono::milliseconds(capture_delay_ms);
+        config.capture_duration =
+            std::chrono::milliseconds(capture_duration_ms);
+        enableStreamingTrace(config);
+      },
+      py::arg("path"),
+      py::arg("buffer_events") = StreamingTraceConfig().buffer_events,
+      py::arg("flush_interval_ms") =
+          StreamingTraceConfig().flush_interval.count(),
+      py::arg("capture_delay_ms") = 0,
+      py::arg("capture_duration_ms") = 0);
+  m.def(
+      "_disable_streaming_trace",
+      disableStreamingTrace,
+      py::call_guard<py::gil_scoped_release>());
+  m.def("_streaming_trace_enabled", streamingTraceEnabled);
+
+  py::class_<MemorySiteStats>(m, "_MemorySiteStats")
+      .def_readonly("scope", &MemorySiteStats::scope)
+      .def_readonly("live_bytes", &MemorySiteStats::live_bytes)
+      .def_readonly("peak_bytes", &MemorySiteStats::peak_bytes)
+      .def_readonly("total_bytes", &MemorySiteStats::total_bytes)
+      .def_readonly("num_allocs", &MemorySiteStats::num_allocs);
+  py::class_<MemoryTrackerSnapshot>(m, "_MemoryTrackerSnapshot")
+      .def_readonly("current_bytes", &MemoryTrackerSnapshot::current_bytes)
+      .def_readonly("peak_bytes", &MemoryTrackerSnapshot::peak_bytes)
+      .def_readonly("peak_time_ns", &MemoryTrackerSnapshot::peak_time_ns)
+      .def_readonly("events_dropped", &MemoryTrackerSnapshot::events_dropped)
+      .def_readonly("sites", &MemoryTrackerSnapshot::sites);
+  m.def(
+      "_enable_memory_tracker",
+      [](size_t max_events) {
+        MemoryTrackerConfig config;
+        config.max_events = max_events;
+        enableMemoryTracker(config);
+      },
+      py::arg("max_events") = MemoryTrackerConfig().max_events);
+  m.def("_disable_memory_tracker", disableMemoryTracker);
+  m.def("_memory_tracker_enabled", memoryTrackerEnabled);
+  m.def("_memory_tracker_snapshot", memoryTrackerSnapshot);
+  m.def(
+      "_save_memory_trace",
+      saveMemoryTrace,
+      py::call_guard<py::gil_scoped_release>());
+
+  // Used by torch.inference_mode, the guard lives as long as the Python object.
+  py::class_<at::InferenceMode>(m, "_InferenceMode")
+      .def(py::init<bool>());
+  m.def("_is_inference_mode_enabled", at::InferenceMode::is_enabled);
+
   Py_RETURN_TRUE;
 }
 
@@ -2,3 +2,6 @@
 
 #include <torch/csrc/autograd/profiler_legacy.h>
 #include <torch/csrc/autograd/profiler_kineto.h>
+#include <torch/csrc/autograd/profiler_memory.h>
+#include <torch/csrc/autograd/profiler_sampling.h>
+#include <torch/csrc/autograd/profiler_streaming.h>
@@ -241,6 +241,10 @@ void ProfilerThreadLocalState::pushRange(
       evt.setStack(callstackStr(cs));
     }
 #endif
+    if (config_.with_perf_counters) {
+      // Read last, so that the profiler overhead is not counted.
+      evt.setPerfCounters(readPerfCounters());
+    }
     getEventList().record(std::move(evt));
   }
 }
@@ -252,6 +256,11 @@ void ProfilerThreadLocalState::popRange(const at::RecordFunction& fn, const bool
   if (config_.state == ProfilerState::NVTX) {
     cuda_stubs()->nvtxRangePop();
   } else {
+    // Read first, so that the profiler overhead is not counted.
+    PerfCounterValues perf_counters;
+    if (config_.with_perf_counters) {
+      perf_counters = readPerfCounters();
+    }
     // In some cases RecordFunction (and popRange) may be
     // called on a different thread than pushRange
     // As a convention, we put the async pop on the original
@@ -263,6 +272,9 @@ void ProfilerThreadLocalState::popRange(const at::RecordFunction& fn, const bool
         record_cuda,
         fn.handle());
     evt.setNodeId(at::RecordFunction::getDefaultNodeId());
+    if (config_.with_perf_counters) {
+      evt.setPerfCounters(perf_counters);
+    }
     getEventList(fn.threadId()).record(std::move(evt));
   }
 }
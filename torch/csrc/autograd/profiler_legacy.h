@@ -12,6 +12,7 @@
 #include <ATen/ATen.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/csrc/autograd/profiler_utils.h>
+#include <torch/csrc/autograd/profiler_perf.h>
 #ifndef _WIN32
 #include <ctime>
 #endif
@@ -308,6 +309,16 @@ struct TORCH_API LegacyEvent {
     flops_ = flops;
   }
 
+  // Hardware counters of the recording thread when the event was recorded,
+  // empty unless the profiler collects them.
+  const std::vector<int64_t>& perfCounters() const {
+    return perf_counters_;
+  }
+
+  void setPerfCounters(const PerfCounterValues& values) {
+    perf_counters_.assign(values.begin(), values.end());
+  }
+
  private:
   // signed to allow for negative intervals, initialized for safety.
   int64_t cpu_ns_ = 0;
@@ -332,6 +343,7 @@ struct TORCH_API LegacyEvent {
   // Extra arguments for computing op flops
   std::unordered_map<std::string, c10::IValue> extra_args_;
   uint64_t flops_ = 0;
+  std::vector<int64_t> perf_counters_;
 };
 
 // a linked-list of fixed sized vectors, to avoid
@@ -388,18 +400,21 @@ struct TORCH_API ProfilerConfig {
       bool report_input_shapes = false,
       bool profile_memory = false,
       bool with_stack = false,
-      bool with_flops = false)
+      bool with_flops = false,
+      bool with_perf_counters = false)
       : state(state),
         report_input_shapes(report_input_shapes),
         profile_memory(profile_memory),
         with_stack(with_stack),
-        with_flops(with_flops) {}
+        with_flops(with_flops),
+        with_perf_counters(with_perf_counters) {}
   ~ProfilerConfig() = default;
   ProfilerState state;
   bool report_input_shapes;
   bool profile_memory;
   bool with_stack;
   bool with_flops;
+  bool with_perf_counters;
 
   // Returns IValues corresponding to ProfilerConfig struct, to be used for
   // serialization.
@@ -0,0 +1,360 @@
+#include <torch/csrc/autograd/profiler_memory.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <ATen/record_function.h>
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/Exception.h>
+#include <c10/util/string_view.h>
+#include <torch/csrc/autograd/profiler_legacy.h>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+// Incremented every time the tracker is enabled, thread local scope stacks of
+// previous sessions are discarded.
+std::atomic<uint64_t> current_session{0};
+
+struct ThreadScopes {
+  uint64_t session = 0;
+  // Names of the RecordFunction scopes of the thread, outermost first.
+  std::vector<at::StringView> stack;
+};
+
+thread_local ThreadScopes tls_scopes;
+
+std::vector<at::StringView>& currentScopes() {
+  auto session = current_session.load(std::memory_order_acquire);
+  if (C10_UNLIKELY(tls_scopes.session != session)) {
+    tls_scopes.stack.clear();
+    tls_scopes.session = session;
+  }
+  return tls_scopes.stack;
+}
+
+struct ScopeObserverContext : public at::ObserverContext {
+  ScopeObserverContext(const std::vector<at::StringView>* stack, size_t depth)
+      : stack(stack), depth(depth) {}
+
+  // Stack the scope was pushed on.
+  const std::vector<at::StringView>* stack;
+  // Size of the stack before the scope was pushed.
+  size_t depth;
+};
+
+std::unique_ptr<at::ObserverContext> onScopeEnter(
+    const at::RecordFunction& fn) {
+  auto& stack = currentScopes();
+  auto depth = stack.size();
+  stack.push_back(fn.name());
+  return std::make_unique<ScopeObserverContext>(&stack, depth);
+}
+
+void onScopeExit(const at::RecordFunction& fn, at::ObserverContext* ctx_ptr) {
+  auto* ctx = static_cast<ScopeObserverContext*>(ctx_ptr);
+  if (!ctx) {
+    return;
+  }
+  auto& stack = currentScopes();
+  // Scopes ending on another thread (async ops) are left on the stack of
+  // their thread, until their parent scope ends.
+  if (&stack == ctx->stack && stack.size() > ctx->depth) {
+    stack.erase(stack.begin() + ctx->depth, stack.end());
+  }
+}
+
+struct MemoryEvent {
+  int64_t time_ns;
+  // Negative for frees.
+  int64_t bytes;
+  int64_t site;
+  uint64_t thread_id;
+};
+
+// FNV-1a. std::hash<c10::string_view> hashes a std::string copy, and the
+// allocation hook must not allocate.
+struct StringViewHash {
+  size_t operator()(c10::string_view str) const {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : str) {
+      hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return static_cast<size_t>(hash);
+  }
+};
+
+void writeJSONString(std::ostream& out, const std::string& str) {
+  out << '"';
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << ' ';
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+class MemoryTracker : public c10::CPUMemoryTracker {
+ public:
+  void enable(const MemoryTrackerConfig& config) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    config_ = config;
+    start_ns_ = getTime();
+    sites_.clear();
+    sites_.emplace_back(-1, std::string());
+    blocks_.clear();
+    current_bytes_ = 0;
+    peak_bytes_ = 0;
+    peak_time_ns_ = start_ns_;
+    peak_live_bytes_.clear();
+    changed_sites_.clear();
+    events_.clear();
+    events_dropped_ = 0;
+    enabled_ = true;
+  }
+
+  void disable() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    enabled_ = false;
+  }
+
+  bool enabled() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return enabled_;
+  }
+
+  void trackAlloc(void* ptr, size_t nbytes) override {
+    const auto& scopes = currentScopes();
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!enabled_) {
+      return;
+    }
+    auto site = internSite(scopes);
+    auto bytes = static_cast<int64_t>(nbytes);
+    blocks_[ptr] = Block{bytes, site};
+    addLiveBytes(site, bytes);
+    sites_[site].total_bytes += bytes;
+    sites_[site].num_allocs++;
+    current_bytes_ += bytes;
+    auto now = getTime();
+    if (current_bytes_ > peak_bytes_) {
+      peak_bytes_ = current_bytes_;
+      peak_time_ns_ = now;
+      // Only the sites that changed since the previous peak need updating.
+      peak_live_bytes_.resize(sites_.size(), 0);
+      for (auto changed : changed_sites_) {
+        peak_live_bytes_[changed] = sites_[changed].live_bytes;
+        sites_[changed].changed_since_peak = false;
+      }
+      changed_sites_.clear();
+    }
+    recordEvent(now, bytes, site);
+  }
+
+  void trackFree(void* ptr) override {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!enabled_) {
+      return;
+    }
+    auto it = blocks_.find(ptr);
+    if (it == blocks_.end()) {
+      // Allocated before the tracker was enabled.
+      return;
+    }
+    auto block = it->second;
+    blocks_.erase(it);
+    addLiveBytes(block.site, -block.nbytes);
+    current_bytes_ -= block.nbytes;
+    recordEvent(getTime(), -block.nbytes, block.site);
+  }
+
+  MemoryTrackerSnapshot snapshot() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    MemoryTrackerSnapshot result;
+    result.current_bytes = current_bytes_;
+    result.peak_bytes = peak_bytes_;
+    result.peak_time_ns = peak_time_ns_ - start_ns_;
+    result.events_dropped = events_dropped_;
+    for (size_t i = 0; i < sites_.size(); i++) {
+      const auto& site = sites_[i];
+      if (site.num_allocs == 0) {
+        continue;
+      }
+      MemorySiteStats stats;
+      for (auto s = static_cast<int64_t>(i); s > 0; s = sites_[s].parent) {
+        stats.scope.push_back(sites_[s].name);
+      }
+      std::reverse(stats.scope.begin(), stats.scope.end());
+      stats.live_bytes = site.live_bytes;
+      stats.peak_bytes = peakLiveBytes(i);
+      stats.total_bytes = site.total_bytes;
+      stats.num_allocs = site.num_allocs;
+      result.sites.push_back(std::move(stats));
+    }
+    return result;
+  }
+
+  void save(const std::string& path) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    TORCH_CHECK(out, "Unable to open memory trace file ", path);
+    out << std::fixed << std::setprecision(3);
+    out << "{\"version\": 1"
+        << ", \"current_bytes\": " << current_bytes_
+        << ", \"peak_bytes\": " << peak_bytes_
+        << ", \"peak_time_us\": " << (peak_time_ns_ - start_ns_) / 1000.0
+        << ", \"events_dropped\": " << events_dropped_
+        << ",\n\"sites\": [";
+    // Parents always come before their children.
+    for (size_t i = 0; i < sites_.size(); i++) {
+      const auto& site = sites_[i];
+      out << (i == 0 ? "\n" : ",\n") << "{\"name\": ";
+      writeJSONString(out, site.name);
+      out << ", \"parent\": " << site.parent
+          << ", \"live_bytes\": " << site.live_bytes
+          << ", \"peak_bytes\": " << peakLiveBytes(i)
+          << ", \"total_bytes\": " << site.total_bytes
+          << ", \"num_allocs\": " << site.num_allocs << "}";
+    }
+    out << "\n],\n\"events\": [";
+    for (size_t i = 0; i < events_.size(); i++) {
+      const auto& event = events_[i];
+      out << (i == 0 ? "\n" : ",\n") << "["
+          << (event.time_ns - start_ns_) / 1000.0 << ", " << event.site << ", "
+          << event.bytes << ", " << event.thread_id << "]";
+    }
+    out << "\n]}\n";
+    TORCH_CHECK(out, "Unable to write memory trace file ", path);
+  }
+
+ private:
+  struct Site {
+    Site(int64_t parent, std::string name)
+        : parent(parent), name(std::move(name)) {}
+
+    int64_t parent;
+    std::string name;
+    // Keys point to the names of the children.
+    std::unordered_map<c10::string_view, int64_t, StringViewHash> children;
+    int64_t live_bytes = 0;
+    int64_t total_bytes = 0;
+    int64_t num_allocs = 0;
+    bool changed_since_peak = false;
+  };
+
+  struct Block {
+    int64_t nbytes;
+    int64_t site;
+  };
+
+  // Returns the site of the given scopes, sites form a tree rooted at the
+  // site without scope.
+  int64_t internSite(const std::vector<at::StringView>& scopes) {
+    int64_t site = 0;
+    for (const auto& scope : scopes) {
+      auto& children = sites_[site].children;
+      auto it = children.find(c10::string_view(scope.str()));
+      if (it != children.end()) {
+        site = it->second;
+        continue;
+      }
+      auto child = static_cast<int64_t>(sites_.size());
+      sites_.emplace_back(site, scope.str());
+      children.emplace(c10::string_view(sites_.back().name), child);
+      site = child;
+    }
+    return site;
+  }
+
+  void addLiveBytes(int64_t site, int64_t bytes) {
+    auto& entry = sites_[site];
+    entry.live_bytes += bytes;
+    if (!entry.changed_since_peak) {
+      entry.changed_since_peak = true;
+      changed_sites_.push_back(site);
+    }
+  }
+
+  // Sites created after the peak had no memory at peak.
+  int64_t peakLiveBytes(size_t site) const {
+    return site < peak_live_bytes_.size() ? peak_live_bytes_[site] : 0;
+  }
+
+  void recordEvent(int64_t time_ns, int64_t bytes, int64_t site) {
+    if (events_.size() >= config_.max_events) {
+      events_dropped_++;
+      return;
+    }
+    events_.push_back(MemoryEvent{
+        time_ns, bytes, site, at::RecordFunction::currentThreadId()});
+  }
+
+  std::mutex mutex_;
+  bool enabled_ = false;
+  MemoryTrackerConfig config_;
+  int64_t start_ns_ = 0;
+  // A deque, so that the names of the sites never move.
+  std::deque<Site> sites_;
+  std::unordered_map<void*, Block> blocks_;
+  int64_t current_bytes_ = 0;
+  int64_t peak_bytes_ = 0;
+  int64_t peak_time_ns_ = 0;
+  // Live bytes of every site at peak, and the sites whose live bytes changed
+  // since then.
+  std::vector<int64_t> peak_live_bytes_;
+  std::vector<int64_t> changed_sites_;
+  std::vector<MemoryEvent> events_;
+  uint64_t events_dropped_ = 0;
+};
+
+// Leaky singleton, since allocations may still report to it after it is
+// unset.
+MemoryTracker& tracker() {
+  static MemoryTracker* tracker = new MemoryTracker();
+  return *tracker;
+}
+
+at::CallbackHandle handle = 0;
+
+} // namespace
+
+void enableMemoryTracker(const MemoryTrackerConfig& config) {
+  TORCH_CHECK(!memoryTrackerEnabled(), "Memory tracker is already enabled");
+  current_session++;
+  tracker().enable(config);
+  handle = at::addGlobalCallback(
+      at::RecordFunctionCallback(&onScopeEnter, &onScopeExit));
+  c10::SetCPUMemoryTracker(&tracker());
+}
+
+void disableMemoryTracker() {
+  TORCH_CHECK(memoryTrackerEnabled(), "Memory tracker is not enabled");
+  c10::SetCPUMemoryTracker(nullptr);
+  at::removeCallback(handle);
+  tracker().disable();
+}
+
+bool memoryTrackerEnabled() {
+  return tracker().enabled();
+}
+
+MemoryTrackerSnapshot memoryTrackerSnapshot() {
+  return tracker().snapshot();
+}
+
+void saveMemoryTrace(const std::string& path) {
+  tracker().save(path);
+}
+
+}}} // namespace torch::autograd::profiler
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// CPU memory tracker, meant to find what holds the memory at peak.
+//
+// While enabled, every CPU allocation and free of all the threads is
+// attributed to an allocation site: the stack of RecordFunction scopes (ops,
+// backward functions, record_function user scopes, e.g. the module scopes
+// pushed by torch.utils.memory_tracker) of the allocating thread. The tracker
+// maintains the live bytes of every site, and a copy of them when the total
+// live memory reaches its peak. It also optionally records a timeline of the
+// allocations and frees.
+//
+// Only the allocations of the default CPU allocator, made after the tracker
+// was enabled, are tracked. All the allocations are serialized on a mutex.
+
+struct TORCH_API MemoryTrackerConfig {
+  // Maximum number of allocation and free events of the timeline, the next
+  // ones are dropped. The per site stats are exact regardless.
+  size_t max_events = 1 << 22;
+};
+
+struct TORCH_API MemorySiteStats {
+  // Outermost scope first, empty for allocations outside of any scope.
+  std::vector<std::string> scope;
+  // Bytes allocated by this site and still alive.
+  int64_t live_bytes = 0;
+  // Bytes allocated by this site and alive when the total reached its peak.
+  int64_t peak_bytes = 0;
+  // Bytes allocated by this site, including the freed ones.
+  int64_t total_bytes = 0;
+  int64_t num_allocs = 0;
+};
+
+struct TORCH_API MemoryTrackerSnapshot {
+  int64_t current_bytes = 0;
+  int64_t peak_bytes = 0;
+  // Time of the peak, relative to enableMemoryTracker().
+  int64_t peak_time_ns = 0;
+  uint64_t events_dropped = 0;
+  // Sites that allocated memory.
+  std::vector<MemorySiteStats> sites;
+};
+
+// Starts tracking and drops the data of the previous session. Not thread safe,
+// see at::addGlobalCallback.
+TORCH_API void enableMemoryTracker(const MemoryTrackerConfig& config);
+
+// Stops tracking. The data can still be inspected until the tracker is enabled
+// again. Not thread safe, see at::removeCallback.
+TORCH_API void disableMemoryTracker();
+
+TORCH_API bool memoryTrackerEnabled();
+
+TORCH_API MemoryTrackerSnapshot memoryTrackerSnapshot();
+
+// Writes the sites and the timeline as JSON, see torch/utils/memory_tracker.py
+// for the format.
+TORCH_API void saveMemoryTrace(const std::string& path);
+
+}}} // namespace torch::autograd::profiler
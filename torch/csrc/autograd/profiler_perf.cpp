@@ -0,0 +1,156 @@
+#include <torch/csrc/autograd/profiler_perf.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <vector>
+#endif
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+#ifdef __linux__
+
+struct PerfCounterSpec {
+  uint32_t type;
+  uint64_t config;
+};
+
+// Same order as PerfCounter.
+constexpr PerfCounterSpec kPerfCounterSpecs[kNumPerfCounters] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    // Usually last level cache misses, see perf_event_open(2).
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+class PerfCounterGroup {
+ public:
+  PerfCounterGroup() {
+    for (size_t i = 0; i < kNumPerfCounters; i++) {
+      struct perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = kPerfCounterSpecs[i].type;
+      attr.config = kPerfCounterSpecs[i].config;
+      // The whole group is enabled through the leader once it is complete.
+      attr.disabled = leader_fd_ < 0 ? 1 : 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+          PERF_FORMAT_TOTAL_TIME_RUNNING;
+      // Current thread, any cpu.
+      int fd = static_cast<int>(syscall(
+          __NR_perf_event_open,
+          &attr,
+          0,
+          -1,
+          leader_fd_,
+          PERF_FLAG_FD_CLOEXEC));
+      if (fd < 0) {
+        // Not permitted or not supported, the other counters may still work.
+        continue;
+      }
+      if (leader_fd_ < 0) {
+        leader_fd_ = fd;
+      }
+      fds_.push_back(fd);
+      counters_.push_back(i);
+    }
+    if (leader_fd_ >= 0 &&
+        ioctl(leader_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) != 0) {
+      closeAll();
+    }
+  }
+
+  ~PerfCounterGroup() {
+    closeAll();
+  }
+
+  PerfCounterGroup(const PerfCounterGroup&) = delete;
+  PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+  bool available() const {
+    return leader_fd_ >= 0;
+  }
+
+  PerfCounterValues read() const {
+    PerfCounterValues values;
+    values.fill(kPerfCounterUnavailable);
+    if (!available()) {
+      return values;
+    }
+    // Layout of a PERF_FORMAT_GROUP read: nr, time_enabled, time_running,
+    // then nr values.
+    uint64_t data[3 + kNumPerfCounters];
+    auto size = ::read(leader_fd_, data, sizeof(data));
+    if (size < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+      return values;
+    }
+    const uint64_t nr = data[0];
+    const uint64_t time_enabled = data[1];
+    const uint64_t time_running = data[2];
+    if (time_running == 0 || nr != counters_.size() ||
+        size < static_cast<ssize_t>((3 + nr) * sizeof(uint64_t))) {
+      // The group was never scheduled on a pmu.
+      return values;
+    }
+    const double scale = time_running < time_enabled
+        ? static_cast<double>(time_enabled) / time_running
+        : 1.0;
+    for (size_t i = 0; i < nr; i++) {
+      values[counters_[i]] = static_cast<int64_t>(data[3 + i] * scale);
+    }
+    return values;
+  }
+
+ private:
+  void closeAll() {
+    for (auto fd : fds_) {
+      close(fd);
+    }
+    fds_.clear();
+    counters_.clear();
+    leader_fd_ = -1;
+  }
+
+  int leader_fd_ = -1;
+  std::vector<int> fds_;
+  // Index in PerfCounterValues of the counter of every fd.
+  std::vector<size_t> counters_;
+};
+
+PerfCounterGroup& getPerfCounterGroup() {
+  thread_local PerfCounterGroup group;
+  return group;
+}
+
+#endif // __linux__
+
+} // namespace
+
+bool perfCountersAvailable() {
+#ifdef __linux__
+  return getPerfCounterGroup().available();
+#else
+  return false;
+#endif
+}
+
+PerfCounterValues readPerfCounters() {
+#ifdef __linux__
+  return getPerfCounterGroup().read();
+#else
+  PerfCounterValues values;
+  values.fill(kPerfCounterUnavailable);
+  return values;
+#endif
+}
+
+}}} // namespace torch::autograd::profiler
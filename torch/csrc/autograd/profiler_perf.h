@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// Hardware performance counters of the current thread, read through Linux
+// perf_event_open(2).
+//
+// The counters are opened as a single group the first time a thread reads
+// them, and count user space events of that thread only: work done by other
+// threads, e.g. intra-op thread pools, is not included. On other platforms, or
+// when perf events are not permitted (kernel.perf_event_paranoid, seccomp
+// filters of containers) or not supported by the (virtual) CPU, the counters
+// are reported as unavailable.
+
+enum class PerfCounter : uint8_t {
+  CYCLES = 0,
+  INSTRUCTIONS,
+  LLC_MISSES,
+  BRANCH_MISSES,
+  NUM_PERF_COUNTERS, // must be the last one
+};
+
+constexpr size_t kNumPerfCounters =
+    static_cast<size_t>(PerfCounter::NUM_PERF_COUNTERS);
+
+// Value of the counters that cannot be read.
+constexpr int64_t kPerfCounterUnavailable = -1;
+
+using PerfCounterValues = std::array<int64_t, kNumPerfCounters>;
+
+// Whether at least one counter can be read on the current thread.
+TORCH_API bool perfCountersAvailable();
+
+// Reads the counters of the current thread. The values are monotonic, only
+// the difference between two reads on the same thread is meaningful. Counters
+// time multiplexed with other perf events are scaled to their enabled time.
+TORCH_API PerfCounterValues readPerfCounters();
+
+}}} // namespace torch::autograd::profiler
@@ -0,0 +1,255 @@
+#include <torch/csrc/autograd/profiler_sampling.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <c10/util/Exception.h>
+#include <c10/util/llvmMathExtras.h>
+#include <torch/csrc/autograd/profiler_legacy.h>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+struct SamplingObserverContext : public at::ObserverContext {
+  explicit SamplingObserverContext(int64_t start_ns) : start_ns(start_ns) {}
+
+  int64_t start_ns;
+};
+
+// Counters of one op on one thread. They are only written by the thread that
+// owns them, so plain loads and stores are enough; they are atomic because
+// snapshots read them concurrently.
+struct OpCounters {
+  OpCounters() {
+    for (auto& bucket : buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> total_ns{0};
+  std::array<std::atomic<uint64_t>, kNumLatencyBuckets> buckets;
+};
+
+inline void increment(std::atomic<uint64_t>& counter, uint64_t value) {
+  counter.store(
+      counter.load(std::memory_order_relaxed) + value,
+      std::memory_order_relaxed);
+}
+
+struct ThreadBuffer {
+  // Only taken when the owning thread inserts a new op, and by snapshots.
+  // Updates of existing counters do not need it, since map nodes are stable.
+  std::mutex mutex;
+  std::unordered_map<std::string, OpCounters> ops;
+};
+
+void accumulate(
+    std::unordered_map<std::string, SampledOpStats>& totals,
+    const ThreadBuffer& buffer) {
+  for (const auto& op : buffer.ops) {
+    auto& stats = totals[op.first];
+    stats.count += op.second.count.load(std::memory_order_relaxed);
+    stats.total_ns += op.second.total_ns.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kNumLatencyBuckets; i++) {
+      stats.buckets[i] += op.second.buckets[i].load(std::memory_order_relaxed);
+    }
+  }
+}
+
+struct SamplingProfilerState {
+  std::mutex mutex;
+  bool enabled = false;
+  at::CallbackHandle handle = 0;
+  // Buffers of the live threads that sampled an op in the current session.
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  // Totals of the threads that exited during the current session.
+  std::unordered_map<std::string, SampledOpStats> retired;
+  // Totals at the previous delta snapshot.
+  std::unordered_map<std::string, SampledOpStats> previous;
+};
+
+// Leaky singleton, since thread local buffers access it when threads exit.
+SamplingProfilerState& state() {
+  static SamplingProfilerState* state = new SamplingProfilerState();
+  return *state;
+}
+
+// Incremented every time the profiler is enabled, thread local buffers of
+// previous sessions are discarded.
+std::atomic<uint64_t> current_session{0};
+
+struct ThreadBufferHolder {
+  ~ThreadBufferHolder() {
+    if (!buffer) {
+      return;
+    }
+    auto& s = state();
+    std::lock_guard<std::mutex> guard(s.mutex);
+    // The buffer is gone if the profiler was disabled or re-enabled since.
+    auto it = std::find(s.buffers.begin(), s.buffers.end(), buffer);
+    if (it == s.buffers.end()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> buffer_guard(buffer->mutex);
+      accumulate(s.retired, *buffer);
+    }
+    s.buffers.erase(it);
+  }
+
+  uint64_t session = 0;
+  std::shared_ptr<ThreadBuffer> buffer;
+};
+
+thread_local ThreadBufferHolder tls_buffer;
+
+ThreadBuffer& getThreadBuffer() {
+  auto session = current_session.load(std::memory_order_acquire);
+  if (C10_UNLIKELY(tls_buffer.session != session || !tls_buffer.buffer)) {
+    auto buffer = std::make_shared<ThreadBuffer>();
+    auto& s = state();
+    std::lock_guard<std::mutex> guard(s.mutex);
+    s.buffers.push_back(buffer);
+    tls_buffer.session = session;
+    tls_buffer.buffer = std::move(buffer);
+  }
+  return *tls_buffer.buffer;
+}
+
+inline size_t latencyBucket(uint64_t latency_ns) {
+  if (latency_ns < 2) {
+    return 0;
+  }
+  return std::min<size_t>(
+      llvm::Log2_64(latency_ns), kNumLatencyBuckets - 1);
+}
+
+std::unique_ptr<at::ObserverContext> onFunctionEnter(
+    const at::RecordFunction& fn) {
+  return std::make_unique<SamplingObserverContext>(getTime());
+}
+
+void onFunctionExit(
+    const at::RecordFunction& fn,
+    at::ObserverContext* ctx_ptr) {
+  auto* ctx = static_cast<SamplingObserverContext*>(ctx_ptr);
+  TORCH_INTERNAL_ASSERT_DEBUG_ONLY(ctx);
+  auto latency_ns = static_cast<uint64_t>(std::max<int64_t>(
+      getTime() - ctx->start_ns, 0));
+
+  auto& buffer = getThreadBuffer();
+  const char* name = fn.name().str();
+  auto it = buffer.ops.find(name);
+  if (C10_UNLIKELY(it == buffer.ops.end())) {
+    std::lock_guard<std::mutex> guard(buffer.mutex);
+    it = buffer.ops
+             .emplace(
+                 std::piecewise_construct,
+                 std::forward_as_tuple(name),
+                 std::forward_as_tuple())
+             .first;
+  }
+  auto& counters = it->second;
+  increment(counters.count, 1);
+  increment(counters.total_ns, latency_ns);
+  increment(counters.buckets[latencyBucket(latency_ns)], 1);
+}
+
+} // namespace
+
+double SampledOpStats::quantileNs(double q) const {
+  if (count == 0) {
+    return 0;
+  }
+  auto rank = q * count;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumLatencyBuckets; i++) {
+    if (buckets[i] == 0 || seen + buckets[i] < rank) {
+      seen += buckets[i];
+      continue;
+    }
+    // Interpolate linearly within the bucket.
+    double lower = i == 0 ? 0 : static_cast<double>(uint64_t(1) << i);
+    double upper = static_cast<double>(uint64_t(1) << (i + 1));
+    return lower + (upper - lower) * (rank - seen) / buckets[i];
+  }
+  return static_cast<double>(uint64_t(1) << kNumLatencyBuckets);
+}
+
+void enableSamplingProfiler(
+    double sampling_prob,
+    const std::unordered_set<at::RecordScope, std::hash<at::RecordScope>>&
+        scopes) {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  TORCH_CHECK(!s.enabled, "Sampling profiler is already enabled");
+  current_session++;
+  // Drop the buffers registered by ops that were still running when the
+  // profiler was disabled.
+  s.buffers.clear();
+  s.retired.clear();
+  s.previous.clear();
+  s.handle = at::addGlobalCallback(
+      at::RecordFunctionCallback(&onFunctionEnter, &onFunctionExit)
+          .samplingProb(sampling_prob)
+          .scopes(scopes));
+  s.enabled = true;
+}
+
+void disableSamplingProfiler() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  TORCH_CHECK(s.enabled, "Sampling profiler is not enabled");
+  at::removeCallback(s.handle);
+  s.enabled = false;
+  s.buffers.clear();
+  s.retired.clear();
+  s.previous.clear();
+}
+
+bool samplingProfilerEnabled() {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  return s.enabled;
+}
+
+std::vector<SampledOpStats> samplingProfilerSnapshot(bool delta) {
+  auto& s = state();
+  std::lock_guard<std::mutex> guard(s.mutex);
+  auto totals = s.retired;
+  for (const auto& buffer : s.buffers) {
+    std::lock_guard<std::mutex> buffer_guard(buffer->mutex);
+    accumulate(totals, *buffer);
+  }
+
+  std::vector<SampledOpStats> result;
+  result.reserve(totals.size());
+  for (auto& entry : totals) {
+    auto stats = entry.second;
+    stats.name = entry.first;
+    if (delta) {
+      auto prev = s.previous.find(entry.first);
+      if (prev != s.previous.end()) {
+        stats.count -= prev->second.count;
+        stats.total_ns -= prev->second.total_ns;
+        for (size_t i = 0; i < kNumLatencyBuckets; i++) {
+          stats.buckets[i] -= prev->second.buckets[i];
+        }
+      }
+    }
+    if (stats.count > 0) {
+      result.push_back(std::move(stats));
+    }
+  }
+  if (delta) {
+    s.previous = std::move(totals);
+  }
+  return result;
+}
+
+}}} // namespace torch::autograd::profiler
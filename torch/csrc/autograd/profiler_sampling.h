@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <ATen/record_function.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// Sampling profiler, meant to stay enabled in production.
+//
+// A global RecordFunction callback records the latency of a random subset of
+// the ops into per-op latency histograms. With a sampling probability not
+// larger than kDefaultSamplingProb, RecordFunction uses its thread local
+// pre-sampling, so that ops that are not sampled only pay for decrementing a
+// thread local counter. Sampled ops update counters in a buffer owned by the
+// current thread, without taking any lock.
+//
+// The histograms of all threads are merged on demand by
+// samplingProfilerSnapshot().
+
+constexpr double kDefaultSamplingProb = 0.001;
+
+// Bucket i of the latency histogram counts the latencies in [2^i, 2^(i+1)) ns,
+// the last bucket also counts all the longer latencies.
+constexpr size_t kNumLatencyBuckets = 40;
+
+struct TORCH_API SampledOpStats {
+  std::string name;
+  // Number of sampled calls.
+  uint64_t count = 0;
+  // Total latency of the sampled calls.
+  uint64_t total_ns = 0;
+  std::array<uint64_t, kNumLatencyBuckets> buckets{};
+
+  // Estimates the latency at quantile q (in [0, 1]) from the histogram.
+  double quantileNs(double q) const;
+};
+
+// Starts sampling ops of the given scopes (all scopes if empty) with the given
+// probability. Not thread safe, see at::addGlobalCallback.
+TORCH_API void enableSamplingProfiler(
+    double sampling_prob = kDefaultSamplingProb,
+    const std::unordered_set<at::RecordScope, std::hash<at::RecordScope>>&
+        scopes = {});
+
+// Stops sampling and drops all the collected data. Not thread safe, see
+// at::removeCallback.
+TORCH_API void disableSamplingProfiler();
+
+TORCH_API bool samplingProfilerEnabled();
+
+// Returns the stats of the ops sampled since the profiler was enabled, or
+// since the previous delta snapshot if delta is true. Can be called from any
+// thread while ops are running.
+TORCH_API std::vector<SampledOpStats> samplingProfilerSnapshot(
+    bool delta = false);
+
+}}} // namespace torch::autograd::profiler
@@ -0,0 +1,337 @@
+#include <torch/csrc/autograd/profiler_streaming.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ATen/record_function.h>
+#include <c10/util/Exception.h>
+#include <c10/util/llvmMathExtras.h>
+#include <torch/csrc/autograd/profiler_legacy.h>
+
+namespace torch { namespace autograd { namespace profiler {
+
+namespace {
+
+// Names are copied into the event, so that recording never allocates; longer
+// names are truncated.
+constexpr size_t kMaxNameLength = 64;
+
+struct TraceEvent {
+  char name[kMaxNameLength];
+  int64_t start_ns;
+  int64_t end_ns;
+  uint64_t thread_id;
+};
+
+struct StreamingObserverContext : public at::ObserverContext {
+  explicit StreamingObserverContext(int64_t start_ns) : start_ns(start_ns) {}
+
+  int64_t start_ns;
+};
+
+// Single producer (the owning thread), single consumer (the flusher) ring
+// buffer of events.
+struct TraceRingBuffer {
+  explicit TraceRingBuffer(size_t capacity)
+      : events(capacity), mask(capacity - 1) {}
+
+  // Only called by the owning thread.
+  void push(
+      const at::RecordFunction& fn,
+      int64_t start_ns,
+      int64_t end_ns) {
+    auto h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == events.size()) {
+      dropped.store(
+          dropped.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+      return;
+    }
+    auto& event = events[h & mask];
+    std::strncpy(event.name, fn.name().str(), kMaxNameLength - 1);
+    event.name[kMaxNameLength - 1] = '\0';
+    event.start_ns = start_ns;
+    event.end_ns = end_ns;
+    event.thread_id = fn.threadId();
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  std::vector<TraceEvent> events;
+  const size_t mask;
+  // Index of the next event to write.
+  std::atomic<uint64_t> head{0};
+  // Index of the next event to read.
+  std::atomic<uint64_t> tail{0};
+  std::atomic<uint64_t> dropped{0};
+  // Set when the owning thread exits, the flusher then drops the buffer once
+  // it is drained.
+  std::atomic<bool> retired{false};
+};
+
+class StreamingTraceSession {
+ public:
+  StreamingTraceSession(const StreamingTraceConfig& config, int64_t start_ns)
+      : config_(config),
+        buffer_events_(
+            llvm::PowerOf2Ceil(std::max<size_t>(config.buffer_events, 2))),
+        start_ns_(start_ns),
+        out_(config.path, std::ios::out | std::ios::trunc) {
+    TORCH_CHECK(out_, "Unable to open trace file ", config.path);
+    // Timestamps are in us, keep ns precision.
+    out_ << std::fixed << std::setprecision(3);
+    out_ << "{\"traceEvents\": [";
+    thread_ = std::thread(&StreamingTraceSession::run, this);
+  }
+
+  ~StreamingTraceSession() {
+    // The tracer is still enabled at exit.
+    if (thread_.joinable()) {
+      stop();
+    }
+  }
+
+  size_t bufferEvents() const {
+    return buffer_events_;
+  }
+
+  void addBuffer(std::shared_ptr<TraceRingBuffer> buffer) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    buffers_.push_back(std::move(buffer));
+  }
+
+  StreamingTraceStats stop() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    finish();
+    return stats_;
+  }
+
+ private:
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_ && !finished_) {
+      cv_.wait_for(lock, config_.flush_interval, [this] { return stop_; });
+      const bool window_over = config_.capture_duration.count() > 0 &&
+          getTime() >= start_ns_ +
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      config_.capture_delay + config_.capture_duration)
+                      .count();
+      auto buffers = buffers_;
+      lock.unlock();
+      drain(buffers);
+      lock.lock();
+      // Drop drained buffers of exited threads.
+      buffers_.erase(
+          std::remove_if(
+              buffers_.begin(),
+              buffers_.end(),
+              [this](const std::shared_ptr<TraceRingBuffer>& buffer) {
+                if (buffer->retired.load() &&
+                    buffer->tail.load() == buffer->head.load()) {
+                  stats_.events_dropped += buffer->dropped.load();
+                  return true;
+                }
+                return false;
+              }),
+          buffers_.end());
+      if (window_over) {
+        // No more events are recorded, complete the trace file right away.
+        lock.unlock();
+        finish();
+        lock.lock();
+      }
+    }
+  }
+
+  // Only called by the flusher thread, or after it exited.
+  void drain(const std::vector<std::shared_ptr<TraceRingBuffer>>& buffers) {
+    if (finished_) {
+      return;
+    }
+    for (const auto& buffer : buffers) {
+      auto head = buffer->head.load(std::memory_order_acquire);
+      auto tail = buffer->tail.load(std::memory_order_relaxed);
+      for (; tail != head; tail++) {
+        writeEvent(buffer->events[tail & buffer->mask]);
+      }
+      buffer->tail.store(tail, std::memory_order_release);
+    }
+    out_.flush();
+  }
+
+  void writeEvent(const TraceEvent& event) {
+    out_ << (stats_.events_written == 0 ? "\n" : ",\n") << "{\"name\": \"";
+    for (const char* c = event.name; *c != '\0'; c++) {
+      if (*c == '"' || *c == '\\') {
+        out_ << '\\' << *c;
+      } else if (static_cast<unsigned char>(*c) < 0x20) {
+        out_ << ' ';
+      } else {
+        out_ << *c;
+      }
+    }
+    out_ << "\", \"ph\": \"X\", \"ts\": "
+         << (event.start_ns - start_ns_) / 1000.0
+         << ", \"dur\": " << (event.end_ns - event.start_ns) / 1000.0
+         << ", \"tid\": " << event.thread_id
+         << ", \"pid\": \"CPU functions\", \"args\": {}}";
+    stats_.events_written++;
+  }
+
+  void finish() {
+    if (finished_) {
+      return;
+    }
+    std::vector<std::shared_ptr<TraceRingBuffer>> buffers;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      buffers = buffers_;
+    }
+    drain(buffers);
+    for (const auto& buffer : buffers) {
+      stats_.events_dropped += buffer->dropped.load();
+    }
+    out_ << "\n]}\n";
+    out_.close();
+    finished_ = true;
+  }
+
+  const StreamingTraceConfig config_;
+  const size_t buffer_events_;
+  const int64_t start_ns_;
+
+  std::ofstream out_;
+  // Only accessed by the flusher thread, or after it exited.
+  StreamingTraceStats stats_;
+  bool finished_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+  std::vector<std::shared_ptr<TraceRingBuffer>> buffers_;
+  std::thread thread_;
+};
+
+std::mutex session_mutex;
+std::unique_ptr<StreamingTraceSession> active_session;
+// Incremented every time the tracer is enabled, thread local buffers of
+// previous sessions are discarded.
+std::atomic<uint64_t> current_session{0};
+// Capture window, in getTime() time.
+std::atomic<int64_t> window_start_ns{0};
+std::atomic<int64_t> window_end_ns{0};
+
+struct ThreadBufferHolder {
+  ~ThreadBufferHolder() {
+    if (buffer) {
+      buffer->retired.store(true);
+    }
+  }
+
+  uint64_t session = 0;
+  std::shared_ptr<TraceRingBuffer> buffer;
+};
+
+thread_local ThreadBufferHolder tls_buffer;
+
+TraceRingBuffer* getThreadBuffer() {
+  auto current = current_session.load(std::memory_order_acquire);
+  if (C10_UNLIKELY(tls_buffer.session != current || !tls_buffer.buffer)) {
+    std::lock_guard<std::mutex> guard(session_mutex);
+    if (!active_session) {
+      return nullptr;
+    }
+    if (tls_buffer.buffer) {
+      tls_buffer.buffer->retired.store(true);
+    }
+    auto buffer =
+        std::make_shared<TraceRingBuffer>(active_session->bufferEvents());
+    active_session->addBuffer(buffer);
+    tls_buffer.session = current;
+    tls_buffer.buffer = std::move(buffer);
+  }
+  return tls_buffer.buffer.get();
+}
+
+std::unique_ptr<at::ObserverContext> onFunctionEnter(
+    const at::RecordFunction& fn) {
+  auto now = getTime();
+  if (now < window_start_ns.load(std::memory_order_relaxed) ||
+      now >= window_end_ns.load(std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  return std::make_unique<StreamingObserverContext>(now);
+}
+
+void onFunctionExit(
+    const at::RecordFunction& fn,
+    at::ObserverContext* ctx_ptr) {
+  auto* ctx = static_cast<StreamingObserverContext*>(ctx_ptr);
+  if (!ctx) {
+    // Outside of the capture window.
+    return;
+  }
+  auto* buffer = getThreadBuffer();
+  if (buffer) {
+    buffer->push(fn, ctx->start_ns, getTime());
+  }
+}
+
+at::CallbackHandle handle = 0;
+
+} // namespace
+
+void enableStreamingTrace(const StreamingTraceConfig& config) {
+  TORCH_CHECK(!streamingTraceEnabled(), "Streaming trace is already enabled");
+  TORCH_CHECK(
+      config.flush_interval.count() > 0,
+      "Streaming trace flush interval must be positive");
+  auto now = getTime();
+  {
+    std::lock_guard<std::mutex> guard(session_mutex);
+    active_session = std::make_unique<StreamingTraceSession>(config, now);
+  }
+  using std::chrono::nanoseconds;
+  auto start_ns = now +
+      std::chrono::duration_cast<nanoseconds>(config.capture_delay).count();
+  window_start_ns = start_ns;
+  window_end_ns = config.capture_duration.count() > 0
+      ? start_ns +
+          std::chrono::duration_cast<nanoseconds>(config.capture_duration)
+              .count()
+      : std::numeric_limits<int64_t>::max();
+  current_session++;
+  handle = at::addGlobalCallback(
+      at::RecordFunctionCallback(&onFunctionEnter, &onFunctionExit));
+}
+
+StreamingTraceStats disableStreamingTrace() {
+  TORCH_CHECK(streamingTraceEnabled(), "Streaming trace is not enabled");
+  at::removeCallback(handle);
+  std::unique_ptr<StreamingTraceSession> stopped;
+  {
+    std::lock_guard<std::mutex> guard(session_mutex);
+    stopped = std::move(active_session);
+  }
+  return stopped->stop();
+}
+
+bool streamingTraceEnabled() {
+  std::lock_guard<std::mutex> guard(session_mutex);
+  return active_session != nullptr;
+}
+
+}}} // namespace torch::autograd::profiler
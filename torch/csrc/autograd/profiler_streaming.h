@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+namespace torch { namespace autograd { namespace profiler {
+
+// Streaming trace export, meant for long profiling sessions.
+//
+// Unlike the legacy profiler, which keeps all events in memory until it is
+// disabled, the streaming tracer records the ops of every thread into a fixed
+// size ring buffer owned by that thread. A background thread periodically
+// drains the buffers and appends the events to a Chrome trace JSON file, which
+// can be opened with chrome://tracing or Perfetto. Memory usage is bounded by
+// the size of the buffers: when a buffer is full, new events of that thread
+// are dropped and counted until the flusher catches up.
+
+struct TORCH_API StreamingTraceConfig {
+  // Path of the trace file.
+  std::string path;
+  // Capacity of the ring buffer of every thread, in events. Rounded up to a
+  // power of 2.
+  size_t buffer_events = 16384;
+  // Interval between two flushes of the ring buffers.
+  std::chrono::milliseconds flush_interval{100};
+  // Capture window, relative to enableStreamingTrace(): only ops starting in
+  // [capture_delay, capture_delay + capture_duration) are recorded. A zero
+  // capture_duration records until disableStreamingTrace(). When the window
+  // ends, the trace file is completed without waiting for
+  // disableStreamingTrace().
+  std::chrono::milliseconds capture_delay{0};
+  std::chrono::milliseconds capture_duration{0};
+};
+
+struct TORCH_API StreamingTraceStats {
+  uint64_t events_written = 0;
+  uint64_t events_dropped = 0;
+};
+
+// Starts tracing the ops of all threads. Not thread safe, see
+// at::addGlobalCallback.
+TORCH_API void enableStreamingTrace(const StreamingTraceConfig& config);
+
+// Stops tracing, writes the remaining events and closes the trace file. Not
+// thread safe, see at::removeCallback.
+TORCH_API StreamingTraceStats disableStreamingTrace();
+
+TORCH_API bool streamingTraceEnabled();
+
+}}} // namespace torch::autograd::profiler
@@ -16,6 +16,9 @@ namespace torch { namespace autograd {
 
 SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_inplace_view) {
   if (variable.defined()) {
+    TORCH_CHECK(!variable.is_inference(),
+      "Inference tensors cannot be saved for backward. To work around "
+      "you can make a clone to get a normal tensor and use it in autograd.");
     was_default_constructed_ = false;
     output_nr_ = variable.output_nr();
     requires_grad_ = variable.requires_grad();
@@ -639,9 +639,18 @@ inline Variable make_variable_non_differentiable_view(
     const at::Tensor& data,
     bool allow_tensor_metadata_change = true) {
   if (data.defined()) {
-    // Currently all of non-differentiable view ops(detach/_indices/_values)
-    // share the same TensorImpl as their base Tensor. Thus a new TensorImpl
-    // allocation here is required.
+    // If we already did a TensorImpl allocation for data, just reuse it (e.g.
+    // for the views created in InferenceMode, see Note [Inference tensors]).
+    if (data.getIntrusivePtr().unique()) {
+      at::TensorImpl* data_impl = data.unsafeGetTensorImpl();
+      data_impl->set_version_counter(impl::version_counter(base));
+      data_impl->set_allow_tensor_metadata_change(allow_tensor_metadata_change);
+      data_impl->set_autograd_meta(nullptr);
+      return data;
+    }
+    // Otherwise, non-differentiable view ops like detach/_indices/_values
+    // share the same TensorImpl as their base Tensor or one of its members.
+    // Thus a new TensorImpl allocation here is required.
     auto data_impl_copy = data.getIntrusivePtr()->shallow_copy_and_detach(
       /*version_counter=*/impl::version_counter(base),
       /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
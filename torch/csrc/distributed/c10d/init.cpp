@@ -5,6 +5,7 @@
 #include <c10d/TCPStore.hpp>
 #ifndef _WIN32
 #include <c10d/HashStore.hpp>
+#include <c10d/ProcessGroupHierarchical.hpp>
 #include <c10d/ProcessGroupRoundRobin.hpp>
 #endif
 #include <c10d/ProcessGroup.hpp>
@@ -24,6 +25,7 @@
 #include <c10d/PrefixStore.hpp>
 #include <fmt/format.h>
 #include <pybind11/chrono.h>
+#include <pybind11/functional.h>
 
 #include <c10d/comm.hpp>
 #include <c10d/frontend.hpp>
@@ -146,8 +148,30 @@ void _register_comm_hook(
 // function of the reducer input to set the hook type.
 void _register_builtin_comm_hook(
     ::c10d::Reducer& reducer,
-    ::c10d::BuiltinCommHookType comm_hook_type) {
-  reducer.register_builtin_comm_hook(comm_hook_type);
+    ::c10d::BuiltinCommHookType comm_hook_type,
+    const ::c10d::GradCompressionOptions& compression_options) {
+  reducer.register_builtin_comm_hook(comm_hook_type, compression_options);
+}
+
+// Returns the state of the built-in gradient compression hook registered on
+// the reducer, so that it can be saved along with the model checkpoint.
+std::unordered_map<std::string, at::Tensor> _get_builtin_comm_hook_state_dict(
+    const ::c10d::Reducer& reducer) {
+  auto state = reducer.get_comm_hook_compression_state();
+  TORCH_CHECK(
+      state != nullptr,
+      "No built-in gradient compression communication hook is registered.");
+  return state->stateDict();
+}
+
+void _load_builtin_comm_hook_state_dict(
+    const ::c10d::Reducer& reducer,
+    const std::unordered_map<std::string, at::Tensor>& state_dict) {
+  auto state = reducer.get_comm_hook_compression_state();
+  TORCH_CHECK(
+      state != nullptr,
+      "No built-in gradient compression communication hook is registered.");
+  state->loadStateDict(state_dict);
 }
 
 PyObject* c10d_init(PyObject* _unused, PyObject* noargs) {
@@ -180,7 +204,19 @@ PyObject* c10d_init(PyObject* _unused, PyObject* noargs) {
           "_register_builtin_comm_hook",
           &_register_builtin_comm_hook,
           py::arg("reducer"),
-          py::arg("comm_hook_type"))
+          py::arg("comm_hook_type"),
+          py::arg("compression_options") = ::c10d::GradCompressionOptions())
+      .def(
+          "_get_builtin_comm_hook_state_dict",
+          &_get_builtin_comm_hook_state_dict,
+          py::arg("reducer"),
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "_load_builtin_comm_hook_state_dict",
+          &_load_builtin_comm_hook_state_dict,
+          py::arg("reducer"),
+          py::arg("state_dict"),
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "_set_construction_logging_data",
           [](
@@ -246,9 +282,30 @@ PyObject* c10d_init(PyObject* _unused, PyObject* noargs) {
           py::call_guard<py::gil_scoped_release>());
 
   py::enum_<::c10d::BuiltinCommHookType>(module, "BuiltinCommHookType", R"(
-An enum-like class for built-in communication hooks: ``ALLREDUCE`` and ``FP16_COMPRESS``.)")
+An enum-like class for built-in communication hooks: ``ALLREDUCE``, ``FP16_COMPRESS``,
+and the gradient compression hooks ``POWER_SGD``, ``TOPK_SPARSIFY`` and ``INT8_QUANTIZE``.)")
       .value("ALLREDUCE", ::c10d::BuiltinCommHookType::ALLREDUCE)
-      .value("FP16_COMPRESS", ::c10d::BuiltinCommHookType::FP16_COMPRESS);
+      .value("FP16_COMPRESS", ::c10d::BuiltinCommHookType::FP16_COMPRESS)
+      .value("POWER_SGD", ::c10d::BuiltinCommHookType::POWER_SGD)
+      .value("TOPK_SPARSIFY", ::c10d::BuiltinCommHookType::TOPK_SPARSIFY)
+      .value("INT8_QUANTIZE", ::c10d::BuiltinCommHookType::INT8_QUANTIZE);
+
+  py::class_<::c10d::GradCompressionOptions>(
+      module, "_GradCompressionOptions", R"(
+Hyperparameters of the built-in gradient compression communication hooks.
+Each hook only reads the fields that are relevant to its algorithm.)")
+      .def(py::init<>())
+      .def_readwrite(
+          "matrix_approximation_rank",
+          &::c10d::GradCompressionOptions::matrixApproximationRank)
+      .def_readwrite("topk_ratio", &::c10d::GradCompressionOptions::topkRatio)
+      .def_readwrite("start_iter", &::c10d::GradCompressionOptions::startIter)
+      .def_readwrite(
+          "use_error_feedback",
+          &::c10d::GradCompressionOptions::useErrorFeedback)
+      .def_readwrite("warm_start", &::c10d::GradCompressionOptions::warmStart)
+      .def_readwrite(
+          "random_seed", &::c10d::GradCompressionOptions::randomSeed);
 
   shared_ptr_class_<::c10d::Reducer>(module, "Reducer")
       .def(
@@ -478,6 +535,61 @@ Example::
     >>> store.set("first_key", "first_value")
     >>> # Should return "first_value"
     >>> store.get("first_key")
+)")
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>(),
+              R"(
+Inserts all the key-value pairs into the store. The :class:`~torch.distributed.TCPStore`
+sends all of them in a single request.
+
+Arguments:
+    keys (list[str]): The keys to be added to the store.
+    values (list[str]): The values associated with ``keys``.
+
+Example::
+    >>> import torch.distributed as dist
+    >>> from datetime import timedelta
+    >>> store = dist.TCPStore("127.0.0.1", 0, 1, True, timedelta(seconds=30))
+    >>> store.multi_set(["first_key", "second_key"], ["po", "tato"])
+    >>> # Should return [b"po", b"tato"]
+    >>> store.multi_get(["first_key", "second_key"])
+)")
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                auto values = [&]() {
+                  py::gil_scoped_release guard;
+                  return store.multiGet(keys);
+                }();
+                std::vector<py::bytes> result;
+                result.reserve(values.size());
+                for (auto& value : values) {
+                  result.emplace_back(
+                      reinterpret_cast<char*>(value.data()), value.size());
+                }
+                return result;
+              },
+              R"(
+Retrieves the values associated with all the given ``keys``, waiting for
+``timeout`` for any key that is not present yet. The :class:`~torch.distributed.TCPStore`
+fetches all of them in a single request.
+
+Arguments:
+    keys (list[str]): The keys to be retrieved from the store.
+
+Returns:
+    A list with the value associated with every key in ``keys``.
 )")
           .def(
               "add",
@@ -1003,6 +1115,45 @@ Arguments:
       },
       py::arg("process_groups"),
       py::call_guard<py::gil_scoped_release>());
+
+  auto processGroupHierarchical =
+      intrusive_ptr_class_<::c10d::ProcessGroupHierarchical>(
+          module, "ProcessGroupHierarchical", processGroup);
+
+  shared_ptr_class_<::c10d::ProcessGroupHierarchical::Options>(
+      processGroupHierarchical, "Options")
+      .def(py::init<>())
+      .def_readwrite(
+          "leader_process_group_factory",
+          &::c10d::ProcessGroupHierarchical::Options::leaderProcessGroupFactory)
+      .def_readwrite(
+          "buffer_bytes",
+          &::c10d::ProcessGroupHierarchical::Options::bufferBytes)
+      .def_readwrite(
+          "timeout", &::c10d::ProcessGroupHierarchical::Options::timeout)
+      .def_readwrite(
+          "node_name", &::c10d::ProcessGroupHierarchical::Options::nodeName);
+
+  processGroupHierarchical
+      .def(
+          py::init<
+              const c10::intrusive_ptr<::c10d::Store>&,
+              int,
+              int,
+              ::c10d::ProcessGroupHierarchical::Options>(),
+          py::arg("store"),
+          py::arg("rank"),
+          py::arg("size"),
+          py::arg("options"),
+          py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly(
+          "num_nodes", &::c10d::ProcessGroupHierarchical::getNumNodes)
+      .def_property_readonly(
+          "node_index", &::c10d::ProcessGroupHierarchical::getNodeIndex)
+      .def_property_readonly(
+          "local_rank", &::c10d::ProcessGroupHierarchical::getLocalRank)
+      .def_property_readonly(
+          "local_size", &::c10d::ProcessGroupHierarchical::getLocalSize);
 #endif
 
 #ifdef USE_C10D_GLOO
@@ -1016,7 +1167,35 @@ Arguments:
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "allreduce_chunk_bytes",
+          &::c10d::ProcessGroupGloo::Options::allreduceChunkBytes);
+
+  py::class_<::c10d::ProcessGroupGloo::AllreduceTimeline>(
+      processGroupGloo, "AllreduceTimeline")
+      .def_readonly("tag", &::c10d::ProcessGroupGloo::AllreduceTimeline::tag)
+      .def_readonly(
+          "num_bytes", &::c10d::ProcessGroupGloo::AllreduceTimeline::numBytes)
+      .def_readonly(
+          "enqueue_time",
+          &::c10d::ProcessGroupGloo::AllreduceTimeline::enqueueTime)
+      .def_readonly(
+          "chunk_start_times",
+          &::c10d::ProcessGroupGloo::AllreduceTimeline::chunkStartTimes)
+      .def_readonly(
+          "chunk_end_times",
+          &::c10d::ProcessGroupGloo::AllreduceTimeline::chunkEndTimes);
+
+  processGroupGloo.def(
+      "_get_allreduce_timelines",
+      &::c10d::ProcessGroupGloo::getAllreduceTimelines,
+      py::call_guard<py::gil_scoped_release>(),
+      R"(
+        Returns and clears the communication timelines of the most recent
+        chunked allreduce calls (see ``Options.allreduce_chunk_bytes``).
+        Times are in nanoseconds on a monotonic clock.
+      )");
 
   processGroupGloo.def_static(
       "create_device",
@@ -1066,6 +1245,13 @@ Arguments:
 
             options.timeout = timeout;
             options.threads = options.devices.size() * 2;
+
+            // Split large allreduce calls into chunks, if "GLOO_ALLREDUCE_CHUNK_BYTES"
+            // is set.
+            char* chunkBytesEnv = getenv(::c10d::GLOO_ALLREDUCE_CHUNK_BYTES_ENV);
+            if (chunkBytesEnv) {
+              options.allreduceChunkBytes = std::stoull(chunkBytesEnv);
+            }
             return c10::make_intrusive<::c10d::ProcessGroupGloo>(
                 store, rank, size, options);
           }),
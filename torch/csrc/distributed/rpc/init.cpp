@@ -522,34 +522,58 @@ PyObject* rpc_init(PyObject* _unused, PyObject* noargs) {
                   :meth:`~torch.distributed.rpc.rpc_async` if necessary.
               init_method (str, optional): The URL to initialize
                   ``ProcessGroupGloo`` (default: ``env://``).
+              shm_threshold_bytes (int, optional): CPU tensors of at least
+                  this many bytes sent to a worker on the same host are
+                  passed through shared memory segments, and only their
+                  descriptors are sent through ``ProcessGroupGloo``. Tensors
+                  that share a storage are received as independent copies.
+                  It must be the same on every worker. A negative value
+                  disables it (default: -1).
       )")
       .def(
-          py::init<int, float, std::string>(),
+          py::init<int, float, std::string, int64_t>(),
           py::arg("num_send_recv_threads") = kDefaultNumSendRecvThreads,
           py::arg("rpc_timeout") = kDefaultRpcTimeoutSeconds,
-          py::arg("init_method") = kDefaultInitMethod)
+          py::arg("init_method") = kDefaultInitMethod,
+          py::arg("shm_threshold_bytes") = kShmDisabled)
       .def_readwrite(
           "num_send_recv_threads",
           &ProcessGroupRpcBackendOptions::numSendRecvThreads,
           R"(
               The number of threads in the thread-pool used by ProcessGroupAgent.
+          )")
+      .def_readwrite(
+          "shm_threshold_bytes",
+          &ProcessGroupRpcBackendOptions::shmThresholdBytes,
+          R"(
+              The minimum size of the tensors sent through shared memory to
+              workers on the same host, or a negative value if disabled.
           )");
 
   module.attr("_DEFAULT_NUM_SEND_RECV_THREADS") =
       py::cast(kDefaultNumSendRecvThreads);
+  module.attr("_DEFAULT_SHM_THRESHOLD_BYTES") = py::cast(kShmDisabled);
 
   shared_ptr_class_<ProcessGroupAgent>(module, "ProcessGroupAgent", rpcAgent)
-      .def(py::init([](std::string workerName,
-                       const c10::intrusive_ptr<::c10d::ProcessGroup>& pg,
-                       int numSendRecvThreads,
-                       std::chrono::milliseconds rpcTimeout) {
-        return std::make_unique<ProcessGroupAgent>(
-            std::move(workerName),
-            pg,
-            numSendRecvThreads,
-            rpcTimeout,
-            std::make_unique<RequestCallbackImpl>());
-      }))
+      .def(
+          py::init([](std::string workerName,
+                      const c10::intrusive_ptr<::c10d::ProcessGroup>& pg,
+                      int numSendRecvThreads,
+                      std::chrono::milliseconds rpcTimeout,
+                      int64_t shmThresholdBytes) {
+            return std::make_unique<ProcessGroupAgent>(
+                std::move(workerName),
+                pg,
+                numSendRecvThreads,
+                rpcTimeout,
+                std::make_unique<RequestCallbackImpl>(),
+                shmThresholdBytes);
+          }),
+          py::arg("worker_name"),
+          py::arg("pg"),
+          py::arg("numSendRecvThreads"),
+          py::arg("rpcTimeout"),
+          py::arg("shmThresholdBytes") = kShmDisabled)
       .def(
           "get_worker_info",
           (const WorkerInfo& (ProcessGroupAgent::*)(void) const) &
@@ -1,14 +1,136 @@
 #include <torch/csrc/distributed/rpc/process_group_agent.h>
 
+#include <TH/THAllocator.h>
 #include <c10/util/C++17.h>
 #include <c10d/ProcessGroup.hpp>
 #include <fmt/format.h>
 #include <torch/csrc/distributed/rpc/utils.h>
 
+#include <unistd.h>
+
+#include <climits>
+#include <random>
+
 namespace torch {
 namespace distributed {
 namespace rpc {
 
+namespace {
+
+// Preamble of every message: rank, payload size, message type, message id and
+// size of the shared memory tensor descriptors at the end of the payload.
+constexpr int64_t kPreambleSize = 5;
+
+constexpr int kShmCreateFlags =
+    TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE;
+constexpr int kShmOpenFlags =
+    TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
+
+std::string newShmName() {
+  static const auto prefix = fmt::format(
+      "/torch_rpc_{}_{:x}_", getpid(), std::random_device()());
+  static std::atomic<uint64_t> counter{0};
+  return prefix + std::to_string(counter++);
+}
+
+// Every shared memory segment starts with a header, followed by the tensor
+// data. The receiver sets `claimed` once it has mapped the segment, which
+// tells the sender that it can drop its own reference.
+struct ShmHeader {
+  std::atomic<int32_t> claimed;
+};
+// Keeps the tensor data aligned.
+constexpr int64_t kShmHeaderSize = 64;
+static_assert(sizeof(ShmHeader) <= kShmHeaderSize, "ShmHeader is too large");
+
+ShmHeader* shmHeader(const at::DataPtr& segment) {
+  return static_cast<ShmHeader*>(segment.get());
+}
+
+char* shmData(const at::DataPtr& segment) {
+  return static_cast<char*>(segment.get()) + kShmHeaderSize;
+}
+
+// Moves the data of every large dense CPU tensor into a new shared memory
+// segment, replaces the tensor by an empty placeholder, and returns the
+// pickled descriptors of the segments.
+//
+// The segments are reference counted and unlinked when the last reference is
+// dropped. The references of the sender are appended to `segments`, and must
+// be kept until the receiver claims the segments, or until the message is
+// known to be lost.
+//
+// Every tensor gets its own segment, so tensors that share a storage are
+// received as independent copies, unlike with the wire format.
+std::vector<char> exportTensorsToShm(
+    std::vector<torch::Tensor>& tensors,
+    int64_t thresholdBytes,
+    std::vector<at::DataPtr>& segments) {
+  std::vector<IValue> descriptors;
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    auto& tensor = tensors[i];
+    const int64_t nbytes = tensor.numel() * tensor.element_size();
+    if (!tensor.device().is_cpu() || tensor.layout() != c10::kStrided ||
+        nbytes == 0 || nbytes < thresholdBytes) {
+      continue;
+    }
+    const auto name = newShmName();
+    auto segment = THRefcountedMapAllocator::makeDataPtr(
+        name.c_str(), kShmCreateFlags, kShmHeaderSize + nbytes, nullptr);
+    new (segment.get()) ShmHeader{{0}};
+    torch::from_blob(shmData(segment), tensor.sizes(), tensor.options())
+        .copy_(tensor.detach());
+    segments.emplace_back(std::move(segment));
+    descriptors.emplace_back(c10::ivalue::Tuple::create(
+        {IValue(static_cast<int64_t>(i)),
+         IValue(name),
+         IValue(static_cast<int64_t>(tensor.scalar_type())),
+         IValue(tensor.sizes().vec())}));
+    tensor = torch::empty({0}, tensor.options());
+  }
+  if (descriptors.empty()) {
+    return {};
+  }
+  return jit::pickle(c10::ivalue::Tuple::create(std::move(descriptors)));
+}
+
+// Maps the shared memory segments described by exportTensorsToShm, claims
+// them, and puts them back in place of their placeholders, without copying
+// them.
+void importTensorsFromShm(
+    const char* data,
+    size_t size,
+    std::vector<torch::Tensor>& tensors) {
+  auto descriptors = jit::unpickle(data, size).toTuple()->elements();
+  for (const auto& descriptor : descriptors) {
+    const auto& fields = descriptor.toTuple()->elements();
+    const auto index = fields[0].toInt();
+    const auto& name = fields[1].toStringRef();
+    const auto scalarType = static_cast<at::ScalarType>(fields[2].toInt());
+    const auto sizes = fields[3].toIntVector();
+    TORCH_CHECK(
+        index >= 0 && static_cast<size_t>(index) < tensors.size(),
+        "Invalid index of shared memory tensor: ",
+        index);
+
+    int64_t nbytes = c10::elementSize(scalarType);
+    for (auto dim : sizes) {
+      nbytes *= dim;
+    }
+    auto segment = std::make_shared<at::DataPtr>(
+        THRefcountedMapAllocator::makeDataPtr(
+            name.c_str(), kShmOpenFlags, kShmHeaderSize + nbytes, nullptr));
+    shmHeader(*segment)->claimed.store(1, std::memory_order_release);
+    tensors[index] = torch::from_blob(
+        shmData(*segment),
+        sizes,
+        [segment](void*) {},
+        torch::TensorOptions().dtype(scalarType));
+  }
+}
+
+} // namespace
+
 //////////////////////////  MessageCounter  /////////////////////////////////
 
 ProcessGroupAgent::MessageCounter::MessageCounter(int worldSize)
@@ -93,12 +215,14 @@ ProcessGroupAgent::ProcessGroupAgent(
     c10::intrusive_ptr<::c10d::ProcessGroup> pg,
     int numSendRecvThreads,
     std::chrono::milliseconds rpcTimeout,
-    std::unique_ptr<RequestCallback> cb)
+    std::unique_ptr<RequestCallback> cb,
+    int64_t shmThresholdBytes)
     : RpcAgent(
           WorkerInfo(std::move(workerName), (int64_t)pg->getRank()),
           std::move(cb),
           rpcTimeout),
       pg_(std::move(pg)),
+      shmThresholdBytes_(shmThresholdBytes),
       sendCounts_(pg_->getSize()),
       recvCounts_(pg_->getSize()),
       nextId_(0),
@@ -135,6 +259,38 @@ ProcessGroupAgent::ProcessGroupAgent(
   for (worker_id_t rank = 0; rank < worldSize; ++rank) {
     allWorkerInfo_.emplace_back(std::move(tmpWorkerIds[rank]), rank);
   }
+
+  // The host names are only needed by the shared memory transport, which is
+  // configured identically on every worker.
+  if (shmThresholdBytes_ != kShmDisabled) {
+    collectHostNames();
+  }
+}
+
+void ProcessGroupAgent::collectHostNames() {
+  const auto worldSize = pg_->getSize();
+  constexpr int64_t kMaxHostNameLen = HOST_NAME_MAX + 1;
+
+  torch::Tensor hostNameTensor = torch::zeros({kMaxHostNameLen}, torch::kChar);
+  auto hostName = static_cast<char*>(hostNameTensor.storage().data());
+  if (gethostname(hostName, kMaxHostNameLen - 1) != 0) {
+    // Without a host name, do not assume that any peer is co-located.
+    hostName[0] = '\0';
+  }
+  std::vector<torch::Tensor> inputHostName = {hostNameTensor};
+  std::vector<std::vector<torch::Tensor>> outputHostNames(1);
+  for (int i = 0; i < worldSize; ++i) {
+    outputHostNames[0].emplace_back(
+        torch::empty({kMaxHostNameLen}, {torch::kChar}));
+  }
+  pg_->allgather(outputHostNames, inputHostName)->wait();
+
+  sameHost_.resize(worldSize);
+  for (worker_id_t i = 0; i < worldSize; ++i) {
+    std::string peerHostName(
+        (const char*)outputHostNames[0][i].storage().data<signed char>());
+    sameHost_[i] = !peerHostName.empty() && peerHostName == hostName;
+  }
 }
 
 ProcessGroupAgent::~ProcessGroupAgent() {
@@ -285,6 +441,32 @@ void ProcessGroupAgent::shutdownImpl() {
   // that we can finish any possible work enqueued into the thread pool, before
   // python RPC handler is shutdown (see shutdown in rpc/api.py).
   threadPool_.waitWorkComplete();
+  // Unlink the segments of the messages that were never received.
+  releaseShmExports([](const ShmExport&) { return true; });
+}
+
+void ProcessGroupAgent::releaseShmExports(
+    const std::function<bool(const ShmExport&)>& withdraw) {
+  std::lock_guard<std::mutex> guard(shmExportsMutex_);
+  for (auto it = shmExports_.begin(); it != shmExports_.end();) {
+    const bool claimed =
+        shmHeader(it->segment)->claimed.load(std::memory_order_acquire) != 0;
+    if (claimed || (withdraw && withdraw(*it))) {
+      it = shmExports_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ProcessGroupAgent::withdrawShmExports(
+    worker_id_t dst,
+    int64_t messageId,
+    bool isRequest) {
+  releaseShmExports([&](const ShmExport& shmExport) {
+    return shmExport.dst == dst && shmExport.messageId == messageId &&
+        shmExport.isRequest == isRequest;
+  });
 }
 
 std::shared_ptr<JitFuture> ProcessGroupAgent::send(
@@ -388,20 +570,42 @@ std::shared_ptr<JitFuture> ProcessGroupAgent::send(
 }
 
 void ProcessGroupAgent::handleSend(const SendWork& work) {
-  auto serializedPayload = std::make_unique<std::string>(std::move(
-      wireSerialize(work.message_.payload(), work.message_.tensors())));
+  const auto dst = work.to_.id_;
+  std::unique_ptr<std::string> serializedPayload;
+  std::vector<char> shmDescriptors;
+  if (shmThresholdBytes_ != kShmDisabled && sameHost_[dst]) {
+    releaseShmExports(nullptr);
+    auto tensors = work.message_.tensors();
+    std::vector<at::DataPtr> segments;
+    shmDescriptors = exportTensorsToShm(tensors, shmThresholdBytes_, segments);
+    if (!segments.empty()) {
+      std::lock_guard<std::mutex> guard(shmExportsMutex_);
+      for (auto& segment : segments) {
+        shmExports_.push_back(ShmExport{dst,
+                                        work.message_.id(),
+                                        work.message_.isRequest(),
+                                        std::move(segment)});
+      }
+    }
+    serializedPayload = std::make_unique<std::string>(
+        wireSerialize(work.message_.payload(), tensors));
+    serializedPayload->append(shmDescriptors.begin(), shmDescriptors.end());
+  } else {
+    serializedPayload = std::make_unique<std::string>(
+        wireSerialize(work.message_.payload(), work.message_.tensors()));
+  }
 
   std::vector<torch::Tensor> preamble = {torch::tensor(
       {(int64_t)pg_->getRank(),
        (int64_t)serializedPayload->length(),
        (int64_t)work.message_.type(),
-       (int64_t)work.message_.id()},
+       (int64_t)work.message_.id(),
+       (int64_t)shmDescriptors.size()},
       {torch::kInt64})};
 
   // ProcessGroup is not thread-safe when sending with the same tag,
   // hence the lock
   std::vector<c10::intrusive_ptr<c10d::ProcessGroup::Work>> pendingSends;
-  const auto dst = work.to_.id_;
 
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   auto serializedPayloadData = const_cast<char*>(serializedPayload->data());
@@ -433,6 +637,9 @@ void ProcessGroupAgent::handleSend(const SendWork& work) {
   for (auto& pendingSend : pendingSends) {
     if (!rpcAgentRunning_.load() || !pendingSend->wait()) {
       // Send was interrupted or RPC is not running.
+      if (!shmDescriptors.empty()) {
+        withdrawShmExports(dst, work.message_.id(), work.message_.isRequest());
+      }
       return;
     }
   }
@@ -494,6 +701,9 @@ void ProcessGroupAgent::enqueueSend(SendWork work) {
               e.what(),
               " on node: ",
               RpcAgent::getWorkerInfo().id_);
+          // The message was not sent, so nobody will claim its segments.
+          withdrawShmExports(
+              work.to_.id_, work.message_.id(), work.message_.isRequest());
           auto exceptionMsg =
               rpc::createExceptionResponse(errorStr, work.message_.id());
           if (work.message_.isRequest()) {
@@ -510,7 +720,18 @@ void ProcessGroupAgent::enqueueSend(SendWork work) {
 
 bool ProcessGroupAgent::handleRecv(RecvWork& work) {
   torch::Tensor& payload = work.payload_;
-  auto data = wireDeserialize(payload.storage().data(), payload.numel());
+  const auto wireSize = payload.numel() - work.shmDescriptorsSize_;
+  auto data = wireDeserialize(payload.storage().data(), wireSize);
+  if (shmThresholdBytes_ != kShmDisabled) {
+    // Among others, a response claims the segments of its request.
+    releaseShmExports(nullptr);
+  }
+  if (work.shmDescriptorsSize_ > 0) {
+    importTensorsFromShm(
+        static_cast<const char*>(payload.storage().data()) + wireSize,
+        work.shmDescriptorsSize_,
+        data.second);
+  }
   Message message(
       std::move(data.first), std::move(data.second), work.type_, work.id_);
   if (message.isRequest()) {
@@ -718,8 +939,9 @@ void ProcessGroupAgent::listenLoop() {
 
 void ProcessGroupAgent::listenLoopInternal() {
   while (rpcAgentRunning_.load()) {
-    // rank, tensor size, message type
-    std::vector<torch::Tensor> preamble = {torch::empty({4}, {torch::kInt64})};
+    // rank, tensor size, message type, message id, shm descriptors size
+    std::vector<torch::Tensor> preamble = {
+        torch::empty({kPreambleSize}, {torch::kInt64})};
     auto work = pg_->recvAnysource(preamble, pg_->getRank());
     {
       // Write class variable so it can be aborted by shutdown()
@@ -737,6 +959,7 @@ void ProcessGroupAgent::listenLoopInternal() {
     auto size = preamble_items[1];
     MessageType type = MessageType(preamble_items[2]);
     int64_t id = preamble_items[3];
+    int64_t shmDescriptorsSize = preamble_items[4];
 
     std::vector<torch::Tensor> tensors = {torch::empty({size}, {torch::kChar})};
     work = pg_->recv(tensors, srcRank, pg_->getRank());
@@ -750,8 +973,12 @@ void ProcessGroupAgent::listenLoopInternal() {
       return;
     }
 
-    enqueueRecv(
-        RecvWork(allWorkerInfo_[srcRank], type, id, std::move(tensors[0])));
+    enqueueRecv(RecvWork(
+        allWorkerInfo_[srcRank],
+        type,
+        id,
+        std::move(tensors[0]),
+        shmDescriptorsSize));
   }
 }
 
@@ -842,6 +1069,9 @@ const std::vector<ProcessGroupAgent::FutureInfo> ProcessGroupAgent::
         const auto futInfo = futureIt->second;
         timedOutFutures.push_back(futInfo);
         futures_.erase(futureID);
+        // The request is abandoned, so it is fine if a late receiver fails to
+        // map its segments; the error is only logged there.
+        withdrawShmExports(futInfo.dstRank_, futureID, /* isRequest */ true);
       }
       it = futureTimeouts_.erase(it);
     }
@@ -6,6 +6,8 @@
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 
 #include <atomic>
+#include <functional>
+#include <list>
 #include <thread>
 
 namespace torch {
@@ -13,14 +15,18 @@ namespace distributed {
 namespace rpc {
 
 constexpr auto kDefaultNumSendRecvThreads = 4;
+// Disables the shared memory transport of tensors.
+constexpr int64_t kShmDisabled = -1;
 
 struct ProcessGroupRpcBackendOptions : public RpcBackendOptions {
   ProcessGroupRpcBackendOptions(
       int num_send_recv_threads,
       float rpc_timeout,
-      std::string init_method)
+      std::string init_method,
+      int64_t shm_threshold_bytes = kShmDisabled)
       : RpcBackendOptions(rpc_timeout, init_method),
-        numSendRecvThreads(num_send_recv_threads) {
+        numSendRecvThreads(num_send_recv_threads),
+        shmThresholdBytes(shm_threshold_bytes) {
     TORCH_CHECK(
         num_send_recv_threads > 0,
         "Cannot create ProcessGroup RPC backend with ",
@@ -29,6 +35,9 @@ struct ProcessGroupRpcBackendOptions : public RpcBackendOptions {
   }
 
   int numSendRecvThreads;
+  // Tensors of at least this many bytes sent to a worker on the same host
+  // are passed through shared memory instead of the ProcessGroup.
+  int64_t shmThresholdBytes;
 };
 
 // SendWork and RecvWork will be put into a task queue, and later picked up by
@@ -48,13 +57,20 @@ struct RecvWork {
       const WorkerInfo& from,
       MessageType type,
       int64_t id,
-      torch::Tensor&& payload)
-      : from_(from), type_(type), id_(id), payload_(payload) {}
+      torch::Tensor&& payload,
+      int64_t shmDescriptorsSize = 0)
+      : from_(from),
+        type_(type),
+        id_(id),
+        payload_(payload),
+        shmDescriptorsSize_(shmDescriptorsSize) {}
 
   const WorkerInfo& from_;
   const MessageType type_;
   const int64_t id_;
   torch::Tensor payload_;
+  // Size of the descriptors of shared memory tensors at the end of payload_.
+  const int64_t shmDescriptorsSize_;
 };
 
 class TORCH_API ProcessGroupAgent : public RpcAgent {
@@ -64,7 +80,8 @@ class TORCH_API ProcessGroupAgent : public RpcAgent {
       c10::intrusive_ptr<::c10d::ProcessGroup> pg,
       int numSendRecvThreads,
       std::chrono::milliseconds rpcTimeout,
-      std::unique_ptr<RequestCallback> cb);
+      std::unique_ptr<RequestCallback> cb,
+      int64_t shmThresholdBytes = kShmDisabled);
 
   const WorkerInfo& getWorkerInfo(const std::string& workerName) const override;
 
@@ -148,7 +165,25 @@ class TORCH_API ProcessGroupAgent : public RpcAgent {
     FutureInfo() = delete;
   };
 
+  // A shared memory segment sent to another worker on the same host, which
+  // this agent keeps a reference to until the receiver claims it.
+  struct ShmExport {
+    worker_id_t dst;
+    int64_t messageId;
+    bool isRequest;
+    at::DataPtr segment;
+  };
+
   void collectNames();
+  // Finds the workers that run on the same host as this one, which can
+  // receive tensors through shared memory.
+  void collectHostNames();
+  // Drops the references to the segments that have been claimed by their
+  // receiver, and to the ones for which `withdraw` returns true. A segment is
+  // unlinked once nobody references it anymore.
+  void releaseShmExports(const std::function<bool(const ShmExport&)>& withdraw);
+  // Withdraws the segments of a message that will never be received.
+  void withdrawShmExports(worker_id_t dst, int64_t messageId, bool isRequest);
   // handle a SendWork request. This serializes the payload inside the work
   // object, and sends the message to the receiver using the underlying
   // ProcessGroup.
@@ -212,6 +247,17 @@ class TORCH_API ProcessGroupAgent : public RpcAgent {
   }
 
   c10::intrusive_ptr<::c10d::ProcessGroup> pg_;
+  // Tensors of at least this many bytes are sent to workers on the same host
+  // through shared memory segments, and only their descriptors go through
+  // pg_. This saves the copies into and out of the serialized payload and
+  // the transport. kShmDisabled disables it.
+  const int64_t shmThresholdBytes_;
+  // Whether each rank runs on the same host as this one. Only collected if
+  // the shared memory transport is enabled.
+  std::vector<bool> sameHost_;
+  // Segments sent through shared memory that have not been claimed yet.
+  std::list<ShmExport> shmExports_;
+  std::mutex shmExportsMutex_;
   // worker name -> rank
   std::unordered_map<std::string, worker_id_t> nameMap_;
   std::vector<WorkerInfo> allWorkerInfo_;
@@ -3,6 +3,7 @@
 #include <torch/csrc/distributed/rpc/utils.h>
 
 #include <sstream>
+#include <thread>
 
 namespace torch {
 namespace distributed {
@@ -80,7 +81,8 @@ const std::string kNumForks = "num_forks";
 
 RRefContext& RRefContext::getInstance() {
   // Leaky singleton to avoid module destructor races.
-  static RRefContext* context = new RRefContext(RpcAgent::getCurrentRpcAgent());
+  static RRefContext* context =
+      new RRefContext(RpcAgent::getCurrentRpcAgent(), computeNumShards());
   return *context;
 }
 
@@ -93,14 +95,17 @@ std::vector<c10::intrusive_ptr<RRef>> RRefContext::destroyInstance(
   }
   ctx.checkRRefLeaks(ignoreRRefLeak);
   std::vector<c10::intrusive_ptr<RRef>> deletedRRefs;
-  for (auto& entry : ctx.owners_) {
-    auto rref = entry.second;
-    if (rref->isPyObj()) {
-      deletedRRefs.emplace_back(std::move(rref));
+  for (auto& shard : ctx.ownerShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (auto& entry : shard.owners) {
+      auto rref = entry.second;
+      if (rref->isPyObj()) {
+        deletedRRefs.emplace_back(std::move(rref));
+      }
     }
+    shard.owners.clear();
+    shard.pendingOwners.clear();
   }
-  ctx.owners_.clear();
-  ctx.pendingOwners_.clear();
   return deletedRRefs;
 }
 
@@ -112,27 +117,92 @@ void RRefContext::handleException(const JitFuture& jitFuture) {
   }
 }
 
-RRefContext::RRefContext(std::shared_ptr<RpcAgent> agent)
-    : agent_(std::move(agent)), destroyed_(false) {}
+RRefContext::RRefContext(std::shared_ptr<RpcAgent> agent, uint32_t numShards)
+    : agent_(std::move(agent)),
+      numShards_(numShards),
+      ownerShards_(numShards),
+      userShards_(numShards),
+      destroyed_(false) {
+  // numShards has to be a power of 2 for the modulo trick in the shard getters
+  // to work.
+  TORCH_INTERNAL_ASSERT((numShards & (numShards - 1)) == 0);
+}
 
 RRefContext::~RRefContext() {
-  if (!owners_.empty()) {
+  if (numOwners() != 0) {
     VLOG(1) << "Destructing RRefContext with non-empty OwnerRRef set. "
             << "This would likely cause Python deref error. "
             << "Make sure destroyInstance() is invoked before destruction.";
   }
 }
 
+uint32_t RRefContext::computeNumShards() {
+  uint32_t numShards = 1;
+  auto numHwThreads = std::thread::hardware_concurrency();
+  if (numHwThreads == 0) {
+    numShards = kNumDefaultShards;
+  } else {
+    // Compute the next power of 2 which is higher than twice the hardware
+    // concurrency.
+    while (numShards < numHwThreads * 2) {
+      numShards <<= 1;
+    }
+  }
+  VLOG(1) << "Number of shards for RRefContext: " << numShards;
+  return numShards;
+}
+
+inline RRefContext::OwnerShard& RRefContext::getOwnerShard(
+    const RRefId& rrefId) {
+  return ownerShards_[RRefId::Hash()(rrefId) & (numShards_ - 1)];
+}
+
+inline RRefContext::UserShard& RRefContext::getUserShard(
+    const ForkId& forkId) {
+  return userShards_[ForkId::Hash()(forkId) & (numShards_ - 1)];
+}
+
+size_t RRefContext::numOwners() const {
+  size_t numOwners = 0;
+  for (const auto& shard : ownerShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    numOwners += shard.owners.size();
+  }
+  return numOwners;
+}
+
+size_t RRefContext::numPendingUsersAndChildren() const {
+  size_t numPending = 0;
+  for (const auto& shard : userShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    numPending += shard.pendingUsers.size() + shard.pendingChildren.size();
+  }
+  return numPending;
+}
+
+void RRefContext::notifyDeleteAllUsers() {
+  // Acquire and release the lock of the waiter, so that the notification cannot
+  // be lost between its predicate check and its wait.
+  { std::lock_guard<std::mutex> lock(deleteAllUsersMutex_); }
+  deleteAllUsersCV_.notify_all();
+}
+
 std::unordered_map<std::string, std::string> RRefContext::getDebugInfo() {
   std::unordered_map<std::string, std::string> info;
-  std::unique_lock<std::mutex> lock(mutex_);
-  auto ownerSize = owners_.size();
-  auto numPendingUsers = pendingUsers_.size();
+  size_t ownerSize = 0;
+  size_t numPendingUsers = 0;
   int numForks = 0;
-  for (const auto& owner : forks_) {
-    numForks += owner.second.size();
+  for (const auto& shard : ownerShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    ownerSize += shard.owners.size();
+    for (const auto& owner : shard.forks) {
+      numForks += owner.second.size();
+    }
+  }
+  for (const auto& shard : userShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    numPendingUsers += shard.pendingUsers.size();
   }
-  lock.unlock();
   info[kNumOwnerRRefs] = c10::to_string(ownerSize);
   info[kNumPendingFutures] = c10::to_string(numPendingFutures_.load());
   info[kNumPendingUsers] = c10::to_string(numPendingUsers);
@@ -141,15 +211,20 @@ std::unordered_map<std::string, std::string> RRefContext::getDebugInfo() {
 }
 
 void RRefContext::checkRRefLeaks(bool ignoreRRefLeak) {
-  if (!forks_.empty()) {
-    std::stringstream ss;
-    for (auto& entry : forks_) {
+  bool hasLeaks = false;
+  std::stringstream ss;
+  for (const auto& shard : ownerShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (auto& entry : shard.forks) {
+      hasLeaks = true;
       const RRefId& rrefId = entry.first;
       for (const auto& forkId : entry.second) {
         ss << "Leaking RRef " << rrefId << " with fork Id " << forkId
            << std::endl;
       }
     }
+  }
+  if (hasLeaks) {
 
     LOG(WARNING)
         << "Detected RRef Leaks during shutdown. This usually "
@@ -224,27 +299,33 @@ void RRefContext::delUser(
     }
   }
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  confirmedUsers_.erase(forkId);
+  auto& shard = getUserShard(forkId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.confirmedUsers.erase(forkId);
 }
 
 void RRefContext::delAllUsersAndUnforkedOwners(
     std::chrono::milliseconds timeoutMillis) {
   // First, wait for all pending UserRRefs to be confirmed,
-  // one kind is pendingUsers_, which are shared from Owner,
-  // the other kind pendingChildren_, which are shared from another User.
+  // one kind is pendingUsers, which are shared from Owner,
+  // the other kind pendingChildren, which are shared from another User.
   std::unordered_map<ForkId, c10::weak_intrusive_ptr<RRef>, ForkId::Hash>
       tempConfirmedUsers;
   {
-    std::unique_lock<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(deleteAllUsersMutex_);
     bool noPending = deleteAllUsersCV_.wait_for(lock, timeoutMillis, [this]() {
-      return pendingUsers_.size() == 0 && pendingChildren_.size() == 0;
+      return numPendingUsersAndChildren() == 0;
     });
     if (!noPending) {
       LOG(ERROR)
           << "Timed out waiting for pending UserRRefs to be confirmed by owner and parent.";
     }
-    tempConfirmedUsers.swap(confirmedUsers_);
+  }
+  for (auto& shard : userShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    tempConfirmedUsers.insert(
+        shard.confirmedUsers.begin(), shard.confirmedUsers.end());
+    shard.confirmedUsers.clear();
   }
 
   // Start sending UserRRef delete messages, after all pendings are confirmed.
@@ -260,35 +341,35 @@ void RRefContext::delAllUsersAndUnforkedOwners(
     rref_ptr->tryDel();
   }
 
-  // If an rref in the owners_ map has never been forked, we will never get a
+  // If an rref in the owners map has never been forked, we will never get a
   // corresponding message from the forking node(s) telling us to delete the
   // RRef. Hence we delete the RRef here. This can occur when a remote call is
   // sent to self and times out.
-  {
-    std::unique_lock<std::mutex> lock(mutex_);
+  for (auto& shard : ownerShards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
     std::vector<RRefId> unforkedOwners;
-    for (const auto& it : owners_) {
+    for (const auto& it : shard.owners) {
       auto rrefId = it.first;
-      if (forks_.find(rrefId) == forks_.end()) {
+      if (shard.forks.find(rrefId) == shard.forks.end()) {
         // Successful fork of owner was never processed.
         unforkedOwners.push_back(rrefId);
       }
     }
     for (auto& rrefId : unforkedOwners) {
       LOG(INFO) << "Removing unforked OwnerRRef with RRefId: " << rrefId;
-      auto iter = owners_.find(rrefId);
+      auto iter = shard.owners.find(rrefId);
       TORCH_CHECK(
-          iter != owners_.end(),
+          iter != shard.owners.end(),
           c10::str("Did not find OwnerRRef with RRefId: ", rrefId));
-      owners_.erase(iter);
+      shard.owners.erase(iter);
     }
   }
   // Wait for this node to process all delete UserRRef messages it may get for
   // the OwnerRRefs that exist on this node.
   {
-    std::unique_lock<std::mutex> lock(mutex_);
+    std::unique_lock<std::mutex> lock(deleteAllUsersMutex_);
     bool noOwner = deleteAllUsersCV_.wait_for(
-        lock, timeoutMillis, [this]() { return owners_.size() == 0; });
+        lock, timeoutMillis, [this]() { return numOwners() == 0; });
     if (!noOwner) {
       LOG(ERROR) << "Timed out waiting for pending OwnerRRefs to be deleted.";
     }
@@ -311,19 +392,20 @@ c10::intrusive_ptr<RRef> RRefContext::getOrCreateRRef(
 c10::intrusive_ptr<OwnerRRef> RRefContext::getOrCreateOwnerRRef(
     const RRefId& rrefId,
     const TypePtr& type) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  const auto iter = owners_.find(rrefId);
-  if (iter == owners_.end()) {
+  auto& shard = getOwnerShard(rrefId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  const auto iter = shard.owners.find(rrefId);
+  if (iter == shard.owners.end()) {
     // Scenario (1) the first time this owner knows about this RRef
     //
     // NB: cannot use make_shared here as the constructor of OwnerRRef is
     // private.
     auto rref = c10::make_intrusive<OwnerRRef>(getWorkerId(), rrefId, type);
-    owners_[rref->rrefId()] = rref;
-    const auto pendingOwnerIter = pendingOwners_.find(rrefId);
-    if (pendingOwnerIter != pendingOwners_.end()) {
+    shard.owners[rref->rrefId()] = rref;
+    const auto pendingOwnerIter = shard.pendingOwners.find(rrefId);
+    if (pendingOwnerIter != shard.pendingOwners.end()) {
       pendingOwnerIter->second->markCompleted(rref);
-      pendingOwners_.erase(pendingOwnerIter);
+      shard.pendingOwners.erase(pendingOwnerIter);
     }
     return rref;
   } else {
@@ -364,7 +446,7 @@ c10::intrusive_ptr<OwnerRRef> RRefContext::getOrCreateOwnerRRef(
 
 c10::intrusive_ptr<OwnerRRef> RRefContext::createOwnerRRef(
     const TypePtr& type) {
-  // Don't add this OnwerRRef to the owners_ map yet, otherwise
+  // Don't add this OnwerRRef to the owners map yet, otherwise
   // it will never be removed from there. Instead, only add it to the
   // map in prepareChildFork, in case this local RRef is being passed
   // to another worker.
@@ -374,20 +456,21 @@ c10::intrusive_ptr<OwnerRRef> RRefContext::createOwnerRRef(
 
 std::shared_ptr<Future<c10::intrusive_ptr<OwnerRRef>>> RRefContext::
     getOwnerRRef(const RRefId& rrefId, bool forceCreated) {
-  std::unique_lock<std::mutex> lock(mutex_);
-  const auto iter = owners_.find(rrefId);
-  if (iter == owners_.end()) {
+  auto& shard = getOwnerShard(rrefId);
+  std::unique_lock<std::mutex> lock(shard.mutex);
+  const auto iter = shard.owners.find(rrefId);
+  if (iter == shard.owners.end()) {
     if (forceCreated) {
       TORCH_INTERNAL_ASSERT(
           false,
           c10::str("Expected OwnerRRef with id ", rrefId, " to be created."));
     }
     // Scenario (1) RRef is used before it is created
-    const auto pendingOwnerIter = pendingOwners_.find(rrefId);
-    if (pendingOwnerIter == pendingOwners_.end()) {
+    const auto pendingOwnerIter = shard.pendingOwners.find(rrefId);
+    if (pendingOwnerIter == shard.pendingOwners.end()) {
       auto futureOwner =
           std::make_shared<Future<c10::intrusive_ptr<OwnerRRef>>>();
-      pendingOwners_[rrefId] = futureOwner;
+      shard.pendingOwners[rrefId] = futureOwner;
       return futureOwner;
     } else {
       return pendingOwnerIter->second;
@@ -425,11 +508,12 @@ RRefForkData RRefContext::prepareChildFork(
     // TODO: When adding failure retries and timeout, this fork needs to be
     // deleted if the owner does not receive the ACK within the timeout.
     addForkOfOwner(rrefForkData.rrefId_, rrefForkData.forkId_);
-    // ensure that this RRef is in the owners_ list to keep it alive.
+    // ensure that this RRef is in the owners list to keep it alive.
     // this is needed for OwnerRRefs that were created locally.
     {
-      std::lock_guard<std::mutex> lock(mutex_);
-      owners_[rref->rrefId()] = rref;
+      auto& shard = getOwnerShard(rref->rrefId());
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.owners[rref->rrefId()] = rref;
     }
   } else {
     // Note [Useful Phantom Fork ID for User to Owner Call]
@@ -474,7 +558,6 @@ void RRefContext::notifyOwnerAndParentOfFork(
       // Hence, it is not necessary to send another RREF_CHILD_ACCEPT or
       // RREF_FORK_REQUEST back to the owner. See Note [Early Fork
       // Registration].
-      std::lock_guard<std::mutex> lock(mutex_);
       addConfirmedUser(forkId, rref);
     }
     return;
@@ -521,23 +604,25 @@ void RRefContext::addPendingChild(
   // fork.
   TORCH_INTERNAL_ASSERT(
       !rref->isOwner(), "OwnerRRef should not have a pending child.");
-  std::lock_guard<std::mutex> lock(mutex_);
+  auto& shard = getUserShard(forkId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
   TORCH_INTERNAL_ASSERT(
-      pendingChildren_.find(forkId) == pendingChildren_.end(),
+      shard.pendingChildren.find(forkId) == shard.pendingChildren.end(),
       "Inconsistent states: attempt to add the same child fork twice.");
-  pendingChildren_[forkId] = rref;
+  shard.pendingChildren[forkId] = rref;
 }
 
 void RRefContext::delPendingChild(const ForkId& forkId) {
   c10::intrusive_ptr<RRef> deletedUser;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto iter = pendingChildren_.find(forkId);
-    // We first check whether the child exists in pendingChildren_. It's
+    auto& shard = getUserShard(forkId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.pendingChildren.find(forkId);
+    // We first check whether the child exists in pendingChildren. It's
     // possible the child may have been removed by a previous send attempt, and
     // this check (as opposed to an assertion here) ensures that messages that
     // trigger this function are idempotent.
-    if (iter != pendingChildren_.end()) {
+    if (iter != shard.pendingChildren.end()) {
       // Since this UserRRef is removed from the map,
       // the refcount of this UserRRef could reach to 0,
       // so the "destructor", `release_resources()`, might be called,
@@ -546,13 +631,13 @@ void RRefContext::delPendingChild(const ForkId& forkId) {
       // Meet this constraint by creating a temporary pointer to increase the
       // refcount, extending its lifetime untill lock released.
       deletedUser = iter->second; // Increase refcount.
-      pendingChildren_.erase(iter); // Decrease refcount.
+      shard.pendingChildren.erase(iter); // Decrease refcount.
     } else {
       LOG(INFO) << "Ignoring duplicate request to delete child UserRRef with "
                 << "ForkId = " << forkId;
     }
   }
-  deleteAllUsersCV_.notify_all();
+  notifyDeleteAllUsers();
   // The refcount of this UserRRef could reach to 0,
   // so the "destructor", release_resources(), might be called,
   // in which the lock is acquired again,
@@ -572,17 +657,18 @@ void RRefContext::addPendingUser(
     // same thread, but deleting pending users will be called from another
     // thread. As the delPendingUser will not be able to access the same
     // thread_local variable, we cannot address this problem by making
-    // pendingUsers_ thread_local. Instead, pendingUsers_ and userTable_ share
+    // pendingUsers thread_local. Instead, pendingUsers and userTable_ share
     // the same PendingUserState shared_ptr.
     userTable_.push_back(state);
   }
 
-  std::lock_guard<std::mutex> lock(mutex_);
+  auto& shard = getUserShard(forkId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
   TORCH_INTERNAL_ASSERT(
-      pendingUsers_.find(forkId) == pendingUsers_.end(),
+      shard.pendingUsers.find(forkId) == shard.pendingUsers.end(),
       "Inconsistent states: attempt to add the same UserRRef twice.");
 
-  pendingUsers_.emplace(
+  shard.pendingUsers.emplace(
       std::piecewise_construct,
       std::forward_as_tuple(forkId),
       std::forward_as_tuple(state));
@@ -591,10 +677,11 @@ void RRefContext::addPendingUser(
 void RRefContext::delPendingUser(const ForkId& forkId) {
   std::shared_ptr<PendingUserState> deletedState = nullptr;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto iter = pendingUsers_.find(forkId);
+    auto& shard = getUserShard(forkId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.pendingUsers.find(forkId);
     TORCH_INTERNAL_ASSERT(
-        iter != pendingUsers_.end(),
+        iter != shard.pendingUsers.end(),
         "Inconsistent states: attempt to delete a non-exist UserRRef.");
 
     // There are two reasons for keeping the deleted PendingUserState alive
@@ -617,29 +704,38 @@ void RRefContext::delPendingUser(const ForkId& forkId) {
     // hiding the subtle logic using a reentrant lock.
     deletedState = iter->second; // Increase refcount
 
-    addConfirmedUser(forkId, iter->second->rref_);
-    pendingUsers_.erase(iter); // Decrease refcount.
+    addConfirmedUser(shard, forkId, iter->second->rref_);
+    shard.pendingUsers.erase(iter); // Decrease refcount.
   }
   deletedState->confirm();
-  deleteAllUsersCV_.notify_all();
+  notifyDeleteAllUsers();
   deletedState.reset(); // Decrease refcount.
 }
 
 void RRefContext::addConfirmedUser(
     const ForkId& forkId,
     const c10::intrusive_ptr<RRef>& rref) {
-  // Notice, caller need to hold the mutex for confirmedUsers_.
-  // std::lock_guard<std::mutex> lock(mutex_);
-  confirmedUsers_.emplace(
+  auto& shard = getUserShard(forkId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  addConfirmedUser(shard, forkId, rref);
+}
+
+void RRefContext::addConfirmedUser(
+    UserShard& shard,
+    const ForkId& forkId,
+    const c10::intrusive_ptr<RRef>& rref) {
+  // Notice, caller need to hold the mutex of the shard.
+  shard.confirmedUsers.emplace(
       std::piecewise_construct,
       std::forward_as_tuple(forkId),
       std::forward_as_tuple(rref));
 }
 
 c10::intrusive_ptr<RRef> RRefContext::getPendingUser(const ForkId& forkId) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto it = pendingUsers_.find(forkId);
-  if (it == pendingUsers_.end()) {
+  auto& shard = getUserShard(forkId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.pendingUsers.find(forkId);
+  if (it == shard.pendingUsers.end()) {
     TORCH_INTERNAL_ASSERT(
         false, "Pending user with forkId ", forkId, " not found");
   }
@@ -694,10 +790,11 @@ void RRefContext::finishForkRequest(const ForkId& forkId, worker_id_t parent) {
 }
 
 void RRefContext::addSelfAsFork(c10::intrusive_ptr<OwnerRRef>& rref) {
-  std::lock_guard<std::mutex> lock(mutex_);
   const auto& rrefId = rref->rrefId();
-  owners_[rrefId] = rref;
-  auto& rrefForks = forks_[rrefId];
+  auto& shard = getOwnerShard(rrefId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.owners[rrefId] = rref;
+  auto& rrefForks = shard.forks[rrefId];
   TORCH_INTERNAL_ASSERT(
       rrefForks.find(rrefId) == rrefForks.end(),
       "Attempt to add self as fork twice ",
@@ -706,8 +803,9 @@ void RRefContext::addSelfAsFork(c10::intrusive_ptr<OwnerRRef>& rref) {
 }
 
 void RRefContext::addForkOfOwner(const RRefId& rrefId, const ForkId& forkId) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto& rrefForks = forks_[rrefId];
+  auto& shard = getOwnerShard(rrefId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto& rrefForks = shard.forks[rrefId];
   TORCH_INTERNAL_ASSERT(
       rrefForks.find(forkId) == rrefForks.end(),
       "Got fork notification twice on the same RRef ",
@@ -718,8 +816,9 @@ void RRefContext::addForkOfOwner(const RRefId& rrefId, const ForkId& forkId) {
 void RRefContext::addForkOfOwnerIfNotPresent(
     const RRefId& rrefId,
     const ForkId& forkId) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto& rrefForks = forks_[rrefId];
+  auto& shard = getOwnerShard(rrefId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto& rrefForks = shard.forks[rrefId];
   // We first check whether the child exists in rrefForks. It's possible
   // the child may have been added by a previous send attempt, and this check
   // (as opposed to an assertion here) ensures that messages that trigger this
@@ -743,9 +842,10 @@ c10::intrusive_ptr<RRef> RRefContext::delForkOfOwner(
   // statements to ensure this function is idempotent. This makes it safe to
   // retry RRefUserDelete messages.
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto rrefIter = forks_.find(rrefId);
-    if (rrefIter != forks_.end()) {
+    auto& shard = getOwnerShard(rrefId);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto rrefIter = shard.forks.find(rrefId);
+    if (rrefIter != shard.forks.end()) {
       auto& rrefForks = rrefIter->second;
       auto forkIter = rrefForks.find(forkId);
       if (forkIter != rrefForks.end()) {
@@ -757,13 +857,13 @@ c10::intrusive_ptr<RRef> RRefContext::delForkOfOwner(
             << ", likely because it was deleted by a previously retried message";
       }
       if (rrefForks.empty()) {
-        auto ownerIter = owners_.find(rrefId);
-        if (ownerIter != owners_.end()) {
+        auto ownerIter = shard.owners.find(rrefId);
+        if (ownerIter != shard.owners.end()) {
           deletedRRef = ownerIter->second;
-          owners_.erase(ownerIter);
+          shard.owners.erase(ownerIter);
           ownerReduced = true;
         }
-        forks_.erase(rrefIter);
+        shard.forks.erase(rrefIter);
       }
     } else {
       LOG(INFO)
@@ -772,7 +872,7 @@ c10::intrusive_ptr<RRef> RRefContext::delForkOfOwner(
     }
   }
   if (ownerReduced) {
-    deleteAllUsersCV_.notify_all();
+    notifyDeleteAllUsers();
   }
   return deletedRRef;
 }
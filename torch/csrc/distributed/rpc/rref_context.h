@@ -9,6 +9,9 @@
 #include <torch/csrc/utils/future.h>
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
 
 namespace torch {
 namespace distributed {
@@ -175,7 +178,7 @@ class TORCH_API RRefContext {
       const c10::intrusive_ptr<RRef>& rref);
 
   // Retrieve a pending user given the fork ID. Throws if the user has already
-  // been confirmed (i.e. is no longer in the pendingUsers_ map).
+  // been confirmed (i.e. is no longer in the pending users map).
   c10::intrusive_ptr<RRef> getPendingUser(const ForkId& forkId);
 
   // Start recroding new pending UserRRefs. All pending UserRRefs introduced
@@ -222,7 +225,7 @@ class TORCH_API RRefContext {
     Future<bool> future_;
   };
 
-  RRefContext(std::shared_ptr<RpcAgent>);
+  RRefContext(std::shared_ptr<RpcAgent>, uint32_t numShards);
 
   c10::intrusive_ptr<UserRRef> createUserRRef(
       worker_id_t ownerId,
@@ -235,36 +238,46 @@ class TORCH_API RRefContext {
   // If there is any leak on any RRef, this method will throw an error.
   void checkRRefLeaks(bool ignoreRRefLeak);
 
-  static std::atomic<local_id_t> nextLocalId_;
+  // Number of shards of the RRef maps, used when the hardware concurrency is
+  // not known. It has to be a power of 2.
+  static constexpr uint32_t kNumDefaultShards = 64;
 
-  const std::shared_ptr<RpcAgent> agent_;
-  mutable std::mutex mutex_;
-  // Keep OwnerRRefs alive until there is no living UserRRefs.
-  std::unordered_map<RRefId, c10::intrusive_ptr<RRef>, RRefId::Hash> owners_;
-  // A map to track OwnerRRefs that are requested but not yet created. This can
-  // happen if the to_here() message is processed on the owner before the
-  // corresponding creator rpc.remote() message. If this happens, instead of
-  // to_here() RPC thread to block waiting for the OwnerRRef creation, the
-  // RRefContext returns a Future, so that the RPC request processing logic can
-  // attach subsequent code as a callback to that Future.
-  // NB: the OwnerRRefs in this map must be cleared when the corresponding
-  // OwnerRRef is created.
-  std::unordered_map<
-      RRefId,
-      std::shared_ptr<Future<c10::intrusive_ptr<OwnerRRef>>>,
-      RRefId::Hash>
-      pendingOwners_;
-  // Tracks known living UserRRefs of an OwnerRRef
-  std::unordered_map<
-      RRefId,
-      std::unordered_set<ForkId, ForkId::Hash>,
-      RRefId::Hash>
-      forks_;
+  // Use cache line size for alignment.
+  static constexpr int kCacheLineSize = 64;
+
+  // The RRef maps are sharded to avoid serializing all RPC threads on a single
+  // lock. The state of an OwnerRRef lives in the shard of its RRefId, and the
+  // state of a UserRRef lives in the shard of its ForkId. Hence, operations
+  // that touch several maps keyed by the same id only hold one shard lock.
+  // NB: a thread must never hold more than one shard lock at a time.
+  //
+  // Shards are aligned to cache line size to avoid contention between adjacent
+  // entries.
+  struct alignas(kCacheLineSize) OwnerShard {
+    mutable std::mutex mutex;
+    // Keep OwnerRRefs alive until there is no living UserRRefs.
+    std::unordered_map<RRefId, c10::intrusive_ptr<RRef>, RRefId::Hash> owners;
+    // A map to track OwnerRRefs that are requested but not yet created. This
+    // can happen if the to_here() message is processed on the owner before the
+    // corresponding creator rpc.remote() message. If this happens, instead of
+    // to_here() RPC thread to block waiting for the OwnerRRef creation, the
+    // RRefContext returns a Future, so that the RPC request processing logic
+    // can attach subsequent code as a callback to that Future.
+    // NB: the OwnerRRefs in this map must be cleared when the corresponding
+    // OwnerRRef is created.
+    std::unordered_map<
+        RRefId,
+        std::shared_ptr<Future<c10::intrusive_ptr<OwnerRRef>>>,
+        RRefId::Hash>
+        pendingOwners;
+    // Tracks known living UserRRefs of an OwnerRRef
+    std::unordered_map<
+        RRefId,
+        std::unordered_set<ForkId, ForkId::Hash>,
+        RRefId::Hash>
+        forks;
+  };
 
-  // This cond var is used by deleteAllUsers(), a event notificaton is sent if
-  // number of pending UserRRef or UserRRef children is reduced, or
-  // number of owned OwnerRRef is reduced.
-  std::condition_variable deleteAllUsersCV_;
   // The follow 3 maps keep UserRRefs alive by holding a intrusive_ptr to the
   // RRef instances. A UserRRef must be added into this map if any of the
   // following two conditions is true:
@@ -273,24 +286,68 @@ class TORCH_API RRefContext {
   //
   //     It can be used or shared, but cannot be deleted, and hence kept alive
   //     in this map. A message of type RREF_USER_ACCEPT will move the
-  //     corresponding RRef from pendingUsers_ map to confirmedUsers_ map.
-  std::unordered_map<ForkId, std::shared_ptr<PendingUserState>, ForkId::Hash>
-      pendingUsers_;
-  //     UserRRefs are added into this map when it is confirmed by the owner.
-  //     When destroying RRefContext this map helps to find local UserRRefs
-  //     and send delete messages if they are still not deleted by Python
-  //     garbage collection.
-  std::unordered_map<ForkId, c10::weak_intrusive_ptr<RRef>, ForkId::Hash>
-      confirmedUsers_;
-
+  //     corresponding RRef from pendingUsers map to confirmedUsers map.
+  //
   // (2) A UserRRef has forked a child UserRRef which has not been accepted by
   //     the owner yet.
   //
   //     In this case, this UserRRef cannot send out RREF_USER_DELETE message,
   //     as it could potentially trigger the OwnerRRef been deleted before the
   //     owner learns about the forked child.
-  std::unordered_map<ForkId, c10::intrusive_ptr<RRef>, ForkId::Hash>
-      pendingChildren_;
+  struct alignas(kCacheLineSize) UserShard {
+    mutable std::mutex mutex;
+    // See (1) above.
+    std::unordered_map<ForkId, std::shared_ptr<PendingUserState>, ForkId::Hash>
+        pendingUsers;
+    // UserRRefs are added into this map when it is confirmed by the owner.
+    // When destroying RRefContext this map helps to find local UserRRefs
+    // and send delete messages if they are still not deleted by Python
+    // garbage collection.
+    std::unordered_map<ForkId, c10::weak_intrusive_ptr<RRef>, ForkId::Hash>
+        confirmedUsers;
+    // See (2) above.
+    std::unordered_map<ForkId, c10::intrusive_ptr<RRef>, ForkId::Hash>
+        pendingChildren;
+  };
+
+  // Compute the number of shards for the RRef maps.
+  static uint32_t computeNumShards();
+
+  // Retrieve the shard for the given id.
+  OwnerShard& getOwnerShard(const RRefId& rrefId);
+  UserShard& getUserShard(const ForkId& forkId);
+
+  // Add a confirmed UserRRef, the caller must hold the lock of the shard.
+  void addConfirmedUser(
+      UserShard& shard,
+      const ForkId& forkId,
+      const c10::intrusive_ptr<RRef>& rref);
+
+  // Counts of the entries in the sharded maps, which are only accurate if
+  // all shard locks are held or no other thread modifies the maps.
+  size_t numOwners() const;
+  size_t numPendingUsersAndChildren() const;
+
+  // Wake up delAllUsersAndUnforkedOwners() after reducing the number of pending
+  // UserRRefs, UserRRef children, or owned OwnerRRefs. Must be called without
+  // holding any shard lock.
+  void notifyDeleteAllUsers();
+
+  static std::atomic<local_id_t> nextLocalId_;
+
+  const std::shared_ptr<RpcAgent> agent_;
+
+  // Number of shards, which has to be a power of 2.
+  const uint32_t numShards_;
+  std::vector<OwnerShard> ownerShards_;
+  std::vector<UserShard> userShards_;
+
+  // This cond var is used by deleteAllUsers(), a event notificaton is sent if
+  // number of pending UserRRef or UserRRef children is reduced, or
+  // number of owned OwnerRRef is reduced. As the counts span all shards, the
+  // waiter holds deleteAllUsersMutex_ and reads the counts shard by shard.
+  std::mutex deleteAllUsersMutex_;
+  std::condition_variable deleteAllUsersCV_;
 
   // The RRef context performs its operations through async RPC requests, in
   // order to not block the user code. Therefore the RRef context's state may be
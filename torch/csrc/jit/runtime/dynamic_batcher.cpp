@@ -0,0 +1,258 @@
+#include <torch/csrc/jit/runtime/dynamic_batcher.h>
+
+#include <numeric>
+
+#include <ATen/ATen.h>
+#include <ATen/core/grad_mode.h>
+#include <torch/csrc/jit/runtime/static/impl.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool compatible(const std::vector<IValue>& lhs, const std::vector<IValue>& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs.size(); i++) {
+    const auto& a = lhs[i].toTensor();
+    const auto& b = rhs[i].toTensor();
+    if (a.scalar_type() != b.scalar_type() || a.device() != b.device() ||
+        a.dim() != b.dim() || !a.sizes().slice(1).equals(b.sizes().slice(1))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Splits a batched output along dim 0, in chunks of the given sizes.
+std::vector<IValue> splitOutput(
+    const IValue& output,
+    const std::vector<int64_t>& num_rows) {
+  std::vector<IValue> result(num_rows.size());
+  auto split = [&](const at::Tensor& tensor) {
+    TORCH_CHECK(
+        tensor.dim() > 0 &&
+            tensor.size(0) ==
+                std::accumulate(num_rows.begin(), num_rows.end(), int64_t(0)),
+        "Expected the outputs of a batch to be batched along dim 0");
+    return tensor.split_with_sizes(num_rows);
+  };
+  if (output.isTensor()) {
+    auto chunks = split(output.toTensor());
+    for (size_t i = 0; i < num_rows.size(); i++) {
+      result[i] = std::move(chunks[i]);
+    }
+    return result;
+  }
+  std::vector<IValue> elements;
+  if (output.isTuple()) {
+    elements = output.toTuple()->elements();
+  } else if (output.isTensorList()) {
+    auto list = output.toTensorVector();
+    elements.assign(list.begin(), list.end());
+  } else {
+    TORCH_CHECK(
+        false,
+        "Expected the output of a batch to be a tensor, or a tuple or list of "
+        "tensors, got ",
+        output.tagKind());
+  }
+  std::vector<std::vector<IValue>> outputs(num_rows.size());
+  for (const auto& element : elements) {
+    TORCH_CHECK(
+        element.isTensor(),
+        "Expected the output of a batch to be a tensor, or a tuple or list of "
+        "tensors, got an element of type ",
+        element.tagKind());
+    auto chunks = split(element.toTensor());
+    for (size_t i = 0; i < num_rows.size(); i++) {
+      outputs[i].emplace_back(std::move(chunks[i]));
+    }
+  }
+  for (size_t i = 0; i < num_rows.size(); i++) {
+    if (output.isTuple()) {
+      result[i] = c10::ivalue::Tuple::create(std::move(outputs[i]));
+    } else {
+      c10::List<at::Tensor> list;
+      for (auto& tensor : outputs[i]) {
+        list.push_back(tensor.toTensor());
+      }
+      result[i] = std::move(list);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+DynamicBatcher::DynamicBatcher(
+    const Module& module,
+    DynamicBatcherOptions options)
+    : options_(options), module_(module) {
+  TORCH_CHECK(options_.max_batch_size > 0, "max_batch_size must be positive");
+  TORCH_CHECK(options_.num_workers > 0, "num_workers must be positive");
+  if (options_.use_static_runtime) {
+    inference_module_ = PrepareForStaticRuntime(module_);
+    for (int i = 0; i < options_.num_workers; i++) {
+      static_runtimes_.push_back(
+          std::make_unique<StaticRuntime>(inference_module_));
+    }
+  }
+  for (int i = 0; i < options_.num_workers; i++) {
+    workers_.emplace_back([this, i]() { workerLoop(i); });
+  }
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> DynamicBatcher::submit(
+    std::vector<IValue> inputs) {
+  TORCH_CHECK(!inputs.empty(), "Expected at least one input");
+  int64_t num_rows = -1;
+  for (const auto& input : inputs) {
+    TORCH_CHECK(
+        input.isTensor() && input.toTensor().dim() > 0,
+        "Expected the inputs of a request to be tensors batched along dim 0");
+    TORCH_CHECK(
+        num_rows < 0 || input.toTensor().size(0) == num_rows,
+        "Expected the inputs of a request to have the same size along dim 0");
+    num_rows = input.toTensor().size(0);
+  }
+  auto future = c10::make_intrusive<c10::ivalue::Future>(AnyType::get());
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    TORCH_CHECK(!stop_, "DynamicBatcher is stopped");
+    queue_.push_back(Request{std::move(inputs),
+                             num_rows,
+                             std::chrono::steady_clock::now(),
+                             future});
+  }
+  cv_.notify_one();
+  return future;
+}
+
+IValue DynamicBatcher::run(std::vector<IValue> inputs) {
+  auto future = submit(std::move(inputs));
+  future->waitAndThrow();
+  return future->value();
+}
+
+DynamicBatcherStats DynamicBatcher::stats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return stats_;
+}
+
+std::vector<DynamicBatcher::Request> DynamicBatcher::takeBatch() {
+  std::vector<Request> batch;
+  int64_t num_rows = 0;
+  for (auto it = queue_.begin(); it != queue_.end();) {
+    if (batch.empty() ||
+        (num_rows + it->num_rows <= options_.max_batch_size &&
+         compatible(batch.front().inputs, it->inputs))) {
+      num_rows += it->num_rows;
+      batch.push_back(std::move(*it));
+      it = queue_.erase(it);
+      if (num_rows >= options_.max_batch_size) {
+        break;
+      }
+    } else {
+      ++it;
+    }
+  }
+  stats_.num_requests += batch.size();
+  stats_.num_batches++;
+  stats_.num_rows += num_rows;
+  return batch;
+}
+
+void DynamicBatcher::workerLoop(size_t worker_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      // Stopped, and all the requests ran.
+      return;
+    }
+    // Wait for more requests until the batch is full, or the oldest request
+    // reached its deadline.
+    auto deadline = queue_.front().arrival + options_.max_delay;
+    cv_.wait_until(lock, deadline, [this]() {
+      if (stop_ || queue_.empty()) {
+        return true;
+      }
+      int64_t num_rows = 0;
+      for (const auto& request : queue_) {
+        num_rows += request.num_rows;
+      }
+      return num_rows >= options_.max_batch_size;
+    });
+    if (queue_.empty()) {
+      // Taken by another worker.
+      continue;
+    }
+    auto batch = takeBatch();
+    lock.unlock();
+    // There may be enough requests left for another worker.
+    cv_.notify_one();
+    runBatch(worker_id, batch);
+    lock.lock();
+  }
+}
+
+void DynamicBatcher::runBatch(size_t worker_id, std::vector<Request>& batch) {
+  std::vector<int64_t> num_rows;
+  num_rows.reserve(batch.size());
+  for (const auto& request : batch) {
+    num_rows.push_back(request.num_rows);
+  }
+  std::vector<IValue> outputs;
+  try {
+    at::NoGradGuard no_grad;
+    std::vector<IValue> inputs;
+    if (batch.size() == 1) {
+      inputs = std::move(batch.front().inputs);
+    } else {
+      for (size_t i = 0; i < batch.front().inputs.size(); i++) {
+        std::vector<at::Tensor> tensors;
+        tensors.reserve(batch.size());
+        for (const auto& request : batch) {
+          tensors.push_back(request.inputs[i].toTensor());
+        }
+        inputs.emplace_back(at::cat(tensors));
+      }
+    }
+    IValue output;
+    if (options_.use_static_runtime) {
+      output = static_runtimes_[worker_id]->run(inputs, {});
+    } else {
+      output = module_.forward(std::move(inputs));
+    }
+    if (batch.size() == 1) {
+      outputs.push_back(std::move(output));
+    } else {
+      outputs = splitOutput(output, num_rows);
+    }
+  } catch (const std::exception&) {
+    for (auto& request : batch) {
+      request.future->setError(std::current_exception());
+    }
+    return;
+  }
+  for (size_t i = 0; i < batch.size(); i++) {
+    batch[i].future->markCompleted(std::move(outputs[i]));
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/jit/api/module.h>
+
+namespace torch {
+namespace jit {
+
+class StaticRuntime;
+struct InferenceModule;
+
+struct TORCH_API DynamicBatcherOptions {
+  // Maximum number of rows (sizes along dim 0 of the inputs) of a batch. A
+  // request larger than this runs as a batch of its own.
+  int64_t max_batch_size{32};
+  // Maximum time the oldest request of a batch waits for more requests
+  // before the batch runs.
+  std::chrono::microseconds max_delay{1000};
+  // Number of threads running batches.
+  int num_workers{1};
+  // Run batches through StaticRuntime instead of Module::forward.
+  bool use_static_runtime{false};
+};
+
+struct TORCH_API DynamicBatcherStats {
+  int64_t num_requests{0};
+  int64_t num_batches{0};
+  int64_t num_rows{0};
+};
+
+/// Coalesces concurrent inference requests into batches.
+///
+/// Requests are the positional arguments of the forward method of a module,
+/// all of them tensors batched along dim 0. Requests whose inputs have the
+/// same number, dtypes, devices and sizes but along dim 0 are compatible:
+/// they are concatenated along dim 0 and run as a single batch, and the
+/// outputs of the batch (a tensor, or a tuple or list of tensors) are split
+/// back along dim 0. Incompatible requests wait for a later batch.
+///
+/// Batches run with gradients disabled.
+///
+/// @code
+///   DynamicBatcher batcher(module, options);
+///   // from many threads
+///   auto future = batcher.submit({torch::randn({1, 16})});
+///   auto output = future->value();
+/// @endcode
+class TORCH_API DynamicBatcher {
+ public:
+  explicit DynamicBatcher(
+      const Module& module,
+      DynamicBatcherOptions options = DynamicBatcherOptions());
+  // Runs the pending requests and stops the workers.
+  ~DynamicBatcher();
+
+  DynamicBatcher(const DynamicBatcher&) = delete;
+  DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+
+  // Thread safe. The future completes with the output of the request, or with
+  // the error of its batch.
+  c10::intrusive_ptr<c10::ivalue::Future> submit(std::vector<IValue> inputs);
+
+  // Submits the request and waits for its output.
+  IValue run(std::vector<IValue> inputs);
+
+  DynamicBatcherStats stats() const;
+
+ private:
+  struct Request {
+    std::vector<IValue> inputs;
+    int64_t num_rows;
+    std::chrono::steady_clock::time_point arrival;
+    c10::intrusive_ptr<c10::ivalue::Future> future;
+  };
+
+  void workerLoop(size_t worker_id);
+  // Takes the oldest request and the compatible requests that fit in the
+  // batch out of the queue.
+  std::vector<Request> takeBatch();
+  void runBatch(size_t worker_id, std::vector<Request>& batch);
+
+  const DynamicBatcherOptions options_;
+  Module module_;
+  std::shared_ptr<InferenceModule> inference_module_;
+  // One per worker, StaticRuntime is not thread safe.
+  std::vector<std::unique_ptr<StaticRuntime>> static_runtimes_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> queue_;
+  bool stop_{false};
+  DynamicBatcherStats stats_;
+  std::vector<std::thread> workers_;
+};
+
+} // namespace jit
+} // namespace torch
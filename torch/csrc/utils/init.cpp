@@ -17,11 +17,37 @@ void initThroughputBenchmarkBindings(PyObject* module) {
       .def_readwrite("num_worker_threads", &BenchmarkConfig::num_worker_threads)
       .def_readwrite("num_warmup_iters", &BenchmarkConfig::num_warmup_iters)
       .def_readwrite("num_iters", &BenchmarkConfig::num_iters)
-      .def_readwrite("profiler_output_path", &BenchmarkConfig::profiler_output_path);
+      .def_readwrite("profiler_output_path", &BenchmarkConfig::profiler_output_path)
+      .def_readwrite("max_batch_size", &BenchmarkConfig::max_batch_size)
+      .def_readwrite(
+          "max_batch_delay_us", &BenchmarkConfig::max_batch_delay_us)
+      .def_readwrite("use_static_runtime", &BenchmarkConfig::use_static_runtime)
+      .def_readwrite("target_qps", &BenchmarkConfig::target_qps)
+      .def_readwrite(
+          "throughput_interval_ms", &BenchmarkConfig::throughput_interval_ms);
 
   py::class_<BenchmarkExecutionStats>(m, "BenchmarkExecutionStats")
       .def_readonly("latency_avg_ms", &BenchmarkExecutionStats::latency_avg_ms)
-      .def_readonly("num_iters", &BenchmarkExecutionStats::num_iters);
+      .def_readonly("num_iters", &BenchmarkExecutionStats::num_iters)
+      .def_readonly("latency_p50_ms", &BenchmarkExecutionStats::latency_p50_ms)
+      .def_readonly("latency_p90_ms", &BenchmarkExecutionStats::latency_p90_ms)
+      .def_readonly("latency_p99_ms", &BenchmarkExecutionStats::latency_p99_ms)
+      .def_readonly(
+          "latency_p999_ms", &BenchmarkExecutionStats::latency_p999_ms)
+      .def_readonly("total_time_ms", &BenchmarkExecutionStats::total_time_ms)
+      .def_readonly(
+          "interval_iters_per_second",
+          &BenchmarkExecutionStats::interval_iters_per_second)
+      .def_readonly("avg_batch_size", &BenchmarkExecutionStats::avg_batch_size)
+      .def_readonly(
+          "warmup_num_iters", &BenchmarkExecutionStats::warmup_num_iters)
+      .def_readonly(
+          "warmup_latency_avg_ms",
+          &BenchmarkExecutionStats::warmup_latency_avg_ms)
+      .def_readonly(
+          "warmup_latency_p99_ms",
+          &BenchmarkExecutionStats::warmup_latency_p99_ms)
+      .def_readonly("warmup_time_ms", &BenchmarkExecutionStats::warmup_time_ms);
 
   py::class_<ThroughputBenchmark>(m, "ThroughputBenchmark", py::dynamic_attr())
       .def(py::init<jit::Module>())
@@ -27,6 +27,20 @@ void initializeLayouts() {
   }
   registerLayoutObject((THPLayout*)sparse_coo_layout, at::Layout::Sparse);
 
+  PyObject *sparse_csr_layout = THPLayout_New(at::Layout::SparseCsr, "torch.sparse_csr");
+  Py_INCREF(sparse_csr_layout);
+  if (PyModule_AddObject(torch_module, "sparse_csr", sparse_csr_layout) != 0) {
+    throw python_error();
+  }
+  registerLayoutObject((THPLayout*)sparse_csr_layout, at::Layout::SparseCsr);
+
+  PyObject *jagged_layout = THPLayout_New(at::Layout::Jagged, "torch.jagged");
+  Py_INCREF(jagged_layout);
+  if (PyModule_AddObject(torch_module, "jagged", jagged_layout) != 0) {
+    throw python_error();
+  }
+  registerLayoutObject((THPLayout*)jagged_layout, at::Layout::Jagged);
+
   PyObject *mkldnn_layout = THPLayout_New(at::Layout::Mkldnn, "torch._mkldnn");
   Py_INCREF(mkldnn_layout);
   if (PyModule_AddObject(torch_module, "_mkldnn", mkldnn_layout) != 0) {
@@ -709,6 +709,41 @@ void _validate_sparse_coo_tensor_args(c10::DispatchKey dispatch_key, at::ScalarT
   at::native::_validate_sparse_coo_tensor_args(indices, values, r.intlist(2));
 }
 
+Tensor sparse_csr_tensor_ctor(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
+  static PythonArgParser parser({
+    "sparse_csr_tensor(PyObject* crow_indices, PyObject* col_indices, PyObject* values, *, ScalarType dtype=None, Device? device=None, bool requires_grad=False)",
+    "sparse_csr_tensor(PyObject* crow_indices, PyObject* col_indices, PyObject* values, IntArrayRef size, *, ScalarType dtype=None, Device? device=None, bool requires_grad=False)",
+  });
+
+  ParsedArgs<7> parsed_args;
+  auto r = parser.parse(args, kwargs, parsed_args);
+  const int ARG_CROW_INDICES = 0, ARG_COL_INDICES = 1, ARG_VALUES = 2, ARG_SIZE = 3;
+  // the keyword arguments come after size in the second signature
+  const int kwarg_offset = r.idx == 0 ? 3 : 4;
+  const int ARG_TYPE = kwarg_offset, ARG_DEVICE = kwarg_offset + 1, ARG_REQUIRES_GRAD = kwarg_offset + 2;
+  bool type_inference = r.isNone(ARG_TYPE);
+  const auto inferred_dispatch_key = denseTypeIdWithDefault(r, ARG_DEVICE, dispatch_key);
+  const auto inferred_scalar_type = r.scalartypeWithDefault(ARG_TYPE, scalar_type);
+  at::OptionalDeviceGuard device_guard(r.deviceOptional(ARG_DEVICE));
+  Tensor values = internal_new_from_data(inferred_dispatch_key, inferred_scalar_type, r.deviceOptional(ARG_DEVICE), r.pyobject(ARG_VALUES),
+                                         /*copy_variables=*/false, /*copy_numpy=*/true,
+                                         /*type_inference=*/type_inference);
+  // unlike for sparse COO tensors, int32 indices are kept as they are; lists
+  // of Python ints become int64 indices
+  Tensor crow_indices = internal_new_from_data(legacyExtractDispatchKey(values.key_set()), kLong, r.deviceOptional(ARG_DEVICE), r.pyobject(ARG_CROW_INDICES),
+                                               /*copy_variables=*/false, /*copy_numpy=*/true,
+                                               /*type_inference=*/true);
+  Tensor col_indices = internal_new_from_data(legacyExtractDispatchKey(values.key_set()), kLong, r.deviceOptional(ARG_DEVICE), r.pyobject(ARG_COL_INDICES),
+                                              /*copy_variables=*/false, /*copy_numpy=*/true,
+                                              /*type_inference=*/true);
+  if (r.idx == 0) {
+    return at::sparse_csr_tensor(crow_indices, col_indices, values, values.options().layout(at::kSparseCsr))
+        .set_requires_grad(r.toBool(ARG_REQUIRES_GRAD));
+  }
+  return at::sparse_csr_tensor(crow_indices, col_indices, values, r.intlist(ARG_SIZE), values.options().layout(at::kSparseCsr))
+      .set_requires_grad(r.toBool(ARG_REQUIRES_GRAD));
+}
+
 Tensor tensor_ctor(c10::DispatchKey dispatch_key, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
   static PythonArgParser parser({
     "tensor(PyObject* data, *, ScalarType dtype=None, Device? device=None, bool pin_memory=False, bool requires_grad=False, DimnameList? names=None)",
@@ -23,6 +23,8 @@ static const char* backend_to_string(const at::Backend& backend) {
     case at::Backend::SparseCPU: return "torch.sparse";
     case at::Backend::SparseCUDA: return "torch.cuda.sparse";
     case at::Backend::SparseXPU: return "torch.xpu.sparse";
+    case at::Backend::SparseCsrCPU: return "torch.sparse_csr";
+    case at::Backend::JaggedCPU: return "torch.jagged";
     case at::Backend::QuantizedCPU: return "torch.quantized";
     default: AT_ERROR("Unimplemented backend ", backend);
   }
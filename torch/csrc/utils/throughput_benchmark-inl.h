@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <numeric>
 #include <random>
 #include <thread>
 
@@ -28,6 +30,9 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   // overhead from the benchmark runner itself
   std::vector<std::vector<Input>> thread_inputs(config.num_calling_threads);
   std::vector<size_t> input_iters(config.num_calling_threads);
+  // Arrival times of the requests relative to the start of the main loop, in
+  // the open loop mode
+  std::vector<std::chrono::nanoseconds> arrivals;
   {
     std::random_device seeder;
     std::mt19937 engine(seeder());
@@ -46,8 +51,17 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
       }
       input_iters[thread_id] = 0;
     }
+    if (config.target_qps > 0) {
+      arrivals = poissonArrivals(config.target_qps, config.num_iters, engine);
+    }
   }
 
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = std::chrono::time_point<Clock>;
+  auto elapsed_ms = [](TimePoint since, TimePoint until) {
+    return std::chrono::duration<float, std::milli>(until - since).count();
+  };
+
   std::mutex m;
   std::condition_variable worker_main_cv;
   std::condition_variable main_worker_cv;
@@ -55,16 +69,26 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
   int64_t initialized{0};
   int64_t finished{0};
   bool start{false};
+  TimePoint start_time;
   std::atomic<int64_t> num_attempted_iters{0};
   std::vector<std::thread> callers;
+  // Indexed by iteration, every iteration is run by a single thread
+  std::vector<float> latencies_ms(config.num_iters);
+  std::vector<float> completion_times_ms(config.num_iters);
+  std::vector<std::vector<float>> thread_warmup_latencies_ms(
+      config.num_calling_threads);
 
+  auto warmup_start_time = Clock::now();
   for (auto thread_id = 0; thread_id < config.num_calling_threads;
        ++thread_id) {
     callers.emplace_back([&, thread_id]() {
       // We use conditional variable as a barrier to make sure each thread
       // performs required warmeup iterations before we start measuring
       for (auto j = 0; j < config.num_warmup_iters; ++j) {
+        auto iter_start = Clock::now();
         runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
+        thread_warmup_latencies_ms[thread_id].push_back(
+            elapsed_ms(iter_start, Clock::now()));
         ++input_iters[thread_id];
       }
       {
@@ -76,8 +100,22 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
         }
       }
       LOG(INFO) << "Starting forward thread " << thread_id;
-      while (num_attempted_iters.fetch_add(1) < config.num_iters) {
+      int64_t i;
+      while ((i = num_attempted_iters.fetch_add(1)) < config.num_iters) {
+        TimePoint iter_start;
+        if (arrivals.empty()) {
+          iter_start = Clock::now();
+        } else {
+          // Open loop: the iterations are taken in order of arrival by the
+          // first available thread, i.e. the calling threads serve a single
+          // queue of requests. Latency includes the time spent in the queue
+          iter_start = start_time + arrivals[i];
+          std::this_thread::sleep_until(iter_start);
+        }
         runOnce(std::move(thread_inputs[thread_id][input_iters[thread_id]]));
+        auto iter_end = Clock::now();
+        latencies_ms[i] = elapsed_ms(iter_start, iter_end);
+        completion_times_ms[i] = elapsed_ms(start_time, iter_end);
         ++input_iters[thread_id];
       }
 
@@ -92,16 +130,14 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     });
   }
 
-  using Clock = std::chrono::high_resolution_clock;
-  using TimePoint = std::chrono::time_point<Clock>;
-  TimePoint start_time;
-
+  float warmup_time_ms;
   std::unique_ptr<torch::autograd::profiler::RecordProfile> profiler_guard;
   {
     std::unique_lock<std::mutex> lock(m);
     while (initialized != config.num_calling_threads) {
       worker_main_cv.wait(lock);
     }
+    warmup_time_ms = elapsed_ms(warmup_start_time, Clock::now());
     if (!config.profiler_output_path.empty()) {
       LOG(INFO) << "Using Autograd profiler. Trace will be saved to "
                 << config.profiler_output_path;
@@ -119,25 +155,40 @@ BenchmarkExecutionStats BenchmarkHelper<Input, Output, Model>::benchmark(
     worker_main_cv.wait(
         lock, [&]() { return finished == config.num_calling_threads; });
   }
-  auto end_time = std::chrono::high_resolution_clock::now();
+  auto end_time = Clock::now();
   profiler_guard.reset();
   LOG(INFO) << "Finished benchmark";
 
   BenchmarkExecutionStats stats;
-  float total_time_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                            end_time - start_time)
-                            .count() /
-      1000.0 / 1000.0;
-  // We use config.num_iters instead of num_attempted_iters as it is
-  // repsesatative of the real work done. Last attempted iteration on each
-  // calling threads doesn't represent the real work (i.e. running the model)
-  stats.latency_avg_ms =
-      total_time_ms * config.num_calling_threads / config.num_iters;
+  float total_time_ms = elapsed_ms(start_time, end_time);
+  if (arrivals.empty()) {
+    // We use config.num_iters instead of num_attempted_iters as it is
+    // repsesatative of the real work done. Last attempted iteration on each
+    // calling threads doesn't represent the real work (i.e. running the model)
+    stats.latency_avg_ms =
+        total_time_ms * config.num_calling_threads / config.num_iters;
+  } else {
+    // The formula above only holds when the calling threads are always busy
+    stats.latency_avg_ms =
+        std::accumulate(latencies_ms.begin(), latencies_ms.end(), 0.0) /
+        config.num_iters;
+  }
   stats.num_iters = config.num_iters;
+  stats.total_time_ms = total_time_ms;
 
   for (auto& t : callers) {
     t.join();
   }
+  setIterationStats(
+      config, std::move(latencies_ms), completion_times_ms, stats);
+  std::vector<float> warmup_latencies_ms;
+  for (const auto& thread_latencies : thread_warmup_latencies_ms) {
+    warmup_latencies_ms.insert(
+        warmup_latencies_ms.end(),
+        thread_latencies.begin(),
+        thread_latencies.end());
+  }
+  setWarmupStats(std::move(warmup_latencies_ms), warmup_time_ms, stats);
   return stats;
 }
 
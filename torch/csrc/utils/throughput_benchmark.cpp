@@ -2,12 +2,20 @@
 
 #include <pybind11/pybind11.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
+#include <torch/csrc/jit/runtime/dynamic_batcher.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 
 namespace torch {
 namespace throughput_benchmark {
 
 std::ostream& operator<<(std::ostream& os, const BenchmarkExecutionStats& value) {
     return os << "Average latency / iter (ms): " << value.latency_avg_ms
+              << "\n Latency p50 / p90 / p99 / p99.9 (ms): "
+              << value.latency_p50_ms << " / " << value.latency_p90_ms << " / "
+              << value.latency_p99_ms << " / " << value.latency_p999_ms
               << "\n Total number of iters: " << value.num_iters;
 }
 
@@ -50,6 +58,12 @@ BenchmarkExecutionStats ThroughputBenchmark::benchmark(
   // Main benchmark thread doesn't hold the GIL after scheduling worker threads
   // But for now we don't release it as we will be implicitly manipulating with
   // py::object ref. counts in the case of nn.Module benchmarking.
+  if (config.max_batch_size > 0) {
+    TORCH_CHECK(
+        script_module_.initialized(),
+        "Batching is only supported for ScriptModule");
+    return script_module_.benchmarkBatched(config);
+  }
   if (script_module_.initialized()) {
     return script_module_.benchmark(config);
   } else {
@@ -63,6 +77,232 @@ BenchmarkExecutionStats ThroughputBenchmark::benchmark(
 
 namespace detail {
 
+namespace {
+
+// Nearest rank percentile
+float percentile(const std::vector<float>& sorted, double p) {
+  auto rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+} // namespace
+
+std::vector<std::chrono::nanoseconds>
+poissonArrivals(double qps, int64_t n, std::mt19937& engine) {
+  std::exponential_distribution<double> interarrival_s(qps);
+  std::vector<std::chrono::nanoseconds> arrivals(n);
+  double arrival_s = 0;
+  for (int64_t i = 0; i < n; ++i) {
+    arrival_s += interarrival_s(engine);
+    arrivals[i] = std::chrono::nanoseconds(static_cast<int64_t>(arrival_s * 1e9));
+  }
+  return arrivals;
+}
+
+void setIterationStats(
+    const BenchmarkConfig& config,
+    std::vector<float> latencies_ms,
+    const std::vector<float>& completion_times_ms,
+    BenchmarkExecutionStats& stats) {
+  if (latencies_ms.empty()) {
+    return;
+  }
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  stats.latency_p50_ms = percentile(latencies_ms, 50);
+  stats.latency_p90_ms = percentile(latencies_ms, 90);
+  stats.latency_p99_ms = percentile(latencies_ms, 99);
+  stats.latency_p999_ms = percentile(latencies_ms, 99.9);
+
+  TORCH_CHECK(
+      config.throughput_interval_ms > 0,
+      "throughput_interval_ms must be positive");
+  auto interval_ms = static_cast<float>(config.throughput_interval_ms);
+  auto num_intervals =
+      std::max<int64_t>(std::ceil(stats.total_time_ms / interval_ms), 1);
+  std::vector<int64_t> completed(num_intervals);
+  for (auto completion_time_ms : completion_times_ms) {
+    auto interval = std::min<int64_t>(
+        completion_time_ms / interval_ms, num_intervals - 1);
+    completed[interval]++;
+  }
+  stats.interval_iters_per_second.resize(num_intervals);
+  for (int64_t i = 0; i < num_intervals; ++i) {
+    auto length_ms = std::min(interval_ms, stats.total_time_ms - i * interval_ms);
+    stats.interval_iters_per_second[i] =
+        length_ms > 0 ? completed[i] * 1000.0 / length_ms : 0;
+  }
+}
+
+void setWarmupStats(
+    std::vector<float> latencies_ms,
+    float warmup_time_ms,
+    BenchmarkExecutionStats& stats) {
+  stats.warmup_num_iters = latencies_ms.size();
+  stats.warmup_time_ms = warmup_time_ms;
+  if (latencies_ms.empty()) {
+    return;
+  }
+  stats.warmup_latency_avg_ms =
+      std::accumulate(latencies_ms.begin(), latencies_ms.end(), 0.0) /
+      latencies_ms.size();
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  stats.warmup_latency_p99_ms = percentile(latencies_ms, 99);
+}
+
+template <>
+BenchmarkExecutionStats ScriptModuleBenchmark::benchmarkBatched(
+    const BenchmarkConfig& config) const {
+  CHECK(initialized_);
+  TORCH_CHECK(
+      !inputs_.empty(),
+      "Please provide benchmark inputs."
+      "Did you forget to call add_input()? ");
+
+  jit::DynamicBatcherOptions options;
+  options.max_batch_size = config.max_batch_size;
+  options.max_delay = std::chrono::microseconds(config.max_batch_delay_us);
+  options.num_workers = config.num_worker_threads;
+  options.use_static_runtime = config.use_static_runtime;
+  jit::DynamicBatcher batcher(model_, options);
+
+  // The batcher takes the arguments of forward, without self
+  std::vector<ScriptModuleInput> requests;
+  for (const auto& input : inputs_) {
+    requests.emplace_back(input.begin() + 1, input.end());
+  }
+  std::random_device seeder;
+  std::mt19937 engine(seeder());
+  std::uniform_int_distribution<size_t> dist(0, requests.size() - 1);
+  std::vector<size_t> request_ids(config.num_iters);
+  for (auto& request_id : request_ids) {
+    request_id = dist(engine);
+  }
+
+  using Clock = std::chrono::steady_clock;
+  auto elapsed_ms = [](Clock::time_point start) {
+    return std::chrono::duration<float, std::milli>(Clock::now() - start)
+        .count();
+  };
+
+  std::vector<float> warmup_latencies_ms;
+  auto warmup_start_time = Clock::now();
+  for (auto i = 0; i < config.num_warmup_iters; ++i) {
+    auto iter_start = Clock::now();
+    batcher.run(requests[dist(engine)]);
+    warmup_latencies_ms.push_back(elapsed_ms(iter_start));
+  }
+  auto warmup_time_ms = elapsed_ms(warmup_start_time);
+  auto warmup_stats = batcher.stats();
+
+  // Indexed by iteration
+  std::vector<float> latencies_ms(config.num_iters);
+  std::vector<float> completion_times_ms(config.num_iters);
+
+  std::unique_ptr<torch::autograd::profiler::RecordProfile> profiler_guard;
+  if (!config.profiler_output_path.empty()) {
+    LOG(INFO) << "Using Autograd profiler. Trace will be saved to "
+              << config.profiler_output_path;
+    profiler_guard.reset(new torch::autograd::profiler::RecordProfile(
+        config.profiler_output_path));
+  }
+  auto start_time = Clock::now();
+  if (config.target_qps > 0) {
+    // Open loop: requests are submitted at their arrival time regardless of
+    // the completion of the previous ones
+    std::mutex m;
+    std::condition_variable completed_cv;
+    int64_t completed = 0;
+    // Number of callbacks to wait for, guarded by m
+    int64_t expected = config.num_iters;
+    std::vector<c10::intrusive_ptr<c10::ivalue::Future>> futures;
+    futures.reserve(config.num_iters);
+    auto arrivals =
+        poissonArrivals(config.target_qps, config.num_iters, engine);
+    try {
+      for (int64_t i = 0; i < config.num_iters; ++i) {
+        auto arrival = start_time + arrivals[i];
+        std::this_thread::sleep_until(arrival);
+        auto future = batcher.submit(requests[request_ids[i]]);
+        future->addCallback([&, i, arrival]() {
+          latencies_ms[i] = elapsed_ms(arrival);
+          completion_times_ms[i] = elapsed_ms(start_time);
+          std::lock_guard<std::mutex> guard(m);
+          if (++completed == expected) {
+            completed_cv.notify_one();
+          }
+        });
+        // Reserved, so it does not throw
+        futures.push_back(std::move(future));
+      }
+    } catch (...) {
+      // The callbacks of the requests already submitted write to the state
+      // above, so they must all have run before it goes out of scope
+      std::unique_lock<std::mutex> lock(m);
+      expected = static_cast<int64_t>(futures.size());
+      completed_cv.wait(lock, [&]() { return completed == expected; });
+      throw;
+    }
+    std::unique_lock<std::mutex> lock(m);
+    completed_cv.wait(lock, [&]() { return completed == expected; });
+    for (const auto& future : futures) {
+      future->waitAndThrow();
+    }
+  } else {
+    // Closed loop: every calling thread waits for its request to complete
+    // before issuing the next one
+    std::atomic<int64_t> next_iter{0};
+    std::vector<std::thread> callers;
+    std::vector<std::exception_ptr> errors(config.num_calling_threads);
+    for (auto thread_id = 0; thread_id < config.num_calling_threads;
+         ++thread_id) {
+      callers.emplace_back([&, thread_id]() {
+        try {
+          int64_t i;
+          while ((i = next_iter.fetch_add(1)) < config.num_iters) {
+            auto iter_start = Clock::now();
+            batcher.run(requests[request_ids[i]]);
+            latencies_ms[i] = elapsed_ms(iter_start);
+            completion_times_ms[i] = elapsed_ms(start_time);
+          }
+        } catch (...) {
+          errors[thread_id] = std::current_exception();
+        }
+      });
+    }
+    for (auto& t : callers) {
+      t.join();
+    }
+    for (const auto& error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+  auto total_time_ms = elapsed_ms(start_time);
+  profiler_guard.reset();
+  LOG(INFO) << "Finished benchmark";
+
+  auto batcher_stats = batcher.stats();
+  BenchmarkExecutionStats stats;
+  stats.num_iters = config.num_iters;
+  stats.total_time_ms = total_time_ms;
+  stats.latency_avg_ms = config.num_iters > 0
+      ? std::accumulate(latencies_ms.begin(), latencies_ms.end(), 0.0) /
+          config.num_iters
+      : 0;
+  auto num_batches = batcher_stats.num_batches - warmup_stats.num_batches;
+  if (num_batches > 0) {
+    stats.avg_batch_size = static_cast<float>(
+                               batcher_stats.num_requests -
+                               warmup_stats.num_requests) /
+        num_batches;
+  }
+  setIterationStats(
+      config, std::move(latencies_ms), completion_times_ms, stats);
+  setWarmupStats(std::move(warmup_latencies_ms), warmup_time_ms, stats);
+  return stats;
+}
+
 template <>
 void ScriptModuleBenchmark::runOnce(ScriptModuleInput&& input) const {
   CHECK(initialized_);
@@ -6,8 +6,10 @@
 
 #include <torch/csrc/jit/python/pybind_utils.h>
 
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -23,6 +25,24 @@ namespace throughput_benchmark {
 struct BenchmarkExecutionStats {
   float latency_avg_ms{-1};
   int64_t num_iters{-1};
+  // Latency percentiles of the individual iterations
+  float latency_p50_ms{-1};
+  float latency_p90_ms{-1};
+  float latency_p99_ms{-1};
+  float latency_p999_ms{-1};
+  // Wall time of the main benchmark loop (without the warmup)
+  float total_time_ms{-1};
+  // Iterations completed per second in every throughput_interval_ms interval
+  // of the main benchmark loop. The last interval may be shorter
+  std::vector<float> interval_iters_per_second;
+  // Average number of requests per batch, only set when batching is enabled
+  float avg_batch_size{-1};
+  // Warmup iterations are not part of the stats above, but are reported
+  // separately so that one can check that the steady state was reached
+  int64_t warmup_num_iters{-1};
+  float warmup_latency_avg_ms{-1};
+  float warmup_latency_p99_ms{-1};
+  float warmup_time_ms{-1};
 };
 
 std::ostream& operator<<(std::ostream& os, const BenchmarkExecutionStats& value);
@@ -41,10 +61,11 @@ struct BenchmarkConfig {
   // Calling threads are those threads that are calling into a module in
   // parallel.
   int num_calling_threads{1};
-  // Worker threads are not supported yet. This is just an example that we plan
-  // to support some sort of multi-threaded forward calls. We may change this
-  // setting in the future to support different intra and inter op parallelizm
-  // which is not available in PyTorch yet
+  // Worker threads run the batches when batching is enabled (see
+  // max_batch_size). Without batching the calling threads run the module
+  // themselves and this must be 1. We may change this setting in the future to
+  // support different intra and inter op parallelizm which is not available in
+  // PyTorch yet
   int num_worker_threads{1};
   // Warmup iters are used to make sure we run a module a few times before
   // actually measuring things. This way we avoid cold caches and any other
@@ -57,6 +78,26 @@ struct BenchmarkConfig {
   // before the main benchmark loop (but after the warmup):
   // RecordProfile guard(profiler_output_path);
   std::string profiler_output_path{""};
+  // If positive, requests are coalesced into batches of up to max_batch_size
+  // rows (sizes along dim 0 of the inputs) by a jit::DynamicBatcher before
+  // running the module. Only supported for ScriptModule, whose inputs must all
+  // be tensors batched along dim 0
+  int64_t max_batch_size{0};
+  // Maximum time a request waits for a batch to fill up
+  int64_t max_batch_delay_us{1000};
+  // Run the batches through jit::StaticRuntime instead of the forward method
+  bool use_static_runtime{false};
+  // If positive, the requests arrive open loop, following a Poisson process of
+  // target_qps requests per second, instead of every calling thread issuing a
+  // request as soon as the previous one completes. Latencies are then measured
+  // from the scheduled arrival times, so that a backlog of requests shows up in
+  // the percentiles. Without batching the calling threads serve the requests in
+  // order of arrival, with batching the requests are submitted to the batcher
+  // as they arrive and calling threads are ignored. Warmup iterations are run
+  // closed loop regardless
+  double target_qps{0};
+  // Length of the intervals of BenchmarkExecutionStats::interval_iters_per_second
+  int64_t throughput_interval_ms{1000};
 };
 
 namespace detail {
@@ -82,6 +123,8 @@ public:
   void addInput(py::args&&, py::kwargs&&);
   void addInput(Input&&);
   BenchmarkExecutionStats benchmark(const BenchmarkConfig& config) const;
+  // Same as benchmark(), but the requests go through a jit::DynamicBatcher
+  BenchmarkExecutionStats benchmarkBatched(const BenchmarkConfig& config) const;
 
   bool initialized() const { return initialized_; }
 
@@ -112,6 +155,24 @@ typedef at::IValue ScriptModuleOutput;
 template<class Input>
 Input cloneInput(const Input& input);
 
+// Returns n Poisson arrival times of rate qps, relative to the first one
+std::vector<std::chrono::nanoseconds>
+poissonArrivals(double qps, int64_t n, std::mt19937& engine);
+
+// Sets the latency percentiles and the interval throughputs of stats from the
+// latencies and completion times (relative to the start of the main loop) of
+// all the iterations
+void setIterationStats(
+    const BenchmarkConfig& config,
+    std::vector<float> latencies_ms,
+    const std::vector<float>& completion_times_ms,
+    BenchmarkExecutionStats& stats);
+
+void setWarmupStats(
+    std::vector<float> latencies_ms,
+    float warmup_time_ms,
+    BenchmarkExecutionStats& stats);
+
 typedef BenchmarkHelper<
     ScriptModuleInput,
     at::IValue,
@@ -142,6 +203,10 @@ template <>
 ModuleOutput ModuleBenchmark::runOnce(py::args&& args, py::kwargs&& kwargs)
     const;
 
+template <>
+BenchmarkExecutionStats ScriptModuleBenchmark::benchmarkBatched(
+    const BenchmarkConfig& config) const;
+
 template <>
 void ScriptModuleBenchmark::addInput(py::args&& args, py::kwargs&& kwargs);
 template <>
@@ -31,6 +31,9 @@ if is_available():
         _GradBucket,
         _register_comm_hook,
         _register_builtin_comm_hook,
+        _GradCompressionOptions,
+        _get_builtin_comm_hook_state_dict,
+        _load_builtin_comm_hook_state_dict,
         _broadcast_coalesced,
         _compute_bucket_assignment_by_size,
         _test_python_store,
@@ -40,6 +43,7 @@ if is_available():
     if sys.platform != 'win32':
         from torch._C._distributed_c10d import (
             HashStore,
+            ProcessGroupHierarchical,
             _round_robin_process_groups,
         )
 
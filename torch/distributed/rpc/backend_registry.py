@@ -103,6 +103,7 @@ def _process_group_construct_rpc_backend_options_handler(
     rpc_timeout,
     init_method,
     num_send_recv_threads=rpc_constants.DEFAULT_NUM_SEND_RECV_THREADS,
+    shm_threshold_bytes=rpc_constants.DEFAULT_SHM_THRESHOLD_BYTES,
     **kwargs
 ):
     from . import ProcessGroupRpcBackendOptions
@@ -110,7 +111,8 @@ def _process_group_construct_rpc_backend_options_handler(
     return ProcessGroupRpcBackendOptions(
         rpc_timeout=rpc_timeout,
         init_method=init_method,
-        num_send_recv_threads=num_send_recv_threads
+        num_send_recv_threads=num_send_recv_threads,
+        shm_threshold_bytes=shm_threshold_bytes,
     )
 
 def _init_process_group(store, rank, world_size):
@@ -161,6 +163,7 @@ def _process_group_init_backend_handler(
         group,
         rpc_backend_options.num_send_recv_threads,
         timedelta(seconds=rpc_backend_options.rpc_timeout),
+        rpc_backend_options.shm_threshold_bytes,
     )
 
 
@@ -5,6 +5,7 @@ from torch._C._distributed_rpc import (
     _DEFAULT_NUM_SEND_RECV_THREADS,
     _DEFAULT_NUM_WORKER_THREADS,
     _DEFAULT_RPC_TIMEOUT_SEC,
+    _DEFAULT_SHM_THRESHOLD_BYTES,
     _UNSET_RPC_TIMEOUT,
 )
 
@@ -16,6 +17,8 @@ DEFAULT_SHUTDOWN_TIMEOUT: float = 5.0
 
 # For ProcessGroupAgent.
 DEFAULT_NUM_SEND_RECV_THREADS: int = _DEFAULT_NUM_SEND_RECV_THREADS
+# Shared memory transport of large tensors to co-located workers is disabled.
+DEFAULT_SHM_THRESHOLD_BYTES: int = _DEFAULT_SHM_THRESHOLD_BYTES
 # For TensorPipeAgent.
 DEFAULT_NUM_WORKER_THREADS: int = _DEFAULT_NUM_WORKER_THREADS
 # Ensure that we don't time out when there are long periods of time without
@@ -67,4 +67,17 @@ void PrefixStore::wait(
   store_->wait(joinedKeys, timeout);
 }
 
+void PrefixStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  auto joinedKeys = joinKeys(keys);
+  store_->multiSet(joinedKeys, values);
+}
+
+std::vector<std::vector<uint8_t>> PrefixStore::multiGet(
+    const std::vector<std::string>& keys) {
+  auto joinedKeys = joinKeys(keys);
+  return store_->multiGet(joinedKeys);
+}
+
 } // namespace c10d
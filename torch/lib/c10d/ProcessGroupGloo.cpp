@@ -13,6 +13,8 @@
 #endif
 #include <sys/types.h>
 
+#include <chrono>
+#include <functional>
 #include <type_traits>
 
 #include <gloo/allgather.h>
@@ -443,7 +445,11 @@ void ProcessGroupGloo::RecvWork::abort() {
 }
 
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      allreduceChunkBytes(0) {}
+
+constexpr size_t ProcessGroupGloo::kMaxAllreduceTimelines;
 
 namespace {
 
@@ -569,6 +575,7 @@ ProcessGroupGloo::ProcessGroupGloo(
     : ProcessGroup(rank, size),
       store_(new GlooStore(store)),
       stop_(false),
+      allreduceChunkBytes_(options.allreduceChunkBytes),
       collectiveCounter_(0) {
   auto& devices = options.devices;
   if (devices.empty()) {
@@ -1180,6 +1187,99 @@ class AsyncSparseAllreduceWork : public ProcessGroupGloo::AsyncWork {
   }
 };
 
+int64_t steadyTimeNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Work object returned by a chunked allreduce. It is never queued itself, but
+// completes when the last of its AsyncAllreduceChunkWork objects has run.
+class AsyncChunkedAllreduceWork : public ProcessGroup::Work {
+ public:
+  AsyncChunkedAllreduceWork(
+      std::vector<at::Tensor>& inputs,
+      size_t numChunks,
+      ProcessGroupGloo::AllreduceTimeline timeline,
+      std::function<void(ProcessGroupGloo::AllreduceTimeline)> onComplete)
+      : ProcessGroup::Work(-1, OpType::ALLREDUCE),
+        inputs_(inputs),
+        pendingChunks_(numChunks),
+        timeline_(std::move(timeline)),
+        onComplete_(std::move(onComplete)) {
+    timeline_.chunkStartTimes.resize(numChunks);
+    timeline_.chunkEndTimes.resize(numChunks);
+  }
+
+  void chunkStarted(size_t chunkIndex) {
+    std::lock_guard<std::mutex> lock(chunkMutex_);
+    timeline_.chunkStartTimes[chunkIndex] = steadyTimeNs();
+  }
+
+  void chunkFinished(size_t chunkIndex, std::exception_ptr eptr) {
+    std::unique_lock<std::mutex> lock(chunkMutex_);
+    timeline_.chunkEndTimes[chunkIndex] = steadyTimeNs();
+    if (eptr && !chunkException_) {
+      chunkException_ = eptr;
+    }
+    if (--pendingChunks_ > 0) {
+      return;
+    }
+    auto exception = chunkException_;
+    auto timeline = std::move(timeline_);
+    lock.unlock();
+
+    onComplete_(std::move(timeline));
+    finish(exception);
+  }
+
+  std::vector<at::Tensor> result() override {
+    TORCH_CHECK(
+        isCompleted(),
+        "Work needs to be completed before calling result(). "
+        "Should call wait() before result().");
+    return inputs_;
+  }
+
+ private:
+  std::vector<at::Tensor> inputs_;
+  std::mutex chunkMutex_;
+  size_t pendingChunks_;
+  std::exception_ptr chunkException_;
+  ProcessGroupGloo::AllreduceTimeline timeline_;
+  std::function<void(ProcessGroupGloo::AllreduceTimeline)> onComplete_;
+};
+
+// Allreduces one contiguous chunk of the input of an
+// AsyncChunkedAllreduceWork.
+class AsyncAllreduceChunkWork : public AsyncAllreduceWork {
+ public:
+  AsyncAllreduceChunkWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag,
+      c10::intrusive_ptr<AsyncChunkedAllreduceWork> parent,
+      size_t chunkIndex)
+      : AsyncAllreduceWork(context, inputs, reduceOp, tag),
+        parent(std::move(parent)),
+        chunkIndex(chunkIndex) {}
+
+  void run() override {
+    parent->chunkStarted(chunkIndex);
+    try {
+      AsyncAllreduceWork::run();
+    } catch (...) {
+      parent->chunkFinished(chunkIndex, std::current_exception());
+      throw;
+    }
+    parent->chunkFinished(chunkIndex, nullptr);
+  }
+
+  const c10::intrusive_ptr<AsyncChunkedAllreduceWork> parent;
+  const size_t chunkIndex;
+};
+
 #ifdef USE_CUDA
 
 class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
@@ -1330,6 +1430,13 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
         "(allreduce of sparse tensors only works with ReduceOp.SUM)");
   }
 
+  if (allreduceChunkBytes_ > 0 && device.type() == at::kCPU &&
+      layout == c10::kStrided && inputs.size() == 1 &&
+      inputs[0].is_contiguous() &&
+      inputs[0].numel() * inputs[0].element_size() > allreduceChunkBytes_) {
+    return allreduceChunked(inputs, opts);
+  }
+
   c10::intrusive_ptr<AsyncWork> work;
   auto tag = nextTag();
   auto context = getContext(tag);
@@ -1363,6 +1470,56 @@ c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   return work;
 }
 
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduceChunked(
+    std::vector<at::Tensor>& inputs,
+    const AllreduceOptions& opts) {
+  auto flat = inputs[0].view(-1);
+  const int64_t numel = flat.numel();
+  const int64_t chunkNumel = std::max<int64_t>(
+      1, static_cast<int64_t>(allreduceChunkBytes_ / flat.element_size()));
+  const size_t numChunks = (numel + chunkNumel - 1) / chunkNumel;
+
+  // Reserve the tags of all chunks up front. The number of chunks only
+  // depends on the input size, so the tags match across processes.
+  const auto firstTag = nextTag();
+  AllreduceTimeline timeline;
+  timeline.tag = firstTag;
+  timeline.numBytes = numel * flat.element_size();
+  timeline.enqueueTime = steadyTimeNs();
+  auto parent = c10::make_intrusive<AsyncChunkedAllreduceWork>(
+      inputs, numChunks, std::move(timeline), [this](AllreduceTimeline t) {
+        recordAllreduceTimeline(std::move(t));
+      });
+
+  for (size_t i = 0; i < numChunks; i++) {
+    const auto tag = i == 0 ? firstTag : nextTag();
+    const int64_t offset = i * chunkNumel;
+    std::vector<at::Tensor> chunk = {
+        flat.narrow(0, offset, std::min(chunkNumel, numel - offset))};
+    enqueue(c10::make_intrusive<AsyncAllreduceChunkWork>(
+        getContext(tag), chunk, opts.reduceOp, tag, parent, i));
+  }
+  return parent;
+}
+
+void ProcessGroupGloo::recordAllreduceTimeline(AllreduceTimeline timeline) {
+  std::lock_guard<std::mutex> lock(allreduceTimelinesMutex_);
+  if (allreduceTimelines_.size() == kMaxAllreduceTimelines) {
+    allreduceTimelines_.pop_front();
+  }
+  allreduceTimelines_.push_back(std::move(timeline));
+}
+
+std::vector<ProcessGroupGloo::AllreduceTimeline> ProcessGroupGloo::
+    getAllreduceTimelines() {
+  std::lock_guard<std::mutex> lock(allreduceTimelinesMutex_);
+  std::vector<AllreduceTimeline> timelines(
+      std::make_move_iterator(allreduceTimelines_.begin()),
+      std::make_move_iterator(allreduceTimelines_.end()));
+  allreduceTimelines_.clear();
+  return timelines;
+}
+
 c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce_coalesced(
     std::vector<at::Tensor>& tensors,
     const AllreduceCoalescedOptions& opts) {
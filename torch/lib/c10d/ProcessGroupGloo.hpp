@@ -133,8 +133,31 @@ class ProcessGroupGloo : public ProcessGroup {
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    // If non-zero, dense CPU allreduce calls on a single tensor larger than
+    // this many bytes are split into chunks of (at most) this size. Every
+    // chunk is an independent collective that is queued on the worker
+    // threads and assigned to the contexts in a round-robin fashion, so up to
+    // `threads` chunks of one or more allreduce calls are in flight at the
+    // same time, spread over one context per entry in `devices`.
+    size_t allreduceChunkBytes;
+  };
+
+  // Communication timeline of a chunked allreduce call (see
+  // `Options::allreduceChunkBytes`). All times are in nanoseconds on the
+  // steady clock.
+  struct AllreduceTimeline {
+    // Tag of the first chunk. Identical across processes for the same call.
+    uint32_t tag;
+    size_t numBytes;
+    int64_t enqueueTime;
+    std::vector<int64_t> chunkStartTimes;
+    std::vector<int64_t> chunkEndTimes;
   };
 
+  // Maximum number of timelines retained by `getAllreduceTimelines`.
+  static constexpr size_t kMaxAllreduceTimelines = 1024;
+
   const std::string getBackendName() const override {
       return std::string(GLOO_BACKEND_NAME);
   }
@@ -236,6 +259,10 @@ class ProcessGroupGloo : public ProcessGroup {
   c10::intrusive_ptr<ProcessGroup::Work> barrier(
       const BarrierOptions& opts = BarrierOptions()) override;
 
+  // Returns the timelines of the most recently completed chunked allreduce
+  // calls, oldest first, and clears them.
+  std::vector<AllreduceTimeline> getAllreduceTimelines();
+
  protected:
   std::unique_ptr<::gloo::rendezvous::Store> store_;
 
@@ -245,6 +272,7 @@ class ProcessGroupGloo : public ProcessGroup {
   std::vector<std::shared_ptr<::gloo::Context>> contexts_;
   std::vector<std::thread> threads_;
   bool stop_;
+  const size_t allreduceChunkBytes_;
 
   // Incremented for every collective we kick off.
   // The value is used as tag for collective operations. Collectives are kicked
@@ -277,6 +305,17 @@ class ProcessGroupGloo : public ProcessGroup {
   std::mutex workMutex_;
   std::condition_variable workProduceCV_;
   std::condition_variable workConsumeCV_;
+
+  // Splits a dense CPU allreduce into chunks, see `allreduceChunkBytes_`.
+  c10::intrusive_ptr<ProcessGroup::Work> allreduceChunked(
+      std::vector<at::Tensor>& inputs,
+      const AllreduceOptions& opts);
+
+  // Called by the last chunk of a chunked allreduce to complete.
+  void recordAllreduceTimeline(AllreduceTimeline timeline);
+
+  std::deque<AllreduceTimeline> allreduceTimelines_;
+  std::mutex allreduceTimelinesMutex_;
 };
 
 } // namespace c10d
@@ -0,0 +1,616 @@
+#include <c10d/ProcessGroupHierarchical.hpp>
+
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <atomic>
+#include <climits>
+#include <unordered_map>
+
+#include <TH/THAllocator.h>
+#include <c10/util/Exception.h>
+#include <c10d/PrefixStore.hpp>
+#include <c10d/Utils.hpp>
+
+namespace c10d {
+
+namespace {
+
+// Control block at the beginning of the shared memory segment. The atomics
+// must be lock-free to be usable across processes.
+struct SegmentControl {
+  std::atomic<uint32_t> barrierCount;
+  std::atomic<uint32_t> barrierGeneration;
+  // Number of ranks sleeping until barrierGeneration changes.
+  std::atomic<uint32_t> barrierSleepers;
+};
+
+static_assert(
+    ATOMIC_INT_LOCK_FREE == 2,
+    "ProcessGroupHierarchical requires lock-free 32-bit atomics");
+static_assert(
+    sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+    "ProcessGroupHierarchical waits on atomics as futex words");
+
+// A rank waiting at the local barrier first spins for this many rounds, which
+// is enough for the short waits between the steps of a local collective, and
+// then sleeps, since the leaders may run a long inter-node collective.
+constexpr int kBarrierSpinRounds = 1000;
+
+// Sleeps until *word no longer holds expected, or for at most timeout. The
+// segment is shared between processes, so the futex is not private. May
+// return spuriously.
+void waitForChange(
+    std::atomic<uint32_t>* word,
+    uint32_t expected,
+    std::chrono::milliseconds timeout) {
+#ifdef __linux__
+  struct timespec ts;
+  ts.tv_sec = timeout.count() / 1000;
+  ts.tv_nsec = (timeout.count() % 1000) * 1000000;
+  syscall(
+      SYS_futex,
+      reinterpret_cast<uint32_t*>(word),
+      FUTEX_WAIT,
+      expected,
+      &ts,
+      nullptr,
+      0);
+#else
+  (void)word;
+  (void)expected;
+  std::this_thread::sleep_for(
+      std::min(timeout, std::chrono::milliseconds(1)));
+#endif
+}
+
+void wakeAll(std::atomic<uint32_t>* word) {
+#ifdef __linux__
+  syscall(
+      SYS_futex,
+      reinterpret_cast<uint32_t*>(word),
+      FUTEX_WAKE,
+      INT_MAX,
+      nullptr,
+      nullptr,
+      0);
+#else
+  (void)word;
+#endif
+}
+
+// Keeps the slots aligned to a cache line.
+constexpr size_t kControlBytes = 64;
+static_assert(sizeof(SegmentControl) <= kControlBytes, "");
+
+std::string getHostname() {
+  char hostname[HOST_NAME_MAX + 1];
+  SYSCHECK_ERR_RETURN_NEG1(gethostname(hostname, sizeof(hostname)));
+  hostname[HOST_NAME_MAX] = '\0';
+  return std::string(hostname);
+}
+
+// Returns a shared memory name that is unique on this host.
+std::string newSegmentName() {
+  static std::atomic<uint64_t> counter{0};
+  return "/torch_c10d_hierarchical_" + std::to_string(getpid()) + "_" +
+      std::to_string(counter++);
+}
+
+std::vector<uint8_t> toBytes(const std::string& str) {
+  return std::vector<uint8_t>(str.begin(), str.end());
+}
+
+std::string fromBytes(const std::vector<uint8_t>& bytes) {
+  return std::string(bytes.begin(), bytes.end());
+}
+
+void reduceInto(at::Tensor& dst, const at::Tensor& src, ReduceOp reduceOp) {
+  switch (reduceOp) {
+    case ReduceOp::SUM:
+      dst.add_(src);
+      break;
+    case ReduceOp::PRODUCT:
+      dst.mul_(src);
+      break;
+    case ReduceOp::MIN:
+      at::min_out(dst, dst, src);
+      break;
+    case ReduceOp::MAX:
+      at::max_out(dst, dst, src);
+      break;
+    default:
+      throw std::runtime_error(
+          "ProcessGroupHierarchical does not support this reduction");
+  }
+}
+
+// Checked before enqueuing, so that every rank rejects an unsupported
+// reduction rather than only the ranks that end up reducing data, while the
+// others wait for them in the local barrier.
+void assertReduceOp(
+    const std::function<void(const std::string&)>& fn,
+    ReduceOp reduceOp) {
+  switch (reduceOp) {
+    case ReduceOp::SUM:
+    case ReduceOp::PRODUCT:
+    case ReduceOp::MIN:
+    case ReduceOp::MAX:
+      return;
+    default:
+      fn("unsupported reduction, expected SUM, PRODUCT, MIN or MAX");
+  }
+}
+
+} // namespace
+
+ProcessGroupHierarchical::Options::Options()
+    : bufferBytes(16 * 1024 * 1024),
+      timeout(std::chrono::milliseconds(10 * 1000)),
+      nodeName(getHostname()) {}
+
+ProcessGroupHierarchical::AsyncWork::AsyncWork(
+    std::vector<at::Tensor> outputs,
+    std::function<void()> fn)
+    : ProcessGroup::Work(-1, OpType::UNKNOWN, "hierarchical"),
+      outputs_(std::move(outputs)),
+      fn_(std::move(fn)) {}
+
+std::vector<at::Tensor> ProcessGroupHierarchical::AsyncWork::result() {
+  TORCH_CHECK(
+      isCompleted(),
+      "Work needs to be completed before calling result(). "
+      "Should call wait() before result().");
+  return outputs_;
+}
+
+void ProcessGroupHierarchical::AsyncWork::run() {
+  std::exception_ptr eptr;
+  try {
+    fn_();
+  } catch (...) {
+    eptr = std::current_exception();
+  }
+  fn_ = nullptr;
+  finish(eptr);
+}
+
+ProcessGroupHierarchical::ProcessGroupHierarchical(
+    const c10::intrusive_ptr<Store>& store,
+    int rank,
+    int size,
+    Options options)
+    : ProcessGroup(rank, size),
+      numNodes_(0),
+      nodeIndex_(-1),
+      localRank_(0),
+      localSize_(0),
+      bufferBytes_(options.bufferBytes),
+      timeout_(options.timeout),
+      stop_(false) {
+  TORCH_CHECK(bufferBytes_ > 0, "bufferBytes must be positive");
+
+  // Group the ranks into nodes. Nodes are ordered by their lowest rank, which
+  // is the node leader.
+  store->set("node/" + std::to_string(rank_), toBytes(options.nodeName));
+  std::unordered_map<std::string, int> nodeIndices;
+  for (int r = 0; r < size_; r++) {
+    const auto name = fromBytes(store->get("node/" + std::to_string(r)));
+    auto it = nodeIndices.find(name);
+    if (it == nodeIndices.end()) {
+      it = nodeIndices.emplace(name, numNodes_++).first;
+    }
+    rankNodes_.push_back(it->second);
+  }
+  nodeIndex_ = rankNodes_[rank_];
+  for (int r = 0; r < size_; r++) {
+    if (rankNodes_[r] == nodeIndex_) {
+      if (r < rank_) {
+        localRank_++;
+      }
+      localSize_++;
+    }
+  }
+  const bool isLeader = localRank_ == 0;
+
+  // The leader creates the segment and publishes its name.
+  const auto segmentKey = "segment/" + std::to_string(nodeIndex_);
+  const size_t segmentBytes = kControlBytes + localSize_ * bufferBytes_;
+  if (isLeader) {
+    const auto name = newSegmentName();
+    segment_ = THRefcountedMapAllocator::makeDataPtr(
+        name.c_str(),
+        TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE,
+        segmentBytes,
+        nullptr);
+    new (segment_.get()) SegmentControl();
+    store->set(segmentKey, toBytes(name));
+  } else {
+    const auto name = fromBytes(store->get(segmentKey));
+    segment_ = THRefcountedMapAllocator::makeDataPtr(
+        name.c_str(),
+        TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE,
+        segmentBytes,
+        nullptr);
+  }
+
+  // Make sure every local rank has mapped the segment before returning, so
+  // that the leader is the last one to drop its reference.
+  localBarrier();
+
+  if (isLeader && numNodes_ > 1) {
+    TORCH_CHECK(
+        options.leaderProcessGroupFactory,
+        "ProcessGroupHierarchical requires a leaderProcessGroupFactory ",
+        "when ranks span more than one node");
+    auto leaderStore = c10::make_intrusive<PrefixStore>("leaders", store);
+    leaderProcessGroup_ = options.leaderProcessGroupFactory(
+        leaderStore, nodeIndex_, numNodes_);
+    TORCH_CHECK(leaderProcessGroup_->getRank() == nodeIndex_);
+    TORCH_CHECK(leaderProcessGroup_->getSize() == numNodes_);
+  }
+
+  workerThread_ = std::thread(&ProcessGroupHierarchical::runLoop, this);
+}
+
+ProcessGroupHierarchical::~ProcessGroupHierarchical() {
+  std::unique_lock<std::mutex> lock(workMutex_);
+  workConsumeCV_.wait(lock, [&] { return workQueue_.empty(); });
+
+  // Queue is empty, signal stop
+  stop_ = true;
+
+  // Release lock to allow threads to terminate
+  lock.unlock();
+
+  workProduceCV_.notify_all();
+
+  workerThread_.join();
+}
+
+uint8_t* ProcessGroupHierarchical::slot(int localRank) const {
+  return static_cast<uint8_t*>(segment_.get()) + kControlBytes +
+      localRank * bufferBytes_;
+}
+
+void ProcessGroupHierarchical::localBarrier() {
+  if (localSize_ == 1) {
+    return;
+  }
+
+  // Sense-reversing barrier: the last rank to arrive resets the counter and
+  // bumps the generation, which releases the other ranks.
+  auto* control = static_cast<SegmentControl*>(segment_.get());
+  const auto generation =
+      control->barrierGeneration.load(std::memory_order_acquire);
+  if (control->barrierCount.fetch_add(1, std::memory_order_acq_rel) + 1 ==
+      static_cast<uint32_t>(localSize_)) {
+    control->barrierCount.store(0, std::memory_order_relaxed);
+    // Both this and the increment of barrierSleepers below are sequentially
+    // consistent, so either the sleeper sees the new generation before it
+    // sleeps, or it is seen here and woken up.
+    control->barrierGeneration.fetch_add(1);
+    if (control->barrierSleepers.load() > 0) {
+      wakeAll(&control->barrierGeneration);
+    }
+    return;
+  }
+
+  for (int round = 0; round < kBarrierSpinRounds; ++round) {
+    if (control->barrierGeneration.load(std::memory_order_acquire) !=
+        generation) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+
+  const auto deadline = std::chrono::steady_clock::now() + timeout_;
+  control->barrierSleepers.fetch_add(1);
+  while (control->barrierGeneration.load() == generation) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now > deadline) {
+      control->barrierSleepers.fetch_sub(1);
+      throw std::runtime_error(
+          "ProcessGroupHierarchical: timed out waiting for local ranks");
+    }
+    // Wake up at least every 100ms to check the deadline.
+    waitForChange(
+        &control->barrierGeneration,
+        generation,
+        std::min(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - now) +
+                std::chrono::milliseconds(1),
+            std::chrono::milliseconds(100)));
+  }
+  control->barrierSleepers.fetch_sub(1);
+}
+
+void ProcessGroupHierarchical::runAllreduce(
+    at::Tensor& tensor,
+    ReduceOp reduceOp) {
+  auto flat = tensor.view(-1);
+  const int64_t numel = flat.numel();
+  const int64_t chunkNumel = bufferBytes_ / flat.element_size();
+  TORCH_CHECK(chunkNumel > 0, "bufferBytes is smaller than an element");
+
+  for (int64_t offset = 0; offset < numel; offset += chunkNumel) {
+    const auto n = std::min(chunkNumel, numel - offset);
+    auto input = flat.narrow(0, offset, n);
+    auto slotTensor = [&](int localRank) {
+      return at::from_blob(slot(localRank), {n}, flat.options());
+    };
+
+    slotTensor(localRank_).copy_(input);
+    localBarrier();
+
+    // Every local rank reduces a disjoint part of the slots into slot 0.
+    const auto partNumel = (n + localSize_ - 1) / localSize_;
+    const auto begin = std::min(n, localRank_ * partNumel);
+    const auto length = std::min(partNumel, n - begin);
+    if (length > 0) {
+      auto dst = slotTensor(0).narrow(0, begin, length);
+      for (int r = 1; r < localSize_; r++) {
+        reduceInto(dst, slotTensor(r).narrow(0, begin, length), reduceOp);
+      }
+    }
+    localBarrier();
+
+    if (numNodes_ > 1) {
+      if (leaderProcessGroup_) {
+        std::vector<at::Tensor> tensors = {slotTensor(0)};
+        AllreduceOptions opts;
+        opts.reduceOp = reduceOp;
+        leaderProcessGroup_->allreduce(tensors, opts)->wait();
+      }
+      localBarrier();
+    }
+
+    input.copy_(slotTensor(0));
+    // Slot 0 may only be overwritten once every local rank has read it.
+    localBarrier();
+  }
+}
+
+void ProcessGroupHierarchical::runBroadcast(at::Tensor& tensor, int rootRank) {
+  auto flat = tensor.view(-1);
+  const int64_t numel = flat.numel();
+  const int64_t chunkNumel = bufferBytes_ / flat.element_size();
+  TORCH_CHECK(chunkNumel > 0, "bufferBytes is smaller than an element");
+
+  for (int64_t offset = 0; offset < numel; offset += chunkNumel) {
+    const auto n = std::min(chunkNumel, numel - offset);
+    auto input = flat.narrow(0, offset, n);
+    auto buffer = at::from_blob(slot(0), {n}, flat.options());
+
+    if (rank_ == rootRank) {
+      buffer.copy_(input);
+    }
+    localBarrier();
+
+    if (numNodes_ > 1) {
+      if (leaderProcessGroup_) {
+        std::vector<at::Tensor> tensors = {buffer};
+        BroadcastOptions opts;
+        opts.rootRank = rankNodes_[rootRank];
+        leaderProcessGroup_->broadcast(tensors, opts)->wait();
+      }
+      localBarrier();
+    }
+
+    if (rank_ != rootRank) {
+      input.copy_(buffer);
+    }
+    localBarrier();
+  }
+}
+
+void ProcessGroupHierarchical::runLoop() {
+  std::unique_lock<std::mutex> lock(workMutex_);
+
+  while (!stop_) {
+    if (workQueue_.empty()) {
+      workProduceCV_.wait(lock);
+      continue;
+    }
+
+    auto work = std::move(workQueue_.front());
+    workQueue_.pop_front();
+    lock.unlock();
+
+    // Notify after releasing the lock so that the waiter
+    // does not immediately block.
+    workConsumeCV_.notify_one();
+
+    work->run();
+    lock.lock();
+  }
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::enqueue(
+    std::vector<at::Tensor> outputs,
+    std::function<void()> fn) {
+  auto work =
+      c10::make_intrusive<AsyncWork>(std::move(outputs), std::move(fn));
+  std::unique_lock<std::mutex> lock(workMutex_);
+  workQueue_.push_back(work);
+  lock.unlock();
+
+  // Notify after releasing the lock so that the waiter
+  // does not immediately block.
+  workProduceCV_.notify_one();
+  return work;
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::broadcast(
+    std::vector<at::Tensor>& tensors,
+    const BroadcastOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupHierarchical::broadcast: " + msg);
+  };
+  assertSingleElement(invalidArgument, tensors);
+  assertDense(invalidArgument, tensors);
+  assertCPU(invalidArgument, tensors);
+  assertRootRank(invalidArgument, opts.rootRank, size_);
+
+  auto tensor = tensors[0];
+  const auto rootRank = opts.rootRank;
+  return enqueue(tensors, [this, tensor, rootRank]() mutable {
+    auto contiguous = tensor.contiguous();
+    runBroadcast(contiguous, rootRank);
+    if (!contiguous.is_same(tensor)) {
+      tensor.copy_(contiguous);
+    }
+  });
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allreduce(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupHierarchical::allreduce: " + msg);
+  };
+  assertSingleElement(invalidArgument, tensors);
+  assertDense(invalidArgument, tensors);
+  assertCPU(invalidArgument, tensors);
+  assertReduceOp(invalidArgument, opts.reduceOp);
+
+  auto tensor = tensors[0];
+  const auto reduceOp = opts.reduceOp;
+  return enqueue(tensors, [this, tensor, reduceOp]() mutable {
+    auto contiguous = tensor.contiguous();
+    runAllreduce(contiguous, reduceOp);
+    if (!contiguous.is_same(tensor)) {
+      tensor.copy_(contiguous);
+    }
+  });
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    allreduce_coalesced(
+        std::vector<at::Tensor>& tensors,
+        const AllreduceCoalescedOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument(
+        "ProcessGroupHierarchical::allreduce_coalesced: " + msg);
+  };
+  assertNonEmpty(invalidArgument, tensors);
+  assertDense(invalidArgument, tensors);
+  assertCPU(invalidArgument, tensors);
+  assertReduceOp(invalidArgument, opts.reduceOp);
+
+  const auto reduceOp = opts.reduceOp;
+  return enqueue(tensors, [this, tensors, reduceOp]() mutable {
+    auto coalesced = flattenDenseTensors(tensors);
+    runAllreduce(coalesced, reduceOp);
+    int64_t offset = 0;
+    for (auto& tensor : tensors) {
+      tensor.copy_(
+          coalesced.narrow(0, offset, tensor.numel()).view_as(tensor));
+      offset += tensor.numel();
+    }
+  });
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::barrier(
+    const BarrierOptions& /* unused */) {
+  return enqueue({}, [this]() {
+    localBarrier();
+    if (leaderProcessGroup_) {
+      leaderProcessGroup_->barrier()->wait();
+    }
+    localBarrier();
+  });
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::reduce(
+    std::vector<at::Tensor>& /* unused */,
+    const ReduceOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support reduce");
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::allgather(
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    std::vector<at::Tensor>& /* unused */,
+    const AllgatherOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupHierarchical does not support allgather");
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    allgather_base(
+        at::Tensor& /* unused */,
+        at::Tensor& /* unused */,
+        const AllgatherOptions& /* unused */) {
+  throw std::runtime_error(
+      "no support for allgather_base in Hierarchical process group");
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    allgather_coalesced(
+        std::vector<std::vector<at::Tensor>>& /* unused */,
+        std::vector<at::Tensor>& /* unused */,
+        const AllgatherOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupHierarchical does not support allgather_coalesced");
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::gather(
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    std::vector<at::Tensor>& /* unused */,
+    const GatherOptions& /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support gather");
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::scatter(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<std::vector<at::Tensor>>& /* unused */,
+    const ScatterOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupHierarchical does not support scatter");
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    reduce_scatter(
+        std::vector<at::Tensor>& /* unused */,
+        std::vector<std::vector<at::Tensor>>& /* unused */,
+        const ReduceScatterOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupHierarchical does not support reduce_scatter");
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::alltoall_base(
+    at::Tensor& /* unused */,
+    at::Tensor& /* unused */,
+    std::vector<int64_t>& /* unused */,
+    std::vector<int64_t>& /* unused */,
+    const AllToAllOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupHierarchical does not support alltoall");
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::send(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support send");
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::recv(
+    std::vector<at::Tensor>& /* unused */,
+    int /* unused */,
+    int /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support recv");
+}
+
+c10::intrusive_ptr<ProcessGroup::Work> ProcessGroupHierarchical::
+    recvAnysource(
+        std::vector<at::Tensor>& /* unused */,
+        int /* unused */) {
+  throw std::runtime_error("ProcessGroupHierarchical does not support recv");
+}
+
+} // namespace c10d
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <c10d/ProcessGroup.hpp>
+#include <c10d/Store.hpp>
+#include <c10d/Types.hpp>
+
+namespace c10d {
+
+constexpr const char* HIERARCHICAL_BACKEND_NAME = "hierarchical";
+
+// ProcessGroupHierarchical implements two-level collectives for CPU tensors.
+//
+// Ranks are grouped into nodes by hostname. Within a node, ranks exchange
+// data through a shared memory segment that is created by the node leader
+// (the lowest rank on the node). Collectives are executed in three steps:
+//
+//   1) every local rank copies its input into its slot of the segment, and
+//      the slots are reduced in parallel, each local rank reducing a disjoint
+//      part of the buffer,
+//   2) the node leaders run the collective over the reduced buffer with a
+//      separate process group that only contains the leaders,
+//   3) every local rank copies the result out of the segment.
+//
+// Tensors larger than `Options::bufferBytes` are processed in several rounds.
+//
+// The leader process group is created by `Options::leaderProcessGroupFactory`
+// on the leaders only, with rank equal to the node index and size equal to
+// the number of nodes. It can be any process group, e.g. a
+// ProcessGroupRoundRobin over several ProcessGroupGloo instances. Conversely,
+// several ProcessGroupHierarchical instances can be combined by a
+// ProcessGroupRoundRobin, since each of them has its own segment.
+//
+// All functions on this class are expected to be called in the same order
+// across processes in the group.
+//
+class ProcessGroupHierarchical : public ProcessGroup {
+ public:
+  using ProcessGroupFactory = std::function<c10::intrusive_ptr<ProcessGroup>(
+      const c10::intrusive_ptr<Store>& store,
+      int rank,
+      int size)>;
+
+  struct Options {
+    explicit Options();
+
+    // Creates the process group among node leaders.
+    ProcessGroupFactory leaderProcessGroupFactory;
+
+    // Capacity in bytes of the slot of every local rank in the shared memory
+    // segment.
+    size_t bufferBytes;
+
+    // Timeout for waiting on the other local ranks.
+    std::chrono::milliseconds timeout;
+
+    // Name used to group ranks into nodes. Defaults to the hostname.
+    std::string nodeName;
+  };
+
+  class AsyncWork : public ProcessGroup::Work {
+   public:
+    explicit AsyncWork(std::vector<at::Tensor> outputs, std::function<void()> fn);
+
+    std::vector<at::Tensor> result() override;
+
+   protected:
+    friend class ProcessGroupHierarchical;
+
+    void run();
+
+    std::vector<at::Tensor> outputs_;
+    std::function<void()> fn_;
+  };
+
+  explicit ProcessGroupHierarchical(
+      const c10::intrusive_ptr<Store>& store,
+      int rank,
+      int size,
+      Options options);
+
+  ~ProcessGroupHierarchical() override;
+
+  const std::string getBackendName() const override {
+    return std::string(HIERARCHICAL_BACKEND_NAME);
+  }
+
+  int getNumNodes() const {
+    return numNodes_;
+  }
+
+  int getNodeIndex() const {
+    return nodeIndex_;
+  }
+
+  int getLocalRank() const {
+    return localRank_;
+  }
+
+  int getLocalSize() const {
+    return localSize_;
+  }
+
+  c10::intrusive_ptr<ProcessGroup::Work> broadcast(
+      std::vector<at::Tensor>& tensors,
+      const BroadcastOptions& opts = BroadcastOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> allreduce(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceOptions& opts = AllreduceOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> allreduce_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceCoalescedOptions& opts =
+          AllreduceCoalescedOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> reduce(
+      std::vector<at::Tensor>& tensors,
+      const ReduceOptions& opts = ReduceOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> allgather(
+      std::vector<std::vector<at::Tensor>>& outputs,
+      std::vector<at::Tensor>& inputs,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> allgather_base(
+      at::Tensor& outputBuffer,
+      at::Tensor& inputBuffer,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> allgather_coalesced(
+      std::vector<std::vector<at::Tensor>>& outputTensorLists,
+      std::vector<at::Tensor>& inputTensors,
+      const AllgatherOptions& opts = AllgatherOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> gather(
+      std::vector<std::vector<at::Tensor>>& outputs,
+      std::vector<at::Tensor>& inputs,
+      const GatherOptions& opts = GatherOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> scatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      const ScatterOptions& opts = ScatterOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> reduce_scatter(
+      std::vector<at::Tensor>& outputs,
+      std::vector<std::vector<at::Tensor>>& inputs,
+      const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> alltoall_base(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputSplitSizes,
+      std::vector<int64_t>& inputSplitSizes,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> send(
+      std::vector<at::Tensor>& tensors,
+      int dstRank,
+      int tag) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> recv(
+      std::vector<at::Tensor>& tensors,
+      int srcRank,
+      int tag) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> recvAnysource(
+      std::vector<at::Tensor>& tensors,
+      int tag) override;
+
+  c10::intrusive_ptr<ProcessGroup::Work> barrier(
+      const BarrierOptions& opts = BarrierOptions()) override;
+
+ protected:
+  // Grouping of ranks into nodes.
+  int numNodes_;
+  int nodeIndex_;
+  int localRank_;
+  int localSize_;
+  // Node index of every rank.
+  std::vector<int> rankNodes_;
+
+  // Only set on node leaders.
+  c10::intrusive_ptr<ProcessGroup> leaderProcessGroup_;
+
+  // Shared memory segment: a control block followed by `localSize_` slots of
+  // `bufferBytes_` bytes each.
+  at::DataPtr segment_;
+  size_t bufferBytes_;
+  std::chrono::milliseconds timeout_;
+
+  // Blocks until all local ranks have reached the barrier.
+  void localBarrier();
+
+  // Returns a pointer to the slot of the given local rank.
+  uint8_t* slot(int localRank) const;
+
+  void runAllreduce(at::Tensor& tensor, ReduceOp reduceOp);
+  void runBroadcast(at::Tensor& tensor, int rootRank);
+
+  // Collectives run on a single background thread in order of submission,
+  // like ProcessGroupGloo with one thread.
+  void runLoop();
+  c10::intrusive_ptr<ProcessGroup::Work> enqueue(
+      std::vector<at::Tensor> outputs,
+      std::function<void()> fn);
+
+  std::deque<c10::intrusive_ptr<AsyncWork>> workQueue_;
+  std::mutex workMutex_;
+  std::condition_variable workProduceCV_;
+  std::condition_variable workConsumeCV_;
+  bool stop_;
+  std::thread workerThread_;
+};
+
+} // namespace c10d
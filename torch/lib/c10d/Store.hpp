@@ -51,6 +51,16 @@ class Store : public torch::CustomClassHolder {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Batched versions of `set` and `get`. Stores that can serve several keys
+  // in one round trip should override them; the default implementations
+  // issue one request per key.
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
@@ -8,6 +8,10 @@
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
 #include <algorithm>
 #include <fcntl.h>
 #include <system_error>
@@ -24,13 +28,21 @@ enum class QueryType : uint8_t {
   CHECK,
   WAIT,
   GETNUMKEYS,
-  DELETE_KEY
+  DELETE_KEY,
+  MULTI_SET,
+  MULTI_GET,
+  WATCH_KEY
 };
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
 enum class WaitResponseType : uint8_t { STOP_WAITING };
 
+#ifdef __linux__
+// Maximum number of events returned by a single epoll_wait call.
+constexpr int kMaxEpollEvents = 256;
+#endif
+
 } // anonymous namespace
 
 // TCPStoreDaemon class methods
@@ -81,30 +93,7 @@ void TCPStoreDaemon::queryFds(std::vector<struct pollfd>& fds) {
       // exception, other connections will get an exception once they try to
       // use the store. We will go ahead and close this connection whenever
       // we hit an exception here.
-      tcputil::closeSocket(fds[fdIdx].fd);
-
-      // Remove all the tracking state of the close FD
-      for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-        for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-          if (*vecIt == fds[fdIdx].fd) {
-            vecIt = it->second.erase(vecIt);
-          } else {
-            ++vecIt;
-          }
-        }
-        if (it->second.size() == 0) {
-          it = waitingSockets_.erase(it);
-        } else {
-          ++it;
-        }
-      }
-      for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-        if (it->first == fds[fdIdx].fd) {
-          it = keysAwaited_.erase(it);
-        } else {
-          ++it;
-        }
-      }
+      cleanupSocket(fds[fdIdx].fd);
       fds.erase(fds.begin() + fdIdx);
       sockets_.erase(sockets_.begin() + fdIdx - CONNECT_SOCKET_OFFSET);
       --fdIdx;
@@ -113,11 +102,52 @@ void TCPStoreDaemon::queryFds(std::vector<struct pollfd>& fds) {
   }
 }
 
+void TCPStoreDaemon::cleanupSocket(int socket) {
+  tcputil::closeSocket(socket);
+
+  // Remove all the tracking state of the close FD
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
+      if (*vecIt == socket) {
+        vecIt = it->second.erase(vecIt);
+      } else {
+        ++vecIt;
+      }
+    }
+    if (it->second.size() == 0) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  keysAwaited_.erase(socket);
+  pendingMultiGets_.erase(socket);
+  for (auto it = watchingSockets_.begin(); it != watchingSockets_.end();) {
+    auto& watchers = it->second;
+    watchers.erase(
+        std::remove_if(
+            watchers.begin(),
+            watchers.end(),
+            [socket](const std::pair<int, std::vector<uint8_t>>& watcher) {
+              return watcher.first == socket;
+            }),
+        watchers.end());
+    if (watchers.empty()) {
+      it = watchingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of wait, check and multi get
 // type of query | number of args | size of arg1 | arg1 | ...
+// or, in the case of multi set
+// type of query | number of keys | size of key1 | key1 | size of value1 |
+// value1 | ...
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
   tcputil::recvBytes<QueryType>(socket, &qt, 1);
@@ -146,6 +176,15 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::DELETE_KEY) {
     deleteHandler(socket);
 
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
+  } else if (qt == QueryType::WATCH_KEY) {
+    watchHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
@@ -153,14 +192,49 @@ void TCPStoreDaemon::query(int socket) {
 
 void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
   auto socketsToWait = waitingSockets_.find(key);
-  if (socketsToWait != waitingSockets_.end()) {
-    for (int socket : socketsToWait->second) {
-      if (--keysAwaited_[socket] == 0) {
+  if (socketsToWait == waitingSockets_.end()) {
+    return;
+  }
+  // Re-parked multi gets add entries to waitingSockets_
+  auto sockets = std::move(socketsToWait->second);
+  waitingSockets_.erase(socketsToWait);
+  for (int socket : sockets) {
+    if (--keysAwaited_[socket] == 0) {
+      auto pending = pendingMultiGets_.find(socket);
+      if (pending != pendingMultiGets_.end()) {
+        auto keys = std::move(pending->second);
+        pendingMultiGets_.erase(pending);
+        // The keys that were present when the multi get was parked may have
+        // been deleted since
+        answerOrParkMultiGet(socket, std::move(keys));
+      } else {
         tcputil::sendValue<WaitResponseType>(
             socket, WaitResponseType::STOP_WAITING);
       }
     }
-    waitingSockets_.erase(socketsToWait);
+  }
+}
+
+void TCPStoreDaemon::notifyWatchers(const std::string& key) {
+  auto watchersIt = watchingSockets_.find(key);
+  auto valueIt = tcpStore_.find(key);
+  if (watchersIt == watchingSockets_.end() || valueIt == tcpStore_.end()) {
+    return;
+  }
+  // Watchers that have already seen the current value keep waiting.
+  auto& watchers = watchersIt->second;
+  auto it = std::partition(
+      watchers.begin(),
+      watchers.end(),
+      [&](const std::pair<int, std::vector<uint8_t>>& watcher) {
+        return watcher.second == valueIt->second;
+      });
+  for (auto notifyIt = it; notifyIt != watchers.end(); ++notifyIt) {
+    tcputil::sendVector<uint8_t>(notifyIt->first, valueIt->second);
+  }
+  watchers.erase(it, watchers.end());
+  if (watchers.empty()) {
+    watchingSockets_.erase(watchersIt);
   }
 }
 
@@ -169,6 +243,7 @@ void TCPStoreDaemon::setHandler(int socket) {
   tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
   // On "set", wake up all clients that have been waiting
   wakeupWaitingClients(key);
+  notifyWatchers(key);
 }
 
 void TCPStoreDaemon::compareSetHandler(int socket) {
@@ -182,6 +257,7 @@ void TCPStoreDaemon::compareSetHandler(int socket) {
   if (it != tcpStore_.end() && it->second == currentValue) {
     it->second = newValue;
     tcputil::sendVector<uint8_t>(socket, newValue);
+    notifyWatchers(key);
   } else {
     tcputil::sendVector<uint8_t>(socket, currentValue);
   }
@@ -202,11 +278,12 @@ void TCPStoreDaemon::addHandler(int socket) {
   tcputil::sendValue<int64_t>(socket, addVal);
   // On "add", wake up all clients that have been waiting
   wakeupWaitingClients(key);
+  notifyWatchers(key);
 }
 
 void TCPStoreDaemon::getHandler(int socket) const {
   std::string key = tcputil::recvString(socket);
-  auto data = tcpStore_.at(key);
+  const auto& data = tcpStore_.at(key);
   tcputil::sendVector<uint8_t>(socket, data);
 }
 
@@ -253,6 +330,69 @@ void TCPStoreDaemon::waitHandler(int socket) {
   }
 }
 
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  for (size_t i = 0; i < nargs; i++) {
+    std::string key = tcputil::recvString(socket);
+    tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+    wakeupWaitingClients(key);
+    notifyWatchers(key);
+  }
+}
+
+// Waits for all the keys to be set and returns their values, so that a multi
+// get takes a single round trip.
+void TCPStoreDaemon::multiGetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+  }
+  answerOrParkMultiGet(socket, std::move(keys));
+}
+
+// Sends the values of the keys if they are all set, or waits for the missing
+// ones to be set.
+void TCPStoreDaemon::answerOrParkMultiGet(
+    int socket,
+    std::vector<std::string> keys) {
+  size_t numMissing = 0;
+  for (const auto& key : keys) {
+    if (tcpStore_.count(key) == 0) {
+      waitingSockets_[key].push_back(socket);
+      ++numMissing;
+    }
+  }
+  if (numMissing == 0) {
+    sendValues(socket, keys);
+  } else {
+    keysAwaited_[socket] = numMissing;
+    pendingMultiGets_[socket] = std::move(keys);
+  }
+}
+
+void TCPStoreDaemon::sendValues(
+    int socket,
+    const std::vector<std::string>& keys) const {
+  for (size_t i = 0; i < keys.size(); i++) {
+    tcputil::sendVector<uint8_t>(
+        socket, tcpStore_.at(keys[i]), (i != (keys.size() - 1)));
+  }
+}
+
+void TCPStoreDaemon::watchHandler(int socket) {
+  std::string key = tcputil::recvString(socket);
+  std::vector<uint8_t> lastValue = tcputil::recvVector<uint8_t>(socket);
+  auto it = tcpStore_.find(key);
+  if (it != tcpStore_.end() && it->second != lastValue) {
+    tcputil::sendVector<uint8_t>(socket, it->second);
+  } else {
+    watchingSockets_[key].emplace_back(socket, std::move(lastValue));
+  }
+}
+
 bool TCPStoreDaemon::checkKeys(const std::vector<std::string>& keys) const {
   return std::all_of(keys.begin(), keys.end(), [this](const std::string& s) {
     return tcpStore_.count(s) > 0;
@@ -342,6 +482,78 @@ void TCPStoreDaemon::stop() {
   }
 }
 
+#ifdef __linux__
+// Uses epoll, so that the cost of every iteration only depends on the number
+// of sockets with pending queries rather than on the number of connections.
+void TCPStoreDaemon::run() {
+  int epollFd;
+  SYSCHECK_ERR_RETURN_NEG1(epollFd = ::epoll_create1(EPOLL_CLOEXEC));
+  auto addEpollFd = [epollFd](int fd, uint32_t events) {
+    struct epoll_event event = {};
+    event.events = events;
+    event.data.fd = fd;
+    SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event));
+  };
+  addEpollFd(storeListenSocket_, EPOLLIN);
+  // Push the read end of the pipe to signal the stopping of the daemon run
+  addEpollFd(controlPipeFd_[0], EPOLLIN);
+
+  std::vector<struct epoll_event> events(kMaxEpollEvents);
+  // receive the queries
+  bool finished = false;
+  while (!finished) {
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents = ::epoll_wait(epollFd, events.data(), events.size(), -1));
+
+    for (int i = 0; i < numEvents; i++) {
+      const int fd = events[i].data.fd;
+      const uint32_t revents = events[i].events;
+
+      // TCPStore's listening socket has an event and it should now be able
+      // to accept new connections.
+      if (fd == storeListenSocket_) {
+        if (revents ^ EPOLLIN) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the master's listening socket: " +
+                  std::to_string(revents));
+        }
+        int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
+        sockets_.push_back(sockFd);
+        addEpollFd(sockFd, EPOLLIN);
+        continue;
+      }
+
+      // The pipe receives an event which tells us to shutdown the daemon
+      if (fd == controlPipeFd_[0]) {
+        // Will be EPOLLHUP when the pipe is closed
+        if (revents ^ EPOLLHUP) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the control pipe's reading fd: " +
+                  std::to_string(revents));
+        }
+        finished = true;
+        break;
+      }
+
+      // Now query the socket that has the event
+      try {
+        query(fd);
+      } catch (...) {
+        // See queryFds for why the connection is closed on any error.
+        // Closing the socket also removes it from the epoll set.
+        cleanupSocket(fd);
+        sockets_.erase(std::find(sockets_.begin(), sockets_.end(), fd));
+      }
+    }
+  }
+  ::close(epollFd);
+}
+#else
 void TCPStoreDaemon::run() {
   std::vector<struct pollfd> fds;
   tcputil::addPollfd(fds, storeListenSocket_, POLLIN);
@@ -389,6 +601,7 @@ void TCPStoreDaemon::run() {
   }
 }
 #endif
+#endif
 
 // TCPStore class methods
 TCPStore::TCPStore(
@@ -432,30 +645,50 @@ TCPStore::~TCPStore() {
 }
 
 void TCPStore::waitForWorkers() {
-  addHelper_(initKey_, 1);
+  auto numWorkersCompleted = addHelper_(initKey_, 1);
   // Let server block until all workers have completed, this ensures that
   // the server daemon thread is always running until the very end
   if (isServer_) {
+    // Every join updates the counter, which notifies the watch, so the
+    // server does not need to poll the daemon.
     const auto start = std::chrono::steady_clock::now();
-    while (true) {
-      std::vector<uint8_t> value = getHelper_(initKey_);
-      auto buf = reinterpret_cast<const char*>(value.data());
-      auto len = value.size();
-      int numWorkersCompleted = std::stoi(std::string(buf, len));
-      if (numWorkersCompleted >= numWorkers_) {
-        break;
+    auto addValStr = std::to_string(numWorkersCompleted);
+    std::vector<uint8_t> value(addValStr.begin(), addValStr.end());
+    while (numWorkersCompleted < numWorkers_) {
+      auto remaining = kNoTimeout;
+      if (timeout_ != kNoTimeout) {
+        const auto elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+        if (elapsed >= timeout_) {
+          break;
+        }
+        remaining = timeout_ - elapsed;
       }
-      const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-          std::chrono::steady_clock::now() - start);
-      if (timeout_ != kNoTimeout && elapsed > timeout_) {
+      try {
+        value = watchHelper_(initKey_, value, remaining);
+      } catch (const std::system_error&) {
+        throw;
+      } catch (const std::runtime_error&) {
+        // The watch timed out and its response is still pending on the
+        // connection, so the connection cannot be reused.
+        reconnect();
         break;
       }
-      /* sleep override */
-      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      auto buf = reinterpret_cast<const char*>(value.data());
+      auto len = value.size();
+      numWorkersCompleted = std::stoi(std::string(buf, len));
     }
   }
 }
 
+void TCPStore::reconnect() {
+  tcputil::closeSocket(storeSocket_);
+  storeSocket_ = tcputil::connect(
+      tcpStoreAddr_, tcpStorePort_, /* wait= */ true, timeout_);
+  setReceiveTimeout(timeout_);
+}
+
 void TCPStore::set(const std::string& key, const std::vector<uint8_t>& data) {
   std::string regKey = regularPrefix_ + key;
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::SET);
@@ -545,25 +778,108 @@ void TCPStore::wait(
   waitHelper_(regKeys, timeout);
 }
 
-void TCPStore::waitHelper_(
+void TCPStore::multiSet(
     const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  TORCH_CHECK(
+      keys.size() == values.size(),
+      "multiSet expects the same number of keys and values");
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    std::string regKey = regularPrefix_ + keys[i];
+    tcputil::sendString(storeSocket_, regKey, true);
+    tcputil::sendVector<uint8_t>(
+        storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    regKeys[i] = regularPrefix_ + keys[i];
+  }
+  // The daemon waits for all the keys before it replies.
+  setReceiveTimeout(timeout_);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET);
+  SizeType nkeys = regKeys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regKeys[i], (i != (nkeys - 1)));
+  }
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(nkeys);
+  try {
+    for (size_t i = 0; i < nkeys; i++) {
+      values.emplace_back(tcputil::recvVector<uint8_t>(storeSocket_));
+    }
+  } catch (const std::system_error&) {
+    throw;
+  } catch (const std::runtime_error&) {
+    // Like a timed out watch, the reply is still pending on the daemon.
+    reconnect();
+    throw;
+  }
+  return values;
+}
+
+std::vector<uint8_t> TCPStore::watchKey(
+    const std::string& key,
+    const std::vector<uint8_t>& lastValue,
     const std::chrono::milliseconds& timeout) {
-  // Set the socket timeout if there is a wait timeout
-  if (timeout != kNoTimeout) {
+  std::string regKey = regularPrefix_ + key;
+  try {
+    return watchHelper_(regKey, lastValue, timeout);
+  } catch (const std::system_error&) {
+    throw;
+  } catch (const std::runtime_error&) {
+    // A timed out watch is still registered on the daemon, so its response
+    // would be mistaken for the reply of the next request.
+    reconnect();
+    throw;
+  }
+}
+
+std::vector<uint8_t> TCPStore::watchHelper_(
+    const std::string& key,
+    const std::vector<uint8_t>& lastValue,
+    const std::chrono::milliseconds& timeout) {
+  setReceiveTimeout(timeout);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::WATCH_KEY);
+  tcputil::sendString(storeSocket_, key, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, lastValue);
+  auto value = tcputil::recvVector<uint8_t>(storeSocket_);
+  // Later requests must not be bound by the timeout of this watch.
+  if (timeout != timeout_) {
+    setReceiveTimeout(timeout_);
+  }
+  return value;
+}
+
+void TCPStore::setReceiveTimeout(const std::chrono::milliseconds& timeout) {
+  // A zero timeval disables the timeout.
+  const auto count = timeout == kNoTimeout ? 0 : timeout.count();
 #ifdef _WIN32
-    struct timeval timeoutTV = {timeout.count() / 1000,
-                                (timeout.count() % 1000) * 1000};
+  struct timeval timeoutTV = {count / 1000, (count % 1000) * 1000};
 #else
-    struct timeval timeoutTV = {.tv_sec = timeout.count() / 1000,
-                                .tv_usec = (timeout.count() % 1000) * 1000};
+  struct timeval timeoutTV = {.tv_sec = count / 1000,
+                              .tv_usec = (count % 1000) * 1000};
 #endif
-    SYSCHECK_ERR_RETURN_NEG1(::setsockopt(
-        storeSocket_,
-        SOL_SOCKET,
-        SO_RCVTIMEO,
-        reinterpret_cast<char*>(&timeoutTV),
-        sizeof(timeoutTV)));
-  }
+  SYSCHECK_ERR_RETURN_NEG1(::setsockopt(
+      storeSocket_,
+      SOL_SOCKET,
+      SO_RCVTIMEO,
+      reinterpret_cast<char*>(&timeoutTV),
+      sizeof(timeoutTV)));
+}
+
+void TCPStore::waitHelper_(
+    const std::vector<std::string>& keys,
+    const std::chrono::milliseconds& timeout) {
+  setReceiveTimeout(timeout);
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::WAIT);
   SizeType nkeys = keys.size();
   tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
@@ -27,6 +27,8 @@ class TCPStoreDaemon {
 
   void queryFds(std::vector<struct pollfd>& fds);
   void query(int socket);
+  // Drops all the waits and watches registered by a closed connection.
+  void cleanupSocket(int socket);
 
   void setHandler(int socket);
   void compareSetHandler(int socket);
@@ -36,9 +38,15 @@ class TCPStoreDaemon {
   void getNumKeysHandler(int socket) const;
   void deleteHandler(int socket);
   void waitHandler(int socket);
+  void multiSetHandler(int socket);
+  void multiGetHandler(int socket);
+  void watchHandler(int socket);
 
   bool checkKeys(const std::vector<std::string>& keys) const;
+  void answerOrParkMultiGet(int socket, std::vector<std::string> keys);
+  void sendValues(int socket, const std::vector<std::string>& keys) const;
   void wakeupWaitingClients(const std::string& key);
+  void notifyWatchers(const std::string& key);
 
   void initStopSignal();
   void closeStopSignal();
@@ -49,6 +57,13 @@ class TCPStoreDaemon {
   std::unordered_map<std::string, std::vector<int>> waitingSockets_;
   // From socket -> number of keys awaited
   std::unordered_map<int, size_t> keysAwaited_;
+  // From socket -> the keys of its multi get, answered once they are all set
+  std::unordered_map<int, std::vector<std::string>> pendingMultiGets_;
+  // From key -> the sockets watching it, with the last value they have seen
+  std::unordered_map<
+      std::string,
+      std::vector<std::pair<int, std::vector<uint8_t>>>>
+      watchingSockets_;
 
   std::vector<int> sockets_;
   int storeListenSocket_;
@@ -96,6 +111,24 @@ class TCPStore : public Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) override;
 
+  // Sets all the keys with a single request.
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  // Waits for all the keys and fetches them with a single request.
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
+  // Blocks until `key` exists with a value different from `lastValue`, and
+  // returns that value. The daemon notifies the client as soon as the key is
+  // updated, so this replaces polling loops of `get`. Throws if the timeout
+  // expires.
+  std::vector<uint8_t> watchKey(
+      const std::string& key,
+      const std::vector<uint8_t>& lastValue,
+      const std::chrono::milliseconds& timeout);
+
   // Waits for all workers to join.
   void waitForWorkers();
 
@@ -108,6 +141,14 @@ class TCPStore : public Store {
   void waitHelper_(
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout);
+  std::vector<uint8_t> watchHelper_(
+      const std::string& key,
+      const std::vector<uint8_t>& lastValue,
+      const std::chrono::milliseconds& timeout);
+  void setReceiveTimeout(const std::chrono::milliseconds& timeout);
+  // Replaces the connection to the daemon, e.g. after a timed out request
+  // left a response pending on the old one.
+  void reconnect();
 
   bool isServer_;
   int storeSocket_ = -1;
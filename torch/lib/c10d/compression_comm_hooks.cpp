@@ -0,0 +1,551 @@
+#include <c10d/compression_comm_hooks.hpp>
+
+#include <cmath>
+#include <limits>
+
+#include <ATen/CPUGeneratorImpl.h>
+#include <ATen/ThreadLocalState.h>
+#include <c10/util/Logging.h>
+#include <c10d/comm.hpp>
+#include <c10d/ProcessGroup.hpp>
+#include <torch/torch.h>
+
+namespace c10d {
+
+namespace {
+
+// The hooks run on the communication thread of their state, so they can wait
+// for their collectives without blocking the backward pass.
+void allreduceAndWait(
+    ProcessGroup* processGroup,
+    at::Tensor& tensor,
+    ReduceOp reduceOp = ReduceOp::SUM) {
+  std::vector<at::Tensor> tensors = {tensor};
+  AllreduceOptions opts;
+  opts.reduceOp = reduceOp;
+  processGroup->allreduce(tensors, opts)->wait();
+}
+
+std::vector<at::Tensor> allgatherAndWait(
+    ProcessGroup* processGroup,
+    const at::Tensor& tensor) {
+  std::vector<std::vector<at::Tensor>> outputs(1);
+  outputs[0].reserve(processGroup->getSize());
+  for (int i = 0; i < processGroup->getSize(); ++i) {
+    outputs[0].push_back(at::empty_like(tensor));
+  }
+  std::vector<at::Tensor> inputs = {tensor};
+  processGroup->allgather(outputs, inputs)->wait();
+  return std::move(outputs[0]);
+}
+
+// Used before `startIter` is reached.
+at::Tensor vanillaAllreduce(GradCompressionState& state, GradBucket& bucket) {
+  auto& tensor = bucket.getTensorsRef()[0];
+  allreduceAndWait(state.getProcessGroup(), tensor);
+  tensor.div_(state.getProcessGroup()->getSize());
+  state.maybeIncreaseIter(bucket);
+  return tensor;
+}
+
+// Adds the error of the previous iteration to the bucket. Returns true if the
+// caller should record the new error in `bucketState.error`.
+bool applyErrorFeedback(
+    const GradCompressionState& state,
+    CompressionBucketState& bucketState,
+    at::Tensor& tensor) {
+  if (!state.getOptions().useErrorFeedback) {
+    return false;
+  }
+  if (bucketState.error.defined() &&
+      bucketState.error.numel() == tensor.numel()) {
+    tensor.add_(bucketState.error);
+  } else {
+    LOG(INFO) << "A zero tensor of length " << tensor.numel()
+              << " that represents local error is created.";
+    bucketState.error = at::zeros_like(tensor);
+  }
+  return true;
+}
+
+// Applies the Gram-Schmidt procedure to orthogonalize the columns of a 2D
+// tensor in place. This is much faster than a QR decomposition for matrices
+// with only a few columns. The epsilon avoids dividing by zero on vanishing
+// gradients.
+void orthogonalize(at::Tensor& matrix, double epsilon = 1e-8) {
+  const auto numCols = matrix.size(1);
+  for (int64_t i = 0; i < numCols; ++i) {
+    auto col = matrix.narrow(1, i, 1);
+    col.div_(col.norm() + epsilon);
+    if (i + 1 < numCols) {
+      auto rest = matrix.narrow(1, i + 1, numCols - i - 1);
+      rest.sub_((col * rest).sum(0) * col);
+    }
+  }
+}
+
+} // namespace
+
+GradCompressionState::GradCompressionState(
+    ProcessGroup* processGroup,
+    GradCompressionOptions options)
+    : processGroup_(processGroup),
+      options_(std::move(options)),
+      iter_(0),
+      generator_(at::detail::createCPUGenerator(options_.randomSeed)) {
+  TORCH_CHECK(
+      options_.matrixApproximationRank > 0,
+      "Expect matrixApproximationRank > 0, but got ",
+      options_.matrixApproximationRank);
+  TORCH_CHECK(
+      options_.topkRatio > 0 && options_.topkRatio <= 1,
+      "Expect topkRatio in (0, 1], but got ",
+      options_.topkRatio);
+  TORCH_CHECK(
+      !(options_.useErrorFeedback || options_.warmStart) ||
+          options_.startIter > 1,
+      "Expect startIter > 1 if useErrorFeedback or warmStart is enabled, ",
+      "because compression can only be applied after the first two ",
+      "iterations in DDP.");
+}
+
+int64_t GradCompressionState::getIter() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return iter_;
+}
+
+bool GradCompressionState::compressionEnabled() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return iter_ >= options_.startIter;
+}
+
+void GradCompressionState::maybeIncreaseIter(const GradBucket& bucket) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (bucket.getIndex() == 0) {
+    iter_++;
+    if (iter_ == options_.startIter) {
+      LOG(INFO) << "Start to apply gradient compression after " << iter_
+                << " iterations.";
+    }
+  }
+}
+
+CompressionBucketState& GradCompressionState::getBucketState(
+    size_t bucketIndex) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return bucketStates_[bucketIndex];
+}
+
+std::unordered_map<std::string, at::Tensor> GradCompressionState::stateDict()
+    const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unordered_map<std::string, at::Tensor> stateDict;
+  stateDict.emplace("iter", at::scalar_tensor(iter_, at::kLong));
+  {
+    std::lock_guard<std::mutex> generatorLock(generator_.mutex());
+    stateDict.emplace("rng_state", generator_.get_state());
+  }
+  for (const auto& entry : bucketStates_) {
+    const auto prefix = "bucket." + std::to_string(entry.first) + ".";
+    const auto& bucketState = entry.second;
+    if (bucketState.error.defined()) {
+      stateDict.emplace(prefix + "error", bucketState.error.clone());
+    }
+    if (bucketState.pMemory.defined()) {
+      stateDict.emplace(prefix + "p_memory", bucketState.pMemory.clone());
+    }
+    if (bucketState.qMemory.defined()) {
+      stateDict.emplace(prefix + "q_memory", bucketState.qMemory.clone());
+    }
+  }
+  return stateDict;
+}
+
+void GradCompressionState::loadStateDict(
+    const std::unordered_map<std::string, at::Tensor>& stateDict) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::unordered_map<size_t, CompressionBucketState> bucketStates;
+  for (const auto& entry : stateDict) {
+    const auto& key = entry.first;
+    if (key == "iter") {
+      iter_ = entry.second.item<int64_t>();
+      continue;
+    }
+    if (key == "rng_state") {
+      std::lock_guard<std::mutex> generatorLock(generator_.mutex());
+      generator_.set_state(entry.second);
+      continue;
+    }
+    const std::string bucketPrefix = "bucket.";
+    const auto fieldPos = key.rfind('.');
+    TORCH_CHECK(
+        key.compare(0, bucketPrefix.size(), bucketPrefix) == 0 &&
+            fieldPos != std::string::npos && fieldPos > bucketPrefix.size(),
+        "Unexpected key in gradient compression state dict: ",
+        key);
+    const auto bucketIndex = std::stoul(
+        key.substr(bucketPrefix.size(), fieldPos - bucketPrefix.size()));
+    const auto field = key.substr(fieldPos + 1);
+    auto& bucketState = bucketStates[bucketIndex];
+    if (field == "error") {
+      bucketState.error = entry.second.clone();
+    } else if (field == "p_memory") {
+      bucketState.pMemory = entry.second.clone();
+    } else if (field == "q_memory") {
+      bucketState.qMemory = entry.second.clone();
+    } else {
+      TORCH_CHECK(
+          false, "Unexpected key in gradient compression state dict: ", key);
+    }
+  }
+  bucketStates_ = std::move(bucketStates);
+}
+
+GradCompressionState::~GradCompressionState() {
+  {
+    std::lock_guard<std::mutex> lock(commMutex_);
+    commStop_ = true;
+  }
+  commCV_.notify_one();
+  if (commThread_.joinable()) {
+    commThread_.join();
+  }
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> GradCompressionState::runAsync(
+    std::function<at::Tensor()> fn) {
+  auto fut = c10::make_intrusive<c10::ivalue::Future>(c10::TensorType::get());
+  // Propagate the thread local state of the caller, such as the dispatch
+  // keys, to the communication thread.
+  at::ThreadLocalState tls;
+  auto task = [fut, fn = std::move(fn), tls]() {
+    at::ThreadLocalStateGuard guard(tls);
+    try {
+      fut->markCompleted(c10::IValue(fn()));
+    } catch (...) {
+      fut->setError(std::current_exception());
+    }
+  };
+  {
+    std::lock_guard<std::mutex> lock(commMutex_);
+    commQueue_.push_back(std::move(task));
+    if (!commThread_.joinable()) {
+      commThread_ = std::thread(&GradCompressionState::runCommLoop, this);
+    }
+  }
+  commCV_.notify_one();
+  return fut;
+}
+
+void GradCompressionState::runCommLoop() {
+  std::unique_lock<std::mutex> lock(commMutex_);
+  while (true) {
+    commCV_.wait(lock, [&] { return commStop_ || !commQueue_.empty(); });
+    if (commQueue_.empty()) {
+      // Stopped, and all the submitted tasks have run.
+      return;
+    }
+    auto task = std::move(commQueue_.front());
+    commQueue_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+namespace {
+
+at::Tensor runPowerSGD(GradCompressionState& state, GradBucket& bucket) {
+  if (!state.compressionEnabled()) {
+    return vanillaAllreduce(state, bucket);
+  }
+
+  auto* processGroup = state.getProcessGroup();
+  const auto& options = state.getOptions();
+  auto& bucketState = state.getBucketState(bucket.getIndex());
+  // The input tensor is a flattened 1D tensor.
+  auto& inputTensor = bucket.getTensorsRef()[0];
+
+  // Keep a copy of the input tensor, so that the local error caused by
+  // compression can be computed after decompression.
+  at::Tensor inputTensorCopy;
+  if (applyErrorFeedback(state, bucketState, inputTensor)) {
+    inputTensorCopy = inputTensor.clone();
+  }
+
+  // Unflatten the input tensor into per-parameter tensors, for layer-wise
+  // compression.
+  const auto& offsets = bucket.getOffsets();
+  const auto& lengths = bucket.getLengths();
+  const auto& sizesVec = bucket.getSizesVec();
+  std::vector<at::Tensor> rank1Tensors;
+  std::vector<at::Tensor> matrices;
+  for (size_t i = 0; i < offsets.size(); ++i) {
+    auto tensor =
+        inputTensor.narrow(0, offsets[i], lengths[i]).view(sizesVec[i]);
+    if (tensor.dim() <= 1) {
+      rank1Tensors.push_back(tensor);
+    } else {
+      matrices.push_back(tensor.view({tensor.size(0), -1}));
+    }
+  }
+  // A bucket without per-parameter information is reduced uncompressed.
+  if (offsets.empty()) {
+    rank1Tensors.push_back(inputTensor);
+  }
+
+  // Step I: allreduce the rank-1 tensors as a batch without compression. It
+  // runs concurrently with the compression of the high-rank tensors.
+  std::vector<at::Tensor> flatRank1Tensors;
+  flatRank1Tensors.reserve(rank1Tensors.size());
+  for (const auto& tensor : rank1Tensors) {
+    flatRank1Tensors.push_back(tensor.view(-1));
+  }
+  auto rank1Memory = flatRank1Tensors.empty()
+      ? at::empty({0}, inputTensor.options())
+      : at::cat(flatRank1Tensors);
+  std::vector<at::Tensor> rank1Vec = {rank1Memory};
+  auto rank1Work = processGroup->allreduce(rank1Vec);
+
+  // Step II: compress the high-rank tensors M into P and Q such that
+  // M = PQ^T.
+  int64_t totalPsSize = 0;
+  int64_t totalQsSize = 0;
+  std::vector<int64_t> ranks;
+  ranks.reserve(matrices.size());
+  for (const auto& matrix : matrices) {
+    const auto n = matrix.size(0);
+    const auto m = matrix.size(1);
+    const auto rank =
+        std::min<int64_t>({n, m, options.matrixApproximationRank});
+    ranks.push_back(rank);
+    totalPsSize += n * rank;
+    totalQsSize += m * rank;
+  }
+
+  // If warm start is enabled, reuse Ps and Qs from the previous iteration.
+  bool needRandomizeQs = false;
+  if (!options.warmStart || !bucketState.pMemory.defined() ||
+      bucketState.pMemory.numel() != totalPsSize ||
+      bucketState.qMemory.numel() != totalQsSize) {
+    needRandomizeQs = true;
+    if (options.warmStart) {
+      LOG(INFO) << "Allocating contiguous memory of length " << totalPsSize
+                << " for Ps, and of length " << totalQsSize
+                << " for Qs, respectively.";
+    }
+    bucketState.pMemory = at::empty({totalPsSize}, inputTensor.options());
+    bucketState.qMemory = at::empty({totalQsSize}, inputTensor.options());
+  }
+
+  std::vector<at::Tensor> ps;
+  std::vector<at::Tensor> qs;
+  ps.reserve(matrices.size());
+  qs.reserve(matrices.size());
+  int64_t pIdx = 0;
+  int64_t qIdx = 0;
+  for (size_t i = 0; i < matrices.size(); ++i) {
+    const auto n = matrices[i].size(0);
+    const auto m = matrices[i].size(1);
+    ps.push_back(
+        bucketState.pMemory.narrow(0, pIdx, n * ranks[i]).view({n, ranks[i]}));
+    qs.push_back(
+        bucketState.qMemory.narrow(0, qIdx, m * ranks[i]).view({m, ranks[i]}));
+    pIdx += n * ranks[i];
+    qIdx += m * ranks[i];
+  }
+
+  // Initialize Qs from a standard normal distribution, with the same
+  // generator state on every rank, and orthogonalize them.
+  if (needRandomizeQs) {
+    for (auto& q : qs) {
+      q.normal_(0, 1, state.getGenerator());
+      orthogonalize(q);
+    }
+  }
+
+  // Compute and allreduce Ps, then orthogonalize them.
+  for (size_t i = 0; i < matrices.size(); ++i) {
+    at::matmul_out(ps[i], matrices[i], qs[i]);
+  }
+  allreduceAndWait(processGroup, bucketState.pMemory);
+  for (auto& p : ps) {
+    orthogonalize(p);
+  }
+
+  // Compute and allreduce Qs, which are approximately equal to M^TP.
+  for (size_t i = 0; i < matrices.size(); ++i) {
+    at::matmul_out(qs[i], matrices[i].t(), ps[i]);
+  }
+  allreduceAndWait(processGroup, bucketState.qMemory);
+
+  // Decompress M = PQ^T in place.
+  for (size_t i = 0; i < matrices.size(); ++i) {
+    at::matmul_out(matrices[i], ps[i], qs[i].t());
+  }
+
+  // Copy the allreduced rank-1 tensors back to the input tensor.
+  rank1Work->wait();
+  int64_t rank1Idx = 0;
+  for (auto& tensor : rank1Tensors) {
+    tensor.copy_(
+        rank1Memory.narrow(0, rank1Idx, tensor.numel()).view_as(tensor));
+    rank1Idx += tensor.numel();
+  }
+
+  inputTensor.div_(processGroup->getSize());
+  if (inputTensorCopy.defined()) {
+    at::sub_out(bucketState.error, inputTensorCopy, inputTensor);
+  }
+  state.maybeIncreaseIter(bucket);
+  return inputTensor;
+}
+
+at::Tensor runTopKSparsify(GradCompressionState& state, GradBucket& bucket) {
+  if (!state.compressionEnabled()) {
+    return vanillaAllreduce(state, bucket);
+  }
+
+  auto* processGroup = state.getProcessGroup();
+  auto& bucketState = state.getBucketState(bucket.getIndex());
+  auto& inputTensor = bucket.getTensorsRef()[0];
+  const bool recordError = applyErrorFeedback(state, bucketState, inputTensor);
+
+  auto flat = inputTensor.view(-1);
+  const int64_t numel = flat.numel();
+  const int64_t k = std::max<int64_t>(
+      1,
+      std::min<int64_t>(
+          numel,
+          static_cast<int64_t>(
+              std::ceil(numel * state.getOptions().topkRatio))));
+  auto indices = std::get<1>(flat.abs().topk(k, 0, /*largest=*/true,
+                                             /*sorted=*/false));
+  auto values = flat.index_select(0, indices);
+
+  // The unselected elements are the local error of this iteration.
+  if (recordError) {
+    bucketState.error.copy_(inputTensor);
+    bucketState.error.view(-1).index_fill_(0, indices, 0);
+  }
+
+  // Send 32-bit indices whenever possible to save bandwidth.
+  const bool useInt32Indices = numel <= std::numeric_limits<int32_t>::max();
+  auto allValues = allgatherAndWait(processGroup, values);
+  auto allIndices = allgatherAndWait(
+      processGroup, useInt32Indices ? indices.to(at::kInt) : indices);
+
+  flat.zero_();
+  for (size_t i = 0; i < allValues.size(); ++i) {
+    flat.index_add_(0, allIndices[i].to(at::kLong), allValues[i]);
+  }
+  flat.div_(processGroup->getSize());
+
+  state.maybeIncreaseIter(bucket);
+  return inputTensor;
+}
+
+at::Tensor runInt8Quantize(GradCompressionState& state, GradBucket& bucket) {
+  if (!state.compressionEnabled()) {
+    return vanillaAllreduce(state, bucket);
+  }
+
+  auto* processGroup = state.getProcessGroup();
+  auto& bucketState = state.getBucketState(bucket.getIndex());
+  auto& inputTensor = bucket.getTensorsRef()[0];
+  const bool recordError = applyErrorFeedback(state, bucketState, inputTensor);
+  const int64_t worldSize = processGroup->getSize();
+  const int64_t rank = processGroup->getRank();
+
+  // All ranks must quantize with the same scale so that the quantized values
+  // can be summed directly.
+  auto maxAbs = inputTensor.abs().max().reshape({1});
+  allreduceAndWait(processGroup, maxAbs, ReduceOp::MAX);
+  const double scale = maxAbs.item<double>() / 127;
+  if (scale == 0) {
+    // All the gradients are zero on every rank.
+    if (recordError) {
+      bucketState.error.zero_();
+    }
+    state.maybeIncreaseIter(bucket);
+    return inputTensor;
+  }
+
+  // The bucket is padded with zeros to a multiple of the world size, so that
+  // rank r reduces elements [r * chunkSize, (r + 1) * chunkSize).
+  const int64_t numel = inputTensor.numel();
+  const int64_t chunkSize = (numel + worldSize - 1) / worldSize;
+  auto quantized =
+      at::zeros({chunkSize * worldSize}, inputTensor.options().dtype(at::kChar));
+  quantized.narrow(0, 0, numel)
+      .copy_(at::round(inputTensor / scale).clamp_(-127, 127));
+  if (recordError) {
+    at::sub_out(
+        bucketState.error,
+        inputTensor,
+        quantized.narrow(0, 0, numel).to(inputTensor.scalar_type()) * scale);
+  }
+
+  // Reduce-scatter: after the alltoall, row r holds the chunk of this rank in
+  // the bucket of rank r. The chunks are summed in int32, which cannot
+  // overflow, and their mean is at most 127 in magnitude, so it is
+  // requantized to int8 with the same scale.
+  auto received = at::empty_like(quantized);
+  std::vector<int64_t> equalSplits;
+  processGroup->alltoall_base(received, quantized, equalSplits, equalSplits)
+      ->wait();
+  auto sum = received.view({worldSize, chunkSize}).to(at::kInt).sum(0);
+  auto mean = sum.to(at::kDouble).div_(worldSize);
+  auto reduced = at::round(mean).to(at::kChar);
+  if (recordError) {
+    // The requantization error of the mean is carried over by the rank that
+    // reduced the chunk, scaled by the world size since the next iteration
+    // divides it again.
+    const int64_t begin = std::min(rank * chunkSize, numel);
+    const int64_t length = std::min(chunkSize, numel - begin);
+    bucketState.error.view(-1).narrow(0, begin, length).add_(
+        (mean - reduced.to(at::kDouble))
+            .narrow(0, 0, length)
+            .to(inputTensor.scalar_type()),
+        scale * worldSize);
+  }
+
+  // Allgather of the reduced chunks.
+  auto allReduced = at::cat(allgatherAndWait(processGroup, reduced));
+  inputTensor.view(-1).copy_(allReduced.narrow(0, 0, numel));
+  inputTensor.mul_(scale);
+
+  state.maybeIncreaseIter(bucket);
+  return inputTensor;
+}
+
+template <typename Fn>
+c10::intrusive_ptr<c10::ivalue::Future> runHookAsync(
+    const std::shared_ptr<GradCompressionState>& state,
+    GradBucket& bucket,
+    Fn fn) {
+  // The bucket is copied, since it does not outlive `runHook`. Its tensors
+  // share the storage of the reducer's bucket.
+  return state->runAsync([state, bucket, fn]() mutable {
+    return fn(*state, bucket);
+  });
+}
+
+} // namespace
+
+c10::intrusive_ptr<c10::ivalue::Future> PowerSGDCommHook::runHook(
+    GradBucket& bucket) {
+  return runHookAsync(state_, bucket, runPowerSGD);
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> TopKSparsifyCommHook::runHook(
+    GradBucket& bucket) {
+  return runHookAsync(state_, bucket, runTopKSparsify);
+}
+
+c10::intrusive_ptr<c10::ivalue::Future> Int8QuantizeCommHook::runHook(
+    GradBucket& bucket) {
+  return runHookAsync(state_, bucket, runInt8Quantize);
+}
+
+} // namespace c10d
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include <ATen/core/Generator.h>
+#include <c10d/comm.hpp>
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// Hyperparameters shared by the built-in gradient compression hooks.
+// Each hook only reads the fields that are relevant to its algorithm.
+struct GradCompressionOptions {
+  // PowerSGD: rank of the low-rank approximation of each gradient matrix.
+  // The lower the rank, the stronger the compression.
+  int64_t matrixApproximationRank = 1;
+
+  // Top-k sparsification: fraction of the bucket elements (by magnitude)
+  // that every rank contributes to the reduction.
+  double topkRatio = 0.01;
+
+  // Compression is deferred until this iteration, and vanilla allreduce is
+  // used before that. Must be > 1 if error feedback or warm start is enabled,
+  // because DDP rebuilds buckets after the first iteration, which changes
+  // the shapes of the memorized per-bucket tensors.
+  int64_t startIter = 10;
+
+  // Accumulates the local compression error of a bucket and adds it back to
+  // the gradients of the same bucket in the next iteration.
+  bool useErrorFeedback = true;
+
+  // PowerSGD: reuses the P and Q factors of the previous iteration instead
+  // of reinitializing Q randomly at every step.
+  bool warmStart = true;
+
+  // Seed of the generator used to initialize the PowerSGD Q factors. It must
+  // be identical across ranks so that all replicas use the same projection.
+  uint64_t randomSeed = 0;
+};
+
+// Per-bucket state of a gradient compression hook. All tensors are lazily
+// allocated the first time compression is applied to the bucket.
+struct CompressionBucketState {
+  // Local error of the previous compression, if error feedback is enabled.
+  at::Tensor error;
+  // PowerSGD: flattened P and Q factors of all the matrices in the bucket.
+  at::Tensor pMemory;
+  at::Tensor qMemory;
+};
+
+// State shared by all the buckets of a single DDP model. It is owned jointly
+// by the hook and the reducer, so that it can be checkpointed and restored
+// through the reducer while training is paused.
+//
+// The hooks chain several collectives whose inputs depend on the results of
+// the previous ones, and not every backend implements `Work::getFuture`
+// (e.g., Gloo). So the hooks run on a communication thread owned by the
+// state and return a pending future, which keeps the communication of a
+// bucket overlapped with the rest of the backward pass. There is a single
+// communication thread, so the buckets issue their collectives in the order
+// in which they are ready, which is the same on every rank.
+class TORCH_PYTHON_API GradCompressionState {
+ public:
+  GradCompressionState(
+      ProcessGroup* processGroup,
+      GradCompressionOptions options = GradCompressionOptions());
+
+  ~GradCompressionState();
+
+  ProcessGroup* getProcessGroup() const {
+    return processGroup_;
+  }
+
+  const GradCompressionOptions& getOptions() const {
+    return options_;
+  }
+
+  int64_t getIter() const;
+
+  // Returns true once `startIter` iterations have run with vanilla allreduce.
+  bool compressionEnabled() const;
+
+  // Since bucket 0 is the last bucket to be reduced in an iteration, the
+  // iteration counter is only increased after bucket 0 is processed.
+  void maybeIncreaseIter(const GradBucket& bucket);
+
+  // Returns the state of the given bucket, creating it if necessary.
+  // The reference stays valid until `loadStateDict` is called.
+  CompressionBucketState& getBucketState(size_t bucketIndex);
+
+  at::Generator& getGenerator() {
+    return generator_;
+  }
+
+  // Returns a snapshot of the iteration counter, the generator state and all
+  // the per-bucket tensors, keyed as "iter", "rng_state" and
+  // "bucket.<index>.<field>". The tensors are cloned, so the snapshot is not
+  // affected by subsequent training steps.
+  std::unordered_map<std::string, at::Tensor> stateDict() const;
+
+  // Restores a snapshot produced by `stateDict`, possibly on another process.
+  void loadStateDict(
+      const std::unordered_map<std::string, at::Tensor>& stateDict);
+
+  // Runs `fn` on the communication thread, after all the previously
+  // submitted tasks, and returns a future that is completed with the tensor
+  // it returns, or with the error it throws.
+  c10::intrusive_ptr<c10::ivalue::Future> runAsync(
+      std::function<at::Tensor()> fn);
+
+ private:
+  void runCommLoop();
+
+  ProcessGroup* processGroup_; // Not owned.
+  const GradCompressionOptions options_;
+
+  mutable std::mutex mutex_;
+  int64_t iter_;
+  mutable at::Generator generator_;
+  std::unordered_map<size_t, CompressionBucketState> bucketStates_;
+
+  // The communication thread is started by the first task.
+  std::mutex commMutex_;
+  std::condition_variable commCV_;
+  std::deque<std::function<void()>> commQueue_;
+  bool commStop_ = false;
+  std::thread commThread_;
+};
+
+// Implements PowerSGD (https://arxiv.org/abs/1905.13727). Every parameter
+// with more than one dimension is viewed as an n x m matrix M and replaced by
+// the product of two low-rank factors P (n x r) and Q (m x r), so only
+// (n + m) * r elements are allreduced instead of n * m. Vectors, such as
+// biases, are allreduced without compression.
+class TORCH_PYTHON_API PowerSGDCommHook
+    : public CppCommHookInterface<std::shared_ptr<GradCompressionState>> {
+ public:
+  explicit PowerSGDCommHook(std::shared_ptr<GradCompressionState> state)
+      : CppCommHookInterface<std::shared_ptr<GradCompressionState>>(state) {}
+
+  ~PowerSGDCommHook() override {}
+
+  c10::intrusive_ptr<c10::ivalue::Future> runHook(GradBucket& bucket) override;
+};
+
+// Every rank only contributes the `topkRatio` fraction of the bucket elements
+// with the largest magnitude. The selected values and their indices are
+// allgathered and scattered back into a dense bucket. Unselected elements
+// are carried over to the next iteration by error feedback.
+class TORCH_PYTHON_API TopKSparsifyCommHook
+    : public CppCommHookInterface<std::shared_ptr<GradCompressionState>> {
+ public:
+  explicit TopKSparsifyCommHook(std::shared_ptr<GradCompressionState> state)
+      : CppCommHookInterface<std::shared_ptr<GradCompressionState>>(state) {}
+
+  ~TopKSparsifyCommHook() override {}
+
+  c10::intrusive_ptr<c10::ivalue::Future> runHook(GradBucket& bucket) override;
+};
+
+// Quantizes the bucket to int8 with a scale that is agreed upon by all the
+// ranks (allreduce of the maximum magnitude), and reduces it in two int8
+// steps: an alltoall sends chunk r of every bucket to rank r, which sums the
+// chunks in int32 and requantizes their mean with the same scale, and the
+// reduced chunks are allgathered. Each rank receives about 2n(w-1)/w bytes
+// for a bucket of n elements on w ranks, against 8n(w-1)/w for a float ring
+// allreduce, whatever the number of ranks. The rounding errors of both steps
+// are carried over to the next iteration by error feedback.
+class TORCH_PYTHON_API Int8QuantizeCommHook
+    : public CppCommHookInterface<std::shared_ptr<GradCompressionState>> {
+ public:
+  explicit Int8QuantizeCommHook(std::shared_ptr<GradCompressionState> state)
+      : CppCommHookInterface<std::shared_ptr<GradCompressionState>>(state) {}
+
+  ~Int8QuantizeCommHook() override {}
+
+  c10::intrusive_ptr<c10::ivalue::Future> runHook(GradBucket& bucket) override;
+};
+
+} // namespace c10d
@@ -8,6 +8,10 @@ namespace c10d {
 enum class BuiltinCommHookType {
   ALLREDUCE = 1,
   FP16_COMPRESS = 2,
+  // Gradient compression hooks, see compression_comm_hooks.hpp.
+  POWER_SGD = 3,
+  TOPK_SPARSIFY = 4,
+  INT8_QUANTIZE = 5,
 };
 
 class AllReduceCommHook : public CppCommHookInterface<ProcessGroup*> {
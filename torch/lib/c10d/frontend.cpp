@@ -198,6 +198,13 @@ c10::intrusive_ptr<ProcessGroup> DistributedC10d::newProcessGroupHelper(
 
       options.timeout = timeout;
       options.threads = options.devices.size() * 2;
+
+      // Split large allreduce calls into chunks, if "GLOO_ALLREDUCE_CHUNK_BYTES"
+      // is set.
+      char* chunkBytesEnv = getenv(GLOO_ALLREDUCE_CHUNK_BYTES_ENV);
+      if (chunkBytesEnv) {
+        options.allreduceChunkBytes = std::stoull(chunkBytesEnv);
+      }
       pg = c10::make_intrusive<ProcessGroupGloo>(
           prefix_store, rank, world_size, options);
 #else
@@ -15,6 +15,7 @@ namespace c10d {
 
 #ifdef USE_C10D_GLOO
 constexpr char* GLOO_SOCKET_IFNAME_ENV = "GLOO_SOCKET_IFNAME";
+constexpr char* GLOO_ALLREDUCE_CHUNK_BYTES_ENV = "GLOO_ALLREDUCE_CHUNK_BYTES";
 #endif
 
 inline std::vector<std::string> split(
@@ -1413,18 +1413,28 @@ void Reducer::register_comm_hook(std::unique_ptr<CommHookInterface> iface) {
 
 // See Note [DDP Communication Hook]
 void Reducer::register_builtin_comm_hook(
-    c10d::BuiltinCommHookType comm_hook_type) {
+    c10d::BuiltinCommHookType comm_hook_type,
+    const c10d::GradCompressionOptions& compression_options) {
   TORCH_CHECK(
       comm_hook_ == nullptr,
       "register_builtin_comm_hook or register_comm_hook can only be called once.");
   TORCH_CHECK(
       replicas_.size() == 1,
       "Communication hook does not support single-process multiple-device mode.");
-  // TODO: Support GLOO and MPI backends for DDP communication hook.
-  TORCH_CHECK(
-      process_group_->getBackendName() == "nccl",
-      "register_builtin_comm_hook currently can only support NCCL backend, but the current backend is %s.",
-      process_group_->getBackendName());
+
+  switch (comm_hook_type) {
+    case c10d::BuiltinCommHookType::ALLREDUCE:
+    case c10d::BuiltinCommHookType::FP16_COMPRESS:
+      // These hooks rely on `ProcessGroup::Work::getFuture`.
+      // TODO: Support GLOO and MPI backends for DDP communication hook.
+      TORCH_CHECK(
+          process_group_->getBackendName() == "nccl",
+          "register_builtin_comm_hook currently can only support NCCL backend for ALLREDUCE and FP16_COMPRESS, but the current backend is ",
+          process_group_->getBackendName());
+      break;
+    default:
+      break;
+  }
 
   switch (comm_hook_type) {
     case c10d::BuiltinCommHookType::ALLREDUCE:
@@ -1437,6 +1447,30 @@ void Reducer::register_builtin_comm_hook(
           std::make_unique<c10d::FP16CompressCommHook>(process_group_.get());
       LOG(INFO) << "Built-in communication hook FP16_COMPRESS is registered.";
       break;
+    case c10d::BuiltinCommHookType::POWER_SGD:
+      comm_hook_compression_state_ =
+          std::make_shared<c10d::GradCompressionState>(
+              process_group_.get(), compression_options);
+      comm_hook_ = std::make_unique<c10d::PowerSGDCommHook>(
+          comm_hook_compression_state_);
+      LOG(INFO) << "Built-in communication hook POWER_SGD is registered.";
+      break;
+    case c10d::BuiltinCommHookType::TOPK_SPARSIFY:
+      comm_hook_compression_state_ =
+          std::make_shared<c10d::GradCompressionState>(
+              process_group_.get(), compression_options);
+      comm_hook_ = std::make_unique<c10d::TopKSparsifyCommHook>(
+          comm_hook_compression_state_);
+      LOG(INFO) << "Built-in communication hook TOPK_SPARSIFY is registered.";
+      break;
+    case c10d::BuiltinCommHookType::INT8_QUANTIZE:
+      comm_hook_compression_state_ =
+          std::make_shared<c10d::GradCompressionState>(
+              process_group_.get(), compression_options);
+      comm_hook_ = std::make_unique<c10d::Int8QuantizeCommHook>(
+          comm_hook_compression_state_);
+      LOG(INFO) << "Built-in communication hook INT8_QUANTIZE is registered.";
+      break;
     default:
       TORCH_WARN_ONCE(
           "Unknown built-in DDP comm hook type is provided. No comm hook will be used.");
@@ -10,6 +10,7 @@
 #include <c10d/comm.hpp>
 #include <c10/util/intrusive_ptr.h>
 #include <c10d/ProcessGroup.hpp>
+#include <c10d/compression_comm_hooks.hpp>
 #include <c10d/default_comm_hooks.hpp>
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/variable.h>
@@ -66,7 +67,19 @@ class Reducer {
   // Registers a built-in C++ comm hook to the reducer. This function can only
   // be called once before calling backward.
   // Cannot combine with the call of `register_comm_hook`.
-  void register_builtin_comm_hook(c10d::BuiltinCommHookType comm_hook_type);
+  // `compression_options` is only used by the gradient compression hooks.
+  void register_builtin_comm_hook(
+      c10d::BuiltinCommHookType comm_hook_type,
+      const c10d::GradCompressionOptions& compression_options =
+          c10d::GradCompressionOptions());
+
+  // Returns the state of the registered built-in gradient compression hook,
+  // or nullptr if no such hook is registered. The state can be checkpointed
+  // through `stateDict` and `loadStateDict` between iterations.
+  std::shared_ptr<c10d::GradCompressionState> get_comm_hook_compression_state()
+      const {
+    return comm_hook_compression_state_;
+  }
 
   // Returns a vector of tensors in each bucket in sequential order.
   std::vector<std::vector<at::Tensor>> get_bucket_tensors() const;
@@ -370,6 +383,9 @@ class Reducer {
  private:
   // comm_hook_ is used to access the DDP communication hook if registered.
   std::unique_ptr<CommHookInterface> comm_hook_;
+  // State shared with comm_hook_ if it is a built-in gradient compression
+  // hook, kept here so that it can be checkpointed.
+  std::shared_ptr<c10d::GradCompressionState> comm_hook_compression_state_;
 
   // ddp_logging_data_ is used to hold all the ddp related logging
   // data fields.
@@ -121,7 +121,8 @@ class CollectiveTest {
   static std::vector<CollectiveTest> initialize(
       const std::string& path,
       int num,
-      bool delayed = false) {
+      bool delayed = false,
+      size_t allreduceChunkBytes = 0) {
     std::vector<CollectiveTest> tests;
     for (auto i = 0; i < num; i++) {
       tests.push_back(CollectiveTest(path));
@@ -129,8 +130,9 @@ class CollectiveTest {
 
     std::vector<std::thread> threads;
     for (auto i = 0; i < num; i++) {
-      threads.push_back(std::thread(
-          [i, &tests, delayed] { tests[i].start(i, tests.size(), delayed); }));
+      threads.push_back(std::thread([i, &tests, delayed, allreduceChunkBytes] {
+        tests[i].start(i, tests.size(), delayed, allreduceChunkBytes);
+      }));
     }
     for (auto& thread : threads) {
       thread.join();
@@ -150,7 +152,7 @@ class CollectiveTest {
     return *pg_;
   }
 
-  void start(int rank, int size, bool delayed) {
+  void start(int rank, int size, bool delayed, size_t allreduceChunkBytes) {
     auto store = c10::make_intrusive<::c10d::FileStore>(path_, size);
 
     // Set a timeout that is small enough to make this test run fast, but also
@@ -159,6 +161,7 @@ class CollectiveTest {
     options.timeout = std::chrono::milliseconds(1000);
     options.devices.push_back(
         ::c10d::ProcessGroupGloo::createDeviceForHostname("127.0.0.1"));
+    options.allreduceChunkBytes = allreduceChunkBytes;
 
     if (!delayed) {
       pg_ = std::unique_ptr<::c10d::ProcessGroupGloo>(
@@ -222,6 +225,55 @@ void testAllreduce(const std::string& path, const at::DeviceType b) {
   }
 }
 
+void testAllreduceChunked(const std::string& path) {
+  const auto size = 4;
+  const auto numel = 1000;
+  const auto chunkBytes = 1024;
+  const auto numChunks = (numel * sizeof(float) + chunkBytes - 1) / chunkBytes;
+  auto tests =
+      CollectiveTest::initialize(path, size, /*delayed=*/false, chunkBytes);
+
+  // Kick off two calls so that their chunks are in flight concurrently.
+  std::vector<std::vector<at::Tensor>> inputs(size * 2);
+  std::vector<c10::intrusive_ptr<::c10d::ProcessGroup::Work>> work(size * 2);
+  for (auto k = 0; k < 2; k++) {
+    for (auto i = 0; i < size; i++) {
+      inputs[k * size + i] = {at::arange(numel, at::kFloat) * (i + k)};
+      work[k * size + i] =
+          tests[i].getProcessGroup().allreduce(inputs[k * size + i]);
+    }
+  }
+
+  for (auto& w : work) {
+    w->wait();
+  }
+
+  // Verify outputs
+  for (auto k = 0; k < 2; k++) {
+    const auto expected = at::arange(numel, at::kFloat) *
+        ((size * (size - 1)) / 2 + size * k);
+    for (auto i = 0; i < size; i++) {
+      EXPECT_TRUE(inputs[k * size + i][0].equal(expected));
+    }
+  }
+
+  // Verify timelines
+  for (auto i = 0; i < size; i++) {
+    auto timelines = tests[i].getProcessGroup().getAllreduceTimelines();
+    ASSERT_EQ(timelines.size(), 2);
+    for (const auto& timeline : timelines) {
+      EXPECT_EQ(timeline.numBytes, numel * sizeof(float));
+      ASSERT_EQ(timeline.chunkStartTimes.size(), numChunks);
+      ASSERT_EQ(timeline.chunkEndTimes.size(), numChunks);
+      for (size_t j = 0; j < numChunks; j++) {
+        EXPECT_GE(timeline.chunkStartTimes[j], timeline.enqueueTime);
+        EXPECT_GE(timeline.chunkEndTimes[j], timeline.chunkStartTimes[j]);
+      }
+    }
+    EXPECT_TRUE(tests[i].getProcessGroup().getAllreduceTimelines().empty());
+  }
+}
+
 void testBroadcast(const std::string& path, const at::DeviceType b) {
   const auto size = 2;
   const auto stride = 2;
@@ -500,6 +552,13 @@ TEST(ProcessGroupGlooTest, testAllReduceCPU) {
   }
 }
 
+TEST(ProcessGroupGlooTest, testAllReduceChunkedCPU) {
+  {
+    TemporaryFile file;
+    testAllreduceChunked(file.path);
+  }
+}
+
 TEST(ProcessGroupGlooTest, testBroadcastCPU) {
   {
     TemporaryFile file;
@@ -0,0 +1,190 @@
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <c10d/FileStore.hpp>
+#include <c10d/ProcessGroupGloo.hpp>
+#include <c10d/ProcessGroupHierarchical.hpp>
+#include <c10d/test/TestUtils.hpp>
+
+using namespace c10d::test;
+
+using ::c10d::ProcessGroupHierarchical;
+
+// Emulates `numNodes` nodes of `localSize` ranks each with threads of the
+// current process, by assigning a different node name to every node.
+std::vector<std::unique_ptr<ProcessGroupHierarchical>> initialize(
+    const std::string& path,
+    int numNodes,
+    int localSize,
+    size_t bufferBytes) {
+  const auto size = numNodes * localSize;
+  std::vector<std::unique_ptr<ProcessGroupHierarchical>> pgs(size);
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < size; i++) {
+    threads.push_back(std::thread([&, i] {
+      auto store = c10::make_intrusive<::c10d::FileStore>(path, size);
+
+      ProcessGroupHierarchical::Options options;
+      options.bufferBytes = bufferBytes;
+      options.nodeName = "node" + std::to_string(i / localSize);
+      options.leaderProcessGroupFactory =
+          [](const c10::intrusive_ptr<::c10d::Store>& store,
+             int rank,
+             int size) -> c10::intrusive_ptr<::c10d::ProcessGroup> {
+        ::c10d::ProcessGroupGloo::Options glooOptions;
+        glooOptions.timeout = std::chrono::milliseconds(1000);
+        glooOptions.devices.push_back(
+            ::c10d::ProcessGroupGloo::createDeviceForHostname("127.0.0.1"));
+        return c10::make_intrusive<::c10d::ProcessGroupGloo>(
+            store, rank, size, glooOptions);
+      };
+      pgs[i].reset(new ProcessGroupHierarchical(store, i, size, options));
+    }));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return pgs;
+}
+
+void testTopology(const std::string& path) {
+  auto pgs = initialize(path, 2, 3, 1024);
+  for (size_t i = 0; i < pgs.size(); i++) {
+    EXPECT_EQ(2, pgs[i]->getNumNodes());
+    EXPECT_EQ(i / 3, pgs[i]->getNodeIndex());
+    EXPECT_EQ(i % 3, pgs[i]->getLocalRank());
+    EXPECT_EQ(3, pgs[i]->getLocalSize());
+  }
+}
+
+void testAllreduce(const std::string& path, size_t bufferBytes) {
+  const auto numNodes = 2;
+  const auto localSize = 2;
+  const auto size = numNodes * localSize;
+  auto pgs = initialize(path, numNodes, localSize, bufferBytes);
+
+  // Use a tensor that spans several rounds when bufferBytes is small.
+  std::vector<std::vector<at::Tensor>> inputs(size);
+  std::vector<c10::intrusive_ptr<::c10d::ProcessGroup::Work>> work(size);
+  for (auto i = 0; i < size; i++) {
+    inputs[i] = {at::arange(1000, at::kFloat).mul_(i + 1).view({10, 100})};
+    work[i] = pgs[i]->allreduce(inputs[i]);
+  }
+  for (auto i = 0; i < size; i++) {
+    work[i]->wait();
+  }
+
+  const auto expected =
+      at::arange(1000, at::kFloat).mul_(size * (size + 1) / 2).view({10, 100});
+  for (auto i = 0; i < size; i++) {
+    EXPECT_TRUE(inputs[i][0].equal(expected))
+        << "Allreduce output differs on rank " << i;
+  }
+}
+
+// Every rank rejects an unsupported reduction, including single-rank nodes,
+// and the process groups remain usable.
+void testUnsupportedReduceOp(const std::string& path, int localSize) {
+  const auto numNodes = 2;
+  const auto size = numNodes * localSize;
+  auto pgs = initialize(path, numNodes, localSize, 64);
+
+  std::vector<std::vector<at::Tensor>> inputs(size);
+  for (auto i = 0; i < size; i++) {
+    inputs[i] = {at::ones({10}, at::kInt)};
+    ::c10d::AllreduceOptions options;
+    options.reduceOp = ::c10d::ReduceOp::BAND;
+    EXPECT_THROW(pgs[i]->allreduce(inputs[i], options), std::invalid_argument)
+        << "Allreduce with BAND did not throw on rank " << i;
+    ::c10d::AllreduceCoalescedOptions coalescedOptions;
+    coalescedOptions.reduceOp = ::c10d::ReduceOp::BXOR;
+    EXPECT_THROW(
+        pgs[i]->allreduce_coalesced(inputs[i], coalescedOptions),
+        std::invalid_argument)
+        << "Coalesced allreduce with BXOR did not throw on rank " << i;
+  }
+
+  std::vector<c10::intrusive_ptr<::c10d::ProcessGroup::Work>> work(size);
+  for (auto i = 0; i < size; i++) {
+    work[i] = pgs[i]->allreduce(inputs[i]);
+  }
+  for (auto i = 0; i < size; i++) {
+    work[i]->wait();
+    EXPECT_TRUE(inputs[i][0].equal(at::full({10}, size, at::kInt)))
+        << "Allreduce output differs on rank " << i;
+  }
+}
+
+void testBroadcast(const std::string& path) {
+  const auto numNodes = 2;
+  const auto localSize = 2;
+  const auto size = numNodes * localSize;
+  auto pgs = initialize(path, numNodes, localSize, 64);
+
+  for (auto rootRank = 0; rootRank < size; rootRank++) {
+    std::vector<std::vector<at::Tensor>> inputs(size);
+    std::vector<c10::intrusive_ptr<::c10d::ProcessGroup::Work>> work(size);
+    for (auto i = 0; i < size; i++) {
+      inputs[i] = {at::full({100}, i, at::kLong)};
+      ::c10d::BroadcastOptions options;
+      options.rootRank = rootRank;
+      work[i] = pgs[i]->broadcast(inputs[i], options);
+    }
+    for (auto i = 0; i < size; i++) {
+      work[i]->wait();
+    }
+    for (auto i = 0; i < size; i++) {
+      EXPECT_TRUE(inputs[i][0].equal(at::full({100}, rootRank, at::kLong)))
+          << "Broadcast from rank " << rootRank << " differs on rank " << i;
+    }
+  }
+}
+
+void testBarrier(const std::string& path) {
+  const auto size = 4;
+  auto pgs = initialize(path, 2, 2, 64);
+
+  std::vector<c10::intrusive_ptr<::c10d::ProcessGroup::Work>> work(size);
+  for (auto i = 0; i < size; i++) {
+    work[i] = pgs[i]->barrier();
+  }
+  for (auto i = 0; i < size; i++) {
+    work[i]->wait();
+  }
+}
+
+TEST(ProcessGroupHierarchicalTest, testTopology) {
+  TemporaryFile file;
+  testTopology(file.path);
+}
+
+TEST(ProcessGroupHierarchicalTest, testAllReduce) {
+  TemporaryFile file;
+  testAllreduce(file.path, 16 * 1024);
+}
+
+TEST(ProcessGroupHierarchicalTest, testAllReduceMultipleRounds) {
+  TemporaryFile file;
+  testAllreduce(file.path, 100 * sizeof(float));
+}
+
+TEST(ProcessGroupHierarchicalTest, testUnsupportedReduceOp) {
+  TemporaryFile file;
+  testUnsupportedReduceOp(file.path, 2);
+}
+
+TEST(ProcessGroupHierarchicalTest, testUnsupportedReduceOpSingleRankNodes) {
+  TemporaryFile file;
+  testUnsupportedReduceOp(file.path, 1);
+}
+
+TEST(ProcessGroupHierarchicalTest, testBroadcast) {
+  TemporaryFile file;
+  testBroadcast(file.path);
+}
+
+TEST(ProcessGroupHierarchicalTest, testBarrier) {
+  TemporaryFile file;
+  testBarrier(file.path);
+}
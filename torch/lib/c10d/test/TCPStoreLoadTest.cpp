@@ -0,0 +1,137 @@
+// Load test for the TCPStore daemon.
+//
+// Simulates a rendezvous of many ranks on a single machine: every client
+// thread connects to the same TCPStore, publishes its address, fetches the
+// addresses of some peers and finally joins a barrier. The time spent in
+// every phase is reported, so that changes to the daemon can be compared.
+//
+// Usage: TCPStoreLoadTest [num_clients] [num_peers]
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <c10d/TCPStore.hpp>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Every client uses one socket on both sides of the connection.
+int maxClients() {
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+    return 0;
+  }
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+  getrlimit(RLIMIT_NOFILE, &limit);
+  return static_cast<int>(
+      std::min<rlim_t>(limit.rlim_cur / 2 - 64, INT32_MAX));
+}
+
+struct Phases {
+  Clock::time_point start;
+  Clock::time_point connected;
+  Clock::time_point published;
+  Clock::time_point fetched;
+  Clock::time_point done;
+};
+
+void printPhase(
+    const std::string& name,
+    const std::vector<Phases>& phases,
+    Clock::time_point Phases::*begin,
+    Clock::time_point Phases::*end) {
+  std::vector<double> latencies;
+  latencies.reserve(phases.size());
+  for (const auto& phase : phases) {
+    latencies.push_back(elapsedMs(phase.*begin, phase.*end));
+  }
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&](double p) {
+    return latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+  };
+  std::cout << name << ": p50 " << percentile(0.5) << " ms, p99 "
+            << percentile(0.99) << " ms, max " << latencies.back() << " ms"
+            << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int numClients = argc > 1 ? std::atoi(argv[1]) : 2048;
+  const int numPeers = argc > 2 ? std::atoi(argv[2]) : 8;
+
+  const auto limit = maxClients();
+  if (numClients > limit) {
+    std::cerr << "Limiting the number of clients to " << limit
+              << " because of RLIMIT_NOFILE" << std::endl;
+    numClients = limit;
+  }
+  if (numClients < 1) {
+    std::cerr << "Expected at least one client" << std::endl;
+    return 1;
+  }
+
+  const auto timeout = std::chrono::seconds(300);
+  c10d::TCPStore server(
+      "127.0.0.1", 0, numClients + 1, true, timeout, /* wait */ false);
+  const auto port = server.getPort();
+
+  std::vector<Phases> phases(numClients);
+  std::vector<std::thread> threads;
+  threads.reserve(numClients);
+  const auto start = Clock::now();
+  for (int rank = 0; rank < numClients; rank++) {
+    threads.emplace_back([&, rank] {
+      auto& phase = phases[rank];
+      phase.start = Clock::now();
+      c10d::TCPStore store("127.0.0.1", port, numClients + 1, false, timeout);
+      phase.connected = Clock::now();
+
+      const auto address = "127.0.0.1:" + std::to_string(10000 + rank);
+      store.set(
+          "addr/" + std::to_string(rank),
+          std::vector<uint8_t>(address.begin(), address.end()));
+      phase.published = Clock::now();
+
+      std::vector<std::string> keys;
+      for (int i = 1; i <= numPeers; i++) {
+        keys.push_back("addr/" + std::to_string((rank + i) % numClients));
+      }
+      store.multiGet(keys);
+      phase.fetched = Clock::now();
+
+      if (store.add("barrier", 1) == numClients) {
+        store.set("barrier_done", std::vector<uint8_t>{1});
+      }
+      store.wait({"barrier_done"});
+      phase.done = Clock::now();
+    });
+  }
+  server.waitForWorkers();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto end = Clock::now();
+
+  std::cout << numClients << " clients, " << numPeers
+            << " peers per client, total " << elapsedMs(start, end) << " ms"
+            << std::endl;
+  printPhase("connect", phases, &Phases::start, &Phases::connected);
+  printPhase("set", phases, &Phases::connected, &Phases::published);
+  printPhase("multi_get", phases, &Phases::published, &Phases::fetched);
+  printPhase("barrier", phases, &Phases::fetched, &Phases::done);
+  return 0;
+}
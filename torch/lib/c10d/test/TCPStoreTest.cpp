@@ -143,3 +143,94 @@ TEST(TCPStoreTest, testHelper) {
 TEST(TCPStoreTest, testHelperPrefix) {
   testHelper("testPrefix");
 }
+
+void testBatchedOps(const std::string& prefix = "") {
+  auto serverTCPStore = c10::make_intrusive<c10d::TCPStore>(
+      "127.0.0.1", 0, 2, true, std::chrono::seconds(30), /* wait */ false);
+  auto serverStore =
+      c10::make_intrusive<c10d::PrefixStore>(prefix, serverTCPStore);
+  auto clientTCPStore = c10::make_intrusive<c10d::TCPStore>(
+      "127.0.0.1", serverTCPStore->getPort(), 2, false);
+  auto clientStore =
+      c10::make_intrusive<c10d::PrefixStore>(prefix, clientTCPStore);
+  serverTCPStore->waitForWorkers();
+
+  // multiGet blocks until the keys are set by the other store.
+  const std::vector<std::string> keys = {"key0", "key1", "key2"};
+  std::vector<std::vector<uint8_t>> values;
+  auto getThread = std::thread(
+      [&serverStore, &keys, &values] { values = serverStore->multiGet(keys); });
+  clientStore->multiSet(
+      keys,
+      {std::vector<uint8_t>{0},
+       std::vector<uint8_t>{1, 1},
+       std::vector<uint8_t>{}});
+  getThread.join();
+  ASSERT_EQ(3, values.size());
+  EXPECT_EQ(std::vector<uint8_t>({0}), values[0]);
+  EXPECT_EQ(std::vector<uint8_t>({1, 1}), values[1]);
+  EXPECT_TRUE(values[2].empty());
+  c10d::test::check(*clientStore, "key1", std::string("\x01\x01"));
+
+  // watchKey returns once the value differs from the last seen value.
+  const auto key = prefix.empty() ? "counter" : prefix + "/counter";
+  clientStore->add("counter", 1);
+  auto watchThread = std::thread([&serverTCPStore, &key] {
+    auto value = serverTCPStore->watchKey(
+        key, std::vector<uint8_t>{'1'}, std::chrono::seconds(30));
+    EXPECT_EQ(std::vector<uint8_t>({'3'}), value);
+  });
+  clientStore->add("counter", 2);
+  watchThread.join();
+
+  // A timed out watch does not break subsequent requests.
+  EXPECT_THROW(
+      serverTCPStore->watchKey(
+          key,
+          std::vector<uint8_t>{'3'},
+          std::chrono::milliseconds(kShortStoreTimeoutMillis)),
+      std::runtime_error);
+  c10d::test::check(*serverStore, "counter", "3");
+
+  // Neither does the timeout of a watch that returns in time.
+  EXPECT_EQ(
+      std::vector<uint8_t>({'3'}),
+      serverTCPStore->watchKey(
+          key,
+          std::vector<uint8_t>{'1'},
+          std::chrono::milliseconds(kShortStoreTimeoutMillis)));
+  auto setThread = std::thread([&clientStore] {
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(2 * kShortStoreTimeoutMillis));
+    clientStore->set("late", std::vector<uint8_t>{2});
+  });
+  EXPECT_EQ(
+      std::vector<uint8_t>({2}), serverStore->multiGet({"late"}).at(0));
+  setThread.join();
+
+  // A key that was present when multiGet was called but is deleted before
+  // the missing ones are set is waited for again.
+  clientStore->set("present", std::vector<uint8_t>{3});
+  auto multiGetThread = std::thread([&serverStore, &values] {
+    values = serverStore->multiGet({"present", "missing"});
+  });
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(2 * kShortStoreTimeoutMillis));
+  EXPECT_TRUE(clientStore->deleteKey("present"));
+  clientStore->set("missing", std::vector<uint8_t>{4});
+  // The connection of the setter is unaffected.
+  c10d::test::check(*clientStore, "missing", std::string("\x04"));
+  clientStore->set("present", std::vector<uint8_t>{5});
+  multiGetThread.join();
+  ASSERT_EQ(2, values.size());
+  EXPECT_EQ(std::vector<uint8_t>({5}), values[0]);
+  EXPECT_EQ(std::vector<uint8_t>({4}), values[1]);
+}
+
+TEST(TCPStoreTest, testBatchedOps) {
+  testBatchedOps();
+}
+
+TEST(TCPStoreTest, testBatchedOpsPrefix) {
+  testBatchedOps("testPrefix");
+}
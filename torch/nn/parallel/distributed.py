@@ -1097,7 +1097,7 @@ class DistributedDataParallel(Module):
         dist._register_comm_hook(self.reducer, state, hook)
 
     def _register_builtin_comm_hook(
-        self, comm_hook_type
+        self, comm_hook_type, compression_options=None
     ):
         r"""
         Registers a built-in communication hook that specifies how DDP
@@ -1108,6 +1108,11 @@ class DistributedDataParallel(Module):
         Args:
             comm_hook_type (dist.BuiltinCommHookType): type of communication hook, such as
             ALLREDUCE, FP16_COMPRESS, etc.
+            compression_options (dist._GradCompressionOptions, optional): hyperparameters of
+            the gradient compression hooks POWER_SGD, TOPK_SPARSIFY and INT8_QUANTIZE. Unlike
+            ALLREDUCE and FP16_COMPRESS, these hooks also support the gloo backend. Their
+            per-bucket state can be checkpointed with ``dist._get_builtin_comm_hook_state_dict``
+            and restored with ``dist._load_builtin_comm_hook_state_dict``.
 
         .. warning ::
             DDP communication hook can only be registered once and should be registered
@@ -1127,8 +1132,18 @@ class DistributedDataParallel(Module):
 
             >>> ddp._register_builtin_comm_hook(dist.BuiltinCommHookType.FP16_COMPRESS)
 
+            Below is an example of PowerSGD compression with a rank-2 approximation.
+
+            >>> options = dist._GradCompressionOptions()
+            >>> options.matrix_approximation_rank = 2
+            >>> ddp._register_builtin_comm_hook(dist.BuiltinCommHookType.POWER_SGD, options)
+
         """
-        dist._register_builtin_comm_hook(self.reducer, comm_hook_type)
+        if compression_options is None:
+            compression_options = dist._GradCompressionOptions()
+        dist._register_builtin_comm_hook(
+            self.reducer, comm_hook_type, compression_options
+        )
 
     def _distributed_broadcast_coalesced(
         self, tensors, buffer_size, authoritative_rank=0
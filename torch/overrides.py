@@ -114,6 +114,7 @@ def get_ignored_functions() -> Set[Callable]:
         torch.set_grad_enabled,
         torch.no_grad,
         torch.enable_grad,
+        torch.inference_mode,
         torch.layout,
         torch.align_tensors,
         torch.arange,
@@ -312,6 +313,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.cartesian_prod: lambda *tensors: -1,
         torch.cat: lambda tensors, dim=0, out=None: -1,
         torch.cdist: lambda x1, x2, p=2.0, compute_mode='use_mm_for_euclid_dist_if_necessary': -1,
+        torch.cdist_topk: lambda x1, x2, k, metric='euclidean', eps=1e-8: -1,
         torch.ceil: lambda input, out=None: -1,
         torch.celu: lambda input, alhpa=1., inplace=False: -1,
         torch.chain_matmul: lambda *matrices: -1,
@@ -788,6 +790,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.scatter: lambda input, dim, index, src: -1,
         torch.scatter_add: lambda input, dim, index, src: -1,
         torch.searchsorted: lambda sorted_sequence, input, out_int32=False, right=False, out=None: -1,
+        torch.segment_reduce: lambda data, reduce, lengths=None, offsets=None, axis=0, unsafe=False, initial=None: -1,
         torch.select: lambda input, dim, index: -1,
         torch.selu: lambda input, inplace=False: -1,
         torch.sigmoid: lambda input, out=None: -1,
@@ -800,6 +803,8 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         torch.slogdet: lambda input: -1,
         torch.linalg.slogdet: lambda input: -1,
         torch.smm: lambda input, mat2: -1,
+        torch.sparse_csr_tensor: lambda crow_indices, col_indices, values, size=None, dtype=None, layout=None, device=None, pin_memory=False, requires_grad=False: -1,
+        torch.jagged_tensor: lambda values, offsets, max_length=None: -1,
         torch.spmm: lambda input, mat2: -1,
         torch.softmax: lambda input, dim, dtype=None: -1,
         torch.solve: lambda input, A, out=None: -1,
@@ -910,9 +915,12 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.is_xpu.__get__: lambda self: -1,
         Tensor.is_leaf.__get__: lambda self: -1,
         Tensor.is_meta.__get__: lambda self: -1,
+        Tensor.is_inference.__get__: lambda self: -1,
         Tensor.is_mkldnn.__get__: lambda self: -1,
         Tensor.is_quantized.__get__: lambda self: -1,
         Tensor.is_sparse.__get__: lambda self: -1,
+        Tensor.is_sparse_csr.__get__: lambda self: -1,
+        Tensor.is_jagged.__get__: lambda self: -1,
         Tensor.is_vulkan.__get__: lambda self: -1,
         Tensor.layout.__get__: lambda self: -1,
         Tensor.name.__get__: lambda self: -1,
@@ -947,9 +955,11 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.cauchy_: lambda self, median=0, sigma=1, *, generator=None: -1,
         Tensor.coalesce: lambda self: -1,
         Tensor._coalesced_: lambda self, coalesced: -1,
+        Tensor.col_indices: lambda self: -1,
         Tensor.contiguous: lambda self, memory_format=torch.contiguous_format: -1,
         Tensor.copy_: lambda self, src, non_blocking=False: -1,
         Tensor.cpu: lambda self, memory_format=torch.preserve_format: -1,
+        Tensor.crow_indices: lambda self: -1,
         Tensor.cuda: lambda self, memory_format=torch.preserve_format: -1,
         Tensor.xpu: lambda self, memory_format=torch.preserve_format: -1,
         Tensor.data_ptr: lambda self: -1,
@@ -986,6 +996,7 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.nelement: lambda self: -1,
         Tensor.normal_: lambda self: -1,
         Tensor.numpy: lambda self: -1,
+        Tensor.offsets: lambda self: -1,
         Tensor.permute: lambda self, dim: -1,
         Tensor.pin_memory: lambda self: -1,
         Tensor.put_: lambda self, indices, tensor, accumulate=False: -1,
@@ -1019,6 +1030,9 @@ def get_testing_overrides() -> Dict[Callable, Callable]:
         Tensor.to: lambda self, dtype, non_blocking=False, copy=False, memory_format=torch.preserve_format: -1,
         Tensor.to_dense: lambda self: -1,
         Tensor.to_sparse: lambda self: -1,
+        Tensor.to_sparse_csr: lambda self: -1,
+        Tensor.to_jagged: lambda self, offsets, max_length=None: -1,
+        Tensor.to_padded_dense: lambda self, padding_value=0, max_length=None: -1,
         Tensor.tolist: lambda self: -1,
         Tensor.to_mkldnn: lambda self: -1,
         Tensor.type_as: lambda self, other: -1,
@@ -4177,6 +4177,36 @@ class ProcessGroupAgentRpcTest(RpcAgentTestFixture):
         self.assertEqual(int(info["agent.thread_pool_size"]), NUM_THREADS)
         rpc.shutdown()
 
+    @dist_init(setup_rpc=False)
+    def test_process_group_shm_tensor_transport(self):
+        rpc_backend_options = rpc.ProcessGroupRpcBackendOptions(
+            init_method=self.rpc_backend_options.init_method,
+            num_send_recv_threads=self.rpc_backend_options.num_send_recv_threads,
+            shm_threshold_bytes=1024,
+        )
+        rpc.init_rpc(
+            name=worker_name(self.rank),
+            backend=self.rpc_backend,
+            rank=self.rank,
+            world_size=self.world_size,
+            rpc_backend_options=rpc_backend_options,
+        )
+
+        dst = worker_name((self.rank + 1) % self.world_size)
+        # Mix tensors above and below the threshold, including a view, so
+        # that placeholders and descriptors have to be matched by index.
+        large = torch.arange(4096, dtype=torch.float)
+        small = torch.ones(1)
+        view = torch.arange(8192, dtype=torch.double).view(64, 128)[:, 1:]
+        ret = rpc.rpc_sync(dst, torch.add, args=(large, 1))
+        self.assertEqual(ret, large + 1)
+        ret = rpc.rpc_sync(dst, my_tensor_function, args=(small, large))
+        self.assertEqual(ret, large + 1)
+        ret = rpc.rpc_sync(dst, my_tensor_function, args=(view, view))
+        self.assertEqual(ret, view * 2)
+
+        rpc.shutdown()
+
     @dist_init(setup_rpc=False)
     def test_process_group_set_default_timeout(self):
         timeout = 0.5
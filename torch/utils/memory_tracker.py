@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""
+Tracks the CPU memory allocated by all the threads, and attributes the memory
+alive at peak to the ops and modules that allocated it.
+
+Example::
+
+    >>> from torch.utils.memory_tracker import track_memory
+    >>> with track_memory(model) as tracker:
+    ...     model(inputs).sum().backward()
+    >>> print(tracker.table(group_by="module"))
+    >>> tracker.save("memory.json")
+
+Saved traces, e.g. of all the ranks of a job, are aggregated with::
+
+    python -m torch.utils.memory_tracker memory.json [more.json ...] --group-by op
+    python -m torch.utils.memory_tracker memory.json --timeline timeline.csv
+
+Every allocation is attributed to a site: the stack of RecordFunction scopes
+(ops, autograd functions, record_function blocks and the modules of the
+tracked model) of the allocating thread. A trace file is a JSON object with:
+
+- ``peak_bytes``, ``current_bytes``: peak and current tracked memory.
+- ``peak_time_us``: time of the peak, relative to the start of the tracking.
+- ``events_dropped``: number of events missing from ``events``.
+- ``sites``: the sites, as a tree; every site has the ``name`` of its
+  innermost scope and the index of its ``parent`` site (-1 for the root site,
+  which has no scope), which always comes before it. ``live_bytes``,
+  ``peak_bytes``, ``total_bytes`` and ``num_allocs`` are the memory allocated
+  by the site itself and still alive, alive at peak, allocated in total, and
+  its number of allocations.
+- ``events``: the allocations and frees, as ``[time_us, site, bytes,
+  thread_id]`` with negative bytes for frees.
+"""
+import argparse
+import json
+import sys
+import threading
+from collections import defaultdict
+from typing import Any, Dict, List, Optional, Tuple
+
+import torch
+from torch.autograd.profiler import format_memory
+
+MODULE_SCOPE_PREFIX = "nn.Module: "
+
+GROUP_BY = ("op", "module", "scope")
+
+
+def _group_key(scope: List[str], group_by: str) -> str:
+    if group_by == "module":
+        # innermost module
+        for name in reversed(scope):
+            if name.startswith(MODULE_SCOPE_PREFIX):
+                return name[len(MODULE_SCOPE_PREFIX):]
+        return "<no module>"
+    elif group_by == "op":
+        # outermost op, i.e. the one called by the user or the module
+        for name in scope:
+            if not name.startswith(MODULE_SCOPE_PREFIX):
+                return name
+        return "<no op>"
+    elif group_by == "scope":
+        return " > ".join(scope) if len(scope) > 0 else "<no scope>"
+    raise ValueError("group_by should be one of {}, got {}".format(GROUP_BY, group_by))
+
+
+def load(path: str) -> Dict[str, Any]:
+    """Loads a trace file, with the full ``scope`` of every site."""
+    with open(path, "r") as f:
+        trace = json.load(f)
+    scopes: List[List[str]] = []
+    for site in trace["sites"]:
+        parent = site["parent"]
+        site["scope"] = [] if parent < 0 else scopes[parent] + [site["name"]]
+        scopes.append(site["scope"])
+    return trace
+
+
+def peak_breakdown(traces: List[Dict[str, Any]], group_by: str = "op") -> List[Tuple[str, int, int]]:
+    """Returns the (key, bytes alive at peak, bytes allocated) of every group
+    of sites, largest first. The peaks of multiple traces are summed."""
+    peak: Dict[str, int] = defaultdict(int)
+    total: Dict[str, int] = defaultdict(int)
+    for trace in traces:
+        for site in trace["sites"]:
+            if site["num_allocs"] == 0:
+                continue
+            key = _group_key(site["scope"], group_by)
+            peak[key] += site["peak_bytes"]
+            total[key] += site["total_bytes"]
+    return sorted(
+        [(key, peak[key], total[key]) for key in peak],
+        key=lambda entry: (entry[1], entry[2]),
+        reverse=True)
+
+
+def timeline(trace: Dict[str, Any]) -> List[Tuple[float, int]]:
+    """Returns the tracked memory after every event, as (time_us, bytes)."""
+    result = []
+    current = 0
+    for time_us, _, nbytes, _ in trace["events"]:
+        current += nbytes
+        result.append((time_us, current))
+    return result
+
+
+def table(traces: List[Dict[str, Any]], group_by: str = "op", row_limit: int = 20) -> str:
+    """Prints the peak memory breakdown of the traces."""
+    rows = peak_breakdown(traces, group_by)
+    peak_bytes = sum(trace["peak_bytes"] for trace in traces)
+    name_width = min(max([len(key) for key, _, _ in rows] + [len(group_by)]) + 2, 80)
+    row_format = "{:<" + str(name_width) + "}  {:>12}  {:>8}  {:>12}"
+    lines = [row_format.format(group_by.capitalize(), "Peak Mem", "Peak %", "Total Mem")]
+    lines.append("-" * len(lines[0]))
+    for key, peak, total in rows[:row_limit] if row_limit >= 0 else rows:
+        if len(key) > name_width:
+            key = key[:name_width - 3] + "..."
+        share = "{:.2f}%".format(100.0 * peak / peak_bytes) if peak_bytes > 0 else "--"
+        lines.append(row_format.format(key, format_memory(peak), share, format_memory(total)))
+    lines.append("-" * len(lines[0]))
+    lines.append("Peak memory: {}".format(format_memory(peak_bytes)))
+    dropped = sum(trace["events_dropped"] for trace in traces)
+    if dropped > 0:
+        lines.append("Timeline events dropped: {}".format(dropped))
+    return "\n".join(lines)
+
+
+class track_memory(object):
+    """Context manager that tracks the CPU memory allocations of all the
+    threads, see the module documentation.
+
+    Only one instance can be active at a time. Tracking serializes the
+    allocations of all the threads, so expect a slowdown.
+
+    Args:
+        module (torch.nn.Module, optional): the allocations made by this module
+            and its submodules are attributed to them, named as in
+            ``module.named_modules()``. Only the forward pass is attributed,
+            the backward pass is attributed to the autograd functions.
+        max_events (int, optional): maximum number of events of the timeline,
+            the per site stats are exact regardless.
+    """
+    def __init__(self, module: Optional[torch.nn.Module] = None, max_events: Optional[int] = None):
+        self.module = module
+        self.max_events = max_events
+        self._hook_handles: List[Any] = []
+        self._local = threading.local()
+
+    def _scopes(self) -> List[Any]:
+        if not hasattr(self._local, "scopes"):
+            self._local.scopes = []
+        return self._local.scopes
+
+    def _add_module_hooks(self):
+        assert self.module is not None
+        for name, submodule in self.module.named_modules():
+            scope_name = "{}{} ({})".format(
+                MODULE_SCOPE_PREFIX, name if name else "<root>", type(submodule).__name__)
+
+            def enter(mod, inputs, scope_name=scope_name):
+                self._scopes().append(torch.ops.profiler._record_function_enter(scope_name))
+
+            def leave(mod, inputs, outputs):
+                scopes = self._scopes()
+                if len(scopes) > 0:
+                    torch.ops.profiler._record_function_exit(scopes.pop())
+
+            self._hook_handles.append(submodule.register_forward_pre_hook(enter))
+            self._hook_handles.append(submodule.register_forward_hook(leave))
+
+    def __enter__(self):
+        if self.max_events is not None:
+            torch.autograd._enable_memory_tracker(self.max_events)
+        else:
+            torch.autograd._enable_memory_tracker()
+        if self.module is not None:
+            self._add_module_hooks()
+        return self
+
+    def __exit__(self, exc_type, exc_val, exc_tb):
+        for handle in self._hook_handles:
+            handle.remove()
+        self._hook_handles = []
+        # scopes left open by an exception in a forward pass
+        scopes = self._scopes()
+        while len(scopes) > 0:
+            torch.ops.profiler._record_function_exit(scopes.pop())
+        torch.autograd._disable_memory_tracker()
+        return False
+
+    def snapshot(self) -> Dict[str, Any]:
+        """Returns the current state of the tracker, in the format of
+        :func:`load`, without the events."""
+        snapshot = torch.autograd._memory_tracker_snapshot()
+        return {
+            "current_bytes": snapshot.current_bytes,
+            "peak_bytes": snapshot.peak_bytes,
+            "peak_time_us": snapshot.peak_time_ns / 1000.0,
+            "events_dropped": snapshot.events_dropped,
+            "sites": [{
+                "scope": site.scope,
+                "live_bytes": site.live_bytes,
+                "peak_bytes": site.peak_bytes,
+                "total_bytes": site.total_bytes,
+                "num_allocs": site.num_allocs,
+            } for site in snapshot.sites],
+        }
+
+    def table(self, group_by: str = "op", row_limit: int = 20) -> str:
+        return table([self.snapshot()], group_by, row_limit)
+
+    def save(self, path: str):
+        """Writes the trace to a JSON file, see :func:`load`."""
+        torch.autograd._save_memory_trace(path)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(
+        description="Prints the peak memory breakdown of memory tracker traces")
+    parser.add_argument("traces", nargs="+", help="trace files, their peaks are summed")
+    parser.add_argument("--group-by", choices=GROUP_BY, default="op",
+                        help="outermost op, innermost module or full scope of the allocations")
+    parser.add_argument("--row-limit", type=int, default=20, help="number of rows, -1 for all")
+    parser.add_argument("--timeline", type=str, default=None,
+                        help="write the memory timeline of the first trace to this CSV file")
+    args = parser.parse_args(argv)
+
+    traces = [load(path) for path in args.traces]
+    print(table(traces, args.group_by, args.row_limit))
+    if args.timeline:
+        with open(args.timeline, "w") as f:
+            f.write("time_us,bytes\n")
+            for time_us, nbytes in timeline(traces[0]):
+                f.write("{},{}\n".format(time_us, nbytes))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
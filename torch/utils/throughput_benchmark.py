@@ -1,4 +1,6 @@
 
+import json
+
 import torch._C
 
 def format_time(time_us=None, time_ms=None, time_s=None):
@@ -36,6 +38,53 @@ class ExecutionStats(object):
     def num_iters(self):
         return self._c_stats.num_iters
 
+    @property
+    def latency_p50_ms(self):
+        return self._c_stats.latency_p50_ms
+
+    @property
+    def latency_p90_ms(self):
+        return self._c_stats.latency_p90_ms
+
+    @property
+    def latency_p99_ms(self):
+        return self._c_stats.latency_p99_ms
+
+    @property
+    def latency_p999_ms(self):
+        return self._c_stats.latency_p999_ms
+
+    @property
+    def interval_iters_per_second(self):
+        '''
+        Returns number of iterations per second completed in every interval of
+        throughput_interval_ms of the benchmark, the last interval may be shorter
+        '''
+        return self._c_stats.interval_iters_per_second
+
+    @property
+    def avg_batch_size(self):
+        '''
+        Returns average number of requests per batch, or -1 without batching
+        '''
+        return self._c_stats.avg_batch_size
+
+    @property
+    def warmup_num_iters(self):
+        return self._c_stats.warmup_num_iters
+
+    @property
+    def warmup_latency_avg_ms(self):
+        return self._c_stats.warmup_latency_avg_ms
+
+    @property
+    def warmup_latency_p99_ms(self):
+        return self._c_stats.warmup_latency_p99_ms
+
+    @property
+    def warmup_time_seconds(self):
+        return self._c_stats.warmup_time_ms / 1000.0
+
     @property
     def iters_per_second(self):
         '''
@@ -45,17 +94,78 @@ class ExecutionStats(object):
 
     @property
     def total_time_seconds(self):
-        return self.num_iters * (
-            self.latency_avg_ms / 1000.0) / self.benchmark_config.num_calling_threads
+        return self._c_stats.total_time_ms / 1000.0
 
 
     def __str__(self):
-        return '\n'.join([
+        lines = [
             "Average latency per example: " + format_time(time_ms=self.latency_avg_ms),
+            "Latency p50 / p90 / p99 / p99.9: {} / {} / {} / {}".format(
+                format_time(time_ms=self.latency_p50_ms),
+                format_time(time_ms=self.latency_p90_ms),
+                format_time(time_ms=self.latency_p99_ms),
+                format_time(time_ms=self.latency_p999_ms)),
             "Total number of iterations: {}".format(self.num_iters),
             "Total number of iterations per second (across all threads): {:.2f}".format(self.iters_per_second),
             "Total time: " + format_time(time_s=self.total_time_seconds)
-        ])
+        ]
+        if self.avg_batch_size >= 0:
+            lines.append("Average batch size: {:.2f}".format(self.avg_batch_size))
+        if self.warmup_num_iters > 0:
+            lines.append("Warmup: {} iterations in {}, average latency {}, p99 latency {}".format(
+                self.warmup_num_iters,
+                format_time(time_s=self.warmup_time_seconds),
+                format_time(time_ms=self.warmup_latency_avg_ms),
+                format_time(time_ms=self.warmup_latency_p99_ms)))
+        return '\n'.join(lines)
+
+    def to_dict(self):
+        '''
+        Returns the benchmark configuration, the intra-op and inter-op thread
+        settings and the stats as a dictionary
+        '''
+        config = self.benchmark_config
+        return {
+            "config": {
+                "num_calling_threads": config.num_calling_threads,
+                "num_worker_threads": config.num_worker_threads,
+                "num_warmup_iters": config.num_warmup_iters,
+                "num_iters": config.num_iters,
+                "max_batch_size": config.max_batch_size,
+                "max_batch_delay_us": config.max_batch_delay_us,
+                "use_static_runtime": config.use_static_runtime,
+                "target_qps": config.target_qps,
+                "throughput_interval_ms": config.throughput_interval_ms,
+                "num_threads": torch.get_num_threads(),
+                "num_interop_threads": torch.get_num_interop_threads(),
+            },
+            "stats": {
+                "num_iters": self.num_iters,
+                "total_time_seconds": self.total_time_seconds,
+                "iters_per_second": self.iters_per_second,
+                "interval_iters_per_second": list(self.interval_iters_per_second),
+                "latency_avg_ms": self.latency_avg_ms,
+                "latency_p50_ms": self.latency_p50_ms,
+                "latency_p90_ms": self.latency_p90_ms,
+                "latency_p99_ms": self.latency_p99_ms,
+                "latency_p999_ms": self.latency_p999_ms,
+                "avg_batch_size": self.avg_batch_size,
+            },
+            "warmup": {
+                "num_iters": self.warmup_num_iters,
+                "time_seconds": self.warmup_time_seconds,
+                "latency_avg_ms": self.warmup_latency_avg_ms,
+                "latency_p99_ms": self.warmup_latency_p99_ms,
+            },
+        }
+
+    def export_json(self, path):
+        '''
+        Writes :meth:`to_dict` to a JSON file, e.g. to compare the results of runs
+        with different thread settings
+        '''
+        with open(path, "w") as f:
+            json.dump(self.to_dict(), f, indent=2)
 
 
 class ThroughputBenchmark(object):
@@ -121,7 +231,13 @@ class ThroughputBenchmark(object):
             num_calling_threads=1,
             num_warmup_iters=10,
             num_iters=100,
-            profiler_output_path=""):
+            profiler_output_path="",
+            max_batch_size=0,
+            max_batch_delay_us=1000,
+            num_worker_threads=1,
+            use_static_runtime=False,
+            target_qps=0,
+            throughput_interval_ms=1000):
         '''
         Args:
             num_warmup_iters (int): Warmup iters are used to make sure we run a module
@@ -141,16 +257,57 @@ class ThroughputBenchmark(object):
                 execution (but not the warmup phase). The full trace will be saved
                 into the file path provided by this argument
 
+            max_batch_size (int): If positive, concurrent requests are coalesced into
+                batches of up to this many rows (sizes along dim 0 of the inputs)
+                before running the module. Only supported for ScriptModule, whose
+                inputs must then all be tensors batched along dim 0. Requests whose
+                inputs differ in anything but their first dimension are not batched
+                together
+
+            max_batch_delay_us (int): Maximum time in microseconds a request waits
+                for its batch to fill up
+
+            num_worker_threads (int): Number of threads running the batches. Must be 1
+                without batching
+
+            use_static_runtime (bool): Run the batches through the static runtime
+                instead of the forward method of the module
+
+            target_qps (float): If positive, requests arrive open loop at this
+                average rate, with exponentially distributed inter-arrival times, and
+                latencies are measured from the scheduled arrival times, including
+                the time requests wait for a free calling thread. Otherwise every
+                calling thread issues a request as soon as its previous one
+                completes. Warmup iterations always run closed loop
+
+            throughput_interval_ms (int): Length of the intervals of
+                stats.interval_iters_per_second, used to check that the throughput
+                is stable over the run
+
 
         This function returns BenchmarkExecutionStats object which is defined via pybind11.
-        It currently has two fields:
+        It has the following fields:
             - num_iters - number of actual iterations the benchmark have made
-            - avg_latency_ms - average time it took to infer on one input example in milliseconds
+            - latency_avg_ms - average time it took to infer on one input example in milliseconds
+            - latency_p50_ms, latency_p90_ms, latency_p99_ms, latency_p999_ms - latency
+              percentiles in milliseconds
+            - total_time_ms - wall time of the benchmark, without the warmup
+            - interval_iters_per_second - throughput of every throughput_interval_ms interval
+            - avg_batch_size - average number of requests per batch, -1 without batching
+            - warmup_num_iters, warmup_latency_avg_ms, warmup_latency_p99_ms,
+              warmup_time_ms - stats of the warmup iterations, not included in the above
+        It is wrapped in ExecutionStats, which can export it to JSON.
         '''
         config = torch._C.BenchmarkConfig()
         config.num_calling_threads = num_calling_threads
         config.num_warmup_iters = num_warmup_iters
         config.num_iters = num_iters
         config.profiler_output_path = profiler_output_path
+        config.max_batch_size = max_batch_size
+        config.max_batch_delay_us = max_batch_delay_us
+        config.num_worker_threads = num_worker_threads
+        config.use_static_runtime = use_static_runtime
+        config.target_qps = target_qps
+        config.throughput_interval_ms = throughput_interval_ms
         c_stats = self._benchmark.benchmark(config)
         return ExecutionStats(c_stats, config)